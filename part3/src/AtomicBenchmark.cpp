@@ -0,0 +1,329 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the AtomicBenchmark class.
+ */
+
+//Headers
+#include <AtomicBenchmark.h>
+#include <common.h>
+#include <AtomicWorker.h>
+#include <Thread.h>
+
+//Libraries
+#include <iostream>
+#include <cstdio>
+
+using namespace xmem;
+
+AtomicBenchmark::AtomicBenchmark(
+        void* mem_array,
+        uint32_t num_lines,
+        uint32_t iterations,
+        uint32_t num_worker_threads,
+        uint32_t mem_node,
+        uint32_t cpu_node,
+        std::vector<uint32_t> spread_cpu_nodes,
+        atomic_op_t op,
+        std::vector<PowerReader*> dram_power_readers,
+        std::string name
+    ) :
+        Benchmark(
+            mem_array,
+            static_cast<size_t>(num_lines) * CACHE_LINE_SIZE,
+            iterations,
+            num_worker_threads,
+            mem_node,
+            cpu_node,
+            SEQUENTIAL,
+            WRITE,
+#ifdef HAS_WORD_64
+            CHUNK_64b,
+#else
+            CHUNK_32b,
+#endif
+            1,
+            1,
+            dram_power_readers,
+            "ns/op",
+            name
+        ),
+        num_lines_(num_lines),
+        spread_cpu_nodes_(spread_cpu_nodes),
+        op_(op),
+        throughput_on_iter_(iterations, 0),
+        latency_histogram_(ATOMIC_BENCHMARK_HISTOGRAM_BINS, 0)
+    {
+}
+
+std::string AtomicBenchmark::atomicOpName(atomic_op_t op) {
+    switch (op) {
+        case ATOMIC_FETCH_ADD:
+            return "fetch-add";
+        case ATOMIC_COMPARE_EXCHANGE:
+            return "compare-exchange";
+        case ATOMIC_EXCHANGE:
+            return "exchange";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+void AtomicBenchmark::reportBenchmarkInfo() const {
+    if (spread_cpu_nodes_.empty())
+        std::cout << "CPU NUMA Node: " << cpu_node_ << std::endl;
+    else {
+        std::cout << "CPU NUMA Nodes:";
+        for (uint32_t n = 0; n < spread_cpu_nodes_.size(); n++)
+            std::cout << " " << spread_cpu_nodes_[n];
+        std::cout << " (threads round-robin)" << std::endl;
+    }
+    std::cout << "Memory NUMA Node: " << mem_node_ << std::endl;
+    std::cout << "Atomic Operation: " << atomicOpName(op_) << std::endl;
+    std::cout << "Shared cache lines: " << num_lines_ << std::endl;
+    std::cout << "Number of worker threads: " << num_worker_threads_ << std::endl;
+    std::cout << std::endl;
+}
+
+void AtomicBenchmark::reportResults() const {
+    std::cout << std::endl;
+    std::cout << "*** RESULTS";
+    std::cout << "***" << std::endl;
+    std::cout << std::endl;
+
+    if (has_run_) {
+        for (uint32_t i = 0; i < iterations_; i++) {
+            std::printf("Iter #%4d:    %0.3f    %s    %0.3f    Mops/s", i, metric_on_iter_[i], metric_units_.c_str(), throughput_on_iter_[i]);
+            if (warning_)
+                std::cout << " (WARNING)";
+            std::cout << std::endl;
+        }
+
+        std::cout << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "Mean throughput: " << getMeanThroughput() << " Mops/s";
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << "Mean latency: " << mean_metric_ << " " << metric_units_;
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        //Distribution of per-operation latency samples, not of per-iteration means
+        std::cout << "Latency distribution (" << ATOMIC_BENCHMARK_BATCH_OPS << "-op samples): ";
+        std::cout << "min " << getLatencyPercentile(0);
+        std::cout << ", 25th " << getLatencyPercentile(25);
+        std::cout << ", median " << getLatencyPercentile(50);
+        std::cout << ", 75th " << getLatencyPercentile(75);
+        std::cout << ", 95th " << getLatencyPercentile(95);
+        std::cout << ", 99th " << getLatencyPercentile(99);
+        std::cout << ", 99.9th " << getLatencyPercentile(99.9);
+        std::cout << ", max " << getLatencyPercentile(100);
+        std::cout << " " << metric_units_;
+        if (latency_histogram_[ATOMIC_BENCHMARK_HISTOGRAM_BINS-1] > 0)
+            std::cout << " (max is clipped)";
+        std::cout << std::endl;
+
+        std::cout << std::endl;
+
+        reportPowerResults();
+    }
+    else
+        std::cerr << "WARNING: Benchmark has not run yet. No reported results." << std::endl;
+}
+
+double AtomicBenchmark::getMeanThroughput() const {
+    if (!has_run_)
+        return -1;
+
+    double total = 0;
+    for (uint32_t i = 0; i < iterations_; i++)
+        total += throughput_on_iter_[i];
+    return total / iterations_;
+}
+
+double AtomicBenchmark::getLatencyPercentile(double percentile) const {
+    if (!has_run_)
+        return -1;
+
+    uint64_t total = 0;
+    for (uint32_t b = 0; b < ATOMIC_BENCHMARK_HISTOGRAM_BINS; b++)
+        total += latency_histogram_[b];
+    if (total == 0)
+        return -1;
+
+    //Find the first bin at which the cumulative count reaches the requested rank
+    uint64_t rank = static_cast<uint64_t>(percentile / 100 * (total-1)) + 1;
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < ATOMIC_BENCHMARK_HISTOGRAM_BINS; b++) {
+        seen += latency_histogram_[b];
+        if (seen >= rank)
+            return b;
+    }
+    return ATOMIC_BENCHMARK_HISTOGRAM_BINS-1;
+}
+
+double AtomicBenchmark::getLatencyMode() const {
+    if (!has_run_)
+        return -1;
+
+    uint32_t mode = 0;
+    for (uint32_t b = 1; b < ATOMIC_BENCHMARK_HISTOGRAM_BINS; b++) {
+        if (latency_histogram_[b] > latency_histogram_[mode])
+            mode = b;
+    }
+    return mode;
+}
+
+int32_t AtomicBenchmark::workerCpu(uint32_t t) const {
+    if (spread_cpu_nodes_.empty())
+        return cpu_id_in_numa_node(cpu_node_, t);
+    uint32_t num_nodes = static_cast<uint32_t>(spread_cpu_nodes_.size());
+    return cpu_id_in_numa_node(spread_cpu_nodes_[t % num_nodes], t / num_nodes);
+}
+
+std::vector<int32_t> AtomicBenchmark::workerCpus() const {
+    std::vector<int32_t> cpus;
+    for (uint32_t t = 0; t < num_worker_threads_; t++)
+        cpus.push_back(workerCpu(t));
+    return cpus;
+}
+
+bool AtomicBenchmark::runCore() {
+    //Zero the counters
+    for (uint32_t l = 0; l < num_lines_; l++)
+        *reinterpret_cast<volatile uint64_t*>(reinterpret_cast<uint8_t*>(mem_array_) + static_cast<size_t>(l) * CACHE_LINE_SIZE) = 0;
+
+    //Start power measurement
+    if (g_verbose)
+        std::cout << "Starting power measurement threads...";
+
+    if (!startPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to start power threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run benchmark
+    if (g_verbose)
+        std::cout << "Running benchmark." << std::endl << std::endl;
+
+    //Do a bunch of iterations of the core benchmark routine
+    for (uint32_t i = 0; i < iterations_; i++) {
+        std::vector<AtomicWorker*> workers;
+        std::vector<Thread*> worker_threads;
+
+        //Create workers and worker threads. Each thread starts on its own line so that threads are spread over the lines.
+        for (uint32_t t = 0; t < num_worker_threads_; t++) {
+            int32_t cpu_id = workerCpu(t);
+            if (cpu_id < 0)
+                std::cerr << "WARNING: Failed to find a logical CPU for worker thread " << t << std::endl;
+            workers.push_back(new AtomicWorker(mem_array_, num_lines_, op_, t, cpu_id));
+            worker_threads.push_back(new Thread(workers[t]));
+        }
+
+        //Start worker threads! gogogo
+        for (uint32_t t = 0; t < num_worker_threads_; t++)
+            worker_threads[t]->create_and_start();
+
+        //Wait for all threads to complete
+        for (uint32_t t = 0; t < num_worker_threads_; t++)
+            if (!worker_threads[t]->join())
+                std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+
+        //Compute metrics for this iteration
+        bool iterwarning = false;
+        double total_ops = 0;
+        double total_adjusted_ticks = 0;
+        double latency_sum = 0;
+        for (uint32_t t = 0; t < num_worker_threads_; t++) {
+            double ops = static_cast<double>(workers[t]->getPasses()) * ATOMIC_BENCHMARK_BATCH_OPS;
+            double adjusted_ticks = static_cast<double>(workers[t]->getAdjustedTicks());
+            total_ops += ops;
+            total_adjusted_ticks += adjusted_ticks;
+            if (ops > 0)
+                latency_sum += adjusted_ticks * g_ns_per_tick / ops;
+            iterwarning |= workers[t]->hadWarning();
+
+            std::vector<uint64_t> histogram = workers[t]->getLatencyHistogram();
+            for (uint32_t b = 0; b < histogram.size() && b < ATOMIC_BENCHMARK_HISTOGRAM_BINS; b++)
+                latency_histogram_[b] += histogram[b];
+        }
+
+        metric_on_iter_[i] = latency_sum / num_worker_threads_;
+        double avg_adjusted_ticks = total_adjusted_ticks / num_worker_threads_;
+        if (avg_adjusted_ticks > 0)
+            throughput_on_iter_[i] = (total_ops / 1e6) / ((avg_adjusted_ticks * g_ns_per_tick) / 1e9);
+
+        if (iterwarning)
+            warning_ = true;
+
+        if (g_verbose) { //Report metrics for this iteration
+            std::cout << "Iter " << i+1 << " had " << total_ops << " total atomic operations across " << num_worker_threads_ << " threads:";
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...mean ns per op == " << metric_on_iter_[i];
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...Mops/s == " << throughput_on_iter_[i];
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+        }
+
+        //Clean up workers and threads for this iteration
+        for (uint32_t t = 0; t < num_worker_threads_; t++) {
+            delete worker_threads[t];
+            delete workers[t];
+        }
+    }
+
+    //Stop power measurement
+    if (g_verbose) {
+        std::cout << std::endl;
+        std::cout << "Stopping power measurement threads...";
+    }
+
+    if (!stopPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to stop power measurement threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run metadata
+    has_run_ = true;
+    computeMetrics();
+
+    return true;
+}
@@ -0,0 +1,243 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the AtomicWorker class.
+ */
+
+//Headers
+#include <AtomicWorker.h>
+#include <common.h>
+
+//Libraries
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <processthreadsapi.h>
+#endif
+
+#ifdef __gnu_linux__
+#include <unistd.h>
+#endif
+
+using namespace xmem;
+
+/**
+ * @brief Runs one batch of atomic operations over the shared lines, visiting them round-robin.
+ * @param base Address of the first shared line.
+ * @param num_lines Number of shared lines.
+ * @param line Index of the next line to visit. Updated on return.
+ * @param op The atomic operation to perform.
+ * @returns A value derived from the operation results, so they are not optimized away.
+ */
+static uint64_t atomic_batch(uint8_t* base, uint32_t num_lines, uint32_t& line, atomic_op_t op) {
+    uint64_t sink = 0;
+    for (uint32_t k = 0; k < ATOMIC_BENCHMARK_BATCH_OPS; k++) {
+#ifdef _WIN32
+        volatile LONG64* counter = reinterpret_cast<volatile LONG64*>(base + static_cast<size_t>(line) * CACHE_LINE_SIZE);
+        switch (op) {
+            case ATOMIC_FETCH_ADD:
+                sink += InterlockedExchangeAdd64(counter, 1);
+                break;
+            case ATOMIC_COMPARE_EXCHANGE: {
+                LONG64 expected = *counter;
+                LONG64 seen;
+                while ((seen = InterlockedCompareExchange64(counter, expected+1, expected)) != expected)
+                    expected = seen;
+                sink += expected;
+                break;
+            }
+            case ATOMIC_EXCHANGE:
+                sink += InterlockedExchange64(counter, static_cast<LONG64>(k));
+                break;
+            default:
+                break;
+        }
+#endif
+#ifdef __gnu_linux__
+        uint64_t* counter = reinterpret_cast<uint64_t*>(base + static_cast<size_t>(line) * CACHE_LINE_SIZE);
+        switch (op) {
+            case ATOMIC_FETCH_ADD:
+                sink += __atomic_fetch_add(counter, 1, __ATOMIC_SEQ_CST);
+                break;
+            case ATOMIC_COMPARE_EXCHANGE: {
+                uint64_t expected = __atomic_load_n(counter, __ATOMIC_RELAXED);
+                while (!__atomic_compare_exchange_n(counter, &expected, expected+1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)); //expected is refreshed on failure
+                sink += expected;
+                break;
+            }
+            case ATOMIC_EXCHANGE:
+                sink += __atomic_exchange_n(counter, static_cast<uint64_t>(k), __ATOMIC_SEQ_CST);
+                break;
+            default:
+                break;
+        }
+#endif
+        if (++line == num_lines)
+            line = 0;
+    }
+    return sink;
+}
+
+AtomicWorker::AtomicWorker(
+        void* mem_array,
+        uint32_t num_lines,
+        atomic_op_t op,
+        uint32_t first_line,
+        int32_t cpu_affinity
+    ) :
+        MemoryWorker(
+            mem_array,
+            static_cast<size_t>(num_lines) * CACHE_LINE_SIZE,
+            1,
+            cpu_affinity
+        ),
+        op_(op),
+        first_line_(first_line),
+        latency_histogram_(ATOMIC_BENCHMARK_HISTOGRAM_BINS, 0)
+    {
+}
+
+AtomicWorker::~AtomicWorker() {
+}
+
+std::vector<uint64_t> AtomicWorker::getLatencyHistogram() {
+    std::vector<uint64_t> retval;
+    if (acquireLock(-1)) {
+        retval = latency_histogram_;
+        releaseLock();
+    }
+
+    return retval;
+}
+
+void AtomicWorker::run() {
+    //Set up relevant state -- localized to this thread's stack
+    int32_t cpu_affinity = 0;
+    atomic_op_t op = ATOMIC_FETCH_ADD;
+    uint8_t* base = NULL;
+    uint32_t num_lines = 0;
+    uint32_t line = 0;
+    uint32_t passes = 0;
+    uint32_t p = 0;
+    tick_t start_tick = 0;
+    tick_t stop_tick = 0;
+    tick_t batch_ticks = 0;
+    tick_t elapsed_ticks = 0;
+    tick_t elapsed_dummy_ticks = 0;
+    tick_t adjusted_ticks = 0;
+    double dummy_ticks_per_batch = 0;
+    bool warning = false;
+    volatile uint64_t sink = 0;
+    std::vector<uint64_t> histogram(ATOMIC_BENCHMARK_HISTOGRAM_BINS, 0);
+    tick_t target_ticks = g_ticks_per_ms * BENCHMARK_DURATION_MS; //Rough target run duration in ticks
+
+    //Grab relevant setup state thread-safely and keep it local
+    if (acquireLock(-1)) {
+        base = static_cast<uint8_t*>(mem_array_);
+        num_lines = static_cast<uint32_t>(len_ / CACHE_LINE_SIZE);
+        line = first_line_ % num_lines;
+        op = op_;
+        cpu_affinity = cpu_affinity_;
+        releaseLock();
+    }
+
+    //Set processor affinity
+    bool locked = lock_thread_to_cpu(cpu_affinity);
+    if (!locked)
+        std::cerr << "WARNING: Failed to lock thread to logical CPU " << cpu_affinity << "! Results may not be correct." << std::endl;
+
+    //Increase scheduling priority
+#ifdef _WIN32
+    DWORD original_priority_class;
+    DWORD original_priority;
+    if (!boost_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!boost_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to boost scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Estimate the timer overhead of one batch first, so it can be taken out of every latency sample
+    for (p = 0; p < 1024; p++) {
+        start_tick = start_timer();
+        stop_tick = stop_timer();
+        elapsed_dummy_ticks += (stop_tick - start_tick);
+    }
+    dummy_ticks_per_batch = static_cast<double>(elapsed_dummy_ticks) / p;
+    elapsed_dummy_ticks = 0;
+
+    //Run benchmark
+    while (elapsed_ticks < target_ticks) {
+        start_tick = start_timer();
+        sink += atomic_batch(base, num_lines, line, op);
+        stop_tick = stop_timer();
+        batch_ticks = stop_tick - start_tick;
+        elapsed_ticks += batch_ticks;
+        passes++;
+
+        double ns_per_op = (static_cast<double>(batch_ticks) - dummy_ticks_per_batch) * g_ns_per_tick / ATOMIC_BENCHMARK_BATCH_OPS;
+        size_t bin = ns_per_op < 0 ? 0 : static_cast<size_t>(ns_per_op);
+        if (bin >= ATOMIC_BENCHMARK_HISTOGRAM_BINS)
+            bin = ATOMIC_BENCHMARK_HISTOGRAM_BINS-1;
+        histogram[bin]++;
+    }
+
+    elapsed_dummy_ticks = static_cast<tick_t>(dummy_ticks_per_batch * passes);
+    adjusted_ticks = elapsed_ticks - elapsed_dummy_ticks;
+
+    //Warn if something looks fishy
+    if (elapsed_dummy_ticks >= elapsed_ticks || elapsed_ticks < MIN_ELAPSED_TICKS || adjusted_ticks < 0.5 * elapsed_ticks)
+        warning = true;
+
+    //Unset processor affinity
+    if (locked)
+        unlock_thread_to_numa_node();
+
+    //Revert thread priority
+#ifdef _WIN32
+    if (!revert_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!revert_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to revert scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Update the object state thread-safely
+    if (acquireLock(-1)) {
+        adjusted_ticks_ = adjusted_ticks;
+        elapsed_ticks_ = elapsed_ticks;
+        elapsed_dummy_ticks_ = elapsed_dummy_ticks;
+        warning_ = warning || !locked;
+        bytes_per_pass_ = ATOMIC_BENCHMARK_BATCH_OPS * sizeof(uint64_t);
+        completed_ = true;
+        passes_ = passes;
+        latency_histogram_ = histogram;
+        releaseLock();
+    }
+}
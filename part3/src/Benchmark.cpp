@@ -34,6 +34,8 @@
 #include <common.h>
 #include <benchmark_kernels.h>
 #include <PowerReader.h>
+#include <InitWorker.h>
+#include <PerfCounters.h>
 
 //Libraries
 #include <cstdint>
@@ -87,6 +89,12 @@ Benchmark::Benchmark(
         metric_units_(metric_units),
         mean_dram_power_socket_(),
         peak_dram_power_socket_(),
+        dram_energy_socket_(),
+        dram_energy_time_socket_(),
+        perf_counts_(PerfCounters::emptyCounts()),
+        perf_counts_added_(0),
+        setup_ticks_(0),
+        region_layout_(NULL),
         name_(name),
         obj_valid_(false),
         has_run_(false),
@@ -107,12 +115,31 @@ bool Benchmark::run() {
     printBenchmarkHeader();
     reportBenchmarkInfo();
 
-    //Write to all of the memory region of interest to make sure
-    //pages are resident in physical memory and are not shared
-    forwSequentialWrite_Word32(mem_array_,
-                               reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_) + len_));
+    //Make sure pages are resident in physical memory and are not shared. This is timed separately from the benchmark itself.
+    //A previous benchmark on the same region may have done this already.
+    if (region_layout_ != NULL && mem_array_ != NULL && region_layout_->resident_len >= len_) {
+        std::cout << "Setup skipped: memory region is already resident" << std::endl;
+    } else {
+        tick_t setup_start_tick = start_timer();
+        if (!setupCore())
+            std::cerr << "WARNING: Memory for benchmark " << name_ << " may not have been initialized on the intended logical CPUs." << std::endl;
+        setup_ticks_ = stop_timer() - setup_start_tick;
+        if (mem_array_ != NULL)
+            std::cout << "Setup time: " << getSetupTime() << " ms" << std::endl;
+
+        if (region_layout_ != NULL) { //Setup overwrites any permutations
+            if (len_ > region_layout_->resident_len)
+                region_layout_->resident_len = len_;
+            region_layout_->slice_permutations.clear();
+        }
+    }
 
     bool success = runCore();
+
+    //Sequential writes overwrite any permutations. Everything else leaves them intact: random writes store back the pointers they read.
+    if (region_layout_ != NULL && pattern_mode_ == SEQUENTIAL && rw_mode_ == WRITE)
+        region_layout_->slice_permutations.clear();
+
     if (success) {
         return true;
     } else {
@@ -121,6 +148,55 @@ bool Benchmark::run() {
     }
 }
 
+bool Benchmark::setupCore() {
+    //Benchmarks that map their own memory have no region here
+    if (mem_array_ == NULL)
+        return true;
+
+    //Each worker thread gets an equal share of the region on the same logical CPU as in runCore()
+    size_t len_per_thread = len_ / num_worker_threads_;
+    std::vector<void*> regions;
+    std::vector<size_t> lens;
+    std::vector<int32_t> cpu_ids;
+    for (uint32_t t = 0; t < num_worker_threads_; t++) {
+        regions.push_back(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_) + t*len_per_thread));
+        lens.push_back(t == num_worker_threads_-1 ? len_ - t*len_per_thread : len_per_thread);
+        cpu_ids.push_back(cpu_id_in_numa_node(cpu_node_, t));
+    }
+
+    return InitWorker::initializeRegions(regions, lens, cpu_ids);
+}
+
+bool Benchmark::buildPermutation(uint32_t slice, size_t slice_len, chunk_size_t chunk_size) {
+    void* start_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_) + slice*slice_len);
+    void* end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_) + (slice+1)*slice_len);
+
+    if (region_layout_ != NULL) {
+        if (region_layout_->slice_len == slice_len && slice < region_layout_->slice_permutations.size() && region_layout_->slice_permutations[slice] == chunk_size) {
+            if (g_verbose)
+                std::cout << "Reusing the random pointer permutation of slice " << slice << "." << std::endl;
+            return true;
+        }
+
+        //Permutations built over differently sized slices cross the new slice boundaries
+        if (region_layout_->slice_len != slice_len) {
+            region_layout_->slice_len = slice_len;
+            region_layout_->slice_permutations.clear();
+        }
+        if (slice >= region_layout_->slice_permutations.size())
+            region_layout_->slice_permutations.resize(slice+1, NUM_CHUNK_SIZES);
+        region_layout_->slice_permutations[slice] = NUM_CHUNK_SIZES;
+    }
+
+    if (!build_random_pointer_permutation(start_address, end_address, chunk_size))
+        return false;
+
+    if (region_layout_ != NULL)
+        region_layout_->slice_permutations[slice] = chunk_size;
+
+    return true;
+}
+
 void Benchmark::printBenchmarkHeader() const {
     //Spit out useful info
     std::cout << std::endl;
@@ -277,13 +353,8 @@ void Benchmark::reportResults() const {
         std::cout << std::endl;
         std::cout << std::endl;
 
-        for (uint32_t i = 0; i < dram_power_readers_.size(); i++) {
-            if (dram_power_readers_[i] != NULL) {
-                std::cout << dram_power_readers_[i]->name() << " Power Statistics..." << std::endl;
-                std::cout << "...Mean Power: " << dram_power_readers_[i]->getMeanPower() * dram_power_readers_[i]->getPowerUnits() << " W" << std::endl;
-                std::cout << "...Peak Power: " << dram_power_readers_[i]->getPeakPower() * dram_power_readers_[i]->getPowerUnits() << " W" << std::endl;
-            }
-        }
+        reportPowerResults();
+        reportPerfCounts();
     }
     else
         std::cerr << "WARNING: Benchmark has not run yet. No reported results." << std::endl;
@@ -367,6 +438,14 @@ std::string Benchmark::getMetricUnits() const {
     return metric_units_;
 }
 
+void Benchmark::setRegionLayout(region_layout_t* region_layout) {
+    region_layout_ = region_layout;
+}
+
+double Benchmark::getSetupTime() const {
+    return static_cast<double>(setup_ticks_) * g_ns_per_tick / 1e6;
+}
+
 double Benchmark::getMeanDRAMPower(uint32_t socket_id) const {
     if (mean_dram_power_socket_.size() > socket_id)
         return mean_dram_power_socket_[socket_id];
@@ -381,6 +460,32 @@ double Benchmark::getPeakDRAMPower(uint32_t socket_id) const {
         return 0;
 }
 
+double Benchmark::getDRAMEnergy(uint32_t socket_id) const {
+    if (dram_energy_socket_.size() > socket_id)
+        return dram_energy_socket_[socket_id];
+    else
+        return 0;
+}
+
+double Benchmark::getDRAMEnergyTime(uint32_t socket_id) const {
+    if (dram_energy_time_socket_.size() > socket_id)
+        return dram_energy_time_socket_[socket_id];
+    else
+        return 0;
+}
+
+double Benchmark::getEnergyEfficiency(uint32_t socket_id) const {
+    return 0;
+}
+
+std::string Benchmark::getEnergyEfficiencyUnits() const {
+    return "";
+}
+
+perf_counts_t Benchmark::getPerfCounts() const {
+    return perf_counts_;
+}
+
 size_t Benchmark::getLen() const {
     return len_;
 }
@@ -462,11 +567,15 @@ void Benchmark::computeMetrics() {
 bool Benchmark::startPowerThreads() {
     bool success = true;
 
+    //Keep the power threads off the worker threads' CPUs, as short sampling periods wake them often
+    int32_t power_cpu = powerThreadCpu();
+
     //Create all power threads
     for (uint32_t i = 0; i < dram_power_readers_.size(); i++) {
         Thread* mythread = NULL;
         if (dram_power_readers_[i] != NULL)  {
             dram_power_readers_[i]->clearAndReset(); //clear the state of the reader
+            dram_power_readers_[i]->setCpuAffinity(power_cpu);
             mythread = new Thread(dram_power_readers_[i]);
             if (mythread == NULL) {
                 std::cerr << "WARNING: Failed to allocate a DRAM power measurement thread." << std::endl;
@@ -507,15 +616,98 @@ bool Benchmark::stopPowerThreads() {
                     std::cerr << "WARNING: Failed to force stop a power measurement thread. Its behavior may be unpredictable." << std::endl;
             }
         }
+    }
 
-        //Collect power data
-        for (uint32_t i = 0; i < dram_power_readers_.size(); i++) {
-            if (dram_power_readers_[i] != NULL) {
-                mean_dram_power_socket_.push_back(dram_power_readers_[i]->getMeanPower() * dram_power_readers_[i]->getPowerUnits());
-                peak_dram_power_socket_.push_back(dram_power_readers_[i]->getPeakPower() * dram_power_readers_[i]->getPowerUnits());
-            }
+    //Collect power data
+    for (uint32_t i = 0; i < dram_power_readers_.size(); i++) {
+        if (dram_power_readers_[i] != NULL) {
+            mean_dram_power_socket_.push_back(dram_power_readers_[i]->getMeanPower() * dram_power_readers_[i]->getPowerUnits());
+            peak_dram_power_socket_.push_back(dram_power_readers_[i]->getPeakPower() * dram_power_readers_[i]->getPowerUnits());
+            dram_energy_socket_.push_back(dram_power_readers_[i]->getEnergy());
+            dram_energy_time_socket_.push_back(dram_power_readers_[i]->getMeasuredTime());
+        } else { //Keep the results aligned with the readers
+            mean_dram_power_socket_.push_back(0);
+            peak_dram_power_socket_.push_back(0);
+            dram_energy_socket_.push_back(0);
+            dram_energy_time_socket_.push_back(0);
         }
     }
 
     return success;
 }
+
+std::vector<int32_t> Benchmark::workerCpus() const {
+    std::vector<int32_t> cpu_ids;
+    for (uint32_t t = 0; t < num_worker_threads_; t++)
+        cpu_ids.push_back(cpu_id_in_numa_node(cpu_node_, t));
+    return cpu_ids;
+}
+
+int32_t Benchmark::powerThreadCpu() const {
+    std::vector<int32_t> cpu_ids = workerCpus();
+    std::vector<bool> worker_cpus(g_num_logical_cpus, false);
+    for (uint32_t t = 0; t < cpu_ids.size(); t++) {
+        if (cpu_ids[t] >= 0 && static_cast<uint32_t>(cpu_ids[t]) < g_num_logical_cpus)
+            worker_cpus[cpu_ids[t]] = true;
+    }
+
+    for (int32_t cpu_id = static_cast<int32_t>(g_num_logical_cpus) - 1; cpu_id >= 0; cpu_id--) {
+        if (!worker_cpus[cpu_id])
+            return cpu_id;
+    }
+
+    return -1;
+}
+
+void Benchmark::reportPowerResults() const {
+    std::string efficiency_units = getEnergyEfficiencyUnits();
+    for (uint32_t i = 0; i < dram_power_readers_.size(); i++) {
+        if (dram_power_readers_[i] != NULL) {
+            std::cout << dram_power_readers_[i]->name() << " Power Statistics..." << std::endl;
+            std::cout << "...Mean Power: " << getMeanDRAMPower(i) << " W" << std::endl;
+            std::cout << "...Peak Power: " << getPeakDRAMPower(i) << " W" << std::endl;
+            std::cout << "...Energy: " << getDRAMEnergy(i) << " J over " << getDRAMEnergyTime(i) << " s" << std::endl;
+            if (efficiency_units != "")
+                std::cout << "...Energy Efficiency: " << getEnergyEfficiency(i) << " " << efficiency_units << std::endl;
+        }
+    }
+}
+
+void Benchmark::addPerfCounts(const perf_counts_t& counts) {
+    for (uint32_t c = 0; c < NUM_PERF_COUNTERS; c++) {
+        perf_counts_.counts[c] += counts.counts[c];
+        perf_counts_.valid[c] = (perf_counts_added_ == 0 || perf_counts_.valid[c]) && counts.valid[c]; //A total missing some threads would be misleading
+    }
+    perf_counts_added_++;
+}
+
+void Benchmark::reportPerfCounts() const {
+    if (!g_perf_counters || perf_counts_added_ == 0)
+        return;
+
+    //Every iteration adds the counters of each of its worker threads once
+    std::cout << "Hardware Performance Counters (timed passes only, summed over " << perf_counts_added_ / iterations_ << " worker threads x " << iterations_ << " iterations)..." << std::endl;
+    for (uint32_t c = 0; c < NUM_PERF_COUNTERS; c++) {
+        std::cout << "..." << PerfCounters::counterName(static_cast<perf_counter_t>(c)) << ": ";
+        if (perf_counts_.valid[c])
+            std::cout << static_cast<uint64_t>(perf_counts_.counts[c]) << std::endl;
+        else
+            std::cout << "N/A" << std::endl;
+    }
+
+    const double* counts = perf_counts_.counts;
+    const bool* valid = perf_counts_.valid;
+    if (valid[PERF_CYCLES] && valid[PERF_INSTRUCTIONS] && counts[PERF_CYCLES] > 0)
+        std::cout << "...IPC: " << counts[PERF_INSTRUCTIONS] / counts[PERF_CYCLES] << std::endl;
+    if (valid[PERF_LLC_LOADS] && valid[PERF_LLC_MISSES] && counts[PERF_LLC_LOADS] > 0)
+        std::cout << "...LLC load miss ratio: " << 100 * counts[PERF_LLC_MISSES] / counts[PERF_LLC_LOADS] << "%" << std::endl;
+    if (valid[PERF_INSTRUCTIONS] && counts[PERF_INSTRUCTIONS] > 0) {
+        //Misses per thousand instructions, which compare across hosts even when the benchmark ran a different number of passes
+        if (valid[PERF_L1D_REPLACEMENTS])
+            std::cout << "...L1D replacements per 1000 instructions: " << 1000 * counts[PERF_L1D_REPLACEMENTS] / counts[PERF_INSTRUCTIONS] << std::endl;
+        if (valid[PERF_LLC_MISSES])
+            std::cout << "...LLC load misses per 1000 instructions: " << 1000 * counts[PERF_LLC_MISSES] / counts[PERF_INSTRUCTIONS] << std::endl;
+        if (valid[PERF_DTLB_MISSES])
+            std::cout << "...dTLB load misses per 1000 instructions: " << 1000 * counts[PERF_DTLB_MISSES] / counts[PERF_INSTRUCTIONS] << std::endl;
+    }
+}
@@ -33,11 +33,27 @@
 #include <BenchmarkManager.h>
 #include <common.h>
 #include <Configurator.h>
+#include <CoreToCoreLatencyBenchmark.h>
+#include <CoherenceLatencyBenchmark.h>
+#include <AtomicBenchmark.h>
+#include <GatherBenchmark.h>
+#include <WorkloadMixBenchmark.h>
+#include <PageFaultBenchmark.h>
+#include <PageMigrationBenchmark.h>
+#include <TlbReachBenchmark.h>
+#include <InitWorker.h>
+#include <PageFaultWorker.h>
+#include <PerfCounters.h>
+#include <benchmark_kernels.h>
 
 #ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
 #include <DelayInjectedLoadedLatencyBenchmark.h>
 #endif
 
+#ifdef EXT_MEMCPY_BENCHMARK
+#include <MemcpyBenchmark.h>
+#endif
+
 #ifdef EXT_STREAM_BENCHMARK
 #include <StreamBenchmark.h> //TODO: implement this class
 #endif
@@ -49,12 +65,20 @@
 #endif
 #endif
 
+#ifdef __gnu_linux__
+#include <LinuxRaplPowerReader.h>
+#endif
+
 //Libraries
 #include <cstdint>
 #include <stdlib.h>
 #include <iostream>
 #include <sstream>
 #include <assert.h>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -63,11 +87,20 @@
 #ifdef __gnu_linux__
 #ifdef HAS_NUMA
 #include <numa.h>
+#include <numaif.h> //for mbind() and move_pages()
+#include <sys/mman.h> //for mapping memory with a placement policy
+#include <errno.h>
+#include <string.h> //for strerror()
+#include <fcntl.h> //for creating backing files
+#include <unistd.h>
+#ifndef MFD_HUGE_SHIFT //Older C libraries lack the page size selector flags for MFD_HUGETLB
+#define MFD_HUGE_SHIFT 26
+#endif
 #endif
 #ifdef HAS_LARGE_PAGES
-extern "C" {
-#include <hugetlbfs.h> //for allocating and freeing huge pages
-}
+#ifndef MAP_HUGE_SHIFT //Older C libraries lack the page size selector flags for MAP_HUGETLB
+#define MAP_HUGE_SHIFT 26
+#endif
 #endif
 #endif
 
@@ -84,6 +117,17 @@ BenchmarkManager::BenchmarkManager(
         orig_malloc_addr_(NULL),
 #endif
         mem_array_lens_(),
+        region_layouts_(),
+        placement_checked_(),
+#if defined(__gnu_linux__) && defined(HAS_LARGE_PAGES)
+        large_page_maps_(),
+        large_page_map_lens_(),
+#endif
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+        backed_maps_(),
+        backed_map_lens_(),
+        backed_fds_(),
+#endif
         tp_benchmarks_(),
         lat_benchmarks_(),
         dram_power_readers_(),
@@ -97,20 +141,35 @@ BenchmarkManager::BenchmarkManager(
 #ifdef _WIN32
 #ifndef ARCH_ARM //lacking library support for Windows on ARM
         //Put the thread on the last logical CPU in each NUMA node.
-        dram_power_readers_.push_back(new WindowsDRAMPowerReader(cpu_id_in_numa_node(i,g_num_logical_cpus / g_num_numa_nodes - 1), POWER_SAMPLING_PERIOD_MS, 1, power_obj_name, cpu_id_in_numa_node(i,g_num_logical_cpus / g_num_numa_nodes - 1)));
+        dram_power_readers_.push_back(new WindowsDRAMPowerReader(cpu_id_in_numa_node(i,g_num_logical_cpus / g_num_numa_nodes - 1), config_.getPowerSamplingPeriod(), 1, power_obj_name, cpu_id_in_numa_node(i,g_num_logical_cpus / g_num_numa_nodes - 1)));
 #else
         dram_power_readers_.push_back(NULL);
 #endif
 #endif
 #ifdef __gnu_linux__
-        //TODO: Implement derived PowerReaders for Linux systems.
-        dram_power_readers_.push_back(NULL);
+        //Sample the package and DRAM RAPL domains through powercap. Domains that do not exist or cannot be read get no readers, and thus no results columns.
+        std::string rapl_domains[2] = { "package", "dram" };
+        std::string rapl_domain_names[2] = { "Package", "DRAM" };
+        for (uint32_t d = 0; d < 2; d++) {
+            std::string zone = LinuxRaplPowerReader::findZone(config_.getRaplRoot(), i, rapl_domains[d]);
+            if (zone.empty())
+                continue;
+
+            std::string rapl_obj_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Socket " << i << " " << rapl_domain_names[d]))->str();
+            LinuxRaplPowerReader* reader = new LinuxRaplPowerReader(zone, config_.getPowerSamplingPeriod(), rapl_obj_name, -1);
+            if (reader->isValid())
+                dram_power_readers_.push_back(reader);
+            else
+                delete reader;
+        }
 #endif
     }
 
     //Set up NUMA stuff
     cpu_numa_node_affinities_ = config_.getCpuNumaNodeAffinities();
     memory_numa_node_affinities_ = config_.getMemoryNumaNodeAffinities();
+    if (config_.getPlacementPolicy() == PLACEMENT_INTERLEAVE) //A single region is interleaved across all selected memory nodes. It lives in the slot of the first one.
+        memory_numa_node_affinities_.resize(1);
 
     //Build working memory regions
     setupWorkingSets(config_.getWorkingSetSizePerThread());
@@ -129,11 +188,22 @@ BenchmarkManager::BenchmarkManager(
             if (dram_power_readers_[i] != NULL) {
                 results_file_ << dram_power_readers_[i]->name() << " Mean Power (W),";
                 results_file_ << dram_power_readers_[i]->name() << " Peak Power (W),";
+                results_file_ << dram_power_readers_[i]->name() << " Energy (J),";
+                results_file_ << dram_power_readers_[i]->name() << " Energy Efficiency,";
             } else {
                 results_file_ << "NAME? Mean Power (W),";
                 results_file_ << "NAME? Peak Power (W),";
+                results_file_ << "NAME? Energy (J),";
+                results_file_ << "NAME? Energy Efficiency,";
             }
         }
+        if (!dram_power_readers_.empty())
+            results_file_ << "Energy Efficiency Units,";
+        if (config_.perfCountersSelected()) {
+            for (uint32_t c = 0; c < NUM_PERF_COUNTERS; c++)
+                results_file_ << PerfCounters::counterName(static_cast<perf_counter_t>(c)) << ",";
+        }
+        results_file_ << "Requested Load Throughput (MB/s),";
         results_file_ << "Extension Info,";
         results_file_ << "Notes,";
         results_file_ << std::endl;
@@ -147,6 +217,9 @@ BenchmarkManager::~BenchmarkManager() {
     //Free latency benchmarks
     for (uint32_t i = 0; i < lat_benchmarks_.size(); i++)
         delete lat_benchmarks_[i];
+    //Free power readers
+    for (uint32_t i = 0; i < dram_power_readers_.size(); i++)
+        delete dram_power_readers_[i];
     //Free memory arrays
     for (uint32_t i = 0; i < mem_arrays_.size(); i++)
         if (mem_arrays_[i] != nullptr) {
@@ -154,9 +227,15 @@ BenchmarkManager::~BenchmarkManager() {
             VirtualFreeEx(GetCurrentProcess(), mem_arrays_[i], 0, MEM_RELEASE);
 #endif
 #ifdef __gnu_linux__
+#ifdef HAS_NUMA
+            if (config_.getWorkingSetBacking() != BACKING_ANONYMOUS) {
+                munmap(backed_maps_[i], backed_map_lens_[i]);
+                close(backed_fds_[i]); //A temporary file goes away with its last reference
+            } else
+#endif
 #ifdef HAS_LARGE_PAGES
             if (config_.useLargePages())
-                free_huge_pages(mem_arrays_[i]);
+                munmap(large_page_maps_[i], large_page_map_lens_[i]);
             else
 #endif
 #ifdef HAS_NUMA
@@ -192,230 +271,1936 @@ bool BenchmarkManager::runThroughputBenchmarks() {
 
     for (uint32_t i = 0; i < tp_benchmarks_.size(); i++) {
         tp_benchmarks_[i]->run();
+        checkPlacementOfResidentRegions();
         tp_benchmarks_[i]->reportResults(); //to console
 
         //Write to results file if necessary
-        if (config_.useOutputFile()) {
-            results_file_ << tp_benchmarks_[i]->getName() << ",";
-            results_file_ << tp_benchmarks_[i]->getIterations() << ",";
-            results_file_ << static_cast<size_t>(tp_benchmarks_[i]->getLen() / tp_benchmarks_[i]->getNumThreads() / KB) << ",";
-            results_file_ << tp_benchmarks_[i]->getNumThreads() << ",";
-            results_file_ << tp_benchmarks_[i]->getNumThreads() << ",";
-            results_file_ << tp_benchmarks_[i]->getMemNode() << ",";
-            results_file_ << tp_benchmarks_[i]->getCPUNode() << ",";
-            pattern_mode_t pattern = tp_benchmarks_[i]->getPatternMode();
-            switch (pattern) {
-                case SEQUENTIAL:
-                    results_file_ << "SEQUENTIAL" << ",";
-                    break;
-                case RANDOM:
-                    results_file_ << "RANDOM" << ",";
-                    break;
-                default:
-                    results_file_ << "UNKNOWN" << ",";
-                    break;
-            }
+        if (config_.useOutputFile())
+            writeThroughputResults(tp_benchmarks_[i], "N/A", "");
+    }
 
-            rw_mode_t rw_mode = tp_benchmarks_[i]->getRWMode();
-            switch (rw_mode) {
-                case READ:
-                    results_file_ << "READ" << ",";
-                    break;
-                case WRITE:
-                    results_file_ << "WRITE" << ",";
-                    break;
-                default:
-                    results_file_ << "UNKNOWN" << ",";
-                    break;
-            }
+    if (g_verbose)
+        std::cout << std::endl << "Done running throughput benchmarks." << std::endl;
 
-            chunk_size_t chunk_size = tp_benchmarks_[i]->getChunkSize();
-            switch (chunk_size) {
-                case CHUNK_32b:
-                    results_file_ << "32" << ",";
-                    break;
+    return true;
+}
+
+bool BenchmarkManager::runLatencyBenchmarks() {
+    if (!built_benchmarks_) {
+        if (!buildBenchmarks()) {
+            std::cerr << "ERROR: Failed to build benchmarks." << std::endl;
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < lat_benchmarks_.size(); i++) {
+        lat_benchmarks_[i]->run();
+        checkPlacementOfResidentRegions();
+        lat_benchmarks_[i]->reportResults(); //to console
+
+        //Write to results file if necessary
+        if (config_.useOutputFile())
+            writeLatencyResults(lat_benchmarks_[i], "N/A", "");
+    }
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running latency benchmarks." << std::endl;
+
+    return true;
+}
+
+bool BenchmarkManager::runLatencyCurve() {
+    forgetPermutations();
+    uint32_t num_worker_threads = config_.getNumWorkerThreads();
+    uint32_t num_load_threads = num_worker_threads - 1;
+    curve_knob_t knob = config_.getLatencyCurveKnob();
+    size_t working_set_size = config_.getWorkingSetSizePerThread();
+
+    if (num_worker_threads < 2) {
+        std::cerr << "ERROR: The loaded latency curve needs at least 2 worker threads." << std::endl;
+        return false;
+    }
+
+    //Load traffic for the curve uses the first access pattern, read/write mode, chunk size and stride that the user selected.
+    pattern_mode_t pattern = config_.useSequentialAccessPattern() ? SEQUENTIAL : RANDOM;
+    rw_mode_t rw = config_.useReads() ? READ : WRITE;
+
+    std::vector<chunk_size_t> chunks;
+    if (config_.useChunk32b() && pattern == SEQUENTIAL) //Random load workers cannot use 32-bit chunks
+        chunks.push_back(CHUNK_32b);
 #ifdef HAS_WORD_64
-                case CHUNK_64b:
-                    results_file_ << "64" << ",";
-                    break;
+    if (config_.useChunk64b())
+        chunks.push_back(CHUNK_64b);
 #endif
 #ifdef HAS_WORD_128
-                case CHUNK_128b:
-                    results_file_ << "128" << ",";
-                    break;
+    if (config_.useChunk128b())
+        chunks.push_back(CHUNK_128b);
 #endif
 #ifdef HAS_WORD_256
-                case CHUNK_256b:
-                    results_file_ << "256" << ",";
-                    break;
+    if (config_.useChunk256b())
+        chunks.push_back(CHUNK_256b);
 #endif
 #ifdef HAS_WORD_512
-                case CHUNK_512b:
-                    results_file_ << "512" << ",";
+    if (config_.useChunk512b())
+        chunks.push_back(CHUNK_512b);
+#endif
+    if (chunks.empty()) {
+        std::cerr << "ERROR: No chunk size selected for the loaded latency curve is compatible with the selected access pattern." << std::endl;
+        return false;
+    }
+    chunk_size_t chunk = chunks[0];
+
+    int32_t stride = 0;
+    if (pattern == SEQUENTIAL) {
+        if (config_.useStrideP1()) stride = 1;
+        else if (config_.useStrideN1()) stride = -1;
+        else if (config_.useStrideP2()) stride = 2;
+        else if (config_.useStrideN2()) stride = -2;
+        else if (config_.useStrideP4()) stride = 4;
+        else if (config_.useStrideN4()) stride = -4;
+        else if (config_.useStrideP8()) stride = 8;
+        else if (config_.useStrideN8()) stride = -8;
+        else if (config_.useStrideP16()) stride = 16;
+        else if (config_.useStrideN16()) stride = -16;
+    }
+
+#ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
+    if (knob == CURVE_KNOB_DELAY) { //Delay-injected kernels only exist for forward sequential reads
+        pattern = SEQUENTIAL;
+        rw = READ;
+        stride = 1;
+#ifdef HAS_WORD_256
+        if (chunk != CHUNK_256b)
+#endif
+            chunk = CHUNK_64b;
+    }
+#endif
+
+    for (auto mem_node_it = memory_numa_node_affinities_.cbegin(); mem_node_it != memory_numa_node_affinities_.cend(); mem_node_it++) { //iterate each memory NUMA node
+        uint32_t mem_node = *mem_node_it;
+        void* mem_array = mem_arrays_[mem_node];
+
+        for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) { //iterate each cpu NUMA node
+            uint32_t cpu_node = *cpu_node_it;
+            if (!usesNodePair(mem_node, cpu_node))
+                continue;
+            std::vector<LatencyBenchmark*> curve; //One benchmark per load level, ordered from lightest to heaviest load
+            std::vector<std::string> settings; //Knob setting for each load level
+            double peak = 0; //Peak aggregate load throughput in MB/s
+            bool calibrated = false;
+            std::string benchmark_name;
+
+            //Level 0 is always unloaded latency. Only the first per-thread region is needed for it.
+            benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "C (Latency Curve)"))->str();
+            curve.push_back(new LatencyBenchmark(mem_array,
+                                                 working_set_size,
+                                                 config_.getIterationsPerTest(),
+                                                 1,
+                                                 mem_node,
+                                                 cpu_node,
+                                                 pattern,
+                                                 rw,
+                                                 chunk,
+                                                 stride,
+                                                 config_.getMlp(),
+                                                 0,
+                                                 dram_power_readers_,
+                                                 benchmark_name));
+            settings.push_back("unloaded");
+
+            switch (knob) {
+                case CURVE_KNOB_RATE: {
+                    //Calibrate peak bandwidth of the load threads alone on the memory they will use when loading the latency thread
+                    benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "T (Latency Curve Calibration)"))->str();
+                    ThroughputBenchmark calibration(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + working_set_size),
+                                                    num_load_threads * working_set_size,
+                                                    config_.getIterationsPerTest(),
+                                                    num_load_threads,
+                                                    mem_node,
+                                                    cpu_node,
+                                                    pattern,
+                                                    rw,
+                                                    chunk,
+                                                    stride,
+                                                    config_.getMlp(),
+                                                    dram_power_readers_,
+                                                    benchmark_name);
+                    if (!calibration.run()) {
+                        std::cerr << "ERROR: Failed to calibrate peak load throughput for the loaded latency curve." << std::endl;
+                        return false;
+                    }
+                    calibration.reportResults(); //to console
+                    peak = calibration.getMeanMetric();
+                    calibrated = true;
+
+                    uint32_t levels = config_.getLatencyCurveLevels();
+                    for (uint32_t l = 1; l <= levels; l++) {
+                        double rate = 0; //The last level is not rate-limited at all
+                        if (l < levels)
+                            rate = (peak / num_load_threads) * l / levels;
+
+                        benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "C (Latency Curve)"))->str();
+                        curve.push_back(new LatencyBenchmark(mem_array,
+                                                             num_worker_threads * working_set_size,
+                                                             config_.getIterationsPerTest(),
+                                                             num_worker_threads,
+                                                             mem_node,
+                                                             cpu_node,
+                                                             pattern,
+                                                             rw,
+                                                             chunk,
+                                                             stride,
+                                                             config_.getMlp(),
+                                                             rate,
+                                                             dram_power_readers_,
+                                                             benchmark_name));
+                        if (l < levels)
+                            settings.push_back(static_cast<std::ostringstream*>(&(std::ostringstream() << "rate " << std::setprecision(3) << 100.0 * l / levels << "% of peak"))->str());
+                        else
+                            settings.push_back("rate unlimited");
+                    }
+                    break;
+                }
+
+                case CURVE_KNOB_THREADS:
+                    for (uint32_t t = 1; t <= num_load_threads; t++) {
+                        benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "C (Latency Curve)"))->str();
+                        curve.push_back(new LatencyBenchmark(mem_array,
+                                                             (t+1) * working_set_size,
+                                                             config_.getIterationsPerTest(),
+                                                             t+1,
+                                                             mem_node,
+                                                             cpu_node,
+                                                             pattern,
+                                                             rw,
+                                                             chunk,
+                                                             stride,
+                                                             config_.getMlp(),
+                                                             0,
+                                                             dram_power_readers_,
+                                                             benchmark_name));
+                        settings.push_back(static_cast<std::ostringstream*>(&(std::ostringstream() << t << " load threads"))->str());
+                    }
+                    break;
+
+#ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
+                case CURVE_KNOB_DELAY:
+                    for (int32_t d = 1024; d >= 0; d = (d > 1) ? d/2 : d-1) { //1024, 512, ... 2, 1, 0 nops: lightest to heaviest load
+                        benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "C (Latency Curve)"))->str();
+                        curve.push_back(new DelayInjectedLoadedLatencyBenchmark(mem_array,
+                                                                                num_worker_threads * working_set_size,
+                                                                                config_.getIterationsPerTest(),
+                                                                                num_worker_threads,
+                                                                                mem_node,
+                                                                                cpu_node,
+                                                                                chunk,
+                                                                                config_.getMlp(),
+                                                                                dram_power_readers_,
+                                                                                benchmark_name,
+                                                                                static_cast<uint32_t>(d)));
+                        settings.push_back(static_cast<std::ostringstream*>(&(std::ostringstream() << "delay " << d << " nops"))->str());
+                    }
                     break;
 #endif
+
                 default:
-                    results_file_ << "UNKNOWN" << ",";
-                    break;
+                    std::cerr << "ERROR: Invalid loaded latency curve knob." << std::endl;
+                    for (uint32_t i = 0; i < curve.size(); i++)
+                        delete curve[i];
+                    return false;
             }
 
-            results_file_ << tp_benchmarks_[i]->getStrideSize() << ",";
-            results_file_ << tp_benchmarks_[i]->getMeanMetric() << ",";
-            results_file_ << tp_benchmarks_[i]->getMinMetric() << ",";
-            results_file_ << tp_benchmarks_[i]->get25PercentileMetric() << ",";
-            results_file_ << tp_benchmarks_[i]->getMedianMetric() << ",";
-            results_file_ << tp_benchmarks_[i]->get75PercentileMetric() << ",";
-            results_file_ << tp_benchmarks_[i]->get95PercentileMetric() << ",";
-            results_file_ << tp_benchmarks_[i]->get99PercentileMetric() << ",";
-            results_file_ << tp_benchmarks_[i]->getMaxMetric() << ",";
-            results_file_ << tp_benchmarks_[i]->getModeMetric() << ",";
-            results_file_ << tp_benchmarks_[i]->getMetricUnits() << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            for (uint32_t j = 0; j < g_num_physical_packages; j++) {
-                results_file_ << tp_benchmarks_[i]->getMeanDRAMPower(j) << ",";
-                results_file_ << tp_benchmarks_[i]->getPeakDRAMPower(j) << ",";
+            //Run the curve
+            std::vector<double> load;
+            std::vector<double> latency;
+            for (uint32_t i = 0; i < curve.size(); i++) {
+                if (!curve[i]->run())
+                    std::cerr << "WARNING: Loaded latency curve level " << i << " failed to run." << std::endl;
+                curve[i]->reportResults(); //to console
+                load.push_back(i == 0 ? 0 : curve[i]->getMeanLoadMetric());
+                latency.push_back(curve[i]->getMeanMetric());
             }
-            results_file_ << "N/A" << ",";
-            results_file_ << "" << ",";
-            results_file_ << std::endl;
+
+            //Without a calibration run, the heaviest load observed stands in for peak bandwidth
+            if (!calibrated) {
+                for (uint32_t i = 0; i < load.size(); i++) {
+                    if (load[i] > peak)
+                        peak = load[i];
+                }
+            }
+
+            uint32_t knee = findLatencyCurveKnee(load, latency);
+
+            //Report the whole curve
+            std::cout << std::endl;
+            std::cout << "*** LOADED LATENCY CURVE: CPU NUMA node " << cpu_node << ", memory NUMA node " << mem_node << " ***" << std::endl;
+            std::cout << std::endl;
+            std::cout << "Peak load throughput: " << peak << " MB/s (" << (calibrated ? "calibrated" : "highest observed") << ")" << std::endl;
+            std::cout << std::endl;
+            std::printf("%-7s %-26s %16s %12s %16s\n", "Level", "Knob setting", "Load (MB/s)", "% of peak", "Latency (ns)");
+            for (uint32_t i = 0; i < curve.size(); i++) {
+                std::printf("%-7u %-26s %16.3f %12.1f %16.3f", i, settings[i].c_str(), load[i], (peak > 0) ? 100 * load[i] / peak : 0, latency[i]);
+                if (i == knee)
+                    std::cout << "  <-- knee";
+                std::cout << std::endl;
+            }
+            std::cout << std::endl;
+            std::cout << "Knee: level " << knee << " (" << settings[knee] << ") at " << load[knee] << " MB/s";
+            if (peak > 0)
+                std::cout << " (" << 100 * load[knee] / peak << "% of peak)";
+            std::cout << " with " << latency[knee] << " " << curve[knee]->getMetricUnits() << std::endl;
+            std::cout << std::endl;
+
+            //Write to results file if necessary
+            if (config_.useOutputFile()) {
+                for (uint32_t i = 0; i < curve.size(); i++) {
+                    std::string notes = static_cast<std::ostringstream*>(&(std::ostringstream() << "latency curve level " << i << " of " << curve.size()-1 << "; peak " << peak << " MB/s" << (i == knee ? "; knee" : "")))->str();
+                    writeLatencyResults(curve[i], settings[i], notes);
+                }
+            }
+
+            for (uint32_t i = 0; i < curve.size(); i++)
+                delete curve[i];
         }
     }
 
     if (g_verbose)
-        std::cout << std::endl << "Done running throughput benchmarks." << std::endl;
+        std::cout << std::endl << "Done running loaded latency curve." << std::endl;
+
+    return true;
+}
+
+bool BenchmarkManager::runCoreToCoreLatencyBenchmark() {
+    forgetPermutations();
+    uint32_t stride = config_.getCoreToCoreCpuStride();
+
+    //Sample logical CPUs from each selected CPU NUMA node
+    std::vector<int32_t> cpus;
+    std::vector<uint32_t> cpu_nodes;
+    for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) { //iterate each cpu NUMA node
+        uint32_t cpu_node = *cpu_node_it;
+        for (uint32_t k = 0; ; k += stride) {
+            int32_t cpu = cpu_id_in_numa_node(cpu_node, k);
+            if (cpu < 0)
+                break;
+            cpus.push_back(cpu);
+            cpu_nodes.push_back(cpu_node);
+        }
+    }
+
+    if (cpus.size() < 2) {
+        std::cerr << "ERROR: The core-to-core latency benchmark needs at least 2 logical CPUs, but only " << cpus.size() << " were selected. Try a smaller CPU sampling stride or more CPU NUMA nodes." << std::endl;
+        return false;
+    }
+
+    for (auto mem_node_it = memory_numa_node_affinities_.cbegin(); mem_node_it != memory_numa_node_affinities_.cend(); mem_node_it++) { //iterate each memory NUMA node
+        uint32_t mem_node = *mem_node_it;
+        std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "X (Core-to-Core Latency)"))->str();
+
+        //Only the first page of the region is needed to hold the cache line
+        CoreToCoreLatencyBenchmark benchmark(mem_arrays_[mem_node],
+                                             g_page_size,
+                                             config_.getIterationsPerTest(),
+                                             mem_node,
+                                             cpus,
+                                             cpu_nodes,
+                                             dram_power_readers_,
+                                             benchmark_name);
+
+        if (!benchmark.run()) {
+            std::cerr << "ERROR: Core-to-core latency benchmark failed on memory NUMA node " << mem_node << "." << std::endl;
+            return false;
+        }
+        benchmark.reportResults(); //to console
+
+        //Write to results file if necessary
+        if (config_.useOutputFile())
+            writeCoreToCoreResults(&benchmark);
+    }
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running core-to-core latency benchmarks." << std::endl;
+
+    return true;
+}
+
+bool BenchmarkManager::runCoherenceLatencyBenchmarks() {
+    forgetPermutations();
+    std::list<coherence_state_t> states = config_.getCoherenceStates();
+
+    for (auto mem_node_it = memory_numa_node_affinities_.cbegin(); mem_node_it != memory_numa_node_affinities_.cend(); mem_node_it++) { //iterate each memory NUMA node
+        uint32_t mem_node = *mem_node_it;
+        if (mem_array_lens_[mem_node] < CoherenceLatencyBenchmark::getRequiredLen()) {
+            std::cerr << "ERROR: The coherence-state-aware latency benchmark needs at least " << CoherenceLatencyBenchmark::getRequiredLen() / KB << " KB of memory per NUMA node. Try a larger working set size." << std::endl;
+            return false;
+        }
+
+        for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) { //iterate each latency thread CPU NUMA node
+            uint32_t cpu_node = *cpu_node_it;
+            if (!usesNodePair(mem_node, cpu_node))
+                continue;
+            for (auto preparer_node_it = cpu_numa_node_affinities_.cbegin(); preparer_node_it != cpu_numa_node_affinities_.cend(); preparer_node_it++) { //iterate each preparer CPU NUMA node
+                uint32_t preparer_cpu_node = *preparer_node_it;
+                for (auto state_it = states.cbegin(); state_it != states.cend(); state_it++) { //iterate each source coherence state
+                    std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "H (Coherence Latency)"))->str();
+                    CoherenceLatencyBenchmark benchmark(mem_arrays_[mem_node],
+                                                        CoherenceLatencyBenchmark::getRequiredLen(),
+                                                        config_.getIterationsPerTest(),
+                                                        mem_node,
+                                                        cpu_node,
+                                                        preparer_cpu_node,
+                                                        *state_it,
+                                                        dram_power_readers_,
+                                                        benchmark_name);
+
+                    if (!benchmark.run()) {
+                        std::cerr << "WARNING: Skipping coherence state " << CoherenceLatencyBenchmark::coherenceStateName(*state_it) << " with preparers on CPU NUMA node " << preparer_cpu_node << "." << std::endl;
+                        continue;
+                    }
+                    benchmark.reportResults(); //to console
+
+                    //Write to results file if necessary
+                    if (config_.useOutputFile())
+                        writeCoherenceLatencyResults(&benchmark);
+                }
+            }
+        }
+    }
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running coherence-state-aware latency benchmarks." << std::endl;
+
+    return true;
+}
+
+bool BenchmarkManager::runAtomicBenchmarks() {
+    forgetPermutations();
+    std::list<atomic_op_t> ops = config_.getAtomicOps();
+    uint32_t max_lines = config_.getAtomicMaxLines();
+    uint32_t max_threads = config_.getNumWorkerThreads();
+
+    //Step the number of lines and threads in powers of two, always ending at the maximum
+    std::vector<uint32_t> line_counts;
+    for (uint32_t l = 1; l < max_lines; l *= 2)
+        line_counts.push_back(l);
+    line_counts.push_back(max_lines);
+
+    std::vector<uint32_t> thread_counts;
+    for (uint32_t t = 1; t < max_threads; t *= 2)
+        thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+
+    //Contender placements: all threads on each selected CPU NUMA node, then, with several nodes, threads round-robin over all of them so that sockets contend with each other
+    std::vector<std::vector<uint32_t> > placements;
+    for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++)
+        placements.push_back(std::vector<uint32_t>(1, *cpu_node_it));
+    if (cpu_numa_node_affinities_.size() > 1)
+        placements.push_back(std::vector<uint32_t>(cpu_numa_node_affinities_.cbegin(), cpu_numa_node_affinities_.cend()));
+
+    for (auto mem_node_it = memory_numa_node_affinities_.cbegin(); mem_node_it != memory_numa_node_affinities_.cend(); mem_node_it++) { //iterate each memory NUMA node
+        uint32_t mem_node = *mem_node_it;
+        if (mem_array_lens_[mem_node] < static_cast<size_t>(max_lines) * CACHE_LINE_SIZE) {
+            std::cerr << "ERROR: " << max_lines << " shared cache lines do not fit in the memory allocated on NUMA node " << mem_node << ". Try a larger working set size." << std::endl;
+            return false;
+        }
+
+        for (uint32_t p = 0; p < placements.size(); p++) { //iterate each contender placement
+            bool spread = (placements[p].size() > 1);
+            uint32_t cpu_node = placements[p].front();
+            if (!spread && !usesNodePair(mem_node, cpu_node))
+                continue;
+            for (auto op_it = ops.cbegin(); op_it != ops.cend(); op_it++) { //iterate each atomic operation
+                for (uint32_t l = 0; l < line_counts.size(); l++) { //iterate each number of shared lines
+                    for (uint32_t t = 0; t < thread_counts.size(); t++) { //iterate each number of contending threads
+                        if (spread && thread_counts[t] < 2) //A single thread cannot contend across nodes
+                            continue;
+                        std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "A (Atomics)"))->str();
+                        AtomicBenchmark benchmark(mem_arrays_[mem_node],
+                                                  line_counts[l],
+                                                  config_.getIterationsPerTest(),
+                                                  thread_counts[t],
+                                                  mem_node,
+                                                  cpu_node,
+                                                  spread ? placements[p] : std::vector<uint32_t>(),
+                                                  *op_it,
+                                                  dram_power_readers_,
+                                                  benchmark_name);
+
+                        if (!benchmark.run()) {
+                            std::cerr << "ERROR: Atomic operation benchmark failed!" << std::endl;
+                            return false;
+                        }
+                        benchmark.reportResults(); //to console
+
+                        //Write to results file if necessary
+                        if (config_.useOutputFile())
+                            writeAtomicResults(&benchmark);
+                    }
+                }
+            }
+        }
+    }
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running atomic operation benchmarks." << std::endl;
+
+    return true;
+}
+
+bool BenchmarkManager::runGatherBenchmarks() {
+    forgetPermutations();
+    size_t max_table_size = config_.getWorkingSetSizePerThread();
+    uint32_t num_threads = config_.getNumWorkerThreads();
+
+    //Step the table size per thread in powers of two, always ending at the working set size
+    std::vector<size_t> table_sizes;
+    for (size_t size = 4*KB; size < max_table_size; size *= 2)
+        table_sizes.push_back(size);
+    table_sizes.push_back(max_table_size);
+
+    std::vector<rw_mode_t> rw_modes;
+    if (config_.useReads())
+        rw_modes.push_back(READ);
+    if (config_.useWrites())
+        rw_modes.push_back(WRITE);
+
+    for (auto mem_node_it = memory_numa_node_affinities_.cbegin(); mem_node_it != memory_numa_node_affinities_.cend(); mem_node_it++) { //iterate each memory NUMA node
+        uint32_t mem_node = *mem_node_it;
+
+        for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) { //iterate each cpu NUMA node
+            uint32_t cpu_node = *cpu_node_it;
+            if (!usesNodePair(mem_node, cpu_node))
+                continue;
+
+            for (uint32_t rw_index = 0; rw_index < rw_modes.size(); rw_index++) { //iterate each read/write mode
+                rw_mode_t rw_mode = rw_modes[rw_index];
+
+                std::vector<gather_kernel_t> kernels;
+                for (uint32_t k = 0; k < NUM_GATHER_KERNELS; k++) {
+                    GatherFunction kernel_fptr = NULL;
+                    if (determine_gather_kernel(rw_mode, static_cast<gather_kernel_t>(k), &kernel_fptr))
+                        kernels.push_back(static_cast<gather_kernel_t>(k));
+                }
+
+                //Keep the mean element rates for the summary, indexed by table size then kernel
+                std::vector<double> rates;
+                for (uint32_t z = 0; z < table_sizes.size(); z++) { //iterate each table size
+                    for (uint32_t k = 0; k < kernels.size(); k++) { //iterate each available kernel
+                        std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "G (Gather/Scatter)"))->str();
+                        GatherBenchmark benchmark(mem_arrays_[mem_node],
+                                                  table_sizes[z] * num_threads,
+                                                  config_.getIterationsPerTest(),
+                                                  num_threads,
+                                                  mem_node,
+                                                  cpu_node,
+                                                  rw_mode,
+                                                  kernels[k],
+                                                  dram_power_readers_,
+                                                  benchmark_name);
+
+                        if (!benchmark.run()) {
+                            std::cerr << "ERROR: Gather/scatter benchmark failed!" << std::endl;
+                            return false;
+                        }
+                        benchmark.reportResults(); //to console
+                        rates.push_back(benchmark.getMeanElementRate());
+
+                        //Write to results file if necessary
+                        if (config_.useOutputFile())
+                            writeGatherResults(&benchmark);
+                    }
+                }
+
+                //Summary: one row per table size, one column per kernel
+                std::cout << std::endl;
+                std::cout << "*** " << (rw_mode == READ ? "Gather" : "Scatter") << " summary in M elements/s (" << num_threads << " thread(s), CPU node " << cpu_node << ", memory node " << mem_node << ") ***" << std::endl;
+                std::cout << "Table KB/thread";
+                for (uint32_t k = 0; k < kernels.size(); k++)
+                    std::cout << "\t" << GatherBenchmark::gatherKernelName(kernels[k]);
+                std::cout << std::endl;
+                for (uint32_t z = 0; z < table_sizes.size(); z++) {
+                    std::cout << table_sizes[z] / KB;
+                    for (uint32_t k = 0; k < kernels.size(); k++)
+                        std::cout << "\t" << rates[z*kernels.size()+k];
+                    std::cout << std::endl;
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running gather/scatter benchmarks." << std::endl;
+
+    return true;
+}
+
+bool BenchmarkManager::runWorkloadMixBenchmark() {
+    forgetPermutations();
+    std::vector<workload_thread_t> workload = config_.getWorkload();
+
+    //Carve each thread's working set out of the memory on its node, one after another
+    std::vector<size_t> node_offsets(g_num_numa_nodes, 0);
+    std::vector<void*> thread_mem_arrays;
+    for (uint32_t t = 0; t < workload.size(); t++) {
+        uint32_t mem_node = workload[t].mem_node;
+        thread_mem_arrays.push_back(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_arrays_[mem_node]) + node_offsets[mem_node]));
+        node_offsets[mem_node] += workload[t].working_set_size;
+    }
+
+    std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "X (Workload mix)"))->str();
+    WorkloadMixBenchmark benchmark(thread_mem_arrays,
+                                   workload,
+                                   config_.getIterationsPerTest(),
+                                   config_.getMlp(),
+                                   dram_power_readers_,
+                                   benchmark_name);
+
+    if (!benchmark.run()) {
+        std::cerr << "ERROR: Workload mix benchmark failed!" << std::endl;
+        return false;
+    }
+    benchmark.reportResults(); //to console
+
+    //Write to results file if necessary
+    if (config_.useOutputFile())
+        writeWorkloadMixResults(&benchmark, "workload mix");
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running workload mix benchmark." << std::endl;
+
+    return true;
+}
+
+bool BenchmarkManager::runPageFaultBenchmarks() {
+    uint32_t num_threads = config_.getNumWorkerThreads();
+    size_t large_page_size = config_.getLargePageSize();
+
+    //Same total footprint as the other modes, rounded up so that every backing uses whole pages
+    size_t region_size = config_.getWorkingSetSizePerThread() * num_threads;
+    region_size = ((region_size + large_page_size - 1) / large_page_size) * large_page_size;
+
+    //Fault in with 1 thread, then with all of them
+    std::vector<uint32_t> thread_counts;
+    thread_counts.push_back(1);
+    if (num_threads > 1)
+        thread_counts.push_back(num_threads);
+
+    for (auto mem_node_it = memory_numa_node_affinities_.cbegin(); mem_node_it != memory_numa_node_affinities_.cend(); mem_node_it++) { //iterate each memory NUMA node
+        uint32_t mem_node = *mem_node_it;
+
+        for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) { //iterate each cpu NUMA node
+            uint32_t cpu_node = *cpu_node_it;
+            if (!usesNodePair(mem_node, cpu_node))
+                continue;
+
+            for (uint32_t b = 0; b < NUM_PAGE_BACKINGS; b++) { //iterate each kind of page
+                page_backing_t backing = static_cast<page_backing_t>(b);
+
+                for (uint32_t m = 0; m < 2; m++) { //iterate anonymous and memfd mappings
+                    bool use_memfd = (m == 1);
+
+                    for (uint32_t f = 0; f < NUM_FAULT_MODES; f++) { //iterate each fault mode
+                        fault_mode_t fault_mode = static_cast<fault_mode_t>(f);
+                        if (fault_mode == FAULT_COW && use_memfd) //Shared mappings take no copy-on-write faults
+                            continue;
+
+                        for (uint32_t t = 0; t < thread_counts.size(); t++) { //iterate each thread count
+                            if (fault_mode == FAULT_POPULATE && thread_counts[t] > 1) //The kernel populates on the mapping thread only
+                                continue;
+
+                            std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "F (Page faults)"))->str();
+                            PageFaultBenchmark benchmark(region_size,
+                                                         config_.getIterationsPerTest(),
+                                                         thread_counts[t],
+                                                         mem_node,
+                                                         cpu_node,
+                                                         backing,
+                                                         use_memfd,
+                                                         fault_mode,
+                                                         large_page_size,
+                                                         dram_power_readers_,
+                                                         benchmark_name);
+
+                            if (!benchmark.run()) {
+                                if (backing == PAGE_BACKING_HUGETLB) { //Explicit huge pages may simply not be reserved, so move on
+                                    std::cerr << "WARNING: Skipping " << PageFaultBenchmark::settingName(backing, use_memfd, fault_mode) << " page fault benchmark." << std::endl;
+                                    continue;
+                                }
+                                std::cerr << "ERROR: Page fault benchmark failed!" << std::endl;
+                                return false;
+                            }
+                            benchmark.reportResults(); //to console
+
+                            //Write to results file if necessary
+                            if (config_.useOutputFile())
+                                writePageFaultResults(&benchmark);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running page fault benchmarks." << std::endl;
+
+    return true;
+}
+
+bool BenchmarkManager::runNumaMatrixBenchmarks() {
+    forgetPermutations();
+    uint32_t num_threads = config_.getNumWorkerThreads();
+    size_t working_set_size = config_.getWorkingSetSizePerThread();
+
+    chunk_size_t chunk = largestSelectedChunk(); //Throughput gets closest to peak bandwidth with wide chunks
+
+    //Results indexed by CPU node then memory node, in order of selection
+    std::vector<uint32_t> cpu_nodes(cpu_numa_node_affinities_.cbegin(), cpu_numa_node_affinities_.cend());
+    std::vector<uint32_t> mem_nodes(memory_numa_node_affinities_.cbegin(), memory_numa_node_affinities_.cend());
+    std::vector<double> latencies(cpu_nodes.size() * mem_nodes.size(), 0);
+    std::vector<double> throughputs(cpu_nodes.size() * mem_nodes.size(), 0);
+
+    for (uint32_t m = 0; m < mem_nodes.size(); m++) { //iterate each memory NUMA node
+        uint32_t mem_node = mem_nodes[m];
+        std::string notes = numa_node_has_cpus(mem_node) ? "" : "memory-only node";
+
+        for (uint32_t c = 0; c < cpu_nodes.size(); c++) { //iterate each cpu NUMA node
+            uint32_t cpu_node = cpu_nodes[c];
+            std::string distance = static_cast<std::ostringstream*>(&(std::ostringstream() << "NUMA distance " << numa_node_distance(cpu_node, mem_node)))->str();
+
+            std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "N (NUMA Matrix Latency)"))->str();
+            LatencyBenchmark latency(mem_arrays_[mem_node],
+                                     working_set_size,
+                                     config_.getIterationsPerTest(),
+                                     1,
+                                     mem_node,
+                                     cpu_node,
+                                     RANDOM,
+                                     READ,
+                                     chunk,
+                                     0,
+                                     config_.getMlp(),
+                                     0,
+                                     dram_power_readers_,
+                                     benchmark_name);
+            latency.setRegionLayout(&region_layouts_[mem_node]);
+            if (!latency.run()) {
+                std::cerr << "ERROR: NUMA matrix latency benchmark failed!" << std::endl;
+                return false;
+            }
+            checkPlacementOfResidentRegions();
+            latency.reportResults(); //to console
+            latencies[c*mem_nodes.size()+m] = latency.getMeanMetric();
+            if (config_.useOutputFile())
+                writeLatencyResults(&latency, distance, notes);
+
+            benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "N (NUMA Matrix Throughput)"))->str();
+            ThroughputBenchmark throughput(mem_arrays_[mem_node],
+                                           mem_array_lens_[mem_node],
+                                           config_.getIterationsPerTest(),
+                                           num_threads,
+                                           mem_node,
+                                           cpu_node,
+                                           SEQUENTIAL,
+                                           READ,
+                                           chunk,
+                                           1,
+                                           config_.getMlp(),
+                                           dram_power_readers_,
+                                           benchmark_name);
+            throughput.setRegionLayout(&region_layouts_[mem_node]);
+            if (!throughput.run()) {
+                std::cerr << "ERROR: NUMA matrix throughput benchmark failed!" << std::endl;
+                return false;
+            }
+            checkPlacementOfResidentRegions();
+            throughput.reportResults(); //to console
+            throughputs[c*mem_nodes.size()+m] = throughput.getMeanMetric();
+            if (config_.useOutputFile())
+                writeThroughputResults(&throughput, distance, notes);
+        }
+    }
+
+    //Summary: one row per CPU node, one column per memory node. Memory-only nodes are marked with a *.
+    for (uint32_t table = 0; table < 3; table++) {
+        std::cout << std::endl;
+        switch (table) {
+            case 0:
+                std::cout << "*** NUMA distances reported by the firmware (0 = unknown) ***" << std::endl;
+                break;
+            case 1:
+                std::cout << "*** Unloaded random read latency in ns/access (1 thread) ***" << std::endl;
+                break;
+            default:
+                std::cout << "*** Sequential read throughput in MB/s (" << num_threads << " thread(s)) ***" << std::endl;
+                break;
+        }
+        std::cout << "CPU \\ mem";
+        for (uint32_t m = 0; m < mem_nodes.size(); m++)
+            std::cout << "\t" << mem_nodes[m] << (numa_node_has_cpus(mem_nodes[m]) ? "" : "*");
+        std::cout << std::endl;
+        for (uint32_t c = 0; c < cpu_nodes.size(); c++) {
+            std::cout << cpu_nodes[c];
+            for (uint32_t m = 0; m < mem_nodes.size(); m++) {
+                std::cout << "\t";
+                if (table == 0)
+                    std::cout << numa_node_distance(cpu_nodes[c], mem_nodes[m]);
+                else if (table == 1)
+                    std::cout << latencies[c*mem_nodes.size()+m];
+                else
+                    std::cout << throughputs[c*mem_nodes.size()+m];
+            }
+            std::cout << std::endl;
+        }
+    }
+    std::cout << std::endl;
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running NUMA matrix benchmarks." << std::endl;
+
+    return true;
+}
+
+bool BenchmarkManager::runAllToAllBenchmark() {
+    forgetPermutations();
+    std::vector<workload_thread_t> workload = config_.getAllToAllWorkload();
+
+    //Carve each thread's working set out of the memory on its node, one after another
+    std::vector<size_t> node_offsets(g_num_numa_nodes, 0);
+    std::vector<void*> thread_mem_arrays;
+    for (uint32_t t = 0; t < workload.size(); t++) {
+        uint32_t mem_node = workload[t].mem_node;
+        thread_mem_arrays.push_back(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_arrays_[mem_node]) + node_offsets[mem_node]));
+        node_offsets[mem_node] += workload[t].working_set_size;
+    }
+
+    std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "Y (All-to-all NUMA traffic)"))->str();
+    WorkloadMixBenchmark benchmark(thread_mem_arrays,
+                                   workload,
+                                   config_.getIterationsPerTest(),
+                                   config_.getMlp(),
+                                   dram_power_readers_,
+                                   benchmark_name);
+
+    if (!benchmark.run()) {
+        std::cerr << "ERROR: All-to-all NUMA traffic benchmark failed!" << std::endl;
+        return false;
+    }
+    benchmark.reportResults(); //to console
+
+    //Add up the load threads of each CPU node and memory node pair, indexed by CPU node then memory node
+    std::vector<double> pair_throughputs(g_num_numa_nodes * g_num_numa_nodes, 0);
+    std::vector<uint32_t> pair_threads(g_num_numa_nodes * g_num_numa_nodes, 0);
+    for (uint32_t t = 0; t < benchmark.getNumThreads(); t++) {
+        workload_thread_t spec = benchmark.getThreadSpec(t);
+        if (spec.latency_probe)
+            continue;
+        pair_throughputs[spec.cpu_node*g_num_numa_nodes+spec.mem_node] += benchmark.getThreadMeanMetric(t);
+        pair_threads[spec.cpu_node*g_num_numa_nodes+spec.mem_node]++;
+    }
+
+    //Summary: one row per CPU node, one column per memory node. Memory-only nodes are marked with a *.
+    workload_thread_t probe = workload.back();
+    std::cout << std::endl;
+    std::cout << "*** All-to-all NUMA traffic summary in " << benchmark.getMetricUnits() << " (" << config_.getAllToAllLocalPercent() << "% local, number of threads in parentheses) ***" << std::endl;
+    std::cout << "CPU \\ mem";
+    for (auto mem_node_it = memory_numa_node_affinities_.cbegin(); mem_node_it != memory_numa_node_affinities_.cend(); mem_node_it++)
+        std::cout << "\t" << *mem_node_it << (numa_node_has_cpus(*mem_node_it) ? "" : "*");
+    std::cout << "\ttotal" << std::endl;
+    for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) {
+        uint32_t cpu_node = *cpu_node_it;
+        double total = 0;
+        std::cout << cpu_node;
+        for (auto mem_node_it = memory_numa_node_affinities_.cbegin(); mem_node_it != memory_numa_node_affinities_.cend(); mem_node_it++) {
+            uint32_t pair = cpu_node*g_num_numa_nodes+*mem_node_it;
+            std::cout << "\t" << pair_throughputs[pair] << " (" << pair_threads[pair] << ")";
+            total += pair_throughputs[pair];
+        }
+        std::cout << "\t" << total << std::endl;
+    }
+    std::cout << "Probe latency from CPU node " << probe.cpu_node << " to memory node " << probe.mem_node << ": " << benchmark.getMeanProbeLatency() << " ns/access" << std::endl;
+    std::cout << std::endl;
+
+    //Write to results file if necessary
+    if (config_.useOutputFile())
+        writeWorkloadMixResults(&benchmark, static_cast<std::ostringstream*>(&(std::ostringstream() << "all-to-all " << config_.getAllToAllLocalPercent() << "% local"))->str());
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running all-to-all NUMA traffic benchmark." << std::endl;
+
+    return true;
+}
+
+bool BenchmarkManager::runThpBenchmarks() {
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+    forgetPermutations();
+    uint32_t num_threads = config_.getNumWorkerThreads();
+    size_t working_set_size = config_.getWorkingSetSizePerThread();
+    uint32_t collapse_seconds = config_.getThpCollapseSeconds();
+    chunk_size_t chunk = largestSelectedChunk();
+    chunk_size_t random_chunk = chunk;
+#ifdef HAS_WORD_64
+    if (random_chunk == CHUNK_32b) //Random load workers cannot use 32-bit chunks
+        random_chunk = CHUNK_64b;
+#endif
+
+    size_t thp_size = g_thp_page_size;
+    size_t len = working_set_size * num_threads;
+    size_t region_size = ((len + thp_size - 1) / thp_size) * thp_size;
+
+    //The system-wide settings decide what the default policy does, and how fast khugepaged collapses
+    const char* settings[] = { "enabled", "defrag", "khugepaged/pages_to_scan", "khugepaged/scan_sleep_millisecs" };
+    std::cout << std::endl << "Transparent huge page settings (huge page size " << thp_size / KB << " KB):" << std::endl;
+    for (uint32_t i = 0; i < sizeof(settings)/sizeof(settings[0]); i++) {
+        std::ifstream setting_file(std::string("/sys/kernel/mm/transparent_hugepage/") + settings[i]);
+        std::string value;
+        if (!setting_file.is_open() || !std::getline(setting_file, value))
+            value = "unknown";
+        std::cout << settings[i] << ": " << value << std::endl;
+    }
+
+    std::vector<thp_policy_t> policies;
+    policies.push_back(THP_SYSTEM_DEFAULT);
+    policies.push_back(THP_MADV_HUGEPAGE);
+    policies.push_back(THP_MADV_NOHUGEPAGE);
+    if (collapse_seconds > 0)
+        policies.push_back(THP_COLLAPSE);
+
+    for (auto mem_node_it = memory_numa_node_affinities_.cbegin(); mem_node_it != memory_numa_node_affinities_.cend(); mem_node_it++) { //iterate each memory NUMA node
+        uint32_t mem_node = *mem_node_it;
+
+        for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) { //iterate each cpu NUMA node
+            uint32_t cpu_node = *cpu_node_it;
+            if (!usesNodePair(mem_node, cpu_node))
+                continue;
+
+            //Keep the results for the summary, indexed by policy
+            std::vector<double> coverages, latencies, seq_throughputs, random_throughputs;
+            for (uint32_t p = 0; p < policies.size(); p++) { //iterate each THP policy
+                thp_policy_t policy = policies[p];
+                std::string policy_name = thpPolicyName(policy);
+
+                void* map = NULL;
+                size_t map_len = 0;
+                void* region = mapThpRegion(region_size, thp_size, mem_node, policy, &map, &map_len);
+                if (region == nullptr) {
+                    std::cerr << "ERROR: Failed to map memory for the THP " << policy_name << " policy on NUMA node " << mem_node << "." << std::endl;
+                    return false;
+                }
+
+                //Fault in with the worker threads on the CPU node under test, as an application would
+                std::vector<void*> regions;
+                std::vector<size_t> lens;
+                std::vector<int32_t> cpu_ids;
+                for (uint32_t t = 0; t < num_threads; t++) {
+                    regions.push_back(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(region) + t * working_set_size));
+                    lens.push_back(working_set_size);
+                    cpu_ids.push_back(cpu_id_in_numa_node(cpu_node, t));
+                }
+                if (!InitWorker::initializeRegions(regions, lens, cpu_ids)) { //Measuring an unprimed region would say nothing about the policy
+                    std::cerr << "ERROR: Failed to fault in memory for the THP " << policy_name << " policy on the logical CPUs of NUMA node " << cpu_node << "." << std::endl;
+                    munmap(map, map_len);
+                    return false;
+                }
+
+                if (policy == THP_COLLAPSE) {
+                    std::cout << std::endl << "khugepaged collapse on CPU node " << cpu_node << ", memory node " << mem_node << ":" << std::endl;
+                    std::cout << "0 s: " << thpCoverage(region, region_size) * 100 << "% AnonHugePages" << std::endl;
+                    if (madvise(region, region_size, MADV_HUGEPAGE) != 0)
+                        std::cerr << "WARNING: madvise(MADV_HUGEPAGE) failed (" << strerror(errno) << ")." << std::endl;
+                    for (uint32_t second = 1; second <= collapse_seconds; second++) {
+                        sleep(1);
+                        std::cout << second << " s: " << thpCoverage(region, region_size) * 100 << "% AnonHugePages" << std::endl;
+                    }
+                }
+
+                double coverage = thpCoverage(region, region_size);
+                coverages.push_back(coverage);
+                std::string notes = static_cast<std::ostringstream*>(&(std::ostringstream() << coverage * 100 << "% AnonHugePages"))->str();
+                std::string extension_info = "THP " + policy_name;
+
+                std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "U (THP Latency)"))->str();
+                LatencyBenchmark latency(region,
+                                         working_set_size,
+                                         config_.getIterationsPerTest(),
+                                         1,
+                                         mem_node,
+                                         cpu_node,
+                                         RANDOM,
+                                         READ,
+                                         chunk,
+                                         0,
+                                         config_.getMlp(),
+                                         0,
+                                         dram_power_readers_,
+                                         benchmark_name);
+                bool ok = latency.run();
+                if (ok) {
+                    latency.reportResults(); //to console
+                    latencies.push_back(latency.getMeanMetric());
+                    if (config_.useOutputFile())
+                        writeLatencyResults(&latency, extension_info, notes);
+                }
+
+                for (uint32_t pattern = 0; ok && pattern < 2; pattern++) { //sequential, then random throughput
+                    benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "U (THP Throughput)"))->str();
+                    ThroughputBenchmark throughput(region,
+                                                   len,
+                                                   config_.getIterationsPerTest(),
+                                                   num_threads,
+                                                   mem_node,
+                                                   cpu_node,
+                                                   pattern == 0 ? SEQUENTIAL : RANDOM,
+                                                   READ,
+                                                   pattern == 0 ? chunk : random_chunk,
+                                                   pattern == 0 ? 1 : 0,
+                                                   config_.getMlp(),
+                                                   dram_power_readers_,
+                                                   benchmark_name);
+                    ok = throughput.run();
+                    if (ok) {
+                        throughput.reportResults(); //to console
+                        (pattern == 0 ? seq_throughputs : random_throughputs).push_back(throughput.getMeanMetric());
+                        if (config_.useOutputFile())
+                            writeThroughputResults(&throughput, extension_info, notes);
+                    }
+                }
+
+                munmap(map, map_len);
+                if (!ok) {
+                    std::cerr << "ERROR: THP benchmark failed!" << std::endl;
+                    return false;
+                }
+            }
+
+            //Summary: one row per policy
+            std::cout << std::endl;
+            std::cout << "*** THP policy summary (CPU node " << cpu_node << ", memory node " << mem_node << ", " << num_threads << " thread(s) for throughput) ***" << std::endl;
+            std::cout << "Policy\tAnonHugePages %\tLatency ns/access\tSeq read MB/s\tRandom read MB/s" << std::endl;
+            for (uint32_t p = 0; p < policies.size(); p++)
+                std::cout << thpPolicyName(policies[p]) << "\t" << coverages[p] * 100 << "\t" << latencies[p] << "\t" << seq_throughputs[p] << "\t" << random_throughputs[p] << std::endl;
+            std::cout << std::endl;
+        }
+    }
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running THP benchmarks." << std::endl;
+
+    return true;
+#else
+    std::cerr << "ERROR: THP comparison mode is only supported on GNU/Linux with NUMA support." << std::endl;
+    return false;
+#endif
+}
+
+bool BenchmarkManager::runPageMigrationBenchmarks() {
+    uint32_t num_threads = config_.getNumWorkerThreads();
+    size_t working_set_size = config_.getWorkingSetSizePerThread();
+    size_t large_page_size = config_.getLargePageSize();
+
+    //Same total footprint as the other modes, rounded up so that every backing uses whole pages. The latency thread reads one working set of it.
+    //Page sizes are powers of two, so the larger of the explicit and transparent huge page sizes is a multiple of both.
+    size_t region_size = working_set_size * num_threads;
+    size_t granularity = (large_page_size > g_thp_page_size) ? large_page_size : g_thp_page_size;
+    region_size = ((region_size + granularity - 1) / granularity) * granularity;
+
+    for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) { //iterate each cpu NUMA node
+        uint32_t cpu_node = *cpu_node_it;
+
+        for (auto src_node_it = memory_numa_node_affinities_.cbegin(); src_node_it != memory_numa_node_affinities_.cend(); src_node_it++) { //iterate each source memory NUMA node
+            uint32_t src_node = *src_node_it;
+            if (!usesNodePair(src_node, cpu_node))
+                continue;
+
+            //Keep the results for the summary, one row per destination node and kind of page
+            std::vector<std::string> rows;
+
+            for (auto dst_node_it = memory_numa_node_affinities_.cbegin(); dst_node_it != memory_numa_node_affinities_.cend(); dst_node_it++) { //iterate each destination memory NUMA node
+                uint32_t dst_node = *dst_node_it;
+                if (dst_node == src_node)
+                    continue;
+
+                for (uint32_t b = 0; b < NUM_PAGE_BACKINGS; b++) { //iterate each kind of page
+                    page_backing_t backing = static_cast<page_backing_t>(b);
+
+                    std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "I (Page migration)"))->str();
+                    PageMigrationBenchmark benchmark(region_size,
+                                                     working_set_size,
+                                                     config_.getIterationsPerTest(),
+                                                     src_node,
+                                                     dst_node,
+                                                     cpu_node,
+                                                     backing,
+                                                     large_page_size,
+                                                     dram_power_readers_,
+                                                     benchmark_name);
+
+                    if (!benchmark.run()) {
+                        if (backing == PAGE_BACKING_HUGETLB) { //Explicit huge pages may simply not be free on both nodes, so move on
+                            std::cerr << "WARNING: Skipping " << PageMigrationBenchmark::backingName(backing) << " page migration benchmark to NUMA node " << dst_node << "." << std::endl;
+                            continue;
+                        }
+                        std::cerr << "ERROR: Page migration benchmark failed!" << std::endl;
+                        return false;
+                    }
+                    benchmark.reportResults(); //to console
+
+                    std::ostringstream row;
+                    row << dst_node << "\t" << PageMigrationBenchmark::backingName(backing) << "\t" << benchmark.getMeanMetric() << "\t" << benchmark.getMeanPageRate() << "\t" << benchmark.getMeanMigrationLatency() << "\t" << benchmark.getMeanBaselineLatency();
+                    rows.push_back(row.str());
+
+                    //Write to results file if necessary
+                    if (config_.useOutputFile())
+                        writePageMigrationResults(&benchmark);
+                }
+            }
+
+            //Summary: one row per destination node and kind of page
+            std::cout << std::endl;
+            std::cout << "*** Page migration summary (CPU node " << cpu_node << ", source memory node " << src_node << ", " << region_size / KB << " KB) ***" << std::endl;
+            std::cout << "To node\tPages\tMB/s\tPages/s\tLatency ns/access during migration\tLatency ns/access without" << std::endl;
+            for (uint32_t r = 0; r < rows.size(); r++)
+                std::cout << rows[r] << std::endl;
+            std::cout << std::endl;
+        }
+    }
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running page migration benchmarks." << std::endl;
+
+    return true;
+}
+
+bool BenchmarkManager::runTlbReachBenchmarks() {
+#ifdef __gnu_linux__
+    size_t max_region_size = config_.getTlbReachMaxRegionSize();
+    size_t budget_pages[2] = { max_region_size / g_page_size, max_region_size / g_thp_page_size }; //regular and transparent huge pages
+
+    std::vector<bool> orders; //true for random page order, false for address order
+    if (config_.useRandomAccessPattern())
+        orders.push_back(true);
+    if (config_.useSequentialAccessPattern())
+        orders.push_back(false);
+    if (orders.empty()) {
+        std::cerr << "ERROR: TLB reach mode needs the random or the sequential access pattern." << std::endl;
+        return false;
+    }
+
+    //Number of pages touched: 1, 2, 4, ...
+    std::vector<size_t> counts;
+    for (size_t n = 1; n <= TLB_REACH_BENCHMARK_MAX_PAGES; n *= 2)
+        counts.push_back(n);
+
+    //Explicit huge page sizes to try: the selected one, the system default, and 1 GB
+    std::vector<size_t> hugetlb_sizes;
+    size_t hugetlb_candidates[3] = { config_.getLargePageSize(), g_large_page_size, static_cast<size_t>(GB) };
+    for (uint32_t c = 0; c < 3; c++) {
+        if (hugetlb_candidates[c] > g_page_size && std::find(hugetlb_sizes.begin(), hugetlb_sizes.end(), hugetlb_candidates[c]) == hugetlb_sizes.end())
+            hugetlb_sizes.push_back(hugetlb_candidates[c]);
+    }
+    std::sort(hugetlb_sizes.begin(), hugetlb_sizes.end());
+
+    for (auto mem_node_it = memory_numa_node_affinities_.cbegin(); mem_node_it != memory_numa_node_affinities_.cend(); mem_node_it++) { //iterate each memory NUMA node
+        uint32_t mem_node = *mem_node_it;
+
+        for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) { //iterate each cpu NUMA node
+            uint32_t cpu_node = *cpu_node_it;
+            if (!usesNodePair(mem_node, cpu_node))
+                continue;
+
+            //Kinds of pages to measure. The first is the dense chain, with all of its lines in one transparent huge page, as the reference without TLB misses.
+            std::vector<page_backing_t> backings;
+            std::vector<size_t> page_sizes;
+            std::vector<size_t> max_pages;
+
+            backings.push_back(PAGE_BACKING_THP);
+            page_sizes.push_back(CACHE_LINE_SIZE);
+            max_pages.push_back(TLB_REACH_BENCHMARK_MAX_PAGES);
+
+            backings.push_back(PAGE_BACKING_BASE);
+            page_sizes.push_back(g_page_size);
+            max_pages.push_back(std::min(budget_pages[0], static_cast<size_t>(TLB_REACH_BENCHMARK_MAX_PAGES)));
+
+            backings.push_back(PAGE_BACKING_THP);
+            page_sizes.push_back(g_thp_page_size);
+            max_pages.push_back(std::min(budget_pages[1], static_cast<size_t>(TLB_REACH_BENCHMARK_MAX_PAGES)));
+
+            for (uint32_t h = 0; h < hugetlb_sizes.size(); h++) {
+                size_t free_pages = 0;
+                std::ostringstream pool_path;
+                pool_path << "/sys/devices/system/node/node" << mem_node << "/hugepages/hugepages-" << hugetlb_sizes[h] / KB << "kB/free_hugepages";
+                std::ifstream pool(pool_path.str().c_str());
+                if (!pool.is_open()) //This page size is not supported
+                    continue;
+                if (!(pool >> free_pages) || free_pages == 0) {
+                    std::cerr << "WARNING: No huge pages of " << hugetlb_sizes[h] / KB << " KB are free on NUMA node " << mem_node << ". Skipping them in TLB reach mode." << std::endl;
+                    continue;
+                }
+                backings.push_back(PAGE_BACKING_HUGETLB);
+                page_sizes.push_back(hugetlb_sizes[h]);
+                max_pages.push_back(std::min(std::min(free_pages, max_region_size / hugetlb_sizes[h]), static_cast<size_t>(TLB_REACH_BENCHMARK_MAX_PAGES)));
+            }
+
+            //Latency of every kind, page order, and number of pages. Numbers of pages that a kind does not reach stay at 0.
+            std::vector<std::vector<std::vector<double> > > latencies(backings.size(), std::vector<std::vector<double> >(orders.size(), std::vector<double>(counts.size(), 0)));
+
+            for (size_t k = 0; k < backings.size(); k++) { //iterate each kind of page
+                bool dense = (k == 0);
+                std::string kind = tlbReachKindName(backings[k], page_sizes[k]);
+                if (max_pages[k] == 0) {
+                    std::cerr << "WARNING: A " << page_sizes[k] / KB << " KB page does not fit in the " << max_region_size / MB << " MB region limit. Skipping " << kind << " pages in TLB reach mode." << std::endl;
+                    continue;
+                }
+
+                //Untimed: map the largest region for this kind and fault it in on the memory node
+                size_t region_len = max_pages[k] * page_sizes[k];
+                if (dense) //Round the dense lines up to whole huge pages
+                    region_len = ((region_len + g_thp_page_size - 1) / g_thp_page_size) * g_thp_page_size;
+                int fd = -1;
+                void* region = PageFaultWorker::mapRegion(backings[k], false, region_len, page_sizes[k] > g_page_size ? page_sizes[k] : g_thp_page_size, false, fd);
+                if (region == NULL) {
+                    if (backings[k] == PAGE_BACKING_HUGETLB) { //Free huge pages may have been taken in the meantime
+                        std::cerr << "WARNING: Failed to map " << region_len / KB << " KB of " << kind << " pages. Skipping them in TLB reach mode." << std::endl;
+                        continue;
+                    }
+                    std::cerr << "ERROR: Failed to map " << region_len / KB << " KB of " << kind << " pages for TLB reach mode." << std::endl;
+                    return false;
+                }
+
+                PageFaultWorker* fault_worker = new PageFaultWorker(region, region_len, mem_node, cpu_id_in_numa_node(cpu_node, 0));
+                Thread* fault_thread = new Thread(fault_worker);
+                fault_thread->create_and_start();
+                if (!fault_thread->join())
+                    std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+                delete fault_thread;
+                delete fault_worker;
+
+                std::string notes;
+#ifdef HAS_NUMA
+                if (backings[k] == PAGE_BACKING_THP) { //The kernel may have fallen back to regular pages
+                    double coverage = thpCoverage(region, region_len);
+                    if (coverage >= 0) {
+                        notes = static_cast<std::ostringstream*>(&(std::ostringstream() << coverage * 100 << "% AnonHugePages"))->str();
+                        if (coverage < 1)
+                            std::cerr << "WARNING: Only " << coverage * 100 << "% of the " << kind << " region is backed by transparent huge pages." << (dense ? " The dense reference may take TLB misses." : "") << std::endl;
+                    }
+                }
+#endif
+
+                for (uint32_t o = 0; o < orders.size(); o++) { //iterate each page order
+                    if (dense && o > 0) { //The reference is always random, as lines packed in address order would be prefetched
+                        latencies[k][o] = latencies[k][0];
+                        continue;
+                    }
+
+                    for (uint32_t s = 0; s < counts.size() && counts[s] <= max_pages[k]; s++) { //iterate each number of pages
+                        std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "P (TLB Reach)"))->str();
+                        TlbReachBenchmark benchmark(region,
+                                                    counts[s],
+                                                    page_sizes[k],
+                                                    backings[k],
+                                                    orders[o],
+                                                    config_.getIterationsPerTest(),
+                                                    mem_node,
+                                                    cpu_node,
+                                                    dram_power_readers_,
+                                                    benchmark_name);
+
+                        if (!benchmark.run()) {
+                            std::cerr << "ERROR: TLB reach benchmark failed!" << std::endl;
+                            PageFaultWorker::unmapRegion(region, region_len, fd);
+                            return false;
+                        }
+                        benchmark.reportResults(); //to console
+                        latencies[k][o][s] = benchmark.getMeanMetric();
+
+                        //Write to results file if necessary
+                        if (config_.useOutputFile()) {
+                            std::ostringstream row_notes;
+                            row_notes << (orders[o] ? "random" : "strided") << " page order";
+                            if (!dense && latencies[0][o][s] > 0)
+                                row_notes << "; " << latencies[k][o][s] - latencies[0][o][s] << " ns/access over dense lines";
+                            if (!notes.empty())
+                                row_notes << "; " << notes;
+                            writeTlbReachResults(&benchmark, static_cast<std::ostringstream*>(&(std::ostringstream() << kind << " " << counts[s] << " pages"))->str(), row_notes.str());
+                        }
+                    }
+                }
+
+                PageFaultWorker::unmapRegion(region, region_len, fd);
+            }
+
+            //Summary: latency over the number of pages for every kind, then the reach and page walk latency found from the extra latency over the dense lines
+            for (uint32_t o = 0; o < orders.size(); o++) {
+                std::cout << std::endl;
+                std::cout << "*** TLB reach (CPU node " << cpu_node << ", memory node " << mem_node << ", " << (orders[o] ? "random" : "strided") << " page order, ns/access) ***" << std::endl;
+                std::cout << "Pages";
+                for (size_t k = 0; k < backings.size(); k++)
+                    std::cout << "\t" << tlbReachKindName(backings[k], page_sizes[k]);
+                std::cout << std::endl;
+                for (uint32_t s = 0; s < counts.size(); s++) {
+                    std::cout << counts[s];
+                    for (size_t k = 0; k < backings.size(); k++) {
+                        if (latencies[k][o][s] > 0)
+                            std::cout << "\t" << latencies[k][o][s];
+                        else
+                            std::cout << "\t-";
+                    }
+                    std::cout << std::endl;
+                }
+                std::cout << std::endl;
+
+                for (size_t k = 1; k < backings.size(); k++) {
+                    //Extra latency over the same number of dense lines, which take the same cache misses but hardly any TLB misses
+                    std::vector<double> extra;
+                    for (uint32_t s = 0; s < counts.size() && latencies[k][o][s] > 0 && latencies[0][o][s] > 0; s++)
+                        extra.push_back(latencies[k][o][s] - latencies[0][o][s]);
+                    if (extra.empty())
+                        continue;
+
+                    //First-level reach ends where the extra latency first shows up, as second-level TLB hits. Second-level reach ends where it rises well above that plateau, as page walks.
+                    size_t l1_step = extra.size();
+                    size_t l2_step = extra.size();
+                    for (size_t s = 0; s < extra.size() && l1_step == extra.size(); s++) {
+                        if (extra[s] > TLB_REACH_BENCHMARK_KNEE_NS)
+                            l1_step = s;
+                    }
+                    for (size_t s = l1_step + 1; s < extra.size() && l2_step == extra.size(); s++) {
+                        if (extra[s] > 2 * extra[l1_step] && extra[s] > extra[l1_step] + TLB_REACH_BENCHMARK_KNEE_NS)
+                            l2_step = s;
+                    }
+
+                    std::cout << tlbReachKindName(backings[k], page_sizes[k]) << " pages: L1 DTLB reach ";
+                    if (l1_step == 0)
+                        std::cout << "under 1 page";
+                    else if (l1_step == extra.size())
+                        std::cout << "at least " << counts[extra.size()-1] << " pages (" << counts[extra.size()-1] * page_sizes[k] / KB << " KB)";
+                    else
+                        std::cout << counts[l1_step-1] << " pages (" << counts[l1_step-1] * page_sizes[k] / KB << " KB)";
+                    std::cout << ", L2 DTLB reach ";
+                    if (l2_step == extra.size())
+                        std::cout << "at least " << counts[extra.size()-1] << " pages (" << counts[extra.size()-1] * page_sizes[k] / KB << " KB)";
+                    else
+                        std::cout << counts[l2_step-1] << " pages (" << counts[l2_step-1] * page_sizes[k] / KB << " KB)";
+                    std::cout << ", page walk latency ";
+                    if (l2_step == extra.size())
+                        std::cout << "not reached";
+                    else
+                        std::cout << extra.back() << " ns at " << counts[extra.size()-1] << " pages";
+                    std::cout << std::endl;
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+
+    if (g_verbose)
+        std::cout << std::endl << "Done running TLB reach benchmarks." << std::endl;
+
+    return true;
+#else
+    std::cerr << "ERROR: TLB reach mode is only supported on GNU/Linux." << std::endl;
+    return false;
+#endif
+}
+
+void BenchmarkManager::writeThroughputResults(ThroughputBenchmark* benchmark, std::string extension_info, std::string notes) {
+    results_file_ << benchmark->getName() << ",";
+    results_file_ << benchmark->getIterations() << ",";
+    results_file_ << static_cast<size_t>(benchmark->getLen() / benchmark->getNumThreads() / KB) << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    results_file_ << benchmark->getMemNode() << ",";
+    results_file_ << benchmark->getCPUNode() << ",";
+    pattern_mode_t pattern = benchmark->getPatternMode();
+    switch (pattern) {
+        case SEQUENTIAL:
+            results_file_ << "SEQUENTIAL" << ",";
+            break;
+        case RANDOM:
+            results_file_ << "RANDOM" << ",";
+            break;
+        default:
+            results_file_ << "UNKNOWN" << ",";
+            break;
+    }
+
+    rw_mode_t rw_mode = benchmark->getRWMode();
+    switch (rw_mode) {
+        case READ:
+            results_file_ << "READ" << ",";
+            break;
+        case WRITE:
+            results_file_ << "WRITE" << ",";
+            break;
+        default:
+            results_file_ << "UNKNOWN" << ",";
+            break;
+    }
+
+    chunk_size_t chunk_size = benchmark->getChunkSize();
+    switch (chunk_size) {
+        case CHUNK_32b:
+            results_file_ << "32" << ",";
+            break;
+#ifdef HAS_WORD_64
+        case CHUNK_64b:
+            results_file_ << "64" << ",";
+            break;
+#endif
+#ifdef HAS_WORD_128
+        case CHUNK_128b:
+            results_file_ << "128" << ",";
+            break;
+#endif
+#ifdef HAS_WORD_256
+        case CHUNK_256b:
+            results_file_ << "256" << ",";
+            break;
+#endif
+#ifdef HAS_WORD_512
+        case CHUNK_512b:
+            results_file_ << "512" << ",";
+            break;
+#endif
+        default:
+            results_file_ << "UNKNOWN" << ",";
+            break;
+    }
 
-    return true;
+    results_file_ << benchmark->getStrideSize() << ",";
+    results_file_ << benchmark->getMeanMetric() << ",";
+    results_file_ << benchmark->getMinMetric() << ",";
+    results_file_ << benchmark->get25PercentileMetric() << ",";
+    results_file_ << benchmark->getMedianMetric() << ",";
+    results_file_ << benchmark->get75PercentileMetric() << ",";
+    results_file_ << benchmark->get95PercentileMetric() << ",";
+    results_file_ << benchmark->get99PercentileMetric() << ",";
+    results_file_ << benchmark->getMaxMetric() << ",";
+    results_file_ << benchmark->getModeMetric() << ",";
+    results_file_ << benchmark->getMetricUnits() << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    writePowerResults(benchmark);
+    writePerfCounts(benchmark);
+    results_file_ << "N/A" << ",";
+    results_file_ << extension_info << ",";
+    std::string placement = placementNotes();
+    if (!placement.empty())
+        notes = notes.empty() ? placement : notes + "; " + placement;
+    results_file_ << notes << ",";
+    results_file_ << std::endl;
 }
 
-bool BenchmarkManager::runLatencyBenchmarks() {
-    if (!built_benchmarks_) {
-        if (!buildBenchmarks()) {
-            std::cerr << "ERROR: Failed to build benchmarks." << std::endl;
-            return false;
+void BenchmarkManager::writeLatencyResults(LatencyBenchmark* benchmark, std::string extension_info, std::string notes) {
+    results_file_ << benchmark->getName() << ",";
+    results_file_ << benchmark->getIterations() << ",";
+    results_file_ << static_cast<size_t>(benchmark->getLen() / benchmark->getNumThreads() / KB) << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    results_file_ << benchmark->getNumThreads()-1 << ",";
+    results_file_ << benchmark->getMemNode() << ",";
+    results_file_ << benchmark->getCPUNode() << ",";
+    if (benchmark->getNumThreads() < 2) {
+        results_file_ << "N/A" << ",";
+        results_file_ << "N/A" << ",";
+        results_file_ << "N/A" << ",";
+        results_file_ << "N/A" << ",";
+    } else {
+        pattern_mode_t pattern = benchmark->getPatternMode();
+        switch (pattern) {
+            case SEQUENTIAL:
+                results_file_ << "SEQUENTIAL" << ",";
+                break;
+            case RANDOM:
+                results_file_ << "RANDOM" << ",";
+                break;
+            default:
+                results_file_ << "UNKNOWN" << ",";
+                break;
         }
-    }
 
-    for (uint32_t i = 0; i < lat_benchmarks_.size(); i++) {
-        lat_benchmarks_[i]->run();
-        lat_benchmarks_[i]->reportResults(); //to console
+        rw_mode_t rw_mode = benchmark->getRWMode();
+        switch (rw_mode) {
+            case READ:
+                results_file_ << "READ" << ",";
+                break;
+            case WRITE:
+                results_file_ << "WRITE" << ",";
+                break;
+            default:
+                results_file_ << "UNKNOWN" << ",";
+                break;
+        }
 
-        //Write to results file if necessary
-        if (config_.useOutputFile()) {
-            results_file_ << lat_benchmarks_[i]->getName() << ",";
-            results_file_ << lat_benchmarks_[i]->getIterations() << ",";
-            results_file_ << static_cast<size_t>(lat_benchmarks_[i]->getLen() / lat_benchmarks_[i]->getNumThreads() / KB) << ",";
-            results_file_ << lat_benchmarks_[i]->getNumThreads() << ",";
-            results_file_ << lat_benchmarks_[i]->getNumThreads()-1 << ",";
-            results_file_ << lat_benchmarks_[i]->getMemNode() << ",";
-            results_file_ << lat_benchmarks_[i]->getCPUNode() << ",";
-            if (lat_benchmarks_[i]->getNumThreads() < 2) {
-                results_file_ << "N/A" << ",";
-                results_file_ << "N/A" << ",";
-                results_file_ << "N/A" << ",";
-                results_file_ << "N/A" << ",";
-            } else {
-                pattern_mode_t pattern = lat_benchmarks_[i]->getPatternMode();
-                switch (pattern) {
-                    case SEQUENTIAL:
-                        results_file_ << "SEQUENTIAL" << ",";
-                        break;
-                    case RANDOM:
-                        results_file_ << "RANDOM" << ",";
-                        break;
-                    default:
-                        results_file_ << "UNKNOWN" << ",";
-                        break;
-                }
-
-                rw_mode_t rw_mode = lat_benchmarks_[i]->getRWMode();
-                switch (rw_mode) {
-                    case READ:
-                        results_file_ << "READ" << ",";
-                        break;
-                    case WRITE:
-                        results_file_ << "WRITE" << ",";
-                        break;
-                    default:
-                        results_file_ << "UNKNOWN" << ",";
-                        break;
-                }
-
-                chunk_size_t chunk_size = lat_benchmarks_[i]->getChunkSize();
-                switch (chunk_size) {
-                    case CHUNK_32b:
-                        results_file_ << "32" << ",";
-                        break;
+        chunk_size_t chunk_size = benchmark->getChunkSize();
+        switch (chunk_size) {
+            case CHUNK_32b:
+                results_file_ << "32" << ",";
+                break;
 #ifdef HAS_WORD_64
-                    case CHUNK_64b:
-                        results_file_ << "64" << ",";
-                        break;
+            case CHUNK_64b:
+                results_file_ << "64" << ",";
+                break;
 #endif
 #ifdef HAS_WORD_128
-                    case CHUNK_128b:
-                        results_file_ << "128" << ",";
-                        break;
+            case CHUNK_128b:
+                results_file_ << "128" << ",";
+                break;
 #endif
 #ifdef HAS_WORD_256
-                    case CHUNK_256b:
-                        results_file_ << "256" << ",";
-                        break;
+            case CHUNK_256b:
+                results_file_ << "256" << ",";
+                break;
 #endif
 #ifdef HAS_WORD_512
-                    case CHUNK_512b:
-                        results_file_ << "512" << ",";
-                        break;
+            case CHUNK_512b:
+                results_file_ << "512" << ",";
+                break;
 #endif
-                    default:
-                        results_file_ << "UNKNOWN" << ",";
-                        break;
-                }
+            default:
+                results_file_ << "UNKNOWN" << ",";
+                break;
+        }
 
-                results_file_ << lat_benchmarks_[i]->getStrideSize() << ",";
-            }
+        results_file_ << benchmark->getStrideSize() << ",";
+    }
 
-            results_file_ << lat_benchmarks_[i]->getMeanLoadMetric() << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
+    results_file_ << benchmark->getMeanLoadMetric() << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "MB/s" << ",";
+    results_file_ << benchmark->getMeanMetric() << ",";
+    results_file_ << benchmark->getMinMetric() << ",";
+    results_file_ << benchmark->get25PercentileMetric() << ",";
+    results_file_ << benchmark->getMedianMetric() << ",";
+    results_file_ << benchmark->get75PercentileMetric() << ",";
+    results_file_ << benchmark->get95PercentileMetric() << ",";
+    results_file_ << benchmark->get99PercentileMetric() << ",";
+    results_file_ << benchmark->getMaxMetric() << ",";
+    results_file_ << benchmark->getModeMetric() << ",";
+    results_file_ << benchmark->getMetricUnits() << ",";
+    writePowerResults(benchmark);
+    writePerfCounts(benchmark);
+    if (benchmark->getTargetLoadMetric() > 0)
+        results_file_ << benchmark->getTargetLoadMetric() << ",";
+    else
+        results_file_ << "N/A" << ",";
+    results_file_ << extension_info << ",";
+    if (g_core_ghz > 0) {
+        std::string cycles = static_cast<std::ostringstream*>(&(std::ostringstream() << benchmark->getMeanMetric() * g_core_ghz << " core cycles/access mean at " << g_core_ghz << " GHz"))->str();
+        notes = notes.empty() ? cycles : notes + "; " + cycles;
+    }
+    std::string placement = placementNotes();
+    if (!placement.empty())
+        notes = notes.empty() ? placement : notes + "; " + placement;
+    results_file_ << notes << ",";
+    results_file_ << std::endl;
+}
+
+void BenchmarkManager::writeCoreToCoreResults(CoreToCoreLatencyBenchmark* benchmark) {
+    std::vector<int32_t> cpus = benchmark->getCpus();
+    std::vector<uint32_t> cpu_nodes = benchmark->getCpuNodes();
+
+    for (uint32_t from = 0; from < cpus.size(); from++) {
+        for (uint32_t to = 0; to < cpus.size(); to++) {
+            if (from == to)
+                continue;
+
+            results_file_ << benchmark->getName() << ",";
+            results_file_ << benchmark->getIterations() << ",";
             results_file_ << "N/A" << ",";
+            results_file_ << benchmark->getNumThreads() << ",";
+            results_file_ << 0 << ",";
+            results_file_ << benchmark->getMemNode() << ",";
+            results_file_ << cpu_nodes[from] << ",";
+            for (uint32_t i = 0; i < 14; i++) //Load pattern, mix, chunk, stride, throughput stats and units
+                results_file_ << "N/A" << ",";
+            results_file_ << benchmark->getTransferLatency(from, to) << ",";
+            for (uint32_t i = 0; i < 8; i++) //Latency distribution is not kept per CPU pair
+                results_file_ << "N/A" << ",";
+            results_file_ << benchmark->getMetricUnits() << ",";
+            writePowerResults(benchmark);
+            writePerfCounts(benchmark);
             results_file_ << "N/A" << ",";
+            results_file_ << "CPU " << cpus[from] << " node " << cpu_nodes[from] << " -> CPU " << cpus[to] << " node " << cpu_nodes[to] << ",";
+            results_file_ << "one-way cache line transfer latency" << ",";
+            results_file_ << std::endl;
+        }
+    }
+}
+
+void BenchmarkManager::writeCoherenceLatencyResults(CoherenceLatencyBenchmark* benchmark) {
+    results_file_ << benchmark->getName() << ",";
+    results_file_ << benchmark->getIterations() << ",";
+    results_file_ << static_cast<size_t>(LATENCY_BENCHMARK_UNROLL_LENGTH * CACHE_LINE_SIZE / KB) << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    results_file_ << 0 << ",";
+    results_file_ << benchmark->getMemNode() << ",";
+    results_file_ << benchmark->getCPUNode() << ",";
+    for (uint32_t i = 0; i < 14; i++) //Load pattern, mix, chunk, stride, throughput stats and units
+        results_file_ << "N/A" << ",";
+    results_file_ << benchmark->getMeanMetric() << ",";
+    results_file_ << benchmark->getMinMetric() << ",";
+    results_file_ << benchmark->get25PercentileMetric() << ",";
+    results_file_ << benchmark->getMedianMetric() << ",";
+    results_file_ << benchmark->get75PercentileMetric() << ",";
+    results_file_ << benchmark->get95PercentileMetric() << ",";
+    results_file_ << benchmark->get99PercentileMetric() << ",";
+    results_file_ << benchmark->getMaxMetric() << ",";
+    results_file_ << benchmark->getModeMetric() << ",";
+    results_file_ << benchmark->getMetricUnits() << ",";
+    writePowerResults(benchmark);
+    writePerfCounts(benchmark);
+    results_file_ << "N/A" << ",";
+    results_file_ << "state " << CoherenceLatencyBenchmark::coherenceStateName(benchmark->getCoherenceState());
+    if (benchmark->getNumThreads() > 1)
+        results_file_ << " prepared on CPU node " << benchmark->getPreparerCPUNode();
+    results_file_ << ",";
+    results_file_ << ",";
+    results_file_ << std::endl;
+}
+
+void BenchmarkManager::writeAtomicResults(AtomicBenchmark* benchmark) {
+    results_file_ << benchmark->getName() << ",";
+    results_file_ << benchmark->getIterations() << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    std::vector<uint32_t> spread_cpu_nodes = benchmark->getSpreadCPUNodes();
+    results_file_ << benchmark->getMemNode() << ",";
+    if (spread_cpu_nodes.empty())
+        results_file_ << benchmark->getCPUNode() << ",";
+    else
+        results_file_ << "N/A" << ",";
+    for (uint32_t i = 0; i < 4; i++) //Load pattern, mix, chunk, stride
+        results_file_ << "N/A" << ",";
+    results_file_ << benchmark->getMeanThroughput() << ",";
+    for (uint32_t i = 0; i < 8; i++) //Throughput distribution is not kept
+        results_file_ << "N/A" << ",";
+    results_file_ << "Mops/s" << ",";
+    results_file_ << benchmark->getMeanMetric() << ",";
+    results_file_ << benchmark->getLatencyPercentile(0) << ",";
+    results_file_ << benchmark->getLatencyPercentile(25) << ",";
+    results_file_ << benchmark->getLatencyPercentile(50) << ",";
+    results_file_ << benchmark->getLatencyPercentile(75) << ",";
+    results_file_ << benchmark->getLatencyPercentile(95) << ",";
+    results_file_ << benchmark->getLatencyPercentile(99) << ",";
+    results_file_ << benchmark->getLatencyPercentile(100) << ",";
+    results_file_ << benchmark->getLatencyMode() << ",";
+    results_file_ << benchmark->getMetricUnits() << ",";
+    writePowerResults(benchmark);
+    writePerfCounts(benchmark);
+    results_file_ << "N/A" << ",";
+    results_file_ << AtomicBenchmark::atomicOpName(benchmark->getAtomicOp()) << " on " << benchmark->getNumLines() << " shared line(s)";
+    if (!spread_cpu_nodes.empty()) {
+        results_file_ << " with threads round-robin over CPU nodes";
+        for (uint32_t n = 0; n < spread_cpu_nodes.size(); n++)
+            results_file_ << " " << spread_cpu_nodes[n];
+    }
+    results_file_ << ",";
+    results_file_ << "latency percentiles are over " << ATOMIC_BENCHMARK_BATCH_OPS << "-op samples" << ",";
+    results_file_ << std::endl;
+}
+
+#ifdef EXT_MEMCPY_BENCHMARK
+void BenchmarkManager::writeMemcpyResults(MemcpyBenchmark* benchmark, std::string notes) {
+    results_file_ << benchmark->getName() << ",";
+    results_file_ << benchmark->getIterations() << ",";
+    results_file_ << static_cast<double>(benchmark->getSize()) / KB << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    results_file_ << 0 << ",";
+    results_file_ << benchmark->getMemNode() << ",";
+    results_file_ << benchmark->getCPUNode() << ",";
+    for (uint32_t i = 0; i < 4; i++) //Load pattern, mix, chunk, stride
+        results_file_ << "N/A" << ",";
+    results_file_ << benchmark->getMeanMetric() << ",";
+    results_file_ << benchmark->getMinMetric() << ",";
+    results_file_ << benchmark->get25PercentileMetric() << ",";
+    results_file_ << benchmark->getMedianMetric() << ",";
+    results_file_ << benchmark->get75PercentileMetric() << ",";
+    results_file_ << benchmark->get95PercentileMetric() << ",";
+    results_file_ << benchmark->get99PercentileMetric() << ",";
+    results_file_ << benchmark->getMaxMetric() << ",";
+    results_file_ << benchmark->getModeMetric() << ",";
+    results_file_ << benchmark->getMetricUnits() << ",";
+    for (uint32_t i = 0; i < 9; i++) //No latency measurement
+        results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    writePowerResults(benchmark);
+    writePerfCounts(benchmark);
+    results_file_ << "N/A" << ",";
+    results_file_ << (benchmark->isFill() ? "memset " : "memcpy ") << bulk_strategy_name(benchmark->getStrategy());
+    if (!benchmark->isFill())
+        results_file_ << (benchmark->isMisaligned() ? " misaligned" : " aligned");
+    results_file_ << " " << benchmark->getSize() << " B" << ",";
+    results_file_ << notes << ",";
+    results_file_ << std::endl;
+}
+#endif
+
+void BenchmarkManager::writeGatherResults(GatherBenchmark* benchmark) {
+    results_file_ << benchmark->getName() << ",";
+    results_file_ << benchmark->getIterations() << ",";
+    results_file_ << static_cast<size_t>(benchmark->getLen() / benchmark->getNumThreads() / KB) << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    results_file_ << benchmark->getMemNode() << ",";
+    results_file_ << benchmark->getCPUNode() << ",";
+    results_file_ << "RANDOM" << ",";
+    results_file_ << (benchmark->getRWMode() == READ ? "READ" : "WRITE") << ",";
+    results_file_ << 64 << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << benchmark->getMeanMetric() << ",";
+    results_file_ << benchmark->getMinMetric() << ",";
+    results_file_ << benchmark->get25PercentileMetric() << ",";
+    results_file_ << benchmark->getMedianMetric() << ",";
+    results_file_ << benchmark->get75PercentileMetric() << ",";
+    results_file_ << benchmark->get95PercentileMetric() << ",";
+    results_file_ << benchmark->get99PercentileMetric() << ",";
+    results_file_ << benchmark->getMaxMetric() << ",";
+    results_file_ << benchmark->getModeMetric() << ",";
+    results_file_ << benchmark->getMetricUnits() << ",";
+    for (uint32_t i = 0; i < 9; i++) //No latency measurement
+        results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    writePowerResults(benchmark);
+    writePerfCounts(benchmark);
+    results_file_ << "N/A" << ",";
+    results_file_ << GatherBenchmark::gatherKernelName(benchmark->getGatherKernel()) << (benchmark->getRWMode() == READ ? " gather" : " scatter") << ",";
+    results_file_ << benchmark->getMeanElementRate() << " M elements/s" << ",";
+    results_file_ << std::endl;
+}
+
+void BenchmarkManager::writePageFaultResults(PageFaultBenchmark* benchmark) {
+    results_file_ << benchmark->getName() << ",";
+    results_file_ << benchmark->getIterations() << ",";
+    results_file_ << static_cast<size_t>(benchmark->getLen() / benchmark->getNumThreads() / KB) << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    results_file_ << benchmark->getMemNode() << ",";
+    results_file_ << benchmark->getCPUNode() << ",";
+    results_file_ << "SEQUENTIAL" << ",";
+    results_file_ << "WRITE" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << benchmark->getMeanMetric() << ",";
+    results_file_ << benchmark->getMinMetric() << ",";
+    results_file_ << benchmark->get25PercentileMetric() << ",";
+    results_file_ << benchmark->getMedianMetric() << ",";
+    results_file_ << benchmark->get75PercentileMetric() << ",";
+    results_file_ << benchmark->get95PercentileMetric() << ",";
+    results_file_ << benchmark->get99PercentileMetric() << ",";
+    results_file_ << benchmark->getMaxMetric() << ",";
+    results_file_ << benchmark->getModeMetric() << ",";
+    results_file_ << benchmark->getMetricUnits() << ",";
+    for (uint32_t i = 0; i < 9; i++) //No latency measurement
+        results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    writePowerResults(benchmark);
+    writePerfCounts(benchmark);
+    results_file_ << "N/A" << ",";
+    results_file_ << PageFaultBenchmark::settingName(benchmark->getPageBacking(), benchmark->usesMemfd(), benchmark->getFaultMode()) << ",";
+    results_file_ << benchmark->getMeanFaultRate() << " faults/s; " << benchmark->getMeanFaults() << " faults per iteration" << ",";
+    results_file_ << std::endl;
+}
+
+void BenchmarkManager::writePageMigrationResults(PageMigrationBenchmark* benchmark) {
+    results_file_ << benchmark->getName() << ",";
+    results_file_ << benchmark->getIterations() << ",";
+    results_file_ << static_cast<size_t>(benchmark->getLen() / KB) << ",";
+    results_file_ << 1 << ",";
+    results_file_ << 0 << ",";
+    results_file_ << benchmark->getMemNode() << ",";
+    results_file_ << benchmark->getCPUNode() << ",";
+    for (uint32_t i = 0; i < 4; i++) //No load
+        results_file_ << "N/A" << ",";
+    results_file_ << benchmark->getMeanMetric() << ",";
+    results_file_ << benchmark->getMinMetric() << ",";
+    results_file_ << benchmark->get25PercentileMetric() << ",";
+    results_file_ << benchmark->getMedianMetric() << ",";
+    results_file_ << benchmark->get75PercentileMetric() << ",";
+    results_file_ << benchmark->get95PercentileMetric() << ",";
+    results_file_ << benchmark->get99PercentileMetric() << ",";
+    results_file_ << benchmark->getMaxMetric() << ",";
+    results_file_ << benchmark->getModeMetric() << ",";
+    results_file_ << benchmark->getMetricUnits() << ",";
+    results_file_ << benchmark->getMeanMigrationLatency() << ",";
+    for (uint32_t i = 0; i < 8; i++) //Only the mean is kept
+        results_file_ << "N/A" << ",";
+    results_file_ << "ns/access" << ",";
+    writePowerResults(benchmark);
+    writePerfCounts(benchmark);
+    results_file_ << "N/A" << ",";
+    results_file_ << PageMigrationBenchmark::backingName(benchmark->getPageBacking()) << " pages to node " << benchmark->getDstNode() << ",";
+    results_file_ << benchmark->getMeanPageRate() << " pages/s; " << benchmark->getMeanBaselineLatency() << " ns/access without migration" << ",";
+    results_file_ << std::endl;
+}
+
+void BenchmarkManager::writeTlbReachResults(TlbReachBenchmark* benchmark, std::string extension_info, std::string notes) {
+    results_file_ << benchmark->getName() << ",";
+    results_file_ << benchmark->getIterations() << ",";
+    results_file_ << static_cast<size_t>(benchmark->getLen() / KB) << ",";
+    results_file_ << 1 << ",";
+    results_file_ << 0 << ",";
+    results_file_ << benchmark->getMemNode() << ",";
+    results_file_ << benchmark->getCPUNode() << ",";
+    for (uint32_t i = 0; i < 4; i++) //No load
+        results_file_ << "N/A" << ",";
+    for (uint32_t i = 0; i < 9; i++) //No throughput measurement
+        results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << benchmark->getMeanMetric() << ",";
+    results_file_ << benchmark->getMinMetric() << ",";
+    results_file_ << benchmark->get25PercentileMetric() << ",";
+    results_file_ << benchmark->getMedianMetric() << ",";
+    results_file_ << benchmark->get75PercentileMetric() << ",";
+    results_file_ << benchmark->get95PercentileMetric() << ",";
+    results_file_ << benchmark->get99PercentileMetric() << ",";
+    results_file_ << benchmark->getMaxMetric() << ",";
+    results_file_ << benchmark->getModeMetric() << ",";
+    results_file_ << benchmark->getMetricUnits() << ",";
+    writePowerResults(benchmark);
+    writePerfCounts(benchmark);
+    results_file_ << "N/A" << ",";
+    results_file_ << extension_info << ",";
+    results_file_ << notes << ",";
+    results_file_ << std::endl;
+}
+
+void BenchmarkManager::writeWorkloadMixResults(WorkloadMixBenchmark* benchmark, std::string extension_info) {
+    //One row per worker thread. Only the mean is kept per thread, and power is reported once on the aggregate row.
+    for (uint32_t t = 0; t < benchmark->getNumThreads(); t++) {
+        workload_thread_t spec = benchmark->getThreadSpec(t);
+        results_file_ << benchmark->getName() << " thread " << t << ",";
+        results_file_ << benchmark->getIterations() << ",";
+        results_file_ << static_cast<size_t>(spec.working_set_size / KB) << ",";
+        results_file_ << 1 << ",";
+        results_file_ << (spec.latency_probe ? 0 : 1) << ",";
+        results_file_ << spec.mem_node << ",";
+        results_file_ << spec.cpu_node << ",";
+        if (spec.latency_probe) {
+            for (uint32_t i = 0; i < 4; i++) //No load
+                results_file_ << "N/A" << ",";
+            for (uint32_t i = 0; i < 9; i++) //No throughput measurement
+                results_file_ << "N/A" << ",";
             results_file_ << "N/A" << ",";
-            results_file_ << "MB/s" << ",";
-            results_file_ << lat_benchmarks_[i]->getMeanMetric() << ",";
-            results_file_ << lat_benchmarks_[i]->getMinMetric() << ",";
-            results_file_ << lat_benchmarks_[i]->get25PercentileMetric() << ",";
-            results_file_ << lat_benchmarks_[i]->getMedianMetric() << ",";
-            results_file_ << lat_benchmarks_[i]->get75PercentileMetric() << ",";
-            results_file_ << lat_benchmarks_[i]->get95PercentileMetric() << ",";
-            results_file_ << lat_benchmarks_[i]->get99PercentileMetric() << ",";
-            results_file_ << lat_benchmarks_[i]->getMaxMetric() << ",";
-            results_file_ << lat_benchmarks_[i]->getModeMetric() << ",";
-            results_file_ << lat_benchmarks_[i]->getMetricUnits() << ",";
-            for (uint32_t j = 0; j < g_num_physical_packages; j++) {
-                results_file_ << lat_benchmarks_[i]->getMeanDRAMPower(j) << ",";
-                results_file_ << lat_benchmarks_[i]->getPeakDRAMPower(j) << ",";
-            }
+            results_file_ << benchmark->getThreadMeanMetric(t) << ",";
+            for (uint32_t i = 0; i < 8; i++) //Only the mean is kept per thread
+                results_file_ << "N/A" << ",";
+            results_file_ << "ns/access" << ",";
+        } else {
+            results_file_ << (spec.pattern_mode == SEQUENTIAL ? "SEQUENTIAL" : "RANDOM") << ",";
+            results_file_ << (spec.rw_mode == READ ? "READ" : "WRITE") << ",";
+            results_file_ << WorkloadMixBenchmark::chunkSizeBits(spec.chunk_size) << ",";
+            if (spec.pattern_mode == SEQUENTIAL)
+                results_file_ << spec.stride_size << ",";
+            else
+                results_file_ << "N/A" << ",";
+            results_file_ << benchmark->getThreadMeanMetric(t) << ",";
+            for (uint32_t i = 0; i < 8; i++) //Only the mean is kept per thread
+                results_file_ << "N/A" << ",";
+            results_file_ << benchmark->getMetricUnits() << ",";
+            for (uint32_t i = 0; i < 9; i++) //No latency measurement
+                results_file_ << "N/A" << ",";
             results_file_ << "N/A" << ",";
-            results_file_ << "" << ",";
-            results_file_ << std::endl;
         }
+        writePowerResults(NULL);
+        writePerfCounts(NULL);
+        results_file_ << "N/A" << ",";
+        results_file_ << WorkloadMixBenchmark::workloadThreadName(spec) << ",";
+        results_file_ << "per-thread" << ",";
+        results_file_ << std::endl;
     }
 
-    if (g_verbose)
-        std::cout << std::endl << "Done running latency benchmarks." << std::endl;
+    //Aggregate row
+    results_file_ << benchmark->getName() << ",";
+    results_file_ << benchmark->getIterations() << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << benchmark->getNumThreads() << ",";
+    results_file_ << benchmark->getNumLoadThreads() << ",";
+    results_file_ << "N/A" << ",";
+    results_file_ << "N/A" << ",";
+    for (uint32_t i = 0; i < 4; i++) //Mixed load
+        results_file_ << "MIXED" << ",";
+    results_file_ << benchmark->getMeanMetric() << ",";
+    results_file_ << benchmark->getMinMetric() << ",";
+    results_file_ << benchmark->get25PercentileMetric() << ",";
+    results_file_ << benchmark->getMedianMetric() << ",";
+    results_file_ << benchmark->get75PercentileMetric() << ",";
+    results_file_ << benchmark->get95PercentileMetric() << ",";
+    results_file_ << benchmark->get99PercentileMetric() << ",";
+    results_file_ << benchmark->getMaxMetric() << ",";
+    results_file_ << benchmark->getModeMetric() << ",";
+    results_file_ << benchmark->getMetricUnits() << ",";
+    if (benchmark->getMeanProbeLatency() > 0)
+        results_file_ << benchmark->getMeanProbeLatency() << ",";
+    else
+        results_file_ << "N/A" << ",";
+    for (uint32_t i = 0; i < 8; i++) //Only the mean probe latency is kept
+        results_file_ << "N/A" << ",";
+    results_file_ << "ns/access" << ",";
+    writePowerResults(benchmark);
+    writePerfCounts(benchmark);
+    results_file_ << "N/A" << ",";
+    results_file_ << extension_info << ",";
+    results_file_ << "aggregate" << ",";
+    results_file_ << std::endl;
+}
 
-    return true;
+uint32_t BenchmarkManager::findLatencyCurveKnee(const std::vector<double>& load, const std::vector<double>& latency) const {
+    uint32_t n = static_cast<uint32_t>(load.size());
+    if (n < 3 || latency.size() != n) //Need at least one point between the endpoints
+        return 0;
+
+    double min_load = load[0], max_load = load[0];
+    double min_latency = latency[0], max_latency = latency[0];
+    for (uint32_t i = 1; i < n; i++) {
+        if (load[i] < min_load) min_load = load[i];
+        if (load[i] > max_load) max_load = load[i];
+        if (latency[i] < min_latency) min_latency = latency[i];
+        if (latency[i] > max_latency) max_latency = latency[i];
+    }
+    if (max_load <= min_load || max_latency <= min_latency) //Flat curve, no knee to speak of
+        return 0;
+
+    //Normalize both axes to [0,1]
+    std::vector<double> x, y;
+    for (uint32_t i = 0; i < n; i++) {
+        x.push_back((load[i] - min_load) / (max_load - min_load));
+        y.push_back((latency[i] - min_latency) / (max_latency - min_latency));
+    }
+
+    //The knee is the point lying furthest below the chord from the first to the last point.
+    //Rescaling the curve does not move it, and it is robust to the unthrottled level bunching up against the previous one.
+    double dx = x[n-1] - x[0];
+    double dy = y[n-1] - y[0];
+    double chord_len = std::sqrt(dx*dx + dy*dy);
+    uint32_t knee = 0; //If nothing lies below the chord, latency climbs from the very first load level
+    double best = 0;
+    for (uint32_t i = 1; i < n-1; i++) {
+        double below = (dy * (x[i] - x[0]) - dx * (y[i] - y[0])) / chord_len; //Signed distance, positive when below the chord
+        if (below > best) {
+            best = below;
+            knee = i;
+        }
+    }
+
+    return knee;
 }
 
 void BenchmarkManager::setupWorkingSets(size_t working_set_size) {
@@ -424,21 +2209,50 @@ void BenchmarkManager::setupWorkingSets(size_t working_set_size) {
     //We reserve the space for these, but that doesn't mean they will all be used.
     mem_arrays_.resize(g_num_numa_nodes);
     mem_array_lens_.resize(g_num_numa_nodes);
+    region_layouts_.resize(g_num_numa_nodes);
+    placement_checked_.resize(g_num_numa_nodes, false);
+#if defined(__gnu_linux__) && defined(HAS_LARGE_PAGES)
+    large_page_maps_.resize(g_num_numa_nodes);
+    large_page_map_lens_.resize(g_num_numa_nodes);
+#endif
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+    backed_maps_.resize(g_num_numa_nodes);
+    backed_map_lens_.resize(g_num_numa_nodes);
+    backed_fds_.resize(g_num_numa_nodes, -1);
+#endif
 
     for (auto it = memory_numa_node_affinities_.cbegin(); it != memory_numa_node_affinities_.cend(); it++) {
         size_t allocation_size = 0;
         uint32_t numa_node = *it;
 
+        //Enough for every worker thread to have its own working set, or for all workload mix or all-to-all threads placed on this node, whichever is larger
+        size_t node_len = config_.getNumWorkerThreads() * working_set_size;
+        if (config_.workloadSelected()) {
+            std::vector<workload_thread_t> workload = config_.getWorkload();
+            size_t workload_len = 0;
+            for (uint32_t t = 0; t < workload.size(); t++) {
+                if (workload[t].mem_node == numa_node)
+                    workload_len += workload[t].working_set_size;
+            }
+            if (workload_len > node_len)
+                node_len = workload_len;
+        }
+        if (config_.allToAllSelected()) {
+            std::vector<workload_thread_t> workload = config_.getAllToAllWorkload();
+            size_t workload_len = 0;
+            for (uint32_t t = 0; t < workload.size(); t++) {
+                if (workload[t].mem_node == numa_node)
+                    workload_len += workload[t].working_set_size;
+            }
+            if (workload_len > node_len)
+                node_len = workload_len;
+        }
+
 #ifdef HAS_LARGE_PAGES
         if (config_.useLargePages()) {
-            size_t remainder = 0;
-            //For large pages, working set size could be less than a single large page. So let's allocate the right amount of memory, which is the working set size rounded up to nearest large page, which could be more than we actually use.
-            if (config_.getNumWorkerThreads() * working_set_size < g_large_page_size)
-                allocation_size = g_large_page_size;
-            else {
-                remainder = (config_.getNumWorkerThreads() * working_set_size) % g_large_page_size;
-                allocation_size = (config_.getNumWorkerThreads() * working_set_size) + remainder;
-            }
+            //For large pages, working set size could be less than a single large page or not a multiple of one. So let's allocate the right amount of memory, which is the working set size rounded up to the nearest large page, which could be more than we actually use.
+            size_t large_page_size = config_.getLargePageSize();
+            allocation_size = ((node_len + large_page_size - 1) / large_page_size) * large_page_size;
 
 #ifdef _WIN32
             //Make sure we have necessary privileges
@@ -456,19 +2270,35 @@ void BenchmarkManager::setupWorkingSets(size_t working_set_size) {
             mem_arrays_[numa_node] = VirtualAllocExNuma(GetCurrentProcess(), NULL, allocation_size, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE, numa_node); //Windows NUMA allocation. Make the allocation one page bigger than necessary so that we can do alignment.
 #endif
 #ifdef __gnu_linux__
-            mem_arrays_[numa_node] = get_huge_pages(allocation_size, GHP_DEFAULT);
+#ifdef HAS_NUMA
+            if (config_.getWorkingSetBacking() != BACKING_ANONYMOUS)
+                mem_arrays_[numa_node] = mapBackedRegion(allocation_size, numa_node);
+            else
+#endif
+                mem_arrays_[numa_node] = mapLargePages(allocation_size, numa_node);
 #endif
         } else { //Non-large pages (nominal case)
 #endif
             //Under normal (not large-page) operation, working set size is a multiple of regular pages.
-            allocation_size = config_.getNumWorkerThreads() * working_set_size + g_page_size;
+            allocation_size = node_len + g_page_size;
 #ifdef _WIN32
             mem_arrays_[numa_node] = VirtualAllocExNuma(GetCurrentProcess(), NULL, allocation_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE, numa_node); //Windows NUMA allocation. Make the allocation one page bigger than necessary so that we can do alignment.
 #endif
 #ifdef __gnu_linux__
 #ifdef HAS_NUMA
-            numa_set_strict(1); //Enforce NUMA memory allocation to land on specified node or fail otherwise. Alternative node fallback is forbidden.
-            mem_arrays_[numa_node] = numa_alloc_onnode(allocation_size, numa_node);
+            if (config_.getWorkingSetBacking() != BACKING_ANONYMOUS)
+                mem_arrays_[numa_node] = mapBackedRegion(allocation_size, numa_node);
+            else if (config_.getPlacementPolicy() == PLACEMENT_INTERLEAVE) {
+                mem_arrays_[numa_node] = mmap(NULL, allocation_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0); //Freed with numa_free(), which unmaps
+                if (mem_arrays_[numa_node] == MAP_FAILED || !bindRegion(mem_arrays_[numa_node], allocation_size, numa_node)) {
+                    if (mem_arrays_[numa_node] != MAP_FAILED)
+                        munmap(mem_arrays_[numa_node], allocation_size);
+                    mem_arrays_[numa_node] = nullptr;
+                }
+            } else {
+                numa_set_strict(1); //Enforce NUMA memory allocation to land on specified node or fail otherwise. Alternative node fallback is forbidden.
+                mem_arrays_[numa_node] = numa_alloc_onnode(allocation_size, numa_node);
+            }
 #endif
 #ifndef HAS_NUMA //special case
             mem_arrays_[numa_node] = malloc(allocation_size);
@@ -480,7 +2310,7 @@ void BenchmarkManager::setupWorkingSets(size_t working_set_size) {
 #endif
 
         if (mem_arrays_[numa_node] != nullptr)
-            mem_array_lens_[numa_node] = config_.getNumWorkerThreads() * working_set_size;
+            mem_array_lens_[numa_node] = node_len;
         else {
             std::cerr << "ERROR: Failed to allocate " << allocation_size << " B on NUMA node " << numa_node << " for " << config_.getNumWorkerThreads() << " worker threads." << std::endl;
             exit(-1);
@@ -495,7 +2325,7 @@ void BenchmarkManager::setupWorkingSets(size_t working_set_size) {
         //upwards alignment to page boundary
         uintptr_t mask;
         if (config_.useLargePages())
-            mask = static_cast<uintptr_t>(g_large_page_size)-1;
+            mask = static_cast<uintptr_t>(config_.getLargePageSize())-1;
         else
             mask = static_cast<uintptr_t>(g_page_size)-1; //e.g. 4095 bytes
         uintptr_t tmp_ptr = reinterpret_cast<uintptr_t>(mem_arrays_[numa_node]);
@@ -507,7 +2337,385 @@ void BenchmarkManager::setupWorkingSets(size_t working_set_size) {
             std::printf("0x%.16llX", reinterpret_cast<long long unsigned int>(mem_arrays_[numa_node]));
             std::cout << std::endl;
         }
+
+        //Nothing is faulted in here. The first benchmark on the region writes it from the logical CPUs its worker threads run on in setupCore(), and its placement is checked once that is done.
+    }
+}
+
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+bool BenchmarkManager::bindRegion(void* addr, size_t len, uint32_t numa_node) {
+    struct bitmask* nodes = numa_allocate_nodemask();
+    bool ok = true;
+
+    if (config_.getPlacementPolicy() == PLACEMENT_INTERLEAVE) {
+        std::list<uint32_t> interleave_nodes = config_.getMemoryNumaNodeAffinities();
+        size_t granularity = config_.getInterleaveGranularity();
+        size_t page_size = config_.useLargePages() ? config_.getLargePageSize() : g_page_size;
+        if (granularity == page_size) { //The kernel interleaves page by page on its own
+            for (auto it = interleave_nodes.cbegin(); it != interleave_nodes.cend(); it++)
+                numa_bitmask_setbit(nodes, *it);
+            ok = (mbind(addr, len, MPOL_INTERLEAVE, nodes->maskp, nodes->size + 1, MPOL_MF_STRICT) == 0);
+        } else { //Coarser granules are bound one by one, round-robin over the nodes
+            std::vector<uint32_t> node_order(interleave_nodes.cbegin(), interleave_nodes.cend());
+            uint8_t* granule = reinterpret_cast<uint8_t*>(addr);
+            uint8_t* end = granule + len;
+            for (size_t g = 0; ok && granule < end; g++, granule += granularity) {
+                numa_bitmask_clearall(nodes);
+                numa_bitmask_setbit(nodes, node_order[g % node_order.size()]);
+                size_t granule_len = (end - granule < static_cast<ptrdiff_t>(granularity)) ? static_cast<size_t>(end - granule) : granularity;
+                ok = (mbind(granule, granule_len, MPOL_BIND, nodes->maskp, nodes->size + 1, MPOL_MF_STRICT) == 0);
+            }
+        }
+    } else { //Node and local placement both bind to exactly the requested node. Alternative node fallback is forbidden, as with numa_set_strict().
+        numa_bitmask_setbit(nodes, numa_node);
+        ok = (mbind(addr, len, MPOL_BIND, nodes->maskp, nodes->size + 1, MPOL_MF_STRICT) == 0);
+    }
+
+    if (!ok)
+        std::cerr << "ERROR: Failed to set the memory placement policy for NUMA node " << numa_node << " (" << strerror(errno) << ")." << std::endl;
+    numa_free_nodemask(nodes);
+    return ok;
+}
+#endif
+
+void BenchmarkManager::checkPlacementOfResidentRegions() {
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+    for (auto it = memory_numa_node_affinities_.cbegin(); it != memory_numa_node_affinities_.cend(); it++) {
+        uint32_t numa_node = *it;
+        if (!placement_checked_[numa_node] && region_layouts_[numa_node].resident_len >= mem_array_lens_[numa_node]) {
+            verifyPlacement(numa_node);
+            placement_checked_[numa_node] = true;
+        }
+    }
+#endif
+}
+
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+void BenchmarkManager::verifyPlacement(uint32_t numa_node) {
+    uint8_t* region = reinterpret_cast<uint8_t*>(mem_arrays_[numa_node]);
+    size_t len = mem_array_lens_[numa_node];
+    size_t page_size = config_.useLargePages() ? config_.getLargePageSize() : g_page_size; //A large page is on a single node, so one query per large page suffices
+    size_t num_pages = (len + page_size - 1) / page_size;
+
+    //Query the node of every page in batches
+    const size_t batch = 4096;
+    std::vector<void*> pages(batch);
+    std::vector<int> status(batch);
+    std::vector<size_t> pages_on_node(g_num_numa_nodes, 0);
+    size_t not_present = 0;
+    for (size_t first = 0; first < num_pages; first += batch) {
+        size_t count = (num_pages - first < batch) ? num_pages - first : batch;
+        for (size_t i = 0; i < count; i++)
+            pages[i] = region + (first + i) * page_size;
+        if (move_pages(0, count, pages.data(), NULL, status.data(), 0) != 0) {
+            std::cerr << "WARNING: Could not check the placement of the memory under test for NUMA node " << numa_node << " (" << strerror(errno) << ")." << std::endl;
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (status[i] >= 0 && static_cast<uint32_t>(status[i]) < g_num_numa_nodes)
+                pages_on_node[status[i]]++;
+            else
+                not_present++;
+        }
+    }
+
+    //Compare against the policy. Interleaved pages should be spread evenly, give or take one granule.
+    size_t misplaced = not_present;
+    if (config_.getPlacementPolicy() == PLACEMENT_INTERLEAVE) {
+        std::list<uint32_t> interleave_nodes = config_.getMemoryNumaNodeAffinities();
+        size_t fair_share = num_pages / interleave_nodes.size();
+        size_t slack = config_.getInterleaveGranularity() / page_size + 1;
+        size_t in_set = 0;
+        for (auto it = interleave_nodes.cbegin(); it != interleave_nodes.cend(); it++) {
+            in_set += pages_on_node[*it];
+            if (pages_on_node[*it] + slack < fair_share)
+                misplaced += fair_share - pages_on_node[*it];
+        }
+        misplaced += num_pages - not_present - in_set;
+    } else
+        misplaced += num_pages - not_present - pages_on_node[numa_node];
+
+    if (misplaced > 0)
+        std::cerr << "WARNING: " << misplaced << " of " << num_pages << " pages of the memory under test for NUMA node " << numa_node << " are not placed as the placement policy requires." << std::endl;
+    if (g_verbose || misplaced > 0 || config_.getPlacementPolicy() != PLACEMENT_NODE) {
+        std::cout << "Placement of " << num_pages << " pages of " << page_size / KB << " KB for memory NUMA node " << numa_node << ":";
+        for (uint32_t n = 0; n < g_num_numa_nodes; n++) {
+            if (pages_on_node[n] > 0)
+                std::cout << " node " << n << ": " << pages_on_node[n];
+        }
+        if (not_present > 0)
+            std::cout << " not present: " << not_present;
+        std::cout << std::endl;
+    }
+}
+
+int BenchmarkManager::createBackingFile(size_t len, bool hugetlb) {
+    int fd = -1;
+    if (config_.getWorkingSetBacking() == BACKING_MEMFD) {
+        unsigned int flags = 0;
+        if (hugetlb) {
+            int page_shift = 0;
+            while ((static_cast<size_t>(1) << page_shift) < config_.getLargePageSize())
+                page_shift++;
+            flags = MFD_HUGETLB | (page_shift << MFD_HUGE_SHIFT);
+        }
+        fd = memfd_create("xmem", flags);
+    } else {
+        std::string directory = config_.getBackingDirectory();
+#ifdef O_TMPFILE
+        fd = open(directory.c_str(), O_TMPFILE | O_RDWR, 0600);
+#endif
+        if (fd < 0) { //Not every file system supports unnamed temporary files
+            std::string path = directory + "/xmem-XXXXXX";
+            std::vector<char> name(path.begin(), path.end());
+            name.push_back('\0');
+            fd = mkstemp(&name[0]);
+            if (fd >= 0)
+                unlink(&name[0]);
+        }
+    }
+
+    if (fd >= 0 && ftruncate(fd, len) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+void* BenchmarkManager::mapBackedRegion(size_t allocation_size, uint32_t numa_node) {
+    int flags = config_.useMapPrivate() ? MAP_PRIVATE : MAP_SHARED;
+    bool large_pages = config_.useLargePages();
+    size_t large_page_size = config_.getLargePageSize();
+    int fd = -1;
+    void* map_start = MAP_FAILED;
+    size_t map_len = allocation_size;
+    void* addr = MAP_FAILED;
+
+    //Explicit huge pages of the requested size, taken from the per-node pool reserved by the administrator
+    if (large_pages && config_.getWorkingSetBacking() == BACKING_MEMFD) {
+        fd = createBackingFile(allocation_size, true);
+        if (fd >= 0) {
+            addr = mmap(NULL, map_len, PROT_READ | PROT_WRITE, flags, fd, 0);
+            bool ok = (addr != MAP_FAILED) && bindRegion(addr, map_len, numa_node);
+#ifdef MADV_POPULATE_WRITE
+            //As for anonymous large pages, fault everything in now so that a short pool on this node does not kill us with SIGBUS later
+            ok = ok && (madvise(addr, map_len, MADV_POPULATE_WRITE) == 0);
+#endif
+            if (!ok) {
+                if (addr != MAP_FAILED)
+                    munmap(addr, map_len);
+                addr = MAP_FAILED;
+                close(fd);
+                fd = -1;
+            }
+        }
+        if (fd < 0)
+            std::cerr << "WARNING: Could not get " << allocation_size / large_page_size << " large pages of " << large_page_size / KB << " KB for a memfd on NUMA node " << numa_node << ". Did you reserve enough of them on this node? Falling back to transparent huge pages." << std::endl;
+        map_start = addr;
+    }
+
+    if (fd < 0) {
+        fd = createBackingFile(allocation_size, false);
+        if (fd < 0) {
+            std::cerr << "ERROR: Failed to create the file backing the working set on NUMA node " << numa_node << " (" << strerror(errno) << ")." << std::endl;
+            return nullptr;
+        }
+
+        if (large_pages) {
+            //Transparent huge pages of a file need the address to be huge-page-aligned like the file offset. Reserve some headroom and map over an aligned part of it.
+            map_len = allocation_size + large_page_size;
+            map_start = mmap(NULL, map_len, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (map_start != MAP_FAILED) {
+                uintptr_t mask = static_cast<uintptr_t>(large_page_size) - 1;
+                void* aligned_addr = reinterpret_cast<void*>((reinterpret_cast<uintptr_t>(map_start) + mask) & ~mask);
+                addr = mmap(aligned_addr, allocation_size, PROT_READ | PROT_WRITE, flags | MAP_FIXED, fd, 0);
+            }
+        } else {
+            addr = mmap(NULL, map_len, PROT_READ | PROT_WRITE, flags, fd, 0);
+            map_start = addr;
+        }
+
+        bool ok = (addr != MAP_FAILED);
+        if (ok && large_pages && madvise(addr, allocation_size, MADV_HUGEPAGE) != 0)
+            std::cerr << "WARNING: Transparent huge pages are not available for this file (" << strerror(errno) << "). Regular-sized pages will be used on NUMA node " << numa_node << "." << std::endl;
+        ok = ok && bindRegion(addr, allocation_size, numa_node);
+        if (!ok) {
+            std::cerr << "ERROR: Failed to map the file backing the working set on NUMA node " << numa_node << " (" << strerror(errno) << ")." << std::endl;
+            if (map_start != MAP_FAILED)
+                munmap(map_start, map_len);
+            close(fd);
+            return nullptr;
+        }
+    }
+
+    backed_maps_[numa_node] = map_start;
+    backed_map_lens_[numa_node] = map_len;
+    backed_fds_[numa_node] = fd;
+    return addr;
+}
+
+void* BenchmarkManager::mapThpRegion(size_t len, size_t thp_size, uint32_t numa_node, thp_policy_t policy, void** map, size_t* map_len) {
+    *map_len = len + thp_size; //Headroom for aligning the region up to a huge page boundary
+    *map = mmap(NULL, *map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (*map == MAP_FAILED)
+        return nullptr;
+    uint8_t* region = reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(*map) + thp_size - 1) & ~(static_cast<uintptr_t>(thp_size) - 1));
+
+    int advice = -1;
+    if (policy == THP_MADV_HUGEPAGE)
+        advice = MADV_HUGEPAGE;
+    else if (policy == THP_MADV_NOHUGEPAGE || policy == THP_COLLAPSE) //Collapse starts from regular pages
+        advice = MADV_NOHUGEPAGE;
+    if (advice != -1 && madvise(region, len, advice) != 0)
+        std::cerr << "WARNING: madvise() for the THP " << thpPolicyName(policy) << " policy failed (" << strerror(errno) << ")." << std::endl;
+
+    if (!bindRegion(region, len, numa_node)) {
+        munmap(*map, *map_len);
+        return nullptr;
+    }
+    return region;
+}
+
+double BenchmarkManager::thpCoverage(void* addr, size_t len) const {
+    std::ifstream smaps("/proc/self/smaps");
+    if (!smaps.is_open())
+        return -1;
+
+    //Sum AnonHugePages over the mappings that lie within the region. The region may have been split into several by madvise() and mbind().
+    uintptr_t start = reinterpret_cast<uintptr_t>(addr);
+    uintptr_t end = start + len;
+    bool in_region = false;
+    size_t huge_kb = 0;
+    std::string line;
+    while (std::getline(smaps, line)) {
+        unsigned long vma_start = 0, vma_end = 0;
+        if (sscanf(line.c_str(), "%lx-%lx ", &vma_start, &vma_end) == 2) //A mapping header such as "7f0000000000-7f0000200000 rw-p ..."
+            in_region = (vma_start >= start && vma_end <= end);
+        else if (in_region && line.compare(0, 14, "AnonHugePages:") == 0)
+            huge_kb += static_cast<size_t>(strtoull(line.c_str() + 14, NULL, 10));
+    }
+    return static_cast<double>(huge_kb * KB) / len;
+}
+#endif
+
+bool BenchmarkManager::usesNodePair(uint32_t mem_node, uint32_t cpu_node) const {
+    return config_.getPlacementPolicy() != PLACEMENT_LOCAL || mem_node == cpu_node;
+}
+
+std::string BenchmarkManager::placementNotes() const {
+    std::ostringstream notes;
+    if (config_.getPlacementPolicy() == PLACEMENT_INTERLEAVE) {
+        std::list<uint32_t> interleave_nodes = config_.getMemoryNumaNodeAffinities();
+        notes << "memory interleaved across NUMA nodes";
+        for (auto it = interleave_nodes.cbegin(); it != interleave_nodes.cend(); it++)
+            notes << " " << *it;
+        notes << " in " << config_.getInterleaveGranularity() / KB << " KB granules";
+    }
+
+    if (config_.getWorkingSetBacking() != BACKING_ANONYMOUS) {
+        if (!notes.str().empty())
+            notes << "; ";
+        if (config_.getWorkingSetBacking() == BACKING_MEMFD)
+            notes << "memfd";
+        else
+            notes << "file in " << config_.getBackingDirectory();
+        notes << (config_.useMapPrivate() ? " private" : " shared") << " mapping";
+    }
+
+    //The directory name must not break the CSV columns
+    std::string result = notes.str();
+    std::replace(result.begin(), result.end(), ',', ' ');
+    return result;
+}
+
+#if defined(__gnu_linux__) && defined(HAS_LARGE_PAGES)
+void* BenchmarkManager::mapLargePages(size_t allocation_size, uint32_t numa_node) {
+    size_t large_page_size = config_.getLargePageSize();
+    int page_shift = 0;
+    while ((static_cast<size_t>(1) << page_shift) < large_page_size)
+        page_shift++;
+
+    //Explicit huge pages of the requested size, taken from the per-node pool reserved by the administrator
+    size_t map_len = allocation_size;
+    void* addr = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (page_shift << MAP_HUGE_SHIFT), -1, 0);
+    if (addr != MAP_FAILED) {
+        bool ok = bindRegion(addr, map_len, numa_node); //Before anything is faulted in
+#ifdef MADV_POPULATE_WRITE
+        //The pool is only reserved system-wide, so fault everything in now. Otherwise running out of pages on this node would kill us with SIGBUS on first touch instead of letting us fall back.
+        ok = ok && (madvise(addr, map_len, MADV_POPULATE_WRITE) == 0);
+#endif
+        if (!ok) {
+            munmap(addr, map_len);
+            addr = MAP_FAILED;
+        }
     }
+
+    //Fall back to transparent huge pages. These come in the PMD size only, and the kernel may back the region partly with regular pages.
+    if (addr == MAP_FAILED) {
+        std::cerr << "WARNING: Could not get " << allocation_size / large_page_size << " large pages of " << large_page_size / KB << " KB on NUMA node " << numa_node << " (" << strerror(errno) << "). Did you reserve enough of them on this node? Falling back to transparent huge pages." << std::endl;
+        map_len = allocation_size + large_page_size; //Headroom for aligning the region up to a large page boundary
+        addr = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED)
+            return nullptr;
+        if (madvise(addr, map_len, MADV_HUGEPAGE) != 0)
+            std::cerr << "WARNING: Transparent huge pages are not available (" << strerror(errno) << "). Regular-sized pages will be used on NUMA node " << numa_node << "." << std::endl;
+        if (!bindRegion(addr, map_len, numa_node)) {
+            munmap(addr, map_len);
+            return nullptr;
+        }
+    }
+
+    large_page_maps_[numa_node] = addr;
+    large_page_map_lens_[numa_node] = map_len;
+    return addr;
+}
+#endif
+
+std::string BenchmarkManager::thpPolicyName(thp_policy_t policy) const {
+    switch (policy) {
+        case THP_SYSTEM_DEFAULT:
+            return "default";
+        case THP_MADV_HUGEPAGE:
+            return "hugepage";
+        case THP_MADV_NOHUGEPAGE:
+            return "nohugepage";
+        case THP_COLLAPSE:
+            return "collapse";
+        default:
+            return "unknown";
+    }
+}
+
+chunk_size_t BenchmarkManager::largestSelectedChunk() const {
+    chunk_size_t chunk = CHUNK_32b;
+#ifdef HAS_WORD_64
+    if (config_.useChunk64b())
+        chunk = CHUNK_64b;
+#endif
+#ifdef HAS_WORD_128
+    if (config_.useChunk128b())
+        chunk = CHUNK_128b;
+#endif
+#ifdef HAS_WORD_256
+    if (config_.useChunk256b())
+        chunk = CHUNK_256b;
+#endif
+#ifdef HAS_WORD_512
+    if (config_.useChunk512b())
+        chunk = CHUNK_512b;
+#endif
+    return chunk;
+}
+
+std::string BenchmarkManager::tlbReachKindName(page_backing_t backing, size_t page_size) const {
+    if (page_size == CACHE_LINE_SIZE)
+        return "dense";
+    return static_cast<std::ostringstream*>(&(std::ostringstream() << PageMigrationBenchmark::backingName(backing) << " " << page_size / KB << " KB"))->str();
+}
+
+void BenchmarkManager::forgetPermutations() {
+    for (uint32_t i = 0; i < region_layouts_.size(); i++)
+        region_layouts_[i].slice_permutations.clear();
 }
 
 bool BenchmarkManager::buildBenchmarks() {
@@ -615,6 +2823,8 @@ bool BenchmarkManager::buildBenchmarks() {
 
         for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) { //iterate each cpu NUMA node
             uint32_t cpu_node = *cpu_node_it;
+            if (!usesNodePair(mem_node, cpu_node))
+                continue;
             bool buildLatBench = true; //Want to get at least one latency benchmark for all NUMA node combos
 
             //DO SEQUENTIAL/STRIDED TESTS
@@ -647,6 +2857,7 @@ bool BenchmarkManager::buildBenchmarks() {
                                 std::cerr << "ERROR: Failed to build a ThroughputBenchmark!" << std::endl;
                                 return false;
                             }
+                            tp_benchmarks_.back()->setRegionLayout(&region_layouts_[mem_node]);
 
                             //Add the latency benchmark
 
@@ -664,12 +2875,14 @@ bool BenchmarkManager::buildBenchmarks() {
                                                                                 chunk,
                                                                                 stride,
                                                                                 config_.getMlp(), //mlp,
+                                                                                config_.getLoadRatePerThread(),
                                                                                 dram_power_readers_,
                                                                                 benchmark_name));
                                 if (lat_benchmarks_[lat_benchmarks_.size()-1] == NULL) {
                                     std::cerr << "ERROR: Failed to build a LatencyBenchmark!" << std::endl;
                                     return false;
                                 }
+                                lat_benchmarks_.back()->setRegionLayout(&region_layouts_[mem_node]);
                                 buildLatBench = false; //Wait for next NUMA combo
                             }
 
@@ -709,6 +2922,7 @@ bool BenchmarkManager::buildBenchmarks() {
                             std::cerr << "ERROR: Failed to build a ThroughputBenchmark!" << std::endl;
                             return false;
                         }
+                        tp_benchmarks_.back()->setRegionLayout(&region_layouts_[mem_node]);
 
                         //Add the latency benchmark
                         //Special case: number of worker threads is 1, only need 1 latency thread in general to do unloaded latency tests.
@@ -725,12 +2939,14 @@ bool BenchmarkManager::buildBenchmarks() {
                                                                             chunk,
                                                                             0, //stride
                                                                             config_.getMlp(), //mlp,
+                                                                            config_.getLoadRatePerThread(),
                                                                             dram_power_readers_,
                                                                             benchmark_name));
                             if (lat_benchmarks_[lat_benchmarks_.size()-1] == NULL) {
                                 std::cerr << "ERROR: Failed to build a LatencyBenchmark!" << std::endl;
                                 return false;
                             }
+                            lat_benchmarks_.back()->setRegionLayout(&region_layouts_[mem_node]);
 
                             buildLatBench = false; //Wait for next NUMA combo
                         }
@@ -748,6 +2964,7 @@ bool BenchmarkManager::buildBenchmarks() {
 
 #ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
 bool BenchmarkManager::runExtDelayInjectedLoadedLatencyBenchmark() {
+    forgetPermutations();
     if (config_.getNumWorkerThreads() < 2) {
         std::cerr << "ERROR: Number of worker threads must be at least 1." << std::endl;
         return false;
@@ -781,6 +2998,8 @@ bool BenchmarkManager::runExtDelayInjectedLoadedLatencyBenchmark() {
 
         for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) { //iterate each cpuory NUMA node
             uint32_t cpu_node = *cpu_node_it;
+            if (!usesNodePair(mem_node, cpu_node))
+                continue;
 
             for (uint32_t chunk_index = 0; chunk_index < chunks.size(); chunk_index++) { //iterate different chunk sizes
                 chunk_size_t chunk = chunks[chunk_index];
@@ -822,108 +3041,117 @@ bool BenchmarkManager::runExtDelayInjectedLoadedLatencyBenchmark() {
 
         //Write to results file if necessary
         if (config_.useOutputFile()) {
-            results_file_ << del_lat_benchmarks[i]->getName() << ",";
-            results_file_ << del_lat_benchmarks[i]->getIterations() << ",";
-            results_file_ << static_cast<size_t>(del_lat_benchmarks[i]->getLen() / del_lat_benchmarks[i]->getNumThreads() / KB) << ",";
-            results_file_ << del_lat_benchmarks[i]->getNumThreads() << ",";
-            results_file_ << del_lat_benchmarks[i]->getNumThreads()-1 << ",";
-            results_file_ << del_lat_benchmarks[i]->getMemNode() << ",";
-            results_file_ << del_lat_benchmarks[i]->getCPUNode() << ",";
-            if (del_lat_benchmarks[i]->getNumThreads() < 2) {
-                results_file_ << "N/A" << ",";
-                results_file_ << "N/A" << ",";
-                results_file_ << "N/A" << ",";
-                results_file_ << "N/A" << ",";
-            } else {
-                pattern_mode_t pattern = del_lat_benchmarks[i]->getPatternMode();
-                switch (pattern) {
-                    case SEQUENTIAL:
-                        results_file_ << "SEQUENTIAL" << ",";
-                        break;
-                    case RANDOM:
-                        results_file_ << "RANDOM" << ",";
-                        break;
-                    default:
-                        results_file_ << "UNKNOWN" << ",";
-                        break;
-                }
-
-                rw_mode_t rw_mode = del_lat_benchmarks[i]->getRWMode();
-                switch (rw_mode) {
-                    case READ:
-                        results_file_ << "READ" << ",";
-                        break;
-                    case WRITE:
-                        results_file_ << "WRITE" << ",";
-                        break;
-                    default:
-                        results_file_ << "UNKNOWN" << ",";
-                        break;
-                }
-
-                chunk_size_t chunk_size = del_lat_benchmarks[i]->getChunkSize();
-                switch (chunk_size) {
-                    case CHUNK_32b:
-                        results_file_ << "32" << ",";
-                        break;
-#ifdef HAS_WORD_64
-                    case CHUNK_64b:
-                        results_file_ << "64" << ",";
-                        break;
-#endif
-#ifdef HAS_WORD_128
-                    case CHUNK_128b:
-                        results_file_ << "128" << ",";
-                        break;
-#endif
-#ifdef HAS_WORD_256
-                    case CHUNK_256b:
-                        results_file_ << "256" << ",";
-                        break;
-#endif
-#ifdef HAS_WORD_512
-                    case CHUNK_512b:
-                        results_file_ << "512" << ",";
-                        break;
+            std::string delay = static_cast<std::ostringstream*>(&(std::ostringstream() << del_lat_benchmarks[i]->getDelay()))->str();
+            writeLatencyResults(del_lat_benchmarks[i], delay, "<-- load threads' memory access delay value in nops");
+        }
+    }
+
+    return true;
+}
 #endif
-                    default:
-                        results_file_ << "UNKNOWN" << ",";
-                        break;
+
+#ifdef EXT_MEMCPY_BENCHMARK
+bool BenchmarkManager::runExtMemcpyBenchmark() {
+    forgetPermutations();
+    report_bulk_cpu_features();
+
+    //Put the available strategies into a vector to make constructing benchmarks more loopable
+    std::vector<bulk_strategy_t> strategies;
+    for (uint32_t s = 0; s < NUM_BULK_STRATEGIES; s++) {
+        BulkFunction kernel_fptr = NULL;
+        if (determine_bulk_kernel(false, static_cast<bulk_strategy_t>(s), &kernel_fptr))
+            strategies.push_back(static_cast<bulk_strategy_t>(s));
+    }
+
+    for (auto mem_node_it = memory_numa_node_affinities_.cbegin(); mem_node_it != memory_numa_node_affinities_.cend(); mem_node_it++) { //iterate each memory NUMA node
+        uint32_t mem_node = *mem_node_it;
+        void* mem_array = mem_arrays_[mem_node];
+        size_t mem_array_len = mem_array_lens_[mem_node];
+
+        //Double the size until the buffers no longer fit in the working set
+        std::vector<size_t> sizes;
+        for (size_t size = MEMCPY_BENCHMARK_MIN_SIZE; MemcpyBenchmark::getRequiredLen(size) <= mem_array_len; size *= 2)
+            sizes.push_back(size);
+        if (sizes.empty()) {
+            std::cerr << "ERROR: The working set on NUMA node " << mem_node << " is too small for the memcpy/memset benchmark. Try a larger working set size." << std::endl;
+            return false;
+        }
+
+        for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) { //iterate each cpu NUMA node
+            uint32_t cpu_node = *cpu_node_it;
+            if (!usesNodePair(mem_node, cpu_node))
+                continue;
+
+            for (uint32_t sweep = 0; sweep < 3; sweep++) { //aligned copy, misaligned copy, fill
+                bool fill = (sweep == 2);
+                bool misaligned = (sweep == 1);
+                std::string sweep_name = fill ? "memset" : (misaligned ? "memcpy (misaligned source)" : "memcpy (aligned source)");
+
+                //Run every strategy at every size. Keep the results until the sweep is done so that the fastest strategy can be marked.
+                std::vector<MemcpyBenchmark*> benchmarks;
+                for (uint32_t z = 0; z < sizes.size(); z++) {
+                    for (uint32_t s = 0; s < strategies.size(); s++) {
+                        std::string benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "E" << EXT_NUM_MEMCPY_BENCHMARK << " (Extension: memcpy/memset)"))->str();
+                        MemcpyBenchmark* benchmark = new MemcpyBenchmark(mem_array,
+                                                                         mem_array_len,
+                                                                         config_.getIterationsPerTest(),
+                                                                         mem_node,
+                                                                         cpu_node,
+                                                                         fill,
+                                                                         strategies[s],
+                                                                         misaligned,
+                                                                         sizes[z],
+                                                                         dram_power_readers_,
+                                                                         benchmark_name);
+                        benchmarks.push_back(benchmark);
+                        if (!benchmark->run()) {
+                            std::cerr << "ERROR: memcpy/memset benchmark failed!" << std::endl;
+                            for (uint32_t i = 0; i < benchmarks.size(); i++)
+                                delete benchmarks[i];
+                            return false;
+                        }
+                        benchmark->reportResults(); //to console
+                    }
                 }
 
-                results_file_ << del_lat_benchmarks[i]->getStrideSize() << ",";
-            }
+                //Pick the winner at each size, and note each size at which the winner changes
+                std::cout << std::endl;
+                std::cout << "*** " << sweep_name << " winners (CPU node " << cpu_node << ", memory node " << mem_node << ") ***" << std::endl;
+                std::vector<uint32_t> winners;
+                for (uint32_t z = 0; z < sizes.size(); z++) {
+                    uint32_t best = 0;
+                    for (uint32_t s = 1; s < strategies.size(); s++) {
+                        if (benchmarks[z*strategies.size()+s]->getMeanMetric() > benchmarks[z*strategies.size()+best]->getMeanMetric())
+                            best = s;
+                    }
+                    winners.push_back(best);
+                    std::cout << sizes[z] << " B: " << bulk_strategy_name(strategies[best]) << " at " << benchmarks[z*strategies.size()+best]->getMeanMetric() << " MB/s" << std::endl;
+                }
 
-            results_file_ << del_lat_benchmarks[i]->getMeanLoadMetric() << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "N/A" << ",";
-            results_file_ << "MB/s" << ",";
-            results_file_ << del_lat_benchmarks[i]->getMeanMetric() << ",";
-            results_file_ << del_lat_benchmarks[i]->getMinMetric() << ",";
-            results_file_ << del_lat_benchmarks[i]->get25PercentileMetric() << ",";
-            results_file_ << del_lat_benchmarks[i]->getMedianMetric() << ",";
-            results_file_ << del_lat_benchmarks[i]->get75PercentileMetric() << ",";
-            results_file_ << del_lat_benchmarks[i]->get95PercentileMetric() << ",";
-            results_file_ << del_lat_benchmarks[i]->get99PercentileMetric() << ",";
-            results_file_ << del_lat_benchmarks[i]->getMaxMetric() << ",";
-            results_file_ << del_lat_benchmarks[i]->getModeMetric() << ",";
-            results_file_ << del_lat_benchmarks[i]->getMetricUnits() << ",";
-            for (uint32_t j = 0; j < g_num_physical_packages; j++) {
-                results_file_ << del_lat_benchmarks[i]->getMeanDRAMPower(j) << ",";
-                results_file_ << del_lat_benchmarks[i]->getPeakDRAMPower(j) << ",";
+                std::cout << "Thresholds:" << std::endl;
+                for (uint32_t z = 0; z < sizes.size(); z++) {
+                    if (z == 0 || winners[z] != winners[z-1])
+                        std::cout << "---> " << bulk_strategy_name(strategies[winners[z]]) << " wins from " << sizes[z] << " B" << std::endl;
+                }
+                std::cout << std::endl;
+
+                //Write to results file if necessary
+                if (config_.useOutputFile()) {
+                    for (uint32_t z = 0; z < sizes.size(); z++) {
+                        for (uint32_t s = 0; s < strategies.size(); s++)
+                            writeMemcpyResults(benchmarks[z*strategies.size()+s], s == winners[z] ? "fastest strategy at this size" : "");
+                    }
+                }
+
+                for (uint32_t i = 0; i < benchmarks.size(); i++)
+                    delete benchmarks[i];
             }
-            results_file_ << del_lat_benchmarks[i]->getDelay() << ",";
-            results_file_ << "<-- load threads' memory access delay value in nops" << ",";
-            results_file_ << std::endl;
         }
     }
 
+    if (g_verbose)
+        std::cout << std::endl << "Done running memcpy/memset benchmarks." << std::endl;
+
     return true;
 }
 #endif
@@ -934,3 +3162,36 @@ bool BenchmarkManager::runExtStreamBenchmark() {
     return true;
 }
 #endif
+
+void BenchmarkManager::writePowerResults(Benchmark* benchmark) {
+    std::string efficiency_units = (benchmark != NULL) ? benchmark->getEnergyEfficiencyUnits() : "";
+    for (uint32_t j = 0; j < dram_power_readers_.size(); j++) {
+        if (benchmark != NULL) {
+            results_file_ << benchmark->getMeanDRAMPower(j) << ",";
+            results_file_ << benchmark->getPeakDRAMPower(j) << ",";
+            results_file_ << benchmark->getDRAMEnergy(j) << ",";
+            if (efficiency_units != "")
+                results_file_ << benchmark->getEnergyEfficiency(j) << ",";
+            else
+                results_file_ << "N/A" << ",";
+        } else {
+            for (uint32_t i = 0; i < 4; i++)
+                results_file_ << "N/A" << ",";
+        }
+    }
+    if (!dram_power_readers_.empty())
+        results_file_ << (efficiency_units != "" ? efficiency_units : "N/A") << ",";
+}
+
+void BenchmarkManager::writePerfCounts(Benchmark* benchmark) {
+    if (!config_.perfCountersSelected())
+        return;
+
+    perf_counts_t counts = (benchmark != NULL) ? benchmark->getPerfCounts() : PerfCounters::emptyCounts();
+    for (uint32_t c = 0; c < NUM_PERF_COUNTERS; c++) {
+        if (counts.valid[c])
+            results_file_ << static_cast<uint64_t>(counts.counts[c]) << ",";
+        else
+            results_file_ << "N/A" << ",";
+    }
+}
@@ -0,0 +1,292 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the CoherenceLatencyBenchmark class.
+ */
+
+//Headers
+#include <CoherenceLatencyBenchmark.h>
+#include <common.h>
+#include <benchmark_kernels.h>
+#include <CoherenceLatencyWorker.h>
+#include <CoherencePreparerWorker.h>
+#include <Thread.h>
+
+//Libraries
+#include <iostream>
+
+using namespace xmem;
+
+/**
+ * @brief Number of threads needed for a coherence state: the latency thread plus its preparers.
+ */
+static uint32_t coherence_state_num_threads(coherence_state_t state) {
+    switch (state) {
+        case COHERENCE_MODIFIED:
+        case COHERENCE_EXCLUSIVE:
+            return 2;
+        case COHERENCE_SHARED:
+            return 3;
+        default:
+            return 1;
+    }
+}
+
+CoherenceLatencyBenchmark::CoherenceLatencyBenchmark(
+        void* mem_array,
+        size_t len,
+        uint32_t iterations,
+        uint32_t mem_node,
+        uint32_t cpu_node,
+        uint32_t preparer_cpu_node,
+        coherence_state_t state,
+        std::vector<PowerReader*> dram_power_readers,
+        std::string name
+    ) :
+        Benchmark(
+            mem_array,
+            len,
+            iterations,
+            coherence_state_num_threads(state),
+            mem_node,
+            cpu_node,
+            RANDOM,
+            READ,
+#ifdef HAS_WORD_64
+            CHUNK_64b,
+#else
+            CHUNK_32b,
+#endif
+            0,
+            1,
+            dram_power_readers,
+            "ns/access",
+            name
+        ),
+        preparer_cpu_node_(preparer_cpu_node),
+        state_(state)
+    {
+}
+
+std::string CoherenceLatencyBenchmark::coherenceStateName(coherence_state_t state) {
+    switch (state) {
+        case COHERENCE_MODIFIED:
+            return "M";
+        case COHERENCE_EXCLUSIVE:
+            return "E";
+        case COHERENCE_SHARED:
+            return "S";
+        case COHERENCE_INVALID:
+            return "I";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+void CoherenceLatencyBenchmark::findCpus(int32_t& latency_cpu, int32_t& owner_cpu, int32_t& sharer_cpu) const {
+    latency_cpu = cpu_id_in_numa_node(cpu_node_, 0);
+
+    //Preparers never share the latency thread's logical CPU
+    uint32_t first = (preparer_cpu_node_ == cpu_node_) ? 1 : 0;
+    owner_cpu = cpu_id_in_numa_node(preparer_cpu_node_, first);
+    sharer_cpu = cpu_id_in_numa_node(preparer_cpu_node_, first+1);
+}
+
+void CoherenceLatencyBenchmark::reportBenchmarkInfo() const {
+    int32_t latency_cpu, owner_cpu, sharer_cpu;
+    findCpus(latency_cpu, owner_cpu, sharer_cpu);
+
+    std::cout << "CPU NUMA Node: " << cpu_node_ << std::endl;
+    std::cout << "Memory NUMA Node: " << mem_node_ << std::endl;
+    std::cout << "Preparer CPU NUMA Node: " << preparer_cpu_node_ << std::endl;
+    std::cout << "Source Coherence State: " << coherenceStateName(state_) << std::endl;
+    std::cout << "Latency thread on logical CPU " << latency_cpu;
+    if (num_worker_threads_ > 1)
+        std::cout << ", preparer on logical CPU " << owner_cpu;
+    if (num_worker_threads_ > 2)
+        std::cout << ", second preparer on logical CPU " << sharer_cpu;
+    std::cout << std::endl;
+    std::cout << "Cache lines per pass: " << LATENCY_BENCHMARK_UNROLL_LENGTH << std::endl;
+    std::cout << std::endl;
+}
+
+std::vector<int32_t> CoherenceLatencyBenchmark::workerCpus() const {
+    int32_t latency_cpu, owner_cpu, sharer_cpu;
+    findCpus(latency_cpu, owner_cpu, sharer_cpu);
+
+    std::vector<int32_t> cpu_ids;
+    cpu_ids.push_back(latency_cpu);
+    if (num_worker_threads_ > 1)
+        cpu_ids.push_back(owner_cpu);
+    if (num_worker_threads_ > 2)
+        cpu_ids.push_back(sharer_cpu);
+    return cpu_ids;
+}
+
+bool CoherenceLatencyBenchmark::runCore() {
+    size_t chain_len = LATENCY_BENCHMARK_UNROLL_LENGTH * CACHE_LINE_SIZE; //One kernel call makes exactly one lap
+    uint8_t* base = static_cast<uint8_t*>(mem_array_);
+    void* owner_control = base + chain_len;
+    void* sharer_control = base + chain_len + CACHE_LINE_SIZE;
+
+#ifndef HAS_CACHE_LINE_FLUSH
+    if (state_ != COHERENCE_MODIFIED) {
+        std::cerr << "ERROR: Coherence state " << coherenceStateName(state_) << " needs cache line flush support, which is not available on this architecture." << std::endl;
+        return false;
+    }
+#endif
+
+    if (len_ < getRequiredLen() || reinterpret_cast<uintptr_t>(mem_array_) % CACHE_LINE_SIZE != 0) {
+        std::cerr << "ERROR: Coherence latency benchmark needs a cache line aligned region of at least " << getRequiredLen() << " bytes." << std::endl;
+        return false;
+    }
+
+    int32_t latency_cpu, owner_cpu, sharer_cpu;
+    findCpus(latency_cpu, owner_cpu, sharer_cpu);
+    if (latency_cpu < 0 || (num_worker_threads_ > 1 && owner_cpu < 0) || (num_worker_threads_ > 2 && sharer_cpu < 0)) {
+        std::cerr << "ERROR: Not enough logical CPUs in CPU NUMA nodes " << cpu_node_ << " and " << preparer_cpu_node_ << " for " << num_worker_threads_ << " threads." << std::endl;
+        return false;
+    }
+
+    //Build a single-cycle chain over whole cache lines, so no line is visited twice in a pass
+    if (!build_random_cache_line_cycle(mem_array_, LATENCY_BENCHMARK_UNROLL_LENGTH)) {
+        std::cerr << "ERROR: Failed to build a random cache line cycle for the latency measurement thread!" << std::endl;
+        return false;
+    }
+
+    //Start power measurement
+    if (g_verbose)
+        std::cout << "Starting power measurement threads...";
+
+    if (!startPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to start power threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run benchmark
+    if (g_verbose)
+        std::cout << "Running benchmark." << std::endl << std::endl;
+
+    for (uint32_t i = 0; i < iterations_; i++) {
+        *static_cast<volatile uint64_t*>(owner_control) = 0;
+        *static_cast<volatile uint64_t*>(sharer_control) = 0;
+
+        std::vector<MemoryWorker*> workers;
+        std::vector<Thread*> worker_threads;
+
+        //Thread 0 is always the latency thread
+        workers.push_back(new CoherenceLatencyWorker(mem_array_,
+                                                     chain_len,
+                                                     state_,
+                                                     num_worker_threads_ > 1 ? owner_control : NULL,
+                                                     num_worker_threads_ > 2 ? sharer_control : NULL,
+                                                     &chasePointers,
+                                                     &dummy_chasePointers,
+                                                     latency_cpu));
+        if (num_worker_threads_ > 1)
+            workers.push_back(new CoherencePreparerWorker(mem_array_,
+                                                          chain_len,
+                                                          state_ == COHERENCE_MODIFIED,
+                                                          owner_control,
+                                                          owner_cpu));
+        if (num_worker_threads_ > 2)
+            workers.push_back(new CoherencePreparerWorker(mem_array_,
+                                                          chain_len,
+                                                          false,
+                                                          sharer_control,
+                                                          sharer_cpu));
+        for (uint32_t t = 0; t < workers.size(); t++)
+            worker_threads.push_back(new Thread(workers[t]));
+
+        //Start worker threads! gogogo
+        for (uint32_t t = 0; t < worker_threads.size(); t++)
+            worker_threads[t]->create_and_start();
+
+        //Wait for all threads to complete
+        for (uint32_t t = 0; t < worker_threads.size(); t++)
+            if (!worker_threads[t]->join())
+                std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+
+        //Compute metrics for this iteration
+        bool iterwarning = false;
+        uint32_t lat_passes = workers[0]->getPasses();
+        tick_t lat_adjusted_ticks = workers[0]->getAdjustedTicks();
+        tick_t lat_elapsed_dummy_ticks = workers[0]->getElapsedDummyTicks();
+        for (uint32_t t = 0; t < workers.size(); t++)
+            iterwarning |= workers[t]->hadWarning();
+
+        if (lat_passes > 0)
+            metric_on_iter_[i] = (static_cast<double>(lat_adjusted_ticks) * g_ns_per_tick) / (static_cast<double>(lat_passes) * LATENCY_BENCHMARK_UNROLL_LENGTH);
+        else
+            iterwarning = true;
+
+        if (iterwarning)
+            warning_ = true;
+
+        if (g_verbose) { //Report metrics for this iteration
+            std::cout << "Iter " << i+1 << " had " << lat_passes << " latency measurement passes, with " << LATENCY_BENCHMARK_UNROLL_LENGTH << " accesses per pass:";
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...lat clock ticks == " << lat_adjusted_ticks << " (adjusted by -" << lat_elapsed_dummy_ticks << ")";
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...lat ns == " << lat_adjusted_ticks * g_ns_per_tick << " (adjusted by -" << lat_elapsed_dummy_ticks * g_ns_per_tick << ")";
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+        }
+
+        //Clean up workers and threads for this iteration
+        for (uint32_t t = 0; t < worker_threads.size(); t++) {
+            delete worker_threads[t];
+            delete workers[t];
+        }
+    }
+
+    //Stop power measurement
+    if (g_verbose) {
+        std::cout << std::endl;
+        std::cout << "Stopping power measurement threads...";
+    }
+
+    if (!stopPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to stop power measurement threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run metadata
+    has_run_ = true;
+    computeMetrics();
+
+    return true;
+}
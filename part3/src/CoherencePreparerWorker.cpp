@@ -0,0 +1,148 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the CoherencePreparerWorker class.
+ */
+
+//Headers
+#include <CoherencePreparerWorker.h>
+#include <common.h>
+
+//Libraries
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <processthreadsapi.h>
+#endif
+
+#ifdef __gnu_linux__
+#include <unistd.h>
+#endif
+
+using namespace xmem;
+
+CoherencePreparerWorker::CoherencePreparerWorker(
+        void* mem_array,
+        size_t len,
+        bool write,
+        void* control,
+        int32_t cpu_affinity
+    ) :
+        MemoryWorker(
+            mem_array,
+            len,
+            1,
+            cpu_affinity
+        ),
+        write_(write),
+        control_(control)
+    {
+}
+
+CoherencePreparerWorker::~CoherencePreparerWorker() {
+}
+
+void CoherencePreparerWorker::run() {
+    //Set up relevant state -- localized to this thread's stack
+    int32_t cpu_affinity = 0;
+    bool write = false;
+    volatile uint64_t* control = NULL;
+    uint8_t* mem_array = NULL;
+    size_t len = 0;
+    uint32_t passes = 0;
+    uint64_t command = 0;
+    volatile uintptr_t sink = 0; //Keeps the reads from being optimized away
+
+    //Grab relevant setup state thread-safely and keep it local
+    if (acquireLock(-1)) {
+        mem_array = static_cast<uint8_t*>(mem_array_);
+        len = len_;
+        write = write_;
+        control = static_cast<volatile uint64_t*>(control_);
+        cpu_affinity = cpu_affinity_;
+        releaseLock();
+    }
+
+    //Set processor affinity
+    bool locked = lock_thread_to_cpu(cpu_affinity);
+    if (!locked)
+        std::cerr << "WARNING: Failed to lock thread to logical CPU " << cpu_affinity << "! Results may not be correct." << std::endl;
+
+    //Increase scheduling priority
+#ifdef _WIN32
+    DWORD original_priority_class;
+    DWORD original_priority;
+    if (!boost_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!boost_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to boost scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Serve preparation requests until told to stop
+    for (uint64_t k = 0; ; k++) {
+        while ((command = *control) == 2*k);
+        if (command == COHERENCE_PREPARER_STOP_COMMAND)
+            break;
+
+        //Only the second word of each line is written, since the first one holds the pointer chain
+        for (size_t offset = 0; offset < len; offset += CACHE_LINE_SIZE) {
+            volatile uintptr_t* line = reinterpret_cast<volatile uintptr_t*>(mem_array + offset);
+            if (write)
+                line[1] = line[1] + 1;
+            else
+                sink = line[0];
+        }
+
+        *control = 2*k+2;
+        passes++;
+    }
+
+    //Unset processor affinity
+    if (locked)
+        unlock_thread_to_numa_node();
+
+    //Revert thread priority
+#ifdef _WIN32
+    if (!revert_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!revert_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to revert scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Update the object state thread-safely
+    if (acquireLock(-1)) {
+        warning_ = !locked;
+        bytes_per_pass_ = static_cast<uint32_t>(len);
+        completed_ = true;
+        passes_ = passes;
+        releaseLock();
+    }
+}
@@ -34,12 +34,19 @@
 #include <common.h>
 #include <optionparser.h>
 #include <MyArg.h>
+#include <PerfCounters.h>
 #include <common.h>
 
 //Libraries
 #include <cstdint>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <fstream>
+
+#ifdef __gnu_linux__
+#include <sys/stat.h> //for checking the backing directory
+#endif
 
 using namespace xmem;
 
@@ -50,11 +57,40 @@ Configurator::Configurator(
 #ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
     run_ext_delay_injected_loaded_latency_benchmark_(false),
 #endif
+#ifdef EXT_MEMCPY_BENCHMARK
+    run_ext_memcpy_benchmark_(false),
+#endif
 #ifdef EXT_STREAM_BENCHMARK
     run_ext_stream_benchmark_(false),
 #endif
     run_latency_(true),
     run_throughput_(true),
+    run_latency_curve_(false),
+    latency_curve_levels_(10),
+    latency_curve_knob_(CURVE_KNOB_RATE),
+    run_core_to_core_(false),
+    core_to_core_cpu_stride_(1),
+    run_coherence_latency_(false),
+    coherence_states_(),
+    run_atomics_(false),
+    atomic_max_lines_(1),
+    atomic_ops_(),
+    run_gather_(false),
+    run_workload_(false),
+    workload_(),
+    run_page_faults_(false),
+    run_numa_matrix_(false),
+    run_all_to_all_(false),
+    all_to_all_local_percent_(100),
+    all_to_all_workload_(),
+    run_thp_compare_(false),
+    thp_collapse_seconds_(0),
+    run_migration_(false),
+    run_tlb_reach_(false),
+    tlb_reach_max_region_size_(0),
+    perf_counters_(false),
+    rapl_root_(DEFAULT_RAPL_SYSFS_ROOT),
+    power_sampling_period_(POWER_SAMPLING_PERIOD_MS),
     working_set_size_per_thread_(DEFAULT_WORKING_SET_SIZE_PER_THREAD),
     num_worker_threads_(DEFAULT_NUM_WORKER_THREADS),
 #ifdef HAS_WORD_64
@@ -87,6 +123,12 @@ Configurator::Configurator(
     use_output_file_(false),
     verbose_(false),
     use_large_pages_(false),
+    large_page_size_(g_large_page_size),
+    placement_policy_(PLACEMENT_NODE),
+    interleave_granularity_(0),
+    working_set_backing_(BACKING_ANONYMOUS),
+    backing_directory_(),
+    map_private_(false),
     use_reads_(true),
     use_writes_(true),
     use_stride_p1_(true),
@@ -106,7 +148,8 @@ Configurator::Configurator(
     use_mlp_8_(false),
     use_mlp_16_(false),
     use_mlp_32_(false),
-    mlp_(1) //mlp_() //TODOJ: should this be init to 1?
+    mlp_(1), //mlp_() //TODOJ: should this be init to 1?
+    load_rate_per_thread_(0)
     {
 }
 
@@ -150,8 +193,50 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
         g_verbose = true; //What rest of X-Mem actually uses.
     }
 
+    //Timer backend
+    if (options[TIMER]) {
+        if (!check_single_option_occurrence(&options[TIMER]))
+            goto error;
+
+        std::string timer_name(options[TIMER].arg);
+        bool found = false;
+        for (uint32_t b = 0; b < NUM_TIMER_BACKENDS; b++) {
+            if (timer_name == timer_backend_name(static_cast<timer_backend_t>(b))) {
+                g_timer_backend = static_cast<timer_backend_t>(b); //Read by setup_timer(), which runs after configuration
+                found = true;
+            }
+        }
+        if (!found) {
+            std::cerr << "ERROR: Unknown timer \"" << timer_name << "\". Allowed values are os, rdtsc, rdtscp and cpuid." << std::endl;
+            goto error;
+        }
+        if (!timer_backend_available(g_timer_backend)) {
+            std::cerr << "ERROR: The " << timer_name << " timer is not available on this platform." << std::endl;
+            goto error;
+        }
+    }
+
+    //Hardware performance counters. Workers collect them only if this thread could open some, but the results file gets the columns either way.
+    if (options[PERF_COUNTERS]) {
+#ifndef __gnu_linux__
+        std::cerr << "ERROR: Hardware performance counters are only supported on GNU/Linux." << std::endl;
+        goto error;
+#endif
+        perf_counters_ = true;
+
+        PerfCounters probe;
+        g_perf_counters = probe.open();
+        if (!g_perf_counters)
+            std::cerr << "WARNING: No hardware performance counters could be opened. Check /proc/sys/kernel/perf_event_paranoid, and whether this virtual machine exposes a PMU. Counters will be reported as N/A." << std::endl;
+        else {
+            for (uint32_t c = 0; c < NUM_PERF_COUNTERS; c++)
+                if (!probe.isOpen(static_cast<perf_counter_t>(c)))
+                    std::cerr << "WARNING: The " << PerfCounters::counterName(static_cast<perf_counter_t>(c)) << " hardware performance counter is not available on this system and will be reported as N/A." << std::endl;
+        }
+    }
+
     //Check runtime modes
-    if (options[MEAS_LATENCY] || options[MEAS_THROUGHPUT] || options[EXTENSION]) { //User explicitly picked at least one mode, so override default selection
+    if (options[MEAS_LATENCY] || options[MEAS_THROUGHPUT] || options[EXTENSION] || options[LATENCY_CURVE] || options[CORE_TO_CORE] || options[COHERENCE_LATENCY] || options[ATOMICS] || options[GATHER] || options[WORKLOAD] || options[PAGE_FAULTS] || options[NUMA_MATRIX] || options[ALL_TO_ALL] || options[THP_COMPARE] || options[MIGRATION] || options[TLB_REACH]) { //User explicitly picked at least one mode, so override default selection
         run_latency_ = false;
         run_throughput_ = false;
         run_extensions_ = false;
@@ -176,6 +261,9 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
 #ifdef EXT_DELAY_INJECTED_LATENCY_BENCHMARK
         run_ext_delay_injected_loaded_latency_benchmark_ = false;
 #endif
+#ifdef EXT_MEMCPY_BENCHMARK
+        run_ext_memcpy_benchmark_ = false;
+#endif
 #ifdef EXT_STREAM_BENCHMARK
         run_ext_stream_benchmark_ = false;
 #endif
@@ -190,6 +278,11 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
                     run_ext_delay_injected_loaded_latency_benchmark_ = true;
                     break;
 #endif
+#ifdef EXT_MEMCPY_BENCHMARK
+                case EXT_NUM_MEMCPY_BENCHMARK:
+                    run_ext_memcpy_benchmark_ = true;
+                    break;
+#endif
 #ifdef EXT_STREAM_BENCHMARK
                 case EXT_NUM_STREAM_BENCHMARK:
                     run_ext_stream_benchmark_ = true;
@@ -201,6 +294,9 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
 #ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
                     << "---> Delay-injected latency benchmark: " << EXT_NUM_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
 #endif
+#ifdef EXT_MEMCPY_BENCHMARK
+                    << "---> memcpy/memset benchmark: " << EXT_NUM_MEMCPY_BENCHMARK
+#endif
 #ifdef EXT_STREAM_BENCHMARK
                     << "---> STREAM-like benchmark: " << EXT_NUM_STREAM_BENCHMARK
 #endif
@@ -255,6 +351,10 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
                     std::cerr << "ERROR: CPU NUMA node affinity of " << cpu_numa_node_affinity << " is not supported. There are only " << g_num_numa_nodes << " nodes in this system." << std::endl;
                     goto error;
                 }
+                if (!numa_node_has_cpus(cpu_numa_node_affinity)) {
+                    std::cerr << "ERROR: NUMA node " << cpu_numa_node_affinity << " is a memory-only node and cannot be used for CPU affinity. It can still be selected as a memory NUMA node." << std::endl;
+                    goto error;
+                }
 
                 bool found = false;
                 for (auto it = cpu_numa_node_affinities_.cbegin(); it != cpu_numa_node_affinities_.cend(); it++) {
@@ -271,9 +371,11 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
             cpu_numa_node_affinities_.sort();
         }
     }
-    else if (numa_enabled_) { //Default: use all CPU NUMA nodes
-        for (uint32_t i = 0; i < g_num_numa_nodes; i++)
-            cpu_numa_node_affinities_.push_back(i);
+    else if (numa_enabled_) { //Default: use all NUMA nodes that have CPUs
+        for (uint32_t i = 0; i < g_num_numa_nodes; i++) {
+            if (numa_node_has_cpus(i))
+                cpu_numa_node_affinities_.push_back(i);
+        }
     }
 
     if (options[MEMORY_NUMA_NODE_AFFINITY]) {
@@ -310,13 +412,7 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
     }
 
     //Check if large pages should be used for allocation of memory under test.
-    if (options[USE_LARGE_PAGES]) {
-#if defined(__gnu_linux__) && defined(ARCH_INTEL)
-        if (numa_enabled_) { //For now, large pages are not --simultaneously-- supported alongside NUMA. This is due to lack of NUMA support in hugetlbfs on GNU/Linux.
-            std::cerr << "ERROR: On GNU/Linux version of X-Mem for Intel architectures, large pages are not simultaneously supported alongside NUMA due to reasons outside our control. If you want large pages, then force UMA using the \"-u\" option explicitly." << std::endl;
-            goto error;
-        }
-#endif
+    if (options[USE_LARGE_PAGES] || options[LARGE_PAGE_SIZE]) {
 #ifndef HAS_LARGE_PAGES
         std::cerr << "WARNING: Huge pages are not supported on this build. Regular-sized pages will be used." << std::endl;
 #else
@@ -324,6 +420,102 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
 #endif
     }
 
+    //Check large page size
+    if (options[LARGE_PAGE_SIZE]) {
+        if (!check_single_option_occurrence(&options[LARGE_PAGE_SIZE]))
+            goto error;
+#if defined(__gnu_linux__) && defined(HAS_LARGE_PAGES)
+        size_t large_page_size_kb = static_cast<size_t>(strtoul(options[LARGE_PAGE_SIZE].arg, NULL, 10));
+        std::ifstream pool("/sys/kernel/mm/hugepages/hugepages-" + std::to_string(large_page_size_kb) + "kB/nr_hugepages"); //Exists for every huge page size the kernel supports
+        if (!pool.is_open()) {
+            std::cerr << "ERROR: Large pages of " << large_page_size_kb << " KB are not supported by this system." << std::endl;
+            goto error;
+        }
+        large_page_size_ = large_page_size_kb * KB;
+#else
+        std::cerr << "WARNING: Selecting the large page size is only supported on GNU/Linux. The system default large page size will be used." << std::endl;
+#endif
+    }
+
+    //Check memory placement policy. The NUMA node and page size selections must be known first.
+    interleave_granularity_ = use_large_pages_ ? large_page_size_ : g_page_size;
+    if (options[PLACEMENT]) {
+        if (!check_single_option_occurrence(&options[PLACEMENT]))
+            goto error;
+
+        std::string policy = options[PLACEMENT].arg;
+        if (policy == "node")
+            placement_policy_ = PLACEMENT_NODE;
+        else if (policy == "local") {
+            placement_policy_ = PLACEMENT_LOCAL;
+            if (options[MEMORY_NUMA_NODE_AFFINITY])
+                std::cerr << "WARNING: Memory NUMA node affinities are ignored with local placement, as each thread's memory is on the node of its own CPU." << std::endl;
+            memory_numa_node_affinities_ = cpu_numa_node_affinities_;
+        } else if (policy.compare(0, 10, "interleave") == 0 && (policy.size() == 10 || policy[10] == ':')) {
+#ifndef __gnu_linux__
+            std::cerr << "ERROR: Interleaved placement is only supported on GNU/Linux." << std::endl;
+            goto error;
+#endif
+            placement_policy_ = PLACEMENT_INTERLEAVE;
+            if (policy.size() > 10) {
+                char* endptr = NULL;
+                long granularity_KB = strtol(policy.c_str() + 11, &endptr, 10);
+                size_t page_size = interleave_granularity_;
+                if (policy.size() == 11 || *endptr != '\0' || granularity_KB <= 0 || (static_cast<size_t>(granularity_KB) * KB) % page_size != 0) {
+                    std::cerr << "ERROR: Interleave granularity must be a positive multiple of the page size in use (" << page_size / KB << " KB), given in KB." << std::endl;
+                    goto error;
+                }
+                interleave_granularity_ = static_cast<size_t>(granularity_KB) * KB;
+            }
+            if (memory_numa_node_affinities_.size() < 2)
+                std::cerr << "WARNING: Interleaved placement was selected with only one memory NUMA node, so it is the same as node placement." << std::endl;
+        } else {
+            std::cerr << "ERROR: Invalid placement policy \"" << policy << "\". Allowed values: node, interleave, interleave:<KB>, local." << std::endl;
+            goto error;
+        }
+    }
+
+    //Check working set backing
+    if (options[BACKING]) {
+        if (!check_single_option_occurrence(&options[BACKING]))
+            goto error;
+
+        std::string backing = options[BACKING].arg;
+        if (backing == "anon")
+            working_set_backing_ = BACKING_ANONYMOUS;
+        else if (backing == "memfd" || (backing.compare(0, 5, "file:") == 0 && backing.size() > 5)) {
+#ifdef __gnu_linux__
+            if (backing == "memfd")
+                working_set_backing_ = BACKING_MEMFD;
+            else {
+                working_set_backing_ = BACKING_FILE;
+                backing_directory_ = backing.substr(5);
+                struct stat dir_stat;
+                if (stat(backing_directory_.c_str(), &dir_stat) != 0 || !S_ISDIR(dir_stat.st_mode)) {
+                    std::cerr << "ERROR: \"" << backing_directory_ << "\" is not a directory." << std::endl;
+                    goto error;
+                }
+            }
+#else
+            std::cerr << "ERROR: memfd and file working sets are only supported on GNU/Linux." << std::endl;
+            goto error;
+#endif
+        } else {
+            std::cerr << "ERROR: Invalid working set backing \"" << backing << "\". Allowed values: anon, memfd, file:<directory>." << std::endl;
+            goto error;
+        }
+    }
+
+    //Check private mapping
+    if (options[PRIVATE_MAPPING]) {
+        if (!check_single_option_occurrence(&options[PRIVATE_MAPPING]))
+            goto error;
+
+        if (working_set_backing_ == BACKING_ANONYMOUS)
+            std::cerr << "WARNING: Anonymous working sets are always private, so the map_private option has no effect." << std::endl;
+        map_private_ = true;
+    }
+
     //Check number of worker threads
     if (options[NUM_WORKER_THREADS]) { //Override default value
         if (!check_single_option_occurrence(&options[NUM_WORKER_THREADS]))
@@ -444,6 +636,30 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
         use_output_file_ = true;
     }
 
+    //Check RAPL sysfs directory
+    if (options[RAPL_ROOT]) {
+        if (!check_single_option_occurrence(&options[RAPL_ROOT]))
+            goto error;
+
+#ifndef __gnu_linux__
+        std::cerr << "ERROR: RAPL power measurement through powercap is only supported on GNU/Linux." << std::endl;
+        goto error;
+#endif
+        rapl_root_ = options[RAPL_ROOT].arg;
+    }
+
+    //Check power sampling period
+    if (options[POWER_PERIOD]) {
+        if (!check_single_option_occurrence(&options[POWER_PERIOD]))
+            goto error;
+
+        power_sampling_period_ = static_cast<uint32_t>(strtoul(options[POWER_PERIOD].arg, NULL, 10));
+        if (power_sampling_period_ < POWER_SAMPLING_PERIOD_MIN_MS) {
+            std::cerr << "ERROR: The power sampling period must be at least " << POWER_SAMPLING_PERIOD_MIN_MS << " ms." << std::endl;
+            goto error;
+        }
+    }
+
     //Check if reads and/or writes should be used in throughput and loaded latency benchmarks
     if (options[USE_READS] || options[USE_WRITES]) { //override defaults
         use_reads_ = false;
@@ -561,8 +777,326 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
         }
     }
 
+    //Check load rate limit
+    if (options[LOAD_RATE]) { //override default of no rate limiting
+        if (!check_single_option_occurrence(&options[LOAD_RATE]))
+            goto error;
+
+        char* endptr = NULL;
+        load_rate_per_thread_ = static_cast<uint32_t>(strtoul(options[LOAD_RATE].arg, &endptr, 10));
+        if (load_rate_per_thread_ > 0 && num_worker_threads_ < 2)
+            std::cerr << "WARNING: A load rate was specified, but there are no load threads because only 1 worker thread is used. The load rate will have no effect." << std::endl;
+    }
+
+    //Check loaded latency curve mode
+    if (options[LATENCY_CURVE]) {
+        if (!check_single_option_occurrence(&options[LATENCY_CURVE]))
+            goto error;
+
+        char* endptr = NULL;
+        latency_curve_levels_ = static_cast<uint32_t>(strtoul(options[LATENCY_CURVE].arg, &endptr, 10));
+        run_latency_curve_ = true;
+    }
+
+    if (options[LATENCY_CURVE_KNOB]) {
+        if (!check_single_option_occurrence(&options[LATENCY_CURVE_KNOB]))
+            goto error;
+
+        std::string knob = options[LATENCY_CURVE_KNOB].arg;
+        if (knob == "rate")
+            latency_curve_knob_ = CURVE_KNOB_RATE;
+        else if (knob == "threads")
+            latency_curve_knob_ = CURVE_KNOB_THREADS;
+        else if (knob == "delay") {
+#ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
+            latency_curve_knob_ = CURVE_KNOB_DELAY;
+#else
+            std::cerr << "ERROR: The delay knob for the loaded latency curve requires the delay-injected loaded latency benchmark extension, which was not included at build time." << std::endl;
+            goto error;
+#endif
+        } else {
+            std::cerr << "ERROR: Invalid loaded latency curve knob \"" << knob << "\". Allowed values: rate, threads, delay." << std::endl;
+            goto error;
+        }
+
+        if (!run_latency_curve_)
+            std::cerr << "WARNING: A loaded latency curve knob was specified, but the loaded latency curve mode was not selected. The knob will have no effect." << std::endl;
+    }
+
+    if (run_latency_curve_ && num_worker_threads_ < 2) {
+        std::cerr << "ERROR: The loaded latency curve mode needs at least 2 worker threads: one for latency measurement and at least one for load generation." << std::endl;
+        goto error;
+    }
+
+    //Check core-to-core latency mode
+    if (options[CORE_TO_CORE]) {
+        if (!check_single_option_occurrence(&options[CORE_TO_CORE]))
+            goto error;
+
+        char* endptr = NULL;
+        core_to_core_cpu_stride_ = static_cast<uint32_t>(strtoul(options[CORE_TO_CORE].arg, &endptr, 10));
+        run_core_to_core_ = true;
+    }
+
+    //Check coherence-state-aware latency mode
+    if (options[COHERENCE_LATENCY])
+        run_coherence_latency_ = true;
+
+    if (options[COHERENCE_STATE]) {
+        Option* curr = options[COHERENCE_STATE];
+        while (curr) { //COHERENCE_STATE may occur more than once, this is perfectly OK.
+            std::string state_name = curr->arg;
+            coherence_state_t state = NUM_COHERENCE_STATES;
+            if (state_name == "M")
+                state = COHERENCE_MODIFIED;
+            else if (state_name == "E")
+                state = COHERENCE_EXCLUSIVE;
+            else if (state_name == "S")
+                state = COHERENCE_SHARED;
+            else if (state_name == "I")
+                state = COHERENCE_INVALID;
+            else {
+                std::cerr << "ERROR: Invalid coherence state \"" << state_name << "\". Allowed values: M, E, S, I." << std::endl;
+                goto error;
+            }
+
+#ifndef HAS_CACHE_LINE_FLUSH
+            if (state != COHERENCE_MODIFIED) {
+                std::cerr << "ERROR: Coherence state " << state_name << " needs cache line flush instructions, which are not available on this architecture." << std::endl;
+                goto error;
+            }
+#endif
+
+            bool found = false;
+            for (auto it = coherence_states_.cbegin(); it != coherence_states_.cend(); it++) {
+                if (*it == state)
+                    found = true;
+            }
+
+            if (!found)
+                coherence_states_.push_back(state);
+
+            curr = curr->next();
+        }
+
+        coherence_states_.sort();
+
+        if (!run_coherence_latency_)
+            std::cerr << "WARNING: A coherence state was specified, but the coherence-state-aware latency mode was not selected. The state will have no effect." << std::endl;
+    } else { //Default: all states this architecture can set up
+        coherence_states_.push_back(COHERENCE_MODIFIED);
+#ifdef HAS_CACHE_LINE_FLUSH
+        coherence_states_.push_back(COHERENCE_EXCLUSIVE);
+        coherence_states_.push_back(COHERENCE_SHARED);
+        coherence_states_.push_back(COHERENCE_INVALID);
+#endif
+    }
+
+    //Check atomic operation mode
+    if (options[ATOMICS]) {
+        if (!check_single_option_occurrence(&options[ATOMICS]))
+            goto error;
+
+        char* endptr = NULL;
+        atomic_max_lines_ = static_cast<uint32_t>(strtoul(options[ATOMICS].arg, &endptr, 10));
+        run_atomics_ = true;
+    }
+
+    if (options[ATOMIC_OP]) {
+        Option* curr = options[ATOMIC_OP];
+        while (curr) { //ATOMIC_OP may occur more than once, this is perfectly OK.
+            std::string op_name = curr->arg;
+            atomic_op_t op = NUM_ATOMIC_OPS;
+            if (op_name == "xadd")
+                op = ATOMIC_FETCH_ADD;
+            else if (op_name == "cmpxchg")
+                op = ATOMIC_COMPARE_EXCHANGE;
+            else if (op_name == "xchg")
+                op = ATOMIC_EXCHANGE;
+            else {
+                std::cerr << "ERROR: Invalid atomic operation \"" << op_name << "\". Allowed values: xadd, cmpxchg, xchg." << std::endl;
+                goto error;
+            }
+
+            bool found = false;
+            for (auto it = atomic_ops_.cbegin(); it != atomic_ops_.cend(); it++) {
+                if (*it == op)
+                    found = true;
+            }
+
+            if (!found)
+                atomic_ops_.push_back(op);
+
+            curr = curr->next();
+        }
+
+        atomic_ops_.sort();
+
+        if (!run_atomics_)
+            std::cerr << "WARNING: An atomic operation was specified, but the atomic operation mode was not selected. The operation will have no effect." << std::endl;
+    } else { //Default: all atomic operations
+        atomic_ops_.push_back(ATOMIC_FETCH_ADD);
+        atomic_ops_.push_back(ATOMIC_COMPARE_EXCHANGE);
+        atomic_ops_.push_back(ATOMIC_EXCHANGE);
+    }
+
+    //Check gather/scatter mode
+    if (options[GATHER]) {
+        if (!check_single_option_occurrence(&options[GATHER]))
+            goto error;
+
+        run_gather_ = true;
+    }
+
+    //Check workload mix mode. The NUMA node selections must be known first, as they supply the defaults.
+    if (options[WORKLOAD]) {
+        Option* curr = options[WORKLOAD];
+        while (curr) { //WORKLOAD may occur more than once, this is perfectly OK.
+            if (!parse_workload_group(curr->arg))
+                goto error;
+            curr = curr->next();
+        }
+
+        if (workload_.size() > g_num_logical_cpus) {
+            std::cerr << "ERROR: The workload mix has " << workload_.size() << " threads, but the number of worker threads may not exceed the number of logical CPUs (" << g_num_logical_cpus << ")" << std::endl;
+            goto error;
+        }
+
+        //Every thread must get its own logical CPU in its CPU node, or the mix would run partly unpinned
+        std::vector<uint32_t> threads_on_cpu_node(g_num_numa_nodes, 0);
+        for (auto it = workload_.cbegin(); it != workload_.cend(); it++)
+            threads_on_cpu_node[it->cpu_node]++;
+        for (uint32_t n = 0; n < g_num_numa_nodes; n++) {
+            if (threads_on_cpu_node[n] > 0 && cpu_id_in_numa_node(n, threads_on_cpu_node[n] - 1) < 0) {
+                std::cerr << "ERROR: The workload mix puts " << threads_on_cpu_node[n] << " threads on CPU NUMA node " << n << ", but the node does not have that many logical CPUs. Move some groups to another node with cpu=, or use fewer threads." << std::endl;
+                goto error;
+            }
+        }
+
+        run_workload_ = true;
+    }
+
+    //Check page fault mode
+    if (options[PAGE_FAULTS]) {
+        if (!check_single_option_occurrence(&options[PAGE_FAULTS]))
+            goto error;
+
+#ifndef __gnu_linux__
+        std::cerr << "ERROR: Page fault mode is only supported on GNU/Linux." << std::endl;
+        goto error;
+#endif
+
+        run_page_faults_ = true;
+    }
+
+    //Check NUMA matrix mode
+    if (options[NUMA_MATRIX]) {
+        if (!check_single_option_occurrence(&options[NUMA_MATRIX]))
+            goto error;
+
+        if (placement_policy_ != PLACEMENT_NODE) {
+            std::cerr << "ERROR: NUMA matrix mode requires node placement, so that each memory NUMA node is measured on its own." << std::endl;
+            goto error;
+        }
+
+        run_numa_matrix_ = true;
+    }
+
+    //Check all-to-all NUMA traffic mode
+    if (options[ALL_TO_ALL]) {
+        if (!check_single_option_occurrence(&options[ALL_TO_ALL]))
+            goto error;
+
+        char* endptr = NULL;
+        long local_percent = strtol(options[ALL_TO_ALL].arg, &endptr, 10);
+        if (*endptr != '\0' || local_percent < 0 || local_percent > 100) {
+            std::cerr << "ERROR: The share of local threads in all-to-all NUMA traffic mode must be a percentage between 0 and 100." << std::endl;
+            goto error;
+        }
+        all_to_all_local_percent_ = static_cast<uint32_t>(local_percent);
+
+        if (placement_policy_ != PLACEMENT_NODE) {
+            std::cerr << "ERROR: All-to-all NUMA traffic mode requires node placement, so that local and remote memory NUMA nodes can be told apart." << std::endl;
+            goto error;
+        }
+
+        build_all_to_all_workload();
+        if (all_to_all_workload_.size() > g_num_logical_cpus) {
+            std::cerr << "ERROR: All-to-all NUMA traffic mode needs " << all_to_all_workload_.size() << " threads including the latency probe, but the number of worker threads may not exceed the number of logical CPUs (" << g_num_logical_cpus << ")" << std::endl;
+            goto error;
+        }
+
+        //Every thread must get its own logical CPU in its CPU node, and the first node also hosts the probe
+        std::vector<uint32_t> threads_on_cpu_node(g_num_numa_nodes, 0);
+        for (auto it = all_to_all_workload_.cbegin(); it != all_to_all_workload_.cend(); it++)
+            threads_on_cpu_node[it->cpu_node]++;
+        for (uint32_t n = 0; n < g_num_numa_nodes; n++) {
+            if (threads_on_cpu_node[n] > 0 && cpu_id_in_numa_node(n, threads_on_cpu_node[n] - 1) < 0) {
+                std::cerr << "ERROR: All-to-all NUMA traffic mode needs " << threads_on_cpu_node[n] << " logical CPUs on CPU NUMA node " << n << (n == cpu_numa_node_affinities_.front() ? " including the latency probe" : "") << ", but the node does not have that many. Use fewer worker threads." << std::endl;
+                goto error;
+            }
+        }
+
+        run_all_to_all_ = true;
+    }
+
+    //Check THP comparison mode
+    if (options[THP_COMPARE]) {
+        if (!check_single_option_occurrence(&options[THP_COMPARE]))
+            goto error;
+
+#if !defined(__gnu_linux__) || !defined(HAS_NUMA)
+        std::cerr << "ERROR: THP comparison mode is only supported on GNU/Linux with NUMA support." << std::endl;
+        goto error;
+#endif
+
+        run_thp_compare_ = true;
+    }
+
+    if (options[THP_COLLAPSE_SECONDS]) {
+        if (!check_single_option_occurrence(&options[THP_COLLAPSE_SECONDS]))
+            goto error;
+
+        if (!run_thp_compare_)
+            std::cerr << "WARNING: The thp_collapse option only applies to THP comparison mode, so it has no effect." << std::endl;
+        else
+            thp_collapse_seconds_ = static_cast<uint32_t>(strtoul(options[THP_COLLAPSE_SECONDS].arg, NULL, 10));
+    }
+
+    //Check page migration mode
+    if (options[MIGRATION]) {
+        if (!check_single_option_occurrence(&options[MIGRATION]))
+            goto error;
+
+#if !defined(__gnu_linux__) || !defined(HAS_NUMA)
+        std::cerr << "ERROR: Page migration mode is only supported on GNU/Linux with NUMA support." << std::endl;
+        goto error;
+#endif
+
+        if (memory_numa_node_affinities_.size() < 2) {
+            std::cerr << "ERROR: Page migration mode needs at least two memory NUMA nodes to move pages between." << std::endl;
+            goto error;
+        }
+
+        run_migration_ = true;
+    }
+
+    //Check TLB reach mode
+    if (options[TLB_REACH]) {
+        if (!check_single_option_occurrence(&options[TLB_REACH]))
+            goto error;
+
+#ifndef __gnu_linux__
+        std::cerr << "ERROR: TLB reach mode is only supported on GNU/Linux." << std::endl;
+        goto error;
+#endif
+
+        tlb_reach_max_region_size_ = static_cast<size_t>(strtoul(options[TLB_REACH].arg, NULL, 10)) * MB;
+        run_tlb_reach_ = true;
+    }
+
     //Make sure at least one mode is available
-    if (!run_latency_ && !run_throughput_ && !run_extensions_) {
+    if (!run_latency_ && !run_throughput_ && !run_extensions_ && !run_latency_curve_ && !run_core_to_core_ && !run_coherence_latency_ && !run_atomics_ && !run_gather_ && !run_workload_ && !run_page_faults_ && !run_numa_matrix_ && !run_all_to_all_ && !run_thp_compare_ && !run_migration_ && !run_tlb_reach_) {
         std::cerr << "ERROR: At least one benchmark type must be selected." << std::endl;
         goto error;
     }
@@ -587,6 +1121,9 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
 #ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
         run_ext_delay_injected_loaded_latency_benchmark_ = true;
 #endif
+#ifdef EXT_MEMCPY_BENCHMARK
+        run_ext_memcpy_benchmark_ = true;
+#endif
 #ifdef EXT_STREAM_BENCHMARK
         run_ext_stream_benchmark_ = true;
 #endif
@@ -653,6 +1190,54 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
                 std::cout << "Unloaded ";
             std::cout << "latency" << std::endl;
         }
+        if (run_latency_curve_) {
+            std::cout << "---> Loaded latency curve (knob: ";
+            switch (latency_curve_knob_) {
+                case CURVE_KNOB_RATE:
+                    std::cout << "rate, " << latency_curve_levels_ << " levels";
+                    break;
+                case CURVE_KNOB_THREADS:
+                    std::cout << "threads";
+                    break;
+                case CURVE_KNOB_DELAY:
+                    std::cout << "delay";
+                    break;
+                default:
+                    std::cout << "UNKNOWN";
+                    break;
+            }
+            std::cout << ")" << std::endl;
+        }
+        if (run_core_to_core_)
+            std::cout << "---> Core-to-core latency (every " << core_to_core_cpu_stride_ << " logical CPU(s) per node)" << std::endl;
+        if (run_coherence_latency_) {
+            std::cout << "---> Coherence-state-aware latency (states:";
+            for (auto it = coherence_states_.cbegin(); it != coherence_states_.cend(); it++)
+                std::cout << " " << "MESI"[*it]; //Same order as coherence_state_t
+            std::cout << ")" << std::endl;
+        }
+        if (run_atomics_)
+            std::cout << "---> Atomic operations (up to " << atomic_max_lines_ << " shared cache line(s))" << std::endl;
+        if (run_gather_)
+            std::cout << "---> Gather/scatter" << std::endl;
+        if (run_workload_)
+            std::cout << "---> Workload mix (" << workload_.size() << " threads)" << std::endl;
+        if (run_page_faults_)
+            std::cout << "---> Page faults" << std::endl;
+        if (run_numa_matrix_)
+            std::cout << "---> NUMA matrix" << std::endl;
+        if (run_all_to_all_)
+            std::cout << "---> All-to-all NUMA traffic (" << all_to_all_local_percent_ << "% local)" << std::endl;
+        if (run_thp_compare_) {
+            std::cout << "---> Transparent huge page policies";
+            if (thp_collapse_seconds_ > 0)
+                std::cout << " (khugepaged collapse for " << thp_collapse_seconds_ << " s)";
+            std::cout << std::endl;
+        }
+        if (run_migration_)
+            std::cout << "---> Page migration" << std::endl;
+        if (run_tlb_reach_)
+            std::cout << "---> TLB reach (up to " << tlb_reach_max_region_size_ / MB << " MB per page size)" << std::endl;
         if (run_extensions_)
             std::cout << "---> Extensions" << std::endl;
         std::cout << std::endl;
@@ -726,6 +1311,18 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
         std::cout << std::endl;
         std::cout << "---> Number of worker threads:        ";
         std::cout << num_worker_threads_ << std::endl;
+        std::cout << "---> Load rate per thread:            ";
+        if (load_rate_per_thread_ > 0)
+            std::cout << load_rate_per_thread_ << " MB/s" << std::endl;
+        else
+            std::cout << "unlimited" << std::endl;
+        std::cout << "---> Hardware performance counters:   ";
+        if (!perf_counters_)
+            std::cout << "no" << std::endl;
+        else if (g_perf_counters)
+            std::cout << "yes" << std::endl;
+        else
+            std::cout << "requested, but unavailable" << std::endl;
         std::cout << "---> NUMA enabled:                    ";
 #ifdef HAS_NUMA
         if (numa_enabled_)
@@ -746,12 +1343,36 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
         std::cout << "---> Large pages:                     ";
 #ifdef HAS_LARGE_PAGES
         if (use_large_pages_)
-            std::cout << "yes" << std::endl;
+            std::cout << "yes, " << large_page_size_ / KB << " KB" << std::endl;
         else
             std::cout << "no" << std::endl;
 #else
         std::cout << "not supported" << std::endl;
 #endif
+        std::cout << "---> Memory placement:                ";
+        switch (placement_policy_) {
+            case PLACEMENT_INTERLEAVE:
+                std::cout << "interleave, " << interleave_granularity_ / KB << " KB" << std::endl;
+                break;
+            case PLACEMENT_LOCAL:
+                std::cout << "local" << std::endl;
+                break;
+            default:
+                std::cout << "node" << std::endl;
+                break;
+        }
+        std::cout << "---> Working set backing:             ";
+        switch (working_set_backing_) {
+            case BACKING_MEMFD:
+                std::cout << "memfd, " << (map_private_ ? "private" : "shared") << std::endl;
+                break;
+            case BACKING_FILE:
+                std::cout << "file in " << backing_directory_ << ", " << (map_private_ ? "private" : "shared") << std::endl;
+                break;
+            default:
+                std::cout << "anon" << std::endl;
+                break;
+        }
         std::cout << "---> Iterations:                      ";
         std::cout << iterations_ << std::endl;
         std::cout << "---> Starting test index:             ";
@@ -762,12 +1383,12 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
         std::cout << "Working set per thread:               ";
     if (use_large_pages_) {
         size_t num_large_pages = 0;
-        if (working_set_size_per_thread_ <= g_large_page_size) //sub one large page, round up to one
+        if (working_set_size_per_thread_ <= large_page_size_) //sub one large page, round up to one
             num_large_pages = 1;
-        else if (working_set_size_per_thread_ % g_large_page_size == 0) //multiple of large page
-            num_large_pages = working_set_size_per_thread_ / g_large_page_size;
+        else if (working_set_size_per_thread_ % large_page_size_ == 0) //multiple of large page
+            num_large_pages = working_set_size_per_thread_ / large_page_size_;
         else //larger than one large page but not a multiple of large page
-            num_large_pages = working_set_size_per_thread_ / g_large_page_size + 1;
+            num_large_pages = working_set_size_per_thread_ / large_page_size_ + 1;
         std::cout << working_set_size_per_thread_ << " B == " << working_set_size_per_thread_ / KB  << " KB == " << working_set_size_per_thread_ / MB << " MB (fits in " << num_large_pages << " large pages)" << std::endl;
     } else {
         std::cout << working_set_size_per_thread_ << " B == " << working_set_size_per_thread_ / KB  << " KB == " << working_set_size_per_thread_ / MB << " MB (" << working_set_size_per_thread_/(g_page_size) << " pages)" << std::endl;
@@ -817,3 +1438,256 @@ bool Configurator::check_single_option_occurrence(Option* opt) const {
     }
     return true;
 }
+
+bool Configurator::parse_workload_group(const std::string& spec) {
+    //Split into colon-separated fields
+    std::vector<std::string> fields;
+    size_t start = 0;
+    size_t colon = 0;
+    while ((colon = spec.find(':', start)) != std::string::npos) {
+        fields.push_back(spec.substr(start, colon - start));
+        start = colon + 1;
+    }
+    fields.push_back(spec.substr(start));
+
+    if (fields.size() < 2) {
+        std::cerr << "ERROR: Workload group \"" << spec << "\" needs at least a thread count and a kind, e.g. 2:seq-read." << std::endl;
+        return false;
+    }
+
+    char* endptr = NULL;
+    uint32_t count = static_cast<uint32_t>(strtoul(fields[0].c_str(), &endptr, 10));
+    if (fields[0].empty() || *endptr != '\0' || count == 0) {
+        std::cerr << "ERROR: Invalid thread count \"" << fields[0] << "\" in workload group \"" << spec << "\"." << std::endl;
+        return false;
+    }
+
+    workload_thread_t thread;
+    thread.latency_probe = false;
+    thread.pattern_mode = SEQUENTIAL;
+    thread.rw_mode = READ;
+#ifdef HAS_WORD_64
+    thread.chunk_size = CHUNK_64b;
+#else
+    thread.chunk_size = CHUNK_32b;
+#endif
+    thread.stride_size = 1;
+    thread.working_set_size = working_set_size_per_thread_;
+    thread.mem_node = memory_numa_node_affinities_.front();
+    thread.cpu_node = cpu_numa_node_affinities_.front();
+
+    if (fields[1] == "seq-read") {
+        thread.pattern_mode = SEQUENTIAL;
+        thread.rw_mode = READ;
+    } else if (fields[1] == "seq-write") {
+        thread.pattern_mode = SEQUENTIAL;
+        thread.rw_mode = WRITE;
+    } else if (fields[1] == "rand-read") {
+        thread.pattern_mode = RANDOM;
+        thread.rw_mode = READ;
+    } else if (fields[1] == "rand-write") {
+        thread.pattern_mode = RANDOM;
+        thread.rw_mode = WRITE;
+    } else if (fields[1] == "latency") {
+        thread.latency_probe = true;
+        thread.pattern_mode = RANDOM;
+        thread.rw_mode = READ;
+    } else {
+        std::cerr << "ERROR: Invalid workload kind \"" << fields[1] << "\". Allowed values: seq-read, seq-write, rand-read, rand-write, latency." << std::endl;
+        return false;
+    }
+
+    for (size_t i = 2; i < fields.size(); i++) {
+        size_t equals = fields[i].find('=');
+        if (equals == std::string::npos) {
+            std::cerr << "ERROR: Workload field \"" << fields[i] << "\" must be of the form key=value." << std::endl;
+            return false;
+        }
+        std::string key = fields[i].substr(0, equals);
+        std::string value = fields[i].substr(equals + 1);
+        endptr = NULL;
+        long number = strtol(value.c_str(), &endptr, 10);
+        if (value.empty() || *endptr != '\0') {
+            std::cerr << "ERROR: Workload field \"" << fields[i] << "\" needs an integer value." << std::endl;
+            return false;
+        }
+
+        if (thread.latency_probe && (key == "chunk" || key == "stride")) {
+            std::cerr << "ERROR: Latency probe threads always chase 64-bit random pointers, so " << key << " cannot be set for them." << std::endl;
+            return false;
+        }
+
+        if (key == "chunk") {
+            switch (number) {
+                case 32:
+                    thread.chunk_size = CHUNK_32b;
+                    break;
+#ifdef HAS_WORD_64
+                case 64:
+                    thread.chunk_size = CHUNK_64b;
+                    break;
+#endif
+#ifdef HAS_WORD_128
+                case 128:
+                    thread.chunk_size = CHUNK_128b;
+                    break;
+#endif
+#ifdef HAS_WORD_256
+                case 256:
+                    thread.chunk_size = CHUNK_256b;
+                    break;
+#endif
+#ifdef HAS_WORD_512
+                case 512:
+                    thread.chunk_size = CHUNK_512b;
+                    break;
+#endif
+                default:
+                    std::cerr << "ERROR: Invalid chunk size " << number << " in workload group \"" << spec << "\". Chunk sizes can be 32 64 128 256 512 bits, but only up to the native width of this platform." << std::endl;
+                    return false;
+            }
+        } else if (key == "stride") {
+            switch (number) {
+                case 1: case -1: case 2: case -2: case 4: case -4: case 8: case -8: case 16: case -16:
+                    thread.stride_size = static_cast<int32_t>(number);
+                    break;
+                default:
+                    std::cerr << "ERROR: Invalid stride size " << number << " in workload group \"" << spec << "\". Stride sizes can be 1, -1, 2, -2, 4, -4, 8, -8, 16, or -16." << std::endl;
+                    return false;
+            }
+        } else if (key == "ws") {
+            if (number <= 0 || (number % 4) != 0) {
+                std::cerr << "ERROR: Working set size in workload group \"" << spec << "\" must be specified in KB and be a positive multiple of 4 KB." << std::endl;
+                return false;
+            }
+            thread.working_set_size = static_cast<size_t>(number) * KB;
+        } else if (key == "mem" || key == "cpu") {
+            if (number < 0 || static_cast<uint32_t>(number) >= g_num_numa_nodes) {
+                std::cerr << "ERROR: NUMA node " << number << " in workload group \"" << spec << "\" is not supported. There are only " << g_num_numa_nodes << " nodes in this system." << std::endl;
+                return false;
+            }
+            if (key == "mem") {
+                if (placement_policy_ != PLACEMENT_NODE) {
+                    std::cerr << "ERROR: The mem field in workload group \"" << spec << "\" can only be used with node placement." << std::endl;
+                    return false;
+                }
+                thread.mem_node = static_cast<uint32_t>(number);
+            } else {
+                if (!numa_node_has_cpus(static_cast<uint32_t>(number))) {
+                    std::cerr << "ERROR: NUMA node " << number << " in workload group \"" << spec << "\" is a memory-only node and has no CPUs to run on." << std::endl;
+                    return false;
+                }
+                thread.cpu_node = static_cast<uint32_t>(number);
+            }
+        } else {
+            std::cerr << "ERROR: Unknown workload field \"" << key << "\". Allowed fields: chunk, stride, ws, mem, cpu." << std::endl;
+            return false;
+        }
+    }
+
+    if (placement_policy_ == PLACEMENT_LOCAL) //Memory follows the thread
+        thread.mem_node = thread.cpu_node;
+
+    //Memory is only allocated on the selected memory NUMA nodes
+    bool found = false;
+    for (auto it = memory_numa_node_affinities_.cbegin(); it != memory_numa_node_affinities_.cend(); it++) {
+        if (*it == thread.mem_node)
+            found = true;
+    }
+    if (!found) {
+        std::cerr << "ERROR: Memory NUMA node " << thread.mem_node << " in workload group \"" << spec << "\" is not one of the selected memory NUMA nodes." << std::endl;
+        return false;
+    }
+
+#ifdef HAS_WORD_64
+    if (thread.pattern_mode == RANDOM && !thread.latency_probe && thread.chunk_size == CHUNK_32b) {
+        std::cerr << "ERROR: Random-access load kernels do not support 32-bit chunk sizes on 64-bit machines." << std::endl;
+        return false;
+    }
+#endif
+
+    if (thread.pattern_mode == RANDOM && !thread.latency_probe && thread.stride_size != 1)
+        std::cerr << "WARNING: Stride has no effect on random-access threads in workload group \"" << spec << "\"." << std::endl;
+
+    for (uint32_t t = 0; t < count; t++)
+        workload_.push_back(thread);
+
+    return true;
+}
+
+void Configurator::build_all_to_all_workload() {
+    all_to_all_workload_.clear();
+
+    //Load traffic uses the first selected access pattern, read/write mode and chunk size
+    workload_thread_t thread;
+    thread.latency_probe = false;
+    thread.pattern_mode = useSequentialAccessPattern() ? SEQUENTIAL : RANDOM;
+    thread.rw_mode = useReads() ? READ : WRITE;
+#ifdef HAS_WORD_64
+    thread.chunk_size = CHUNK_64b; //Random load workers cannot use 32-bit chunks
+#else
+    thread.chunk_size = CHUNK_32b;
+#endif
+    if (use_chunk_32b_ && thread.pattern_mode == SEQUENTIAL)
+        thread.chunk_size = CHUNK_32b;
+#ifdef HAS_WORD_64
+    else if (use_chunk_64b_)
+        thread.chunk_size = CHUNK_64b;
+#endif
+#ifdef HAS_WORD_128
+    else if (use_chunk_128b_)
+        thread.chunk_size = CHUNK_128b;
+#endif
+#ifdef HAS_WORD_256
+    else if (use_chunk_256b_)
+        thread.chunk_size = CHUNK_256b;
+#endif
+#ifdef HAS_WORD_512
+    else if (use_chunk_512b_)
+        thread.chunk_size = CHUNK_512b;
+#endif
+    thread.stride_size = 1;
+    thread.working_set_size = working_set_size_per_thread_;
+
+    std::vector<uint32_t> mem_nodes(memory_numa_node_affinities_.cbegin(), memory_numa_node_affinities_.cend());
+    for (auto cpu_node_it = cpu_numa_node_affinities_.cbegin(); cpu_node_it != cpu_numa_node_affinities_.cend(); cpu_node_it++) {
+        uint32_t cpu_node = *cpu_node_it;
+        bool has_local = false;
+        std::vector<uint32_t> remote_nodes;
+        for (uint32_t m = 0; m < mem_nodes.size(); m++) {
+            if (mem_nodes[m] == cpu_node)
+                has_local = true;
+            else
+                remote_nodes.push_back(mem_nodes[m]);
+        }
+
+        //Round the local share to the nearest thread. All threads are local if there is no remote node, and none are if the CPU node's memory is not selected.
+        uint32_t num_local_threads = (num_worker_threads_ * all_to_all_local_percent_ + 50) / 100;
+        if (remote_nodes.empty())
+            num_local_threads = num_worker_threads_;
+        else if (!has_local)
+            num_local_threads = 0;
+
+        thread.cpu_node = cpu_node;
+        for (uint32_t t = 0; t < num_worker_threads_; t++) {
+            if (t < num_local_threads)
+                thread.mem_node = cpu_node;
+            else //Start the round-robin at a different remote node for each CPU node, so the remote traffic is spread evenly
+                thread.mem_node = remote_nodes[(t - num_local_threads + cpu_node) % remote_nodes.size()];
+            all_to_all_workload_.push_back(thread);
+        }
+    }
+
+    //The probe measures latency from the first CPU node across the links to its first remote node, or to local memory if there is none
+    workload_thread_t probe = thread;
+    probe.latency_probe = true;
+    probe.cpu_node = cpu_numa_node_affinities_.front();
+    probe.mem_node = probe.cpu_node;
+    for (uint32_t m = 0; m < mem_nodes.size(); m++) {
+        if (mem_nodes[m] != probe.cpu_node) {
+            probe.mem_node = mem_nodes[m];
+            break;
+        }
+    }
+    all_to_all_workload_.push_back(probe);
+}
@@ -0,0 +1,249 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the CoreToCoreLatencyBenchmark class.
+ */
+
+//Headers
+#include <CoreToCoreLatencyBenchmark.h>
+#include <common.h>
+#include <PingPongWorker.h>
+#include <Thread.h>
+
+//Libraries
+#include <iostream>
+#include <cstdio>
+#include <map>
+
+using namespace xmem;
+
+CoreToCoreLatencyBenchmark::CoreToCoreLatencyBenchmark(
+        void* mem_array,
+        size_t len,
+        uint32_t iterations,
+        uint32_t mem_node,
+        std::vector<int32_t> cpus,
+        std::vector<uint32_t> cpu_nodes,
+        std::vector<PowerReader*> dram_power_readers,
+        std::string name
+    ) :
+        Benchmark(
+            mem_array,
+            len,
+            iterations,
+            2,
+            mem_node,
+            cpu_nodes.empty() ? 0 : cpu_nodes[0],
+            SEQUENTIAL,
+            WRITE,
+#ifdef HAS_WORD_64
+            CHUNK_64b,
+#else
+            CHUNK_32b,
+#endif
+            1,
+            1,
+            dram_power_readers,
+            "ns/transfer",
+            name
+        ),
+        cpus_(cpus),
+        cpu_nodes_(cpu_nodes),
+        transfer_latency_(cpus.size(), std::vector<double>(cpus.size(), 0))
+    {
+}
+
+void CoreToCoreLatencyBenchmark::reportBenchmarkInfo() const {
+    std::cout << "Cache line home NUMA node: " << mem_node_ << std::endl;
+    std::cout << "Logical CPUs measured: ";
+    for (uint32_t i = 0; i < cpus_.size(); i++)
+        std::cout << cpus_[i] << " ";
+    std::cout << std::endl;
+    std::cout << "Timed round trips per CPU pair: " << CORE_TO_CORE_BENCHMARK_ROUND_TRIPS << std::endl;
+    std::cout << std::endl;
+}
+
+void CoreToCoreLatencyBenchmark::reportResults() const {
+    std::cout << std::endl;
+    std::cout << "*** RESULTS";
+    std::cout << "***" << std::endl;
+    std::cout << std::endl;
+
+    if (has_run_) {
+        //Full matrix: rows start each round trip, columns answer
+        std::cout << "One-way cache line transfer latency (" << metric_units_ << "), from row CPU to column CPU:" << std::endl;
+        std::printf("%8s", "from\\to");
+        for (uint32_t j = 0; j < cpus_.size(); j++)
+            std::printf(" %7d", cpus_[j]);
+        std::printf("\n");
+        for (uint32_t i = 0; i < cpus_.size(); i++) {
+            std::printf("%8d", cpus_[i]);
+            for (uint32_t j = 0; j < cpus_.size(); j++) {
+                if (i == j)
+                    std::printf(" %7s", "-");
+                else
+                    std::printf(" %7.1f", transfer_latency_[i][j]);
+            }
+            std::printf("\n");
+        }
+        std::cout << std::endl;
+
+        //Summarize by NUMA node pair, which is what matters most for thread placement
+        std::map<std::pair<uint32_t,uint32_t>, double> node_pair_sum;
+        std::map<std::pair<uint32_t,uint32_t>, uint32_t> node_pair_count;
+        for (uint32_t i = 0; i < cpus_.size(); i++) {
+            for (uint32_t j = 0; j < cpus_.size(); j++) {
+                if (i == j)
+                    continue;
+                std::pair<uint32_t,uint32_t> node_pair(cpu_nodes_[i], cpu_nodes_[j]);
+                node_pair_sum[node_pair] += transfer_latency_[i][j];
+                node_pair_count[node_pair]++;
+            }
+        }
+        std::cout << "Mean one-way latency by NUMA node pair:" << std::endl;
+        for (auto it = node_pair_sum.cbegin(); it != node_pair_sum.cend(); it++)
+            std::cout << "...CPU node " << it->first.first << " -> CPU node " << it->first.second << ": " << it->second / node_pair_count[it->first] << " " << metric_units_ << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "Mean over all CPU pairs: " << mean_metric_ << " " << metric_units_;
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << "Min over iterations: " << min_metric_ << " " << metric_units_;
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << "Max over iterations: " << max_metric_ << " " << metric_units_;
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << std::endl;
+
+        reportPowerResults();
+    }
+    else
+        std::cerr << "WARNING: Benchmark has not run yet. No reported results." << std::endl;
+}
+
+double CoreToCoreLatencyBenchmark::getTransferLatency(uint32_t from, uint32_t to) const {
+    if (has_run_ && from < cpus_.size() && to < cpus_.size() && from != to)
+        return transfer_latency_[from][to];
+    else //bad call
+        return -1;
+}
+
+std::vector<int32_t> CoreToCoreLatencyBenchmark::workerCpus() const {
+    return cpus_; //Every pair is measured within one run, so all of them are busy at some point
+}
+
+bool CoreToCoreLatencyBenchmark::runCore() {
+    if (cpus_.size() < 2 || cpu_nodes_.size() != cpus_.size()) {
+        std::cerr << "ERROR: Core-to-core latency benchmark needs at least 2 logical CPUs with known NUMA nodes." << std::endl;
+        return false;
+    }
+
+    //The flag lives at the start of the region, so it has a cache line of its own
+    volatile uint64_t* flag = static_cast<volatile uint64_t*>(mem_array_);
+
+    //Start power measurement
+    if (g_verbose)
+        std::cout << "Starting power measurement threads...";
+
+    if (!startPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to start power threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run benchmark
+    if (g_verbose)
+        std::cout << "Running benchmark." << std::endl << std::endl;
+
+    for (uint32_t i = 0; i < iterations_; i++) {
+        double iter_total = 0;
+        uint32_t iter_pairs = 0;
+        bool iterwarning = false;
+
+        for (uint32_t from = 0; from < cpus_.size(); from++) {
+            for (uint32_t to = 0; to < cpus_.size(); to++) {
+                if (from == to)
+                    continue;
+
+                *flag = 0;
+                PingPongWorker initiator(mem_array_, true, CORE_TO_CORE_BENCHMARK_ROUND_TRIPS, cpus_[from]);
+                PingPongWorker responder(mem_array_, false, CORE_TO_CORE_BENCHMARK_ROUND_TRIPS, cpus_[to]);
+                Thread initiator_thread(&initiator);
+                Thread responder_thread(&responder);
+
+                //Start the responder first so it is usually already waiting when the initiator begins its warmup
+                responder_thread.create_and_start();
+                initiator_thread.create_and_start();
+                if (!initiator_thread.join() || !responder_thread.join())
+                    std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+
+                iterwarning |= initiator.hadWarning() || responder.hadWarning();
+
+                //Each round trip is two one-way transfers
+                double one_way_ns = (static_cast<double>(initiator.getAdjustedTicks()) * g_ns_per_tick) / (2.0 * initiator.getPasses());
+                transfer_latency_[from][to] += one_way_ns / iterations_;
+                iter_total += one_way_ns;
+                iter_pairs++;
+
+                if (g_verbose)
+                    std::cout << "Iter " << i+1 << ": CPU " << cpus_[from] << " -> CPU " << cpus_[to] << " == " << one_way_ns << " ns one-way" << std::endl;
+            }
+        }
+
+        metric_on_iter_[i] = iter_total / iter_pairs;
+        if (iterwarning)
+            warning_ = true;
+    }
+
+    //Stop power measurement
+    if (g_verbose) {
+        std::cout << std::endl;
+        std::cout << "Stopping power measurement threads...";
+    }
+
+    if (!stopPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to stop power measurement threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run metadata
+    has_run_ = true;
+    computeMetrics();
+
+    return true;
+}
@@ -0,0 +1,273 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the GatherBenchmark class.
+ */
+
+//Headers
+#include <GatherBenchmark.h>
+#include <common.h>
+#include <benchmark_kernels.h>
+#include <GatherWorker.h>
+#include <Thread.h>
+
+//Libraries
+#include <iostream>
+#include <cstdio>
+
+using namespace xmem;
+
+GatherBenchmark::GatherBenchmark(
+        void* mem_array,
+        size_t len,
+        uint32_t iterations,
+        uint32_t num_worker_threads,
+        uint32_t mem_node,
+        uint32_t cpu_node,
+        rw_mode_t rw_mode,
+        gather_kernel_t gather_kernel,
+        std::vector<PowerReader*> dram_power_readers,
+        std::string name
+    ) :
+        Benchmark(
+            mem_array,
+            len,
+            iterations,
+            num_worker_threads,
+            mem_node,
+            cpu_node,
+            RANDOM,
+            rw_mode,
+#ifdef HAS_WORD_64
+            CHUNK_64b,
+#else
+            CHUNK_32b,
+#endif
+            1,
+            1,
+            dram_power_readers,
+            "MB/s",
+            name
+        ),
+        gather_kernel_(gather_kernel),
+        element_rate_on_iter_(iterations, 0)
+    {
+}
+
+std::string GatherBenchmark::gatherKernelName(gather_kernel_t gather_kernel) {
+    switch (gather_kernel) {
+        case GATHER_KERNEL_SCALAR:
+            return "scalar";
+        case GATHER_KERNEL_256:
+            return "avx2";
+        case GATHER_KERNEL_512:
+            return "avx512";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+uint32_t GatherBenchmark::gatherKernelLanes(gather_kernel_t gather_kernel) {
+    switch (gather_kernel) {
+        case GATHER_KERNEL_256:
+            return 4;
+        case GATHER_KERNEL_512:
+            return 8;
+        default:
+            return 1;
+    }
+}
+
+void GatherBenchmark::reportBenchmarkInfo() const {
+    std::cout << "CPU NUMA Node: " << cpu_node_ << std::endl;
+    std::cout << "Memory NUMA Node: " << mem_node_ << std::endl;
+    std::cout << "Operation: " << (rw_mode_ == READ ? "gather" : "scatter") << std::endl;
+    std::cout << "Kernel: " << gatherKernelName(gather_kernel_) << " (" << gatherKernelLanes(gather_kernel_) << " x 64-bit elements per instruction)" << std::endl;
+    std::cout << "Table size per thread: " << len_ / num_worker_threads_ / KB << " KB" << std::endl;
+    std::cout << "Number of worker threads: " << num_worker_threads_ << std::endl;
+    std::cout << std::endl;
+}
+
+void GatherBenchmark::reportResults() const {
+    std::cout << std::endl;
+    std::cout << "*** RESULTS";
+    std::cout << "***" << std::endl;
+    std::cout << std::endl;
+
+    if (has_run_) {
+        for (uint32_t i = 0; i < iterations_; i++) {
+            std::printf("Iter #%4d:    %0.3f    %s    %0.3f    M elements/s", i, metric_on_iter_[i], metric_units_.c_str(), element_rate_on_iter_[i]);
+            if (warning_)
+                std::cout << " (WARNING)";
+            std::cout << std::endl;
+        }
+
+        std::cout << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "Mean effective throughput: " << mean_metric_ << " " << metric_units_;
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << "Mean element rate: " << getMeanElementRate() << " M elements/s (" << getMeanElementRate() / gatherKernelLanes(gather_kernel_) << " M instructions/s)";
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << std::endl;
+
+        reportPowerResults();
+    }
+    else
+        std::cerr << "WARNING: Benchmark has not run yet. No reported results." << std::endl;
+}
+
+double GatherBenchmark::getMeanElementRate() const {
+    if (!has_run_)
+        return -1;
+
+    double total = 0;
+    for (uint32_t i = 0; i < iterations_; i++)
+        total += element_rate_on_iter_[i];
+    return total / iterations_;
+}
+
+bool GatherBenchmark::runCore() {
+    size_t len_per_thread = len_ / num_worker_threads_;
+    if (len_per_thread < 8 * sizeof(uint64_t)) {
+        std::cerr << "ERROR: Each worker thread needs a table of at least " << 8 * sizeof(uint64_t) << " B." << std::endl;
+        return false;
+    }
+
+    GatherFunction kernel_fptr = NULL;
+    if (!determine_gather_kernel(rw_mode_, gather_kernel_, &kernel_fptr)) {
+        std::cerr << "ERROR: The " << gatherKernelName(gather_kernel_) << " " << (rw_mode_ == READ ? "gather" : "scatter") << " kernel is not available in this build." << std::endl;
+        return false;
+    }
+
+    //Start power measurement
+    if (g_verbose)
+        std::cout << "Starting power measurement threads...";
+
+    if (!startPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to start power threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run benchmark
+    if (g_verbose)
+        std::cout << "Running benchmark." << std::endl << std::endl;
+
+    //Do a bunch of iterations of the core benchmark routine
+    for (uint32_t i = 0; i < iterations_; i++) {
+        std::vector<GatherWorker*> workers;
+        std::vector<Thread*> worker_threads;
+
+        //Create workers and worker threads, each with its own table
+        for (uint32_t t = 0; t < num_worker_threads_; t++) {
+            void* thread_mem_array = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_) + t * len_per_thread);
+            int32_t cpu_id = cpu_id_in_numa_node(cpu_node_, t);
+            if (cpu_id < 0)
+                std::cerr << "WARNING: Failed to find logical CPU " << t << " in NUMA node " << cpu_node_ << std::endl;
+            workers.push_back(new GatherWorker(thread_mem_array, len_per_thread, kernel_fptr, cpu_id));
+            worker_threads.push_back(new Thread(workers[t]));
+        }
+
+        //Start worker threads! gogogo
+        for (uint32_t t = 0; t < num_worker_threads_; t++)
+            worker_threads[t]->create_and_start();
+
+        //Wait for all threads to complete
+        for (uint32_t t = 0; t < num_worker_threads_; t++)
+            if (!worker_threads[t]->join())
+                std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+
+        //Compute metrics for this iteration
+        bool iterwarning = false;
+        double total_elements = 0;
+        double total_adjusted_ticks = 0;
+        for (uint32_t t = 0; t < num_worker_threads_; t++) {
+            total_elements += static_cast<double>(workers[t]->getPasses()) * static_cast<double>(workers[t]->getElementsPerPass());
+            total_adjusted_ticks += static_cast<double>(workers[t]->getAdjustedTicks());
+            iterwarning |= workers[t]->hadWarning();
+        }
+
+        double avg_adjusted_ticks = total_adjusted_ticks / num_worker_threads_;
+        if (avg_adjusted_ticks > 0) {
+            double seconds = (avg_adjusted_ticks * g_ns_per_tick) / 1e9;
+            metric_on_iter_[i] = (total_elements * sizeof(uint64_t) / static_cast<double>(MB)) / seconds;
+            element_rate_on_iter_[i] = (total_elements / 1e6) / seconds;
+        } else
+            iterwarning = true;
+
+        if (iterwarning)
+            warning_ = true;
+
+        if (g_verbose) { //Report metrics for this iteration
+            std::cout << "Iter " << i+1 << " had " << total_elements << " total elements " << (rw_mode_ == READ ? "gathered" : "scattered") << " across " << num_worker_threads_ << " threads:";
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...MB/s == " << metric_on_iter_[i];
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...M elements/s == " << element_rate_on_iter_[i];
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+        }
+
+        //Clean up workers and threads for this iteration
+        for (uint32_t t = 0; t < num_worker_threads_; t++) {
+            delete worker_threads[t];
+            delete workers[t];
+        }
+    }
+
+    //Stop power measurement
+    if (g_verbose) {
+        std::cout << std::endl;
+        std::cout << "Stopping power measurement threads...";
+    }
+
+    if (!stopPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to stop power measurement threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run metadata
+    has_run_ = true;
+    computeMetrics();
+
+    return true;
+}
@@ -0,0 +1,173 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the GatherWorker class.
+ */
+
+//Headers
+#include <GatherWorker.h>
+#include <common.h>
+
+//Libraries
+#include <iostream>
+#include <random>
+#include <vector>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <processthreadsapi.h>
+#endif
+
+using namespace xmem;
+
+GatherWorker::GatherWorker(
+        void* mem_array,
+        size_t len,
+        GatherFunction kernel_fptr,
+        int32_t cpu_affinity
+    ) :
+        MemoryWorker(
+            mem_array,
+            len,
+            1,
+            cpu_affinity
+        ),
+        kernel_fptr_(kernel_fptr),
+        elements_per_pass_(0)
+    {
+}
+
+GatherWorker::~GatherWorker() {
+}
+
+size_t GatherWorker::getElementsPerPass() {
+    size_t retval = 0;
+    if (acquireLock(-1)) {
+        retval = elements_per_pass_;
+        releaseLock();
+    }
+
+    return retval;
+}
+
+void GatherWorker::run() {
+    //Set up relevant state -- localized to this thread's stack
+    int32_t cpu_affinity = 0;
+    GatherFunction kernel_fptr = NULL;
+    uint64_t* table = NULL;
+    size_t num_elements = 0;
+    uint32_t passes = 0;
+    tick_t start_tick = 0;
+    tick_t stop_tick = 0;
+    tick_t elapsed_ticks = 0;
+    tick_t elapsed_dummy_ticks = 0;
+    tick_t adjusted_ticks = 0;
+    bool warning = false;
+    tick_t target_ticks = g_ticks_per_ms * BENCHMARK_DURATION_MS; //Rough target run duration in ticks
+
+    //Grab relevant setup state thread-safely and keep it local
+    if (acquireLock(-1)) {
+        table = static_cast<uint64_t*>(mem_array_);
+        num_elements = len_ / sizeof(uint64_t);
+        kernel_fptr = kernel_fptr_;
+        cpu_affinity = cpu_affinity_;
+        releaseLock();
+    }
+
+    if (num_elements > GATHER_BENCHMARK_MAX_ELEMENTS)
+        num_elements = GATHER_BENCHMARK_MAX_ELEMENTS;
+
+    //Set processor affinity
+    bool locked = lock_thread_to_cpu(cpu_affinity);
+    if (!locked)
+        std::cerr << "WARNING: Failed to lock thread to logical CPU " << cpu_affinity << "! Results may not be correct." << std::endl;
+
+    //Build the index array on this thread's NUMA node. One index per table element, rounded up to a whole number of 8-lane groups.
+    size_t num_indices = (num_elements + 7) / 8 * 8;
+    std::vector<uint32_t> indices(num_indices);
+    std::mt19937_64 gen(time(NULL) + cpu_affinity); //Mersenne Twister random number generator, seeded at current time and offset per thread
+    std::uniform_int_distribution<uint32_t> dist(0, static_cast<uint32_t>(num_elements-1));
+    for (size_t i = 0; i < num_indices; i++)
+        indices[i] = dist(gen);
+
+    //Increase scheduling priority
+#ifdef _WIN32
+    DWORD original_priority_class;
+    DWORD original_priority;
+    if (!boost_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!boost_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to boost scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Warm up the table so that it is measured out of whatever cache level it fits in
+    (*kernel_fptr)(table, indices.data(), num_indices);
+
+    //Run benchmark. There is no dummy loop: reading the index stream is part of any real vectorized lookup, so it is not subtracted.
+    while (elapsed_ticks < target_ticks) {
+        start_tick = start_timer();
+        (*kernel_fptr)(table, indices.data(), num_indices);
+        stop_tick = stop_timer();
+        elapsed_ticks += (stop_tick - start_tick);
+        passes++;
+    }
+
+    adjusted_ticks = elapsed_ticks - elapsed_dummy_ticks;
+
+    //Warn if something looks fishy
+    if (elapsed_ticks < MIN_ELAPSED_TICKS)
+        warning = true;
+
+    //Unset processor affinity
+    if (locked)
+        unlock_thread_to_numa_node();
+
+    //Revert thread priority
+#ifdef _WIN32
+    if (!revert_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!revert_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to revert scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Update the object state thread-safely
+    if (acquireLock(-1)) {
+        adjusted_ticks_ = adjusted_ticks;
+        elapsed_ticks_ = elapsed_ticks;
+        elapsed_dummy_ticks_ = elapsed_dummy_ticks;
+        warning_ = warning || !locked;
+        bytes_per_pass_ = static_cast<uint32_t>(num_indices * sizeof(uint64_t));
+        elements_per_pass_ = num_indices;
+        completed_ = true;
+        passes_ = passes;
+        releaseLock();
+    }
+}
@@ -0,0 +1,128 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the InitWorker class.
+ */
+
+//Headers
+#include <InitWorker.h>
+#include <benchmark_kernels.h>
+#include <common.h>
+#include <Thread.h>
+
+//Libraries
+#include <iostream>
+
+using namespace xmem;
+
+InitWorker::InitWorker(
+        void* mem_array,
+        size_t len,
+        int32_t cpu_affinity
+    ) :
+        MemoryWorker(
+            mem_array,
+            len,
+            1,
+            cpu_affinity
+        )
+    {
+}
+
+InitWorker::~InitWorker() {
+}
+
+void InitWorker::run() {
+    //Set up relevant state -- localized to this thread's stack
+    int32_t cpu_affinity = 0;
+    void* start_address = NULL;
+    void* end_address = NULL;
+    tick_t start_tick = 0;
+    tick_t stop_tick = 0;
+
+    //Grab relevant setup state thread-safely and keep it local
+    if (acquireLock(-1)) {
+        start_address = mem_array_;
+        end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_) + len_);
+        cpu_affinity = cpu_affinity_;
+        releaseLock();
+    }
+
+    //Set processor affinity
+    bool locked = false;
+    if (cpu_affinity >= 0)
+        locked = lock_thread_to_cpu(cpu_affinity);
+
+    //Write to all of the region to make sure pages are resident in physical memory and are not shared
+    start_tick = start_timer();
+    forwSequentialWrite_Word32(start_address, end_address);
+    stop_tick = stop_timer();
+
+    //Unset processor affinity
+    if (locked)
+        unlock_thread_to_numa_node();
+
+    //Update the object state thread-safely
+    if (acquireLock(-1)) {
+        adjusted_ticks_ = stop_tick - start_tick;
+        elapsed_ticks_ = stop_tick - start_tick;
+        elapsed_dummy_ticks_ = 0;
+        warning_ = !locked;
+        completed_ = true;
+        passes_ = 1;
+        releaseLock();
+    }
+}
+
+bool InitWorker::initializeRegions(const std::vector<void*>& regions, const std::vector<size_t>& lens, const std::vector<int32_t>& cpu_ids) {
+    std::vector<InitWorker*> workers;
+    std::vector<Thread*> worker_threads;
+    for (uint32_t t = 0; t < regions.size(); t++) {
+        workers.push_back(new InitWorker(regions[t], lens[t], cpu_ids[t]));
+        worker_threads.push_back(new Thread(workers[t]));
+    }
+
+    //Start worker threads! gogogo
+    for (uint32_t t = 0; t < worker_threads.size(); t++)
+        worker_threads[t]->create_and_start();
+
+    //Wait for all threads to complete
+    bool success = true;
+    for (uint32_t t = 0; t < worker_threads.size(); t++) {
+        if (!worker_threads[t]->join()) {
+            std::cerr << "WARNING: A memory initialization thread failed to complete correctly!" << std::endl;
+            success = false;
+        }
+        if (workers[t]->hadWarning())
+            success = false;
+        delete worker_threads[t];
+        delete workers[t];
+    }
+
+    return success;
+}
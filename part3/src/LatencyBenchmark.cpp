@@ -62,6 +62,7 @@ LatencyBenchmark::LatencyBenchmark(
         chunk_size_t chunk_size,
         int32_t stride_size,
         uint8_t mlp,
+        double load_rate,
         std::vector<PowerReader*> dram_power_readers,
         std::string name
     ) :
@@ -82,7 +83,8 @@ LatencyBenchmark::LatencyBenchmark(
             name
         ),
         load_metric_on_iter_(),
-        mean_load_metric_(0)
+        mean_load_metric_(0),
+        load_rate_per_thread_(load_rate)
     {
 
     for (uint32_t i = 0; i < iterations_; i++)
@@ -164,6 +166,13 @@ void LatencyBenchmark::reportBenchmarkInfo() const {
 
         std::cout << "Load number of worker threads: " << num_worker_threads_-1;
         std::cout << std::endl;
+
+        std::cout << "Load rate limit per thread: ";
+        if (load_rate_per_thread_ > 0)
+            std::cout << load_rate_per_thread_ << " MB/s (" << getTargetLoadMetric() << " MB/s total)";
+        else
+            std::cout << "none";
+        std::cout << std::endl;
     }
 
     std::cout << std::endl;
@@ -188,11 +197,21 @@ void LatencyBenchmark::reportResults() const {
         std::cout << std::endl;
         std::cout << std::endl;
 
-        std::cout << "Mean: " << mean_metric_ << " " << metric_units_ << " and " << mean_load_metric_ << " MB/s mean imposed load (not necessarily matched)";
+        std::cout << "Mean: " << mean_metric_ << " " << metric_units_;
+        if (g_core_ghz > 0)
+            std::cout << " (" << mean_metric_ * g_core_ghz << " core cycles)";
+        std::cout << " and " << mean_load_metric_ << " MB/s mean imposed load (not necessarily matched)";
         if (warning_)
             std::cout << " (WARNING)";
         std::cout << std::endl;
 
+        if (load_rate_per_thread_ > 0 && num_worker_threads_ > 1) {
+            std::cout << "Requested load: " << getTargetLoadMetric() << " MB/s, achieved: " << mean_load_metric_ << " MB/s (" << 100 * mean_load_metric_ / getTargetLoadMetric() << "%)";
+            if (mean_load_metric_ < 0.95 * getTargetLoadMetric())
+                std::cout << " -- load threads could not sustain the requested rate";
+            std::cout << std::endl;
+        }
+
         std::cout << "Min: " << min_metric_ << " " << metric_units_;
         if (warning_)
             std::cout << " (WARNING)";
@@ -204,6 +223,8 @@ void LatencyBenchmark::reportResults() const {
         std::cout << std::endl;
 
         std::cout << "Median: " << median_metric_ << " " << metric_units_;
+        if (g_core_ghz > 0)
+            std::cout << " (" << median_metric_ * g_core_ghz << " core cycles)";
         if (warning_)
             std::cout << " (WARNING)";
         std::cout << std::endl;
@@ -236,13 +257,9 @@ void LatencyBenchmark::reportResults() const {
         std::cout << std::endl;
         std::cout << std::endl;
 
-        for (uint32_t i = 0; i < dram_power_readers_.size(); i++) {
-            if (dram_power_readers_[i] != NULL) {
-                std::cout << dram_power_readers_[i]->name() << " Power Statistics..." << std::endl;
-                std::cout << "...Mean Power: " << dram_power_readers_[i]->getMeanPower() * dram_power_readers_[i]->getPowerUnits() << " W" << std::endl;
-                std::cout << "...Peak Power: " << dram_power_readers_[i]->getPeakPower() * dram_power_readers_[i]->getPowerUnits() << " W" << std::endl;
-            }
-        }
+        reportPowerResults();
+
+        reportPerfCounts();
     }
     else
         std::cerr << "WARNING: Benchmark has not run yet. No reported results." << std::endl;
@@ -262,6 +279,25 @@ double LatencyBenchmark::getMeanLoadMetric() const {
         return -1;
 }
 
+double LatencyBenchmark::getTargetLoadMetric() const {
+    if (num_worker_threads_ > 1)
+        return load_rate_per_thread_ * (num_worker_threads_-1);
+    else //no load threads
+        return 0;
+}
+
+double LatencyBenchmark::getEnergyEfficiency(uint32_t socket_id) const {
+    double energy_time = getDRAMEnergyTime(socket_id);
+    if (!has_run_ || energy_time <= 0 || mean_metric_ <= 0)
+        return 0;
+
+    return (getDRAMEnergy(socket_id) / energy_time) * mean_metric_; //W * ns = nJ
+}
+
+std::string LatencyBenchmark::getEnergyEfficiencyUnits() const {
+    return "nJ/access";
+}
+
 bool LatencyBenchmark::runCore() {
     size_t len_per_thread = len_ / num_worker_threads_; //Carve up memory space so each worker has its own area to play in
     uint8_t mlp = getMlp();
@@ -275,18 +311,13 @@ bool LatencyBenchmark::runCore() {
     RandomFunction lat_kernel_fptr = &chasePointers;
     RandomFunction lat_kernel_dummy_fptr = &dummy_chasePointers;
 
-    //Initialize memory regions for all threads by writing to them, causing the memory to be physically resident.
-    forwSequentialWrite_Word32(mem_array_,
-                               reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_)+len_)); //static casts to silence compiler warnings
-
     //Build pointer indices for random-access latency thread. We assume that latency thread is the first one, so we use beginning of memory region.
-    if (!build_random_pointer_permutation(mem_array_,
-                                       reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_)+len_per_thread), //static casts to silence compiler warnings
+    if (!buildPermutation(0, len_per_thread,
 #ifndef HAS_WORD_64 //special case: 32-bit architectures
-                                       CHUNK_32b)) {
+                          CHUNK_32b)) {
 #endif
 #ifdef HAS_WORD_64
-                                       CHUNK_64b)) {
+                          CHUNK_64b)) {
 #endif
         std::cerr << "ERROR: Failed to build a random pointer permutation for the latency measurement thread!" << std::endl;
         return false;
@@ -311,9 +342,7 @@ bool LatencyBenchmark::runCore() {
 
             //Build pointer indices for random-access load threads. Note that the pointers for each load thread must stay within its respective region, otherwise sharing may occur.
             for (uint32_t i = 1; i < num_worker_threads_; i++) {
-                if (!build_random_pointer_permutation(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_) + i*len_per_thread), //static casts to silence compiler warnings
-                                                   reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_) + (i+1)*len_per_thread), //static casts to silence compiler warnings
-                                                   chunk_size_)) {
+                if (!buildPermutation(i, len_per_thread, chunk_size_)) {
                     std::cerr << "ERROR: Failed to build a random pointer permutation for a load generation thread!" << std::endl;
                     return false;
                 }
@@ -367,14 +396,16 @@ bool LatencyBenchmark::runCore() {
                                                      mlp,
                                                      load_kernel_fptr_seq,
                                                      load_kernel_dummy_fptr_seq,
-                                                     cpu_id));
+                                                     cpu_id,
+                                                     load_rate_per_thread_));
                 else if (pattern_mode_ == RANDOM)
                     workers.push_back(new LoadWorker(thread_mem_array,
                                                      len_per_thread,
                                                      mlp,
                                                      load_kernel_fptr_ran,
                                                      load_kernel_dummy_fptr_ran,
-                                                     cpu_id));
+                                                     cpu_id,
+                                                     load_rate_per_thread_));
                 else
                     std::cerr << "WARNING: Invalid benchmark pattern mode." << std::endl;
             }
@@ -401,6 +432,7 @@ bool LatencyBenchmark::runCore() {
         uint32_t lat_bytes_per_pass = workers[0]->getBytesPerPass();
         uint32_t lat_accesses_per_pass = lat_bytes_per_pass / 8;
         iterwarning |= workers[0]->hadWarning();
+        addPerfCounts(workers[0]->getPerfCounts());
 
         //Compute throughput generated by load threads
         uint32_t load_total_passes = 0;
@@ -414,6 +446,7 @@ bool LatencyBenchmark::runCore() {
             load_total_elapsed_dummy_ticks += workers[t]->getElapsedDummyTicks();
             load_bytes_per_pass = workers[t]->getBytesPerPass(); //all should be the same.
             iterwarning |= workers[t]->hadWarning();
+            addPerfCounts(workers[t]->getPerfCounts());
         }
 
         //Compute load metrics for this iteration
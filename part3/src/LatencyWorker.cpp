@@ -33,6 +33,7 @@
 #include <LatencyWorker.h>
 #include <benchmark_kernels.h>
 #include <common.h>
+#include <PerfCounters.h>
 
 //Libraries
 #include <iostream>
@@ -89,6 +90,8 @@ void LatencyWorker::run() {
     size_t len = 0;
     tick_t target_ticks = g_ticks_per_ms * BENCHMARK_DURATION_MS; //Rough target run duration in ticks
     uint8_t mlp = mlp_; //TODOJ: this might be wrong
+    PerfCounters perf_counters;
+    bool use_perf_counters = false;
 
     //Grab relevant setup state thread-safely and keep it local
     if (acquireLock(-1)) {
@@ -127,6 +130,10 @@ void LatencyWorker::run() {
 
     //Run benchmark
     //Run actual version of function and loop overhead
+    if (g_perf_counters)
+        use_perf_counters = perf_counters.open();
+    if (use_perf_counters)
+        perf_counters.start();
     next_address = static_cast<uintptr_t*>(mem_array);
     while (elapsed_ticks < target_ticks) {
         start_tick = start_timer();
@@ -137,6 +144,8 @@ void LatencyWorker::run() {
         elapsed_ticks += (stop_tick - start_tick);
         passes+=256;
     }
+    if (use_perf_counters)
+        perf_counters.stop();
 
     //Run dummy version of function and loop overhead
     next_address = static_cast<uintptr_t*>(mem_array);
@@ -178,6 +187,7 @@ void LatencyWorker::run() {
         bytes_per_pass_ = bytes_per_pass;
         completed_ = true;
         passes_ = passes;
+        perf_counts_ = perf_counters.read();
         releaseLock();
     }
 }
@@ -0,0 +1,177 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the LinuxRaplPowerReader class.
+ */
+
+#ifdef __gnu_linux__
+
+//Headers
+#include <LinuxRaplPowerReader.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+using namespace xmem;
+
+LinuxRaplPowerReader::LinuxRaplPowerReader(std::string zone_path, uint32_t sampling_period, std::string name, int32_t cpu_affinity) :
+    PowerReader(sampling_period, 1, name, cpu_affinity), //Samples are in watts
+    zone_path_(zone_path),
+    max_energy_range_uj_(0),
+    valid_(false)
+{
+    std::ifstream range_file((zone_path_ + "/max_energy_range_uj").c_str());
+    if (!(range_file >> max_energy_range_uj_))
+        max_energy_range_uj_ = 0;
+
+    uint64_t energy_uj = 0;
+    valid_ = readEnergy(energy_uj);
+    if (!valid_)
+        std::cerr << "WARNING: Unable to read " << zone_path_ << "/energy_uj, so " << name << " power will not be collected. Reading RAPL energy counters usually requires root." << std::endl;
+}
+
+LinuxRaplPowerReader::~LinuxRaplPowerReader() {
+}
+
+void LinuxRaplPowerReader::run() {
+    bool done = false;
+    int32_t cpu_affinity = -1;
+    if (acquireLock(-1)) { //Wait indefinitely for the lock
+        cpu_affinity = cpu_affinity_;
+        releaseLock();
+    }
+    if (cpu_affinity >= 0 && !lock_thread_to_cpu(cpu_affinity))
+        std::cerr << "WARNING: Failed to lock " << name() << " power measurement to logical CPU " << cpu_affinity << ", so it may perturb the benchmark." << std::endl;
+
+    uint64_t last_energy_uj = 0;
+    bool have_last = readEnergy(last_energy_uj);
+    tick_t last_tick = start_timer();
+
+    while (!done) {
+        //Sleep for the rest of the sampling period, accounting for the time spent on the last sample. Sleep in short slices so that a stop ends the measurement window promptly.
+        while (!done) {
+            if (acquireLock(-1)) { //Wait indefinitely for the lock
+                if (stop_signal_) //we're done here, let's wrap up
+                    done = true;
+                releaseLock();
+            }
+
+            double remaining_ms = sampling_period_ - (start_timer() - last_tick) * g_ns_per_tick * 1e-6;
+            if (done || remaining_ms <= 0)
+                break;
+            usleep(static_cast<useconds_t>((remaining_ms < POWER_SAMPLING_PERIOD_MIN_MS ? remaining_ms : POWER_SAMPLING_PERIOD_MIN_MS) * 1000));
+        }
+
+        //After a stop, this last read closes the measurement window. Its partial period counts toward energy but not toward the power trace, as a short period can alias with the counter update interval.
+        uint64_t energy_uj = 0;
+        bool have_energy = readEnergy(energy_uj);
+        tick_t tick = stop_timer();
+        double elapsed_s = (tick - last_tick) * g_ns_per_tick * 1e-9;
+
+        if (have_last && have_energy && elapsed_s > 0) {
+            bool wrapped = energy_uj < last_energy_uj;
+            if (!wrapped || max_energy_range_uj_ > 0) { //A wrapped counter can only be unwrapped if its range is known
+                uint64_t delta_uj = wrapped ? (max_energy_range_uj_ - last_energy_uj) + energy_uj : energy_uj - last_energy_uj;
+                addEnergy(delta_uj * 1e-6, elapsed_s);
+
+                if (!done) {
+                    double result = delta_uj * 1e-6 / elapsed_s;
+
+                    //Thread-safe update of power trace
+                    if (acquireLock(-1)) { //Wait indefinitely for the lock
+                        if (num_samples_ >= power_trace_.capacity())
+                            power_trace_.reserve(power_trace_.capacity() + 256); //add more space
+                        power_trace_.push_back(result);
+                        num_samples_++;
+                        releaseLock();
+                    }
+
+                    calculateMetrics();
+                }
+            }
+        }
+
+        last_energy_uj = energy_uj;
+        have_last = have_energy;
+        last_tick = tick;
+    }
+}
+
+bool LinuxRaplPowerReader::isValid() {
+    bool retval = false;
+    if (acquireLock(-1)) { //Wait indefinitely for the lock
+        retval = valid_;
+        releaseLock();
+    }
+    return retval;
+}
+
+std::string LinuxRaplPowerReader::findZone(std::string sysfs_root, uint32_t package, std::string domain) {
+    std::string package_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "package-" << package))->str();
+
+    //Zones are numbered densely, so stop at the first one that does not exist
+    for (uint32_t n = 0; ; n++) {
+        std::string package_zone = static_cast<std::ostringstream*>(&(std::ostringstream() << sysfs_root << "/intel-rapl:" << n))->str();
+        std::ifstream package_name_file((package_zone + "/name").c_str());
+        if (!package_name_file.is_open())
+            return "";
+
+        std::string name;
+        package_name_file >> name;
+        if (name != package_name)
+            continue;
+        if (domain == "package")
+            return package_zone;
+
+        for (uint32_t m = 0; ; m++) {
+            std::string subzone = static_cast<std::ostringstream*>(&(std::ostringstream() << package_zone << ":" << m))->str();
+            std::ifstream subzone_name_file((subzone + "/name").c_str());
+            if (!subzone_name_file.is_open())
+                return "";
+
+            std::string subzone_name;
+            subzone_name_file >> subzone_name;
+            if (subzone_name == domain)
+                return subzone;
+        }
+    }
+}
+
+bool LinuxRaplPowerReader::readEnergy(uint64_t& energy_uj) const {
+    std::ifstream energy_file((zone_path_ + "/energy_uj").c_str());
+    return static_cast<bool>(energy_file >> energy_uj);
+}
+
+#endif
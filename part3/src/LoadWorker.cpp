@@ -33,6 +33,7 @@
 #include <LoadWorker.h>
 #include <benchmark_kernels.h>
 #include <common.h>
+#include <PerfCounters.h>
 
 //Libraries
 #include <iostream>
@@ -54,7 +55,8 @@ LoadWorker::LoadWorker(
         uint8_t mlp,
         SequentialFunction kernel_fptr,
         SequentialFunction kernel_dummy_fptr,
-        int32_t cpu_affinity
+        int32_t cpu_affinity,
+        double target_rate
     ) :
         MemoryWorker(
             mem_array,
@@ -62,12 +64,12 @@ LoadWorker::LoadWorker(
             mlp,
             cpu_affinity
         ),
-        mlp_(mlp), //TODOJ: maybe this?
         use_sequential_kernel_fptr_(true),
         kernel_fptr_seq_(kernel_fptr),
         kernel_dummy_fptr_seq_(kernel_dummy_fptr),
         kernel_fptr_ran_(NULL),
-        kernel_dummy_fptr_ran_(NULL)
+        kernel_dummy_fptr_ran_(NULL),
+        target_rate_(target_rate)
     {
 }
 
@@ -77,7 +79,8 @@ LoadWorker::LoadWorker(
         uint8_t mlp,
         RandomFunction kernel_fptr,
         RandomFunction kernel_dummy_fptr,
-        int32_t cpu_affinity
+        int32_t cpu_affinity,
+        double target_rate
     ) :
         MemoryWorker(
             mem_array,
@@ -89,13 +92,24 @@ LoadWorker::LoadWorker(
         kernel_fptr_seq_(NULL),
         kernel_dummy_fptr_seq_(NULL),
         kernel_fptr_ran_(kernel_fptr),
-        kernel_dummy_fptr_ran_(kernel_dummy_fptr)
+        kernel_dummy_fptr_ran_(kernel_dummy_fptr),
+        target_rate_(target_rate)
     {
 }
 
 LoadWorker::~LoadWorker() {
 }
 
+double LoadWorker::getTargetRate() {
+    double retval = 0;
+    if (acquireLock(-1)) {
+        retval = target_rate_;
+        releaseLock();
+    }
+
+    return retval;
+}
+
 void LoadWorker::run() {
     //Set up relevant state -- localized to this thread's stack
     int32_t cpu_affinity = 0;
@@ -119,22 +133,26 @@ void LoadWorker::run() {
     void* mem_array = NULL;
     size_t len = 0;
     tick_t target_ticks = g_ticks_per_ms * BENCHMARK_DURATION_MS; //Rough target run duration in ticks
+    double target_rate = 0;
     uint32_t p = 0;
     bytes_per_pass = THROUGHPUT_BENCHMARK_BYTES_PER_PASS;
-    uint8_t mlp = 1;  //TODOJ: pretty sure this hardcoded one is wrong! may have to set to mlp_, and then uncomment mlp_ in constructor (line 65)
-    //uint8_t mlp = mlp_; //TODOJ: ?
+    uint8_t mlp = 1;
+    uintptr_t* chains[MAX_RANDOM_CHAINS]; //Cursors of the independent chains followed by random kernels
+    PerfCounters perf_counters;
+    bool use_perf_counters = false;
 
     //Grab relevant setup state thread-safely and keep it local
     if (acquireLock(-1)) {
         mem_array = mem_array_;
         len = len_;
-        mlp = mlp_; //TODOJ: ?
+        mlp = mlp_;
         cpu_affinity = cpu_affinity_;
         use_sequential_kernel_fptr = use_sequential_kernel_fptr_;
         kernel_fptr_seq = kernel_fptr_seq_;
         kernel_dummy_fptr_seq = kernel_dummy_fptr_seq_;
         kernel_fptr_ran = kernel_fptr_ran_;
         kernel_dummy_fptr_ran = kernel_dummy_fptr_ran_;
+        target_rate = target_rate_;
         start_address = mem_array_;
         end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_)+bytes_per_pass);
         prime_start_address = mem_array_;
@@ -142,6 +160,17 @@ void LoadWorker::run() {
         releaseLock();
     }
 
+    //Random kernels interleave mlp independent chains. Round each pass down so every chain does the same number of hops of even the widest chunk.
+    if (!use_sequential_kernel_fptr) {
+        if (mlp < 1)
+            mlp = 1;
+        else if (mlp > MAX_RANDOM_CHAINS) {
+            std::cerr << "WARNING: Random-access load threads support at most " << MAX_RANDOM_CHAINS << " independent chains, but an MLP of " << static_cast<uint32_t>(mlp) << " was requested." << std::endl;
+            mlp = MAX_RANDOM_CHAINS;
+        }
+        bytes_per_pass -= bytes_per_pass % (mlp * CACHE_LINE_SIZE);
+    }
+
     //Set processor affinity
     bool locked = lock_thread_to_cpu(cpu_affinity);
     if (!locked)
@@ -164,50 +193,98 @@ void LoadWorker::run() {
     }
 
     //Run the benchmark!
-    uintptr_t* next_address = static_cast<uintptr_t*>(mem_array);
-    //Run actual version of function and loop overhead
-    while (elapsed_ticks < target_ticks) {
-        if (use_sequential_kernel_fptr) { //sequential function semantics
-            start_tick = start_timer();
-            UNROLL1024(
-                (*kernel_fptr_seq)(start_address, end_address);
-                start_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array)+(reinterpret_cast<uintptr_t>(start_address)+bytes_per_pass) % len);
-                end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(start_address) + bytes_per_pass);
-            )
-            stop_tick = stop_timer();
-            passes+=1024;
-        } else { //random function semantics
-            start_tick = start_timer();
-            UNROLL1024((*kernel_fptr_ran)(next_address, &next_address, bytes_per_pass, mlp);)  //TODOJ: mlp here may be wrong!
-            stop_tick = stop_timer();
-            passes+=1024;
-        }
-        elapsed_ticks += (stop_tick - start_tick);
-    }
+    if (!use_sequential_kernel_fptr)
+        place_random_chains(mem_array, len, chains, mlp);
+    if (g_perf_counters)
+        use_perf_counters = perf_counters.open();
+    if (target_rate > 0) { //Open-loop mode: a token bucket paces bursts of passes so the imposed bandwidth does not depend on how fast the kernel is
+        double bytes_per_tick = (target_rate * MB * g_ns_per_tick) / 1e9;
+        double burst_bytes = static_cast<double>(LOAD_RATE_BURST_PASSES) * bytes_per_pass;
+        double bucket_depth = 2 * burst_bytes; //Room for one burst plus whatever accrued while we were checking the clock
+        double tokens = 0;
+        tick_t now_tick = 0;
+        tick_t last_tick = 0;
+
+        if (use_perf_counters)
+            perf_counters.start();
+        start_tick = start_timer();
+        last_tick = start_tick;
+        while (elapsed_ticks < target_ticks) {
+            now_tick = start_timer();
+            tokens += static_cast<double>(now_tick - last_tick) * bytes_per_tick;
+            if (tokens > bucket_depth) //Budget that could not be spent in time is lost, so a stalled worker never catches up with one huge burst
+                tokens = bucket_depth;
+            last_tick = now_tick;
+            elapsed_ticks = now_tick - start_tick;
 
-    //Run dummy version of function and loop overhead
-    p = 0;
-    start_address = mem_array;
-    end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + bytes_per_pass);
-    next_address = static_cast<uintptr_t*>(mem_array);
-    while (p < passes) {
-        if (use_sequential_kernel_fptr) { //sequential function semantics
-            start_tick = start_timer();
-            UNROLL1024(
-                (*kernel_dummy_fptr_seq)(start_address, end_address);
-                start_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array)+(reinterpret_cast<uintptr_t>(start_address)+bytes_per_pass) % len);
-                end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(start_address) + bytes_per_pass);
-            )
-            stop_tick = stop_timer();
-            p+=1024;
-        } else { //random function semantics
-            start_tick = start_timer();
-            UNROLL1024((*kernel_dummy_fptr_ran)(next_address, &next_address, bytes_per_pass, mlp);)   //TODOJ: mlp here may be wrong!
-            stop_tick = stop_timer();
-            p+=1024;
+            if (tokens < burst_bytes) //Not allowed to issue a burst yet
+                continue;
+
+            if (use_sequential_kernel_fptr) { //sequential function semantics
+                for (uint32_t b = 0; b < LOAD_RATE_BURST_PASSES; b++) {
+                    (*kernel_fptr_seq)(start_address, end_address);
+                    start_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array)+(reinterpret_cast<uintptr_t>(start_address)+bytes_per_pass) % len);
+                    end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(start_address) + bytes_per_pass);
+                }
+            } else { //random function semantics
+                for (uint32_t b = 0; b < LOAD_RATE_BURST_PASSES; b++)
+                    (*kernel_fptr_ran)(chains[0], chains, bytes_per_pass, mlp);
+            }
+            tokens -= burst_bytes;
+            passes += LOAD_RATE_BURST_PASSES;
+        }
+        stop_tick = stop_timer();
+        if (use_perf_counters)
+            perf_counters.stop();
+        elapsed_ticks = stop_tick - start_tick; //Wall time including idle waiting, so passes over ticks gives the achieved rate. There is no dummy run to subtract.
+    } else { //Closed-loop mode: run as fast as possible
+        //Run actual version of function and loop overhead
+        if (use_perf_counters)
+            perf_counters.start();
+        while (elapsed_ticks < target_ticks) {
+            if (use_sequential_kernel_fptr) { //sequential function semantics
+                start_tick = start_timer();
+                UNROLL1024(
+                    (*kernel_fptr_seq)(start_address, end_address);
+                    start_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array)+(reinterpret_cast<uintptr_t>(start_address)+bytes_per_pass) % len);
+                    end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(start_address) + bytes_per_pass);
+                )
+                stop_tick = stop_timer();
+                passes+=1024;
+            } else { //random function semantics
+                start_tick = start_timer();
+                UNROLL1024((*kernel_fptr_ran)(chains[0], chains, bytes_per_pass, mlp);)
+                stop_tick = stop_timer();
+                passes+=1024;
+            }
+            elapsed_ticks += (stop_tick - start_tick);
         }
+        if (use_perf_counters)
+            perf_counters.stop();
 
-        elapsed_dummy_ticks += (stop_tick - start_tick);
+        //Run dummy version of function and loop overhead
+        p = 0;
+        start_address = mem_array;
+        end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + bytes_per_pass);
+        while (p < passes) {
+            if (use_sequential_kernel_fptr) { //sequential function semantics
+                start_tick = start_timer();
+                UNROLL1024(
+                    (*kernel_dummy_fptr_seq)(start_address, end_address);
+                    start_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array)+(reinterpret_cast<uintptr_t>(start_address)+bytes_per_pass) % len);
+                    end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(start_address) + bytes_per_pass);
+                )
+                stop_tick = stop_timer();
+                p+=1024;
+            } else { //random function semantics
+                start_tick = start_timer();
+                UNROLL1024((*kernel_dummy_fptr_ran)(chains[0], chains, bytes_per_pass, mlp);)
+                stop_tick = stop_timer();
+                p+=1024;
+            }
+
+            elapsed_dummy_ticks += (stop_tick - start_tick);
+        }
     }
 
     //Unset processor affinity
@@ -238,6 +315,7 @@ void LoadWorker::run() {
         bytes_per_pass_ = bytes_per_pass;
         completed_ = true;
         passes_ = passes;
+        perf_counts_ = perf_counters.read();
         releaseLock();
     }
 }
@@ -32,6 +32,7 @@
 //Headers
 #include <MemoryWorker.h>
 #include <common.h>
+#include <PerfCounters.h>
 
 using namespace xmem;
 
@@ -51,7 +52,8 @@ MemoryWorker::MemoryWorker(
         elapsed_dummy_ticks_(0),
         adjusted_ticks_(0),
         warning_(false),
-        completed_(false)
+        completed_(false),
+        perf_counts_(PerfCounters::emptyCounts())
     {
 }
 
@@ -138,3 +140,13 @@ bool MemoryWorker::hadWarning() {
 
     return retval;
 }
+
+perf_counts_t MemoryWorker::getPerfCounts() {
+    perf_counts_t retval = PerfCounters::emptyCounts();
+    if (acquireLock(-1)) {
+        retval = perf_counts_;
+        releaseLock();
+    }
+
+    return retval;
+}
@@ -0,0 +1,413 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the PageFaultBenchmark class.
+ */
+
+//Headers
+#include <PageFaultBenchmark.h>
+#include <common.h>
+#include <PageFaultWorker.h>
+#include <Thread.h>
+
+//Libraries
+#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifdef __gnu_linux__
+#include <unistd.h>
+#include <sys/resource.h> //for getrusage()
+#include <sys/wait.h>
+#endif
+
+using namespace xmem;
+
+PageFaultBenchmark::PageFaultBenchmark(
+        size_t len,
+        uint32_t iterations,
+        uint32_t num_worker_threads,
+        uint32_t mem_node,
+        uint32_t cpu_node,
+        page_backing_t backing,
+        bool use_memfd,
+        fault_mode_t fault_mode,
+        size_t large_page_size,
+        std::vector<PowerReader*> dram_power_readers,
+        std::string name
+    ) :
+        Benchmark(
+            NULL, //Every iteration maps its own region
+            len,
+            iterations,
+            num_worker_threads,
+            mem_node,
+            cpu_node,
+            SEQUENTIAL,
+            WRITE,
+#ifdef HAS_WORD_64
+            CHUNK_64b,
+#else
+            CHUNK_32b,
+#endif
+            1,
+            1,
+            dram_power_readers,
+            "MB/s",
+            name
+        ),
+        backing_(backing),
+        use_memfd_(use_memfd),
+        fault_mode_(fault_mode),
+        large_page_size_(large_page_size),
+        fault_rate_on_iter_(iterations, 0),
+        faults_on_iter_(iterations, 0)
+    {
+}
+
+std::string PageFaultBenchmark::settingName(page_backing_t backing, bool use_memfd, fault_mode_t fault_mode) {
+    std::string name;
+    switch (backing) {
+        case PAGE_BACKING_BASE:
+            name = "base";
+            break;
+        case PAGE_BACKING_THP:
+            name = "thp";
+            break;
+        case PAGE_BACKING_HUGETLB:
+            name = "hugetlb";
+            break;
+        default:
+            name = "UNKNOWN";
+            break;
+    }
+
+    name += use_memfd ? " memfd" : " anon";
+
+    switch (fault_mode) {
+        case FAULT_LAZY:
+            name += " lazy";
+            break;
+        case FAULT_POPULATE:
+            name += " populate";
+            break;
+        case FAULT_COW:
+            name += " cow";
+            break;
+        default:
+            name += " UNKNOWN";
+            break;
+    }
+
+    return name;
+}
+
+void PageFaultBenchmark::reportBenchmarkInfo() const {
+    std::cout << "CPU NUMA Node: " << cpu_node_ << std::endl;
+    std::cout << "Memory NUMA Node: " << mem_node_ << std::endl;
+    std::cout << "Setting: " << settingName(backing_, use_memfd_, fault_mode_) << std::endl;
+    std::cout << "Page size: " << (backing_ == PAGE_BACKING_BASE ? g_page_size : large_page_size_) / KB << " KB" << std::endl;
+    std::cout << "Region size: " << len_ / KB << " KB" << std::endl;
+    std::cout << "Number of worker threads: " << num_worker_threads_ << std::endl;
+    std::cout << std::endl;
+}
+
+void PageFaultBenchmark::reportResults() const {
+    std::cout << std::endl;
+    std::cout << "*** RESULTS";
+    std::cout << "***" << std::endl;
+    std::cout << std::endl;
+
+    if (has_run_) {
+        for (uint32_t i = 0; i < iterations_; i++) {
+            std::printf("Iter #%4d:    %0.3f    %s    %0.0f    faults/s", i, metric_on_iter_[i], metric_units_.c_str(), fault_rate_on_iter_[i]);
+            if (warning_)
+                std::cout << " (WARNING)";
+            std::cout << std::endl;
+        }
+
+        std::cout << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "Mean first-touch throughput: " << mean_metric_ << " " << metric_units_;
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << "Mean fault rate: " << getMeanFaultRate() << " faults/s (" << getMeanFaults() << " faults per iteration)";
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << std::endl;
+
+        reportPowerResults();
+    }
+    else
+        std::cerr << "WARNING: Benchmark has not run yet. No reported results." << std::endl;
+}
+
+double PageFaultBenchmark::getMeanFaultRate() const {
+    if (!has_run_)
+        return -1;
+
+    double total = 0;
+    for (uint32_t i = 0; i < iterations_; i++)
+        total += fault_rate_on_iter_[i];
+    return total / iterations_;
+}
+
+double PageFaultBenchmark::getMeanFaults() const {
+    if (!has_run_)
+        return -1;
+
+    double total = 0;
+    for (uint32_t i = 0; i < iterations_; i++)
+        total += faults_on_iter_[i];
+    return total / iterations_;
+}
+
+tick_t PageFaultBenchmark::touchRegion(void* region, bool& iterwarning) {
+    //Split the region into equal shares of whole backing pages, so that no page is faulted in by two threads
+    size_t page_size = (backing_ == PAGE_BACKING_BASE) ? g_page_size : large_page_size_;
+    size_t num_pages = len_ / page_size;
+    size_t first_page = 0;
+
+    std::vector<PageFaultWorker*> workers;
+    std::vector<Thread*> worker_threads;
+    for (uint32_t t = 0; t < num_worker_threads_; t++) {
+        size_t thread_pages = num_pages / num_worker_threads_ + (t < num_pages % num_worker_threads_ ? 1 : 0);
+        void* thread_region = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(region) + first_page * page_size);
+        first_page += thread_pages;
+        int32_t cpu_id = cpu_id_in_numa_node(cpu_node_, t);
+        if (cpu_id < 0)
+            std::cerr << "WARNING: Failed to find logical CPU " << t << " in NUMA node " << cpu_node_ << std::endl;
+        workers.push_back(new PageFaultWorker(thread_region, thread_pages * page_size, mem_node_, cpu_id));
+        worker_threads.push_back(new Thread(workers[t]));
+    }
+
+    //Start worker threads! gogogo
+    for (uint32_t t = 0; t < num_worker_threads_; t++)
+        worker_threads[t]->create_and_start();
+
+    //Wait for all threads to complete
+    for (uint32_t t = 0; t < num_worker_threads_; t++)
+        if (!worker_threads[t]->join())
+            std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+
+    //The region is only usable once the slowest thread is done
+    tick_t max_ticks = 0;
+    for (uint32_t t = 0; t < num_worker_threads_; t++) {
+        if (workers[t]->getElapsedTicks() > max_ticks)
+            max_ticks = workers[t]->getElapsedTicks();
+        iterwarning |= workers[t]->hadWarning();
+        delete worker_threads[t];
+        delete workers[t];
+    }
+
+    return max_ticks;
+}
+
+bool PageFaultBenchmark::runCore() {
+#ifndef __gnu_linux__
+    std::cerr << "ERROR: The page fault benchmark is only supported on GNU/Linux." << std::endl;
+    return false;
+#else
+    if (fault_mode_ == FAULT_POPULATE && num_worker_threads_ != 1) {
+        std::cerr << "ERROR: A populating mapping is faulted in by the kernel on the mapping thread, so it can only use one worker thread." << std::endl;
+        return false;
+    }
+    if (fault_mode_ == FAULT_COW && use_memfd_) {
+        std::cerr << "ERROR: Shared memfd mappings do not take copy-on-write faults." << std::endl;
+        return false;
+    }
+
+    //Explicit huge pages must be free on the memory node under test, or faulting them in there would fail with SIGBUS. Copy-on-write needs a second set.
+    if (backing_ == PAGE_BACKING_HUGETLB) {
+        size_t needed = len_ / large_page_size_ * (fault_mode_ == FAULT_COW ? 2 : 1);
+        size_t free_pages = 0;
+        std::ostringstream pool_path;
+        pool_path << "/sys/devices/system/node/node" << mem_node_ << "/hugepages/hugepages-" << large_page_size_ / KB << "kB/free_hugepages";
+        std::ifstream pool(pool_path.str().c_str());
+        if (!(pool >> free_pages) || free_pages < needed) {
+            std::cerr << "WARNING: Need " << needed << " free huge pages of " << large_page_size_ / KB << " KB on NUMA node " << mem_node_ << ", but only " << free_pages << " are available. Skipping." << std::endl;
+            return false;
+        }
+    }
+
+    //Start power measurement
+    if (g_verbose)
+        std::cout << "Starting power measurement threads...";
+
+    if (!startPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to start power threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run benchmark
+    if (g_verbose)
+        std::cout << "Running benchmark." << std::endl << std::endl;
+
+    //Every iteration starts from a brand new mapping
+    bool success = true;
+    for (uint32_t i = 0; i < iterations_ && success; i++) {
+        void* region = NULL;
+        int fd = -1;
+        pid_t child = -1;
+        int child_pipe[2] = { -1, -1 };
+        bool iterwarning = false;
+
+        if (fault_mode_ != FAULT_POPULATE) {
+            region = PageFaultWorker::mapRegion(backing_, use_memfd_, len_, large_page_size_, false, fd);
+            if (region == NULL) {
+                std::cerr << "ERROR: Failed to map " << len_ / KB << " KB for " << settingName(backing_, use_memfd_, fault_mode_) << "." << std::endl;
+                success = false;
+                break;
+            }
+
+            if (fault_mode_ == FAULT_COW) {
+                //Untimed: the parent owns every page before the child shares them
+                touchRegion(region, iterwarning);
+                if (pipe(child_pipe) != 0) {
+                    std::cerr << "ERROR: Failed to create a pipe for the copy-on-write child process." << std::endl;
+                    PageFaultWorker::unmapRegion(region, len_, fd);
+                    success = false;
+                    break;
+                }
+                child = fork();
+                if (child == 0) { //Child: hold on to the shared pages without touching them until the parent closes the pipe
+                    char c;
+                    close(child_pipe[1]);
+                    while (read(child_pipe[0], &c, 1) > 0)
+                        ;
+                    _exit(0);
+                }
+                close(child_pipe[0]);
+                if (child < 0) {
+                    std::cerr << "ERROR: Failed to fork the copy-on-write child process." << std::endl;
+                    close(child_pipe[1]);
+                    PageFaultWorker::unmapRegion(region, len_, fd);
+                    success = false;
+                    break;
+                }
+            }
+        }
+
+        //Faults are counted for the whole process, including ones the kernel takes on our behalf while populating
+        struct rusage usage_before;
+        struct rusage usage_after;
+        getrusage(RUSAGE_SELF, &usage_before);
+
+        tick_t ticks = 0;
+        if (fault_mode_ == FAULT_POPULATE) {
+            int32_t cpu_id = cpu_id_in_numa_node(cpu_node_, 0);
+            if (cpu_id < 0)
+                std::cerr << "WARNING: Failed to find logical CPU 0 in NUMA node " << cpu_node_ << std::endl;
+            PageFaultWorker* worker = new PageFaultWorker(backing_, use_memfd_, len_, large_page_size_, mem_node_, cpu_id);
+            Thread* worker_thread = new Thread(worker);
+            worker_thread->create_and_start();
+            if (!worker_thread->join())
+                std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+            ticks = worker->getElapsedTicks();
+            region = worker->getRegion();
+            fd = worker->getFd();
+            iterwarning |= worker->hadWarning();
+            delete worker_thread;
+            delete worker;
+        } else
+            ticks = touchRegion(region, iterwarning);
+
+        getrusage(RUSAGE_SELF, &usage_after);
+        double faults = static_cast<double>((usage_after.ru_minflt - usage_before.ru_minflt) + (usage_after.ru_majflt - usage_before.ru_majflt));
+
+        //Let the copy-on-write child go
+        if (child > 0) {
+            close(child_pipe[1]);
+            waitpid(child, NULL, 0);
+        }
+
+        if (region == NULL) {
+            std::cerr << "ERROR: Failed to map and populate " << len_ / KB << " KB for " << settingName(backing_, use_memfd_, fault_mode_) << "." << std::endl;
+            success = false;
+            break;
+        }
+        PageFaultWorker::unmapRegion(region, len_, fd);
+
+        //Compute metrics for this iteration
+        faults_on_iter_[i] = faults;
+        if (ticks > 0) {
+            double seconds = (static_cast<double>(ticks) * g_ns_per_tick) / 1e9;
+            metric_on_iter_[i] = (static_cast<double>(len_) / static_cast<double>(MB)) / seconds;
+            fault_rate_on_iter_[i] = faults / seconds;
+        } else
+            iterwarning = true;
+
+        if (iterwarning)
+            warning_ = true;
+
+        if (g_verbose) { //Report metrics for this iteration
+            std::cout << "Iter " << i+1 << " took " << faults << " page faults on " << len_ / KB << " KB across " << num_worker_threads_ << " threads:";
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...MB/s == " << metric_on_iter_[i];
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...faults/s == " << fault_rate_on_iter_[i];
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+        }
+    }
+
+    //Stop power measurement
+    if (g_verbose) {
+        std::cout << std::endl;
+        std::cout << "Stopping power measurement threads...";
+    }
+
+    if (!stopPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to stop power measurement threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    if (!success)
+        return false;
+
+    //Run metadata
+    has_run_ = true;
+    computeMetrics();
+
+    return true;
+#endif
+}
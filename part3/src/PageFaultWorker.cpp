@@ -0,0 +1,329 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the PageFaultWorker class.
+ */
+
+//Headers
+#include <PageFaultWorker.h>
+#include <common.h>
+
+//Libraries
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <processthreadsapi.h>
+#endif
+
+#ifdef __gnu_linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef HAS_NUMA
+#include <numa.h>
+#include <numaif.h> //for set_mempolicy()
+#endif
+#ifndef MAP_HUGE_SHIFT //Older C libraries lack the page size selector flags for huge pages
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MFD_HUGE_SHIFT
+#define MFD_HUGE_SHIFT 26
+#endif
+#endif
+
+using namespace xmem;
+
+PageFaultWorker::PageFaultWorker(
+        void* mem_array,
+        size_t len,
+        uint32_t mem_node,
+        int32_t cpu_affinity
+    ) :
+        MemoryWorker(
+            mem_array,
+            len,
+            1,
+            cpu_affinity
+        ),
+        populate_(false),
+        backing_(PAGE_BACKING_BASE),
+        use_memfd_(false),
+        large_page_size_(0),
+        mem_node_(mem_node),
+        fd_(-1)
+    {
+}
+
+PageFaultWorker::PageFaultWorker(
+        page_backing_t backing,
+        bool use_memfd,
+        size_t len,
+        size_t large_page_size,
+        uint32_t mem_node,
+        int32_t cpu_affinity
+    ) :
+        MemoryWorker(
+            nullptr,
+            len,
+            1,
+            cpu_affinity
+        ),
+        populate_(true),
+        backing_(backing),
+        use_memfd_(use_memfd),
+        large_page_size_(large_page_size),
+        mem_node_(mem_node),
+        fd_(-1)
+    {
+}
+
+PageFaultWorker::~PageFaultWorker() {
+}
+
+void* PageFaultWorker::getRegion() {
+    void* retval = nullptr;
+    if (acquireLock(-1)) {
+        retval = mem_array_;
+        releaseLock();
+    }
+
+    return retval;
+}
+
+int PageFaultWorker::getFd() {
+    int retval = -1;
+    if (acquireLock(-1)) {
+        retval = fd_;
+        releaseLock();
+    }
+
+    return retval;
+}
+
+void* PageFaultWorker::mapRegion(page_backing_t backing, bool use_memfd, size_t len, size_t large_page_size, bool populate, int& fd) {
+    fd = -1;
+#ifdef __gnu_linux__
+    int page_shift = 0;
+    while ((static_cast<size_t>(1) << page_shift) < large_page_size)
+        page_shift++;
+
+    int flags = 0;
+    if (use_memfd) {
+        unsigned int memfd_flags = 0;
+        if (backing == PAGE_BACKING_HUGETLB)
+            memfd_flags = MFD_HUGETLB | (page_shift << MFD_HUGE_SHIFT);
+        fd = memfd_create("xmem", memfd_flags);
+        if (fd < 0)
+            return nullptr;
+        if (ftruncate(fd, len) != 0) {
+            close(fd);
+            fd = -1;
+            return nullptr;
+        }
+        flags = MAP_SHARED;
+    } else {
+        flags = MAP_PRIVATE | MAP_ANONYMOUS;
+        if (backing == PAGE_BACKING_HUGETLB)
+            flags |= MAP_HUGETLB | (page_shift << MAP_HUGE_SHIFT);
+    }
+
+    //Transparent huge pages need a huge-page-aligned address, which is also huge-page-aligned relative to the file offset for a memfd. Reserve some headroom and map over an aligned part of it.
+    void* reservation = MAP_FAILED;
+    void* hint = NULL;
+    if (backing == PAGE_BACKING_THP) {
+        reservation = mmap(NULL, len + large_page_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (reservation == MAP_FAILED) {
+            unmapRegion(NULL, 0, fd);
+            fd = -1;
+            return nullptr;
+        }
+        uintptr_t mask = static_cast<uintptr_t>(large_page_size) - 1;
+        hint = reinterpret_cast<void*>((reinterpret_cast<uintptr_t>(reservation) + mask) & ~mask);
+        flags |= MAP_FIXED;
+    }
+
+    //Transparent huge pages must be advised before anything is faulted in, so they cannot use MAP_POPULATE
+    if (populate && backing != PAGE_BACKING_THP)
+        flags |= MAP_POPULATE;
+
+    void* region = mmap(hint, len, PROT_READ | PROT_WRITE, flags, fd, 0);
+
+    if (backing == PAGE_BACKING_THP) { //Give back the headroom that is not covered by the region
+        uint8_t* reservation_start = reinterpret_cast<uint8_t*>(reservation);
+        uint8_t* reservation_end = reservation_start + len + large_page_size;
+        if (region == MAP_FAILED)
+            munmap(reservation, len + large_page_size);
+        else {
+            uint8_t* region_start = reinterpret_cast<uint8_t*>(region);
+            if (region_start > reservation_start)
+                munmap(reservation_start, region_start - reservation_start);
+            if (region_start + len < reservation_end)
+                munmap(region_start + len, reservation_end - (region_start + len));
+        }
+    }
+
+    if (region == MAP_FAILED) {
+        unmapRegion(NULL, 0, fd);
+        fd = -1;
+        return nullptr;
+    }
+
+    if (backing == PAGE_BACKING_THP) {
+        madvise(region, len, MADV_HUGEPAGE); //If THP is disabled, this falls back to regular pages, which shows up in the fault count
+        if (populate) {
+#ifdef MADV_POPULATE_WRITE
+            if (madvise(region, len, MADV_POPULATE_WRITE) != 0) {
+#endif
+                unmapRegion(region, len, fd);
+                fd = -1;
+                return nullptr;
+#ifdef MADV_POPULATE_WRITE
+            }
+#endif
+        }
+    }
+
+    return region;
+#else
+    return nullptr;
+#endif
+}
+
+void PageFaultWorker::unmapRegion(void* region, size_t len, int fd) {
+#ifdef __gnu_linux__
+    if (region != NULL)
+        munmap(region, len);
+    if (fd >= 0)
+        close(fd);
+#endif
+}
+
+void PageFaultWorker::run() {
+    //Set up relevant state -- localized to this thread's stack
+    int32_t cpu_affinity = 0;
+    void* region = NULL;
+    size_t len = 0;
+    bool populate = false;
+    page_backing_t backing = PAGE_BACKING_BASE;
+    bool use_memfd = false;
+    size_t large_page_size = 0;
+    uint32_t mem_node = 0;
+    int fd = -1;
+    tick_t start_tick = 0;
+    tick_t stop_tick = 0;
+    tick_t elapsed_ticks = 0;
+    bool warning = false;
+
+    //Grab relevant setup state thread-safely and keep it local
+    if (acquireLock(-1)) {
+        region = mem_array_;
+        len = len_;
+        populate = populate_;
+        backing = backing_;
+        use_memfd = use_memfd_;
+        large_page_size = large_page_size_;
+        mem_node = mem_node_;
+        cpu_affinity = cpu_affinity_;
+        releaseLock();
+    }
+
+    //Set processor affinity
+    bool locked = lock_thread_to_cpu(cpu_affinity);
+    if (!locked)
+        std::cerr << "WARNING: Failed to lock thread to logical CPU " << cpu_affinity << "! Results may not be correct." << std::endl;
+
+    //Pages faulted in by this thread go to the memory node under test. Copy-on-write copies are allocated by the faulting thread too.
+    bool bound = true;
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+    struct bitmask* nodes = numa_allocate_nodemask();
+    numa_bitmask_setbit(nodes, mem_node);
+    bound = (set_mempolicy(MPOL_BIND, nodes->maskp, nodes->size + 1) == 0);
+    numa_free_nodemask(nodes);
+    if (!bound)
+        std::cerr << "WARNING: Failed to bind the memory policy of a page fault worker to NUMA node " << mem_node << "! Results may not be correct." << std::endl;
+#endif
+
+    //Increase scheduling priority
+#ifdef _WIN32
+    DWORD original_priority_class;
+    DWORD original_priority;
+    if (!boost_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!boost_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to boost scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Run benchmark. Every page is faulted in exactly once, so there is nothing to repeat and no dummy loop.
+    if (populate) {
+        start_tick = start_timer();
+        region = mapRegion(backing, use_memfd, len, large_page_size, true, fd);
+        stop_tick = stop_timer();
+    } else {
+        volatile uint8_t* bytes = static_cast<volatile uint8_t*>(region);
+        start_tick = start_timer();
+        for (size_t offset = 0; offset < len; offset += g_page_size) //One write per base page. Extra writes to an already faulted-in huge page are cheap.
+            bytes[offset] = 1;
+        stop_tick = stop_timer();
+    }
+    elapsed_ticks = stop_tick - start_tick;
+
+    //Warn if something looks fishy
+    if (region == NULL || elapsed_ticks == 0)
+        warning = true;
+
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+    set_mempolicy(MPOL_DEFAULT, NULL, 0);
+#endif
+
+    //Unset processor affinity
+    if (locked)
+        unlock_thread_to_numa_node();
+
+    //Revert thread priority
+#ifdef _WIN32
+    if (!revert_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!revert_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to revert scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Update the object state thread-safely
+    if (acquireLock(-1)) {
+        mem_array_ = region;
+        fd_ = fd;
+        adjusted_ticks_ = elapsed_ticks;
+        elapsed_ticks_ = elapsed_ticks;
+        elapsed_dummy_ticks_ = 0;
+        warning_ = warning || !locked || !bound;
+        completed_ = true;
+        passes_ = 1;
+        releaseLock();
+    }
+}
@@ -0,0 +1,411 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the PageMigrationBenchmark class.
+ */
+
+//Headers
+#include <PageMigrationBenchmark.h>
+#include <common.h>
+#include <benchmark_kernels.h>
+#include <LatencyWorker.h>
+#include <PageFaultWorker.h>
+#include <Thread.h>
+
+//Libraries
+#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+#include <numaif.h> //for move_pages()
+#endif
+
+using namespace xmem;
+
+PageMigrationBenchmark::PageMigrationBenchmark(
+        size_t len,
+        size_t probe_len,
+        uint32_t iterations,
+        uint32_t src_node,
+        uint32_t dst_node,
+        uint32_t cpu_node,
+        page_backing_t backing,
+        size_t large_page_size,
+        std::vector<PowerReader*> dram_power_readers,
+        std::string name
+    ) :
+        Benchmark(
+            NULL, //Every iteration maps its own region
+            len,
+            iterations,
+            1,
+            src_node,
+            cpu_node,
+            RANDOM,
+            READ,
+#ifdef HAS_WORD_64
+            CHUNK_64b,
+#else
+            CHUNK_32b,
+#endif
+            0,
+            1,
+            dram_power_readers,
+            "MB/s",
+            name
+        ),
+        probe_len_(probe_len),
+        dst_node_(dst_node),
+        backing_(backing),
+        large_page_size_(large_page_size),
+        page_rate_on_iter_(iterations, 0),
+        migration_latency_on_iter_(iterations, 0),
+        baseline_latency_on_iter_(iterations, 0)
+    {
+}
+
+std::string PageMigrationBenchmark::backingName(page_backing_t backing) {
+    switch (backing) {
+        case PAGE_BACKING_BASE:
+            return "base";
+        case PAGE_BACKING_THP:
+            return "thp";
+        case PAGE_BACKING_HUGETLB:
+            return "hugetlb";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+void PageMigrationBenchmark::reportBenchmarkInfo() const {
+    std::cout << "CPU NUMA Node: " << cpu_node_ << std::endl;
+    std::cout << "Source Memory NUMA Node: " << mem_node_ << std::endl;
+    std::cout << "Destination Memory NUMA Node: " << dst_node_ << std::endl;
+    std::cout << "Pages: " << backingName(backing_) << ", " << pageSize() / KB << " KB" << std::endl;
+    std::cout << "Region size: " << len_ / KB << " KB" << std::endl;
+    std::cout << "Latency thread working set size: " << probe_len_ / KB << " KB" << std::endl;
+    std::cout << std::endl;
+}
+
+void PageMigrationBenchmark::reportResults() const {
+    std::cout << std::endl;
+    std::cout << "*** RESULTS";
+    std::cout << "***" << std::endl;
+    std::cout << std::endl;
+
+    if (has_run_) {
+        for (uint32_t i = 0; i < iterations_; i++) {
+            std::printf("Iter #%4d:    %0.3f    %s    %0.0f    pages/s @    %0.3f ns/access (%0.3f ns/access without migration)", i, metric_on_iter_[i], metric_units_.c_str(), page_rate_on_iter_[i], migration_latency_on_iter_[i], baseline_latency_on_iter_[i]);
+            if (warning_)
+                std::cout << " (WARNING)";
+            std::cout << std::endl;
+        }
+
+        std::cout << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "Mean migration throughput: " << mean_metric_ << " " << metric_units_ << " (" << getMeanPageRate() << " pages/s)";
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << "Mean latency during migration: " << getMeanMigrationLatency() << " ns/access (" << getMeanBaselineLatency() << " ns/access without migration)";
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << std::endl;
+
+        reportPowerResults();
+    }
+    else
+        std::cerr << "WARNING: Benchmark has not run yet. No reported results." << std::endl;
+}
+
+double PageMigrationBenchmark::getMeanPageRate() const {
+    if (!has_run_)
+        return -1;
+
+    double total = 0;
+    for (uint32_t i = 0; i < iterations_; i++)
+        total += page_rate_on_iter_[i];
+    return total / iterations_;
+}
+
+double PageMigrationBenchmark::getMeanMigrationLatency() const {
+    if (!has_run_)
+        return -1;
+
+    double total = 0;
+    for (uint32_t i = 0; i < iterations_; i++)
+        total += migration_latency_on_iter_[i];
+    return total / iterations_;
+}
+
+double PageMigrationBenchmark::getMeanBaselineLatency() const {
+    if (!has_run_)
+        return -1;
+
+    double total = 0;
+    for (uint32_t i = 0; i < iterations_; i++)
+        total += baseline_latency_on_iter_[i];
+    return total / iterations_;
+}
+
+tick_t PageMigrationBenchmark::movePages(std::vector<void*>& pages, uint32_t node, size_t& failed) {
+    failed = 0;
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+    std::vector<int> nodes(pages.size(), static_cast<int>(node));
+    std::vector<int> status(pages.size(), 0);
+
+    tick_t start_tick = start_timer();
+    long ret = move_pages(0, pages.size(), pages.data(), nodes.data(), status.data(), MPOL_MF_MOVE);
+    tick_t stop_tick = stop_timer();
+
+    //A page that is not on the target node afterwards has a negative error code or another node in its status
+    if (ret < 0)
+        failed = pages.size();
+    else {
+        for (size_t p = 0; p < status.size(); p++) {
+            if (status[p] != static_cast<int>(node))
+                failed++;
+        }
+    }
+    return stop_tick - start_tick;
+#else
+    failed = pages.size();
+    return 0;
+#endif
+}
+
+size_t PageMigrationBenchmark::pageSize() const {
+    if (backing_ == PAGE_BACKING_HUGETLB)
+        return large_page_size_;
+    else if (backing_ == PAGE_BACKING_THP)
+        return g_thp_page_size;
+    else
+        return g_page_size;
+}
+
+double PageMigrationBenchmark::probeLatency(void* region, std::vector<void*>& pages, size_t& migrated_bytes, tick_t& migration_ticks, bool& iterwarning) {
+    size_t page_size = pageSize();
+    migrated_bytes = 0;
+    migration_ticks = 0;
+
+    int32_t probe_cpu = cpu_id_in_numa_node(cpu_node_, 0);
+    if (probe_cpu < 0)
+        std::cerr << "WARNING: Failed to find logical CPU 0 in NUMA node " << cpu_node_ << std::endl;
+    LatencyWorker* worker = new LatencyWorker(region, probe_len_, mlp_, &chasePointers, &dummy_chasePointers, probe_cpu);
+    Thread* worker_thread = new Thread(worker);
+    worker_thread->create_and_start();
+
+    //Migrate back and forth on the next CPU of the node for as long as the latency thread measures. Only the moves to the destination node are timed.
+    if (!pages.empty()) {
+        int32_t migrate_cpu = cpu_id_in_numa_node(cpu_node_, 1);
+        if (migrate_cpu < 0) //Single-CPU node: share it with the latency thread
+            migrate_cpu = probe_cpu;
+        bool locked = lock_thread_to_cpu(migrate_cpu);
+        tick_t target_ticks = g_ticks_per_ms * BENCHMARK_DURATION_MS;
+        tick_t start_tick = start_timer();
+        tick_t elapsed_ticks = 0;
+        while (elapsed_ticks < target_ticks) {
+            size_t failed = 0;
+            size_t failed_back = 0;
+            migration_ticks += movePages(pages, dst_node_, failed);
+            migrated_bytes += (pages.size() - failed) * page_size;
+            movePages(pages, mem_node_, failed_back);
+            if (failed > 0 || failed_back > 0)
+                iterwarning = true;
+            elapsed_ticks = stop_timer() - start_tick;
+        }
+        if (locked)
+            unlock_thread_to_numa_node();
+    }
+
+    if (!worker_thread->join())
+        std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+
+    double latency = 0;
+    uint32_t accesses = worker->getPasses() * (worker->getBytesPerPass() / 8);
+    if (accesses > 0)
+        latency = static_cast<double>(worker->getAdjustedTicks() * g_ns_per_tick) / static_cast<double>(accesses);
+    iterwarning |= worker->hadWarning();
+
+    delete worker_thread;
+    delete worker;
+    return latency;
+}
+
+std::vector<int32_t> PageMigrationBenchmark::workerCpus() const {
+    //The latency thread, and the calling thread while it migrates or faults in the region
+    std::vector<int32_t> cpu_ids;
+    cpu_ids.push_back(cpu_id_in_numa_node(cpu_node_, 0));
+    cpu_ids.push_back(cpu_id_in_numa_node(cpu_node_, 1));
+    return cpu_ids;
+}
+
+bool PageMigrationBenchmark::runCore() {
+#if !defined(__gnu_linux__) || !defined(HAS_NUMA)
+    std::cerr << "ERROR: The page migration benchmark is only supported on GNU/Linux with NUMA support." << std::endl;
+    return false;
+#else
+    size_t page_size = pageSize();
+
+    //Explicit huge pages must be free on the source node to fault the region in, and on the destination node to migrate it there
+    if (backing_ == PAGE_BACKING_HUGETLB) {
+        size_t needed = len_ / large_page_size_;
+        uint32_t pool_nodes[2] = { mem_node_, dst_node_ };
+        for (uint32_t n = 0; n < 2; n++) {
+            size_t free_pages = 0;
+            std::ostringstream pool_path;
+            pool_path << "/sys/devices/system/node/node" << pool_nodes[n] << "/hugepages/hugepages-" << large_page_size_ / KB << "kB/free_hugepages";
+            std::ifstream pool(pool_path.str().c_str());
+            if (!(pool >> free_pages) || free_pages < needed) {
+                std::cerr << "WARNING: Need " << needed << " free huge pages of " << large_page_size_ / KB << " KB on NUMA node " << pool_nodes[n] << ", but only " << free_pages << " are available. Skipping." << std::endl;
+                return false;
+            }
+        }
+    }
+
+    //Start power measurement
+    if (g_verbose)
+        std::cout << "Starting power measurement threads...";
+
+    if (!startPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to start power threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run benchmark
+    if (g_verbose)
+        std::cout << "Running benchmark." << std::endl << std::endl;
+
+    //Every iteration starts from a brand new mapping on the source node
+    bool success = true;
+    for (uint32_t i = 0; i < iterations_ && success; i++) {
+        bool iterwarning = false;
+        int fd = -1;
+        void* region = PageFaultWorker::mapRegion(backing_, false, len_, page_size, false, fd);
+        if (region == NULL) {
+            std::cerr << "ERROR: Failed to map " << len_ / KB << " KB of " << backingName(backing_) << " pages." << std::endl;
+            success = false;
+            break;
+        }
+
+        //Untimed: fault in on the source node
+        PageFaultWorker* fault_worker = new PageFaultWorker(region, len_, mem_node_, cpu_id_in_numa_node(cpu_node_, 0));
+        Thread* fault_thread = new Thread(fault_worker);
+        fault_thread->create_and_start();
+        if (!fault_thread->join())
+            std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+        iterwarning |= fault_worker->hadWarning();
+        delete fault_thread;
+        delete fault_worker;
+
+        void* probe_end = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(region) + probe_len_);
+#ifdef HAS_WORD_64
+        if (!build_random_pointer_permutation(region, probe_end, CHUNK_64b)) {
+#else
+        if (!build_random_pointer_permutation(region, probe_end, CHUNK_32b)) {
+#endif
+            std::cerr << "ERROR: Failed to build a random pointer permutation for the latency measurement thread!" << std::endl;
+            PageFaultWorker::unmapRegion(region, len_, fd);
+            success = false;
+            break;
+        }
+
+        //One entry per backing page. A huge page is migrated as a whole where the kernel supports it.
+        std::vector<void*> pages;
+        for (size_t offset = 0; offset < len_; offset += page_size)
+            pages.push_back(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(region) + offset));
+
+        std::vector<void*> no_pages;
+        size_t migrated_bytes = 0;
+        tick_t migration_ticks = 0;
+        baseline_latency_on_iter_[i] = probeLatency(region, no_pages, migrated_bytes, migration_ticks, iterwarning);
+        migration_latency_on_iter_[i] = probeLatency(region, pages, migrated_bytes, migration_ticks, iterwarning);
+
+        PageFaultWorker::unmapRegion(region, len_, fd);
+
+        //Compute metrics for this iteration
+        if (migration_ticks > 0 && migrated_bytes > 0) {
+            double seconds = (static_cast<double>(migration_ticks) * g_ns_per_tick) / 1e9;
+            metric_on_iter_[i] = (static_cast<double>(migrated_bytes) / static_cast<double>(MB)) / seconds;
+            page_rate_on_iter_[i] = static_cast<double>(migrated_bytes / page_size) / seconds;
+        } else
+            iterwarning = true;
+
+        if (iterwarning)
+            warning_ = true;
+
+        if (g_verbose) { //Report metrics for this iteration
+            std::cout << "Iter " << i+1 << " migrated " << migrated_bytes / KB << " KB from NUMA node " << mem_node_ << " to NUMA node " << dst_node_ << ":";
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...MB/s == " << metric_on_iter_[i];
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...pages/s == " << page_rate_on_iter_[i];
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...ns/access == " << migration_latency_on_iter_[i] << " (" << baseline_latency_on_iter_[i] << " without migration)";
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+        }
+    }
+
+    //Stop power measurement
+    if (g_verbose) {
+        std::cout << std::endl;
+        std::cout << "Stopping power measurement threads...";
+    }
+
+    if (!stopPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to stop power measurement threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    if (!success)
+        return false;
+
+    //Run metadata
+    has_run_ = true;
+    computeMetrics();
+
+    return true;
+#endif
+}
@@ -0,0 +1,229 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the PerfCounters class.
+ */
+
+//Headers
+#include <PerfCounters.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __gnu_linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifdef ARCH_INTEL
+#include <cpuid.h>
+#endif
+#endif
+
+using namespace xmem;
+
+#ifdef __gnu_linux__
+/**
+ * @brief How to open one hardware performance counter.
+ */
+typedef struct {
+    perf_counter_t counter; /**< Which counter this is. */
+    uint32_t group; /**< Counter group. The first counter of a group that opens leads it. */
+    uint32_t type; /**< perf_event_attr type. */
+    uint64_t config; /**< perf_event_attr config. */
+} perf_event_spec_t;
+
+#define PERF_CACHE_EVENT(cache, result) ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | ((result) << 16))
+
+/**
+ * @brief The counters to open. Group 0 holds cycles and instructions, which most PMUs count on fixed counters, and the LLC events. Group 1 holds the remaining cache and TLB events.
+ */
+static const perf_event_spec_t perf_event_specs[NUM_PERF_COUNTERS] = {
+    { PERF_CYCLES, 0, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_INSTRUCTIONS, 0, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_LLC_LOADS, 0, PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_ACCESS) },
+    { PERF_LLC_MISSES, 0, PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+    { PERF_DTLB_MISSES, 1, PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+    { PERF_L1D_REPLACEMENTS, 1, PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+    { PERF_OFFCORE_REQUESTS, 1, PERF_TYPE_RAW, 0x08B0 } //Event 0xB0, umask 0x08: OFFCORE_REQUESTS.ALL_DATA_RD
+};
+
+#define PERF_NUM_GROUPS 2
+
+/**
+ * @brief Indicates if the CPU is an Intel one, whose raw event encodings the offcore request counter uses.
+ * @returns True if CPUID reports GenuineIntel.
+ */
+static bool is_intel_cpu() {
+#ifdef ARCH_INTEL
+    uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx))
+        return false;
+    return ebx == 0x756e6547 && edx == 0x49656e69 && ecx == 0x6c65746e; //"Genu" "ineI" "ntel"
+#else
+    return false;
+#endif
+}
+#endif
+
+PerfCounters::PerfCounters() :
+    group_leaders_(),
+    group_members_(),
+    fds_()
+{
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __gnu_linux__
+    for (uint32_t i = 0; i < fds_.size(); i++)
+        close(fds_[i]);
+#endif
+}
+
+bool PerfCounters::open() {
+#ifdef __gnu_linux__
+    bool intel = is_intel_cpu();
+    group_leaders_.assign(PERF_NUM_GROUPS, -1);
+    group_members_.assign(PERF_NUM_GROUPS, std::vector<perf_counter_t>());
+
+    for (uint32_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+        const perf_event_spec_t& spec = perf_event_specs[i];
+        if (spec.type == PERF_TYPE_RAW && !intel)
+            continue;
+
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = spec.type;
+        attr.config = spec.config;
+        attr.disabled = (group_leaders_[spec.group] < 0) ? 1 : 0; //Members follow their leader
+        attr.exclude_kernel = 1; //Allowed at perf_event_paranoid 2, and keeps page faults and interrupts out of the counts
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        //The kernel rejects a member that would make its group impossible to schedule, so such events are simply left out
+        int32_t fd = static_cast<int32_t>(syscall(__NR_perf_event_open, &attr, 0, -1, group_leaders_[spec.group], 0));
+        if (fd < 0)
+            continue;
+        if (group_leaders_[spec.group] < 0)
+            group_leaders_[spec.group] = fd;
+        group_members_[spec.group].push_back(spec.counter);
+        fds_.push_back(fd);
+    }
+
+    return !fds_.empty();
+#else
+    return false; //perf_event_open() is GNU/Linux only, and the Configurator rejects the option on other platforms
+#endif
+}
+
+void PerfCounters::start() {
+#ifdef __gnu_linux__
+    for (uint32_t g = 0; g < group_leaders_.size(); g++) {
+        if (group_leaders_[g] < 0)
+            continue;
+        ioctl(group_leaders_[g], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(group_leaders_[g], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+void PerfCounters::stop() {
+#ifdef __gnu_linux__
+    for (uint32_t g = 0; g < group_leaders_.size(); g++)
+        if (group_leaders_[g] >= 0)
+            ioctl(group_leaders_[g], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+perf_counts_t PerfCounters::read() const {
+    perf_counts_t counts = emptyCounts();
+#ifdef __gnu_linux__
+    for (uint32_t g = 0; g < group_leaders_.size(); g++) {
+        if (group_leaders_[g] < 0)
+            continue;
+
+        //Group read format: number of counters, time enabled, time running, then one value per counter
+        std::vector<uint64_t> values(3 + group_members_[g].size(), 0);
+        ssize_t bytes = values.size() * sizeof(uint64_t);
+        if (::read(group_leaders_[g], values.data(), bytes) != bytes)
+            continue;
+        if (values[2] == 0) //The group was never scheduled on the PMU
+            continue;
+
+        double scale = static_cast<double>(values[1]) / static_cast<double>(values[2]);
+        for (uint32_t i = 0; i < values[0] && i < group_members_[g].size(); i++) {
+            counts.counts[group_members_[g][i]] = static_cast<double>(values[3 + i]) * scale;
+            counts.valid[group_members_[g][i]] = true;
+        }
+    }
+#endif
+    return counts;
+}
+
+bool PerfCounters::isOpen(perf_counter_t counter) const {
+    for (uint32_t g = 0; g < group_members_.size(); g++)
+        for (uint32_t i = 0; i < group_members_[g].size(); i++)
+            if (group_members_[g][i] == counter)
+                return true;
+    return false;
+}
+
+perf_counts_t PerfCounters::emptyCounts() {
+    perf_counts_t counts;
+    for (uint32_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+        counts.counts[i] = 0;
+        counts.valid[i] = false;
+    }
+    return counts;
+}
+
+std::string PerfCounters::counterName(perf_counter_t counter) {
+    switch (counter) {
+        case PERF_CYCLES:
+            return "Cycles";
+        case PERF_INSTRUCTIONS:
+            return "Instructions";
+        case PERF_LLC_LOADS:
+            return "LLC Loads";
+        case PERF_LLC_MISSES:
+            return "LLC Load Misses";
+        case PERF_DTLB_MISSES:
+            return "dTLB Load Misses";
+        case PERF_L1D_REPLACEMENTS:
+            return "L1D Replacements";
+        case PERF_OFFCORE_REQUESTS:
+            return "Offcore Data Read Requests";
+        default:
+            return "UNKNOWN";
+    }
+}
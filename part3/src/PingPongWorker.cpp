@@ -0,0 +1,156 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the PingPongWorker class.
+ */
+
+//Headers
+#include <PingPongWorker.h>
+#include <common.h>
+
+//Libraries
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <processthreadsapi.h>
+#endif
+
+#ifdef __gnu_linux__
+#include <unistd.h>
+#endif
+
+using namespace xmem;
+
+PingPongWorker::PingPongWorker(
+        void* mem_array,
+        bool initiator,
+        uint32_t round_trips,
+        int32_t cpu_affinity
+    ) :
+        MemoryWorker(
+            mem_array,
+            sizeof(uint64_t),
+            1,
+            cpu_affinity
+        ),
+        initiator_(initiator),
+        round_trips_(round_trips)
+    {
+}
+
+PingPongWorker::~PingPongWorker() {
+}
+
+void PingPongWorker::run() {
+    //Set up relevant state -- localized to this thread's stack
+    int32_t cpu_affinity = 0;
+    bool initiator = false;
+    uint64_t round_trips = 0;
+    uint64_t warmup_round_trips = CORE_TO_CORE_BENCHMARK_WARMUP_ROUND_TRIPS;
+    volatile uint64_t* flag = NULL;
+    tick_t start_tick = 0;
+    tick_t stop_tick = 0;
+    tick_t elapsed_ticks = 0;
+    bool warning = false;
+
+    //Grab relevant setup state thread-safely and keep it local
+    if (acquireLock(-1)) {
+        flag = static_cast<volatile uint64_t*>(mem_array_);
+        initiator = initiator_;
+        round_trips = round_trips_;
+        cpu_affinity = cpu_affinity_;
+        releaseLock();
+    }
+
+    //Set processor affinity
+    bool locked = lock_thread_to_cpu(cpu_affinity);
+    if (!locked)
+        std::cerr << "WARNING: Failed to lock thread to logical CPU " << cpu_affinity << "! Results may not be correct." << std::endl;
+
+    //Increase scheduling priority
+#ifdef _WIN32
+    DWORD original_priority_class;
+    DWORD original_priority;
+    if (!boost_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!boost_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to boost scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Run the benchmark! The untimed warmup round trips also make sure the partner is up and running before we start the clock.
+    if (initiator) {
+        for (uint64_t k = 0; k < warmup_round_trips; k++) {
+            *flag = 2*k+1;
+            while (*flag != 2*k+2);
+        }
+
+        start_tick = start_timer();
+        for (uint64_t k = warmup_round_trips; k < warmup_round_trips + round_trips; k++) {
+            *flag = 2*k+1;
+            while (*flag != 2*k+2);
+        }
+        stop_tick = stop_timer();
+        elapsed_ticks = stop_tick - start_tick;
+    } else {
+        for (uint64_t k = 0; k < warmup_round_trips + round_trips; k++) {
+            while (*flag != 2*k+1);
+            *flag = 2*k+2;
+        }
+    }
+
+    //Unset processor affinity
+    if (locked)
+        unlock_thread_to_numa_node();
+
+    //Revert thread priority
+#ifdef _WIN32
+    if (!revert_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!revert_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to revert scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Warn if something looks fishy
+    if (!locked || (initiator && elapsed_ticks < MIN_ELAPSED_TICKS))
+        warning = true;
+
+    //Update the object state thread-safely
+    if (acquireLock(-1)) {
+        adjusted_ticks_ = elapsed_ticks;
+        elapsed_ticks_ = elapsed_ticks;
+        elapsed_dummy_ticks_ = 0;
+        warning_ = warning;
+        bytes_per_pass_ = sizeof(uint64_t);
+        completed_ = true;
+        passes_ = static_cast<uint32_t>(round_trips);
+        releaseLock();
+    }
+}
@@ -49,6 +49,8 @@ PowerReader::PowerReader(uint32_t sampling_period, double power_units, std::stri
     mean_power_(0),
     peak_power_(0),
     num_samples_(0),
+    energy_(0),
+    measured_time_(0),
     sampling_period_(sampling_period)
 {
     power_trace_.reserve(16); //Arbitrary default
@@ -92,6 +94,8 @@ bool PowerReader::clear() {
         mean_power_ = 0;
         peak_power_ = 0;
         num_samples_ = 0;
+        energy_ = 0;
+        measured_time_ = 0;
         return releaseLock();
     } else
         return false;
@@ -135,6 +139,32 @@ double PowerReader::getPeakPower() {
     return retval;
 }
 
+double PowerReader::getEnergy() {
+    double retval = 0;
+    if (acquireLock(-1)) { //Wait indefinitely for the lock
+        retval = energy_ * power_units_;
+        releaseLock();
+    }
+    return retval;
+}
+
+double PowerReader::getMeasuredTime() {
+    double retval = 0;
+    if (acquireLock(-1)) { //Wait indefinitely for the lock
+        retval = measured_time_;
+        releaseLock();
+    }
+    return retval;
+}
+
+bool PowerReader::setCpuAffinity(int32_t cpu_affinity) {
+    if (acquireLock(-1)) { //Wait indefinitely for the lock
+        cpu_affinity_ = cpu_affinity;
+        return releaseLock();
+    } else
+        return false;
+}
+
 double PowerReader::getLastSample() {
     double retval = 0;
     if (acquireLock(-1)) { //Wait indefinitely for the lock
@@ -179,3 +209,12 @@ std::string PowerReader::name() {
     }
     return retval;
 }
+
+bool PowerReader::addEnergy(double energy, double elapsed_s) {
+    if (acquireLock(-1)) { //Wait indefinitely for the lock
+        energy_ += energy;
+        measured_time_ += elapsed_s;
+        return releaseLock();
+    } else
+        return false;
+}
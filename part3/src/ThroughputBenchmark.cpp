@@ -76,6 +76,18 @@ ThroughputBenchmark::ThroughputBenchmark(
     {
 }
 
+double ThroughputBenchmark::getEnergyEfficiency(uint32_t socket_id) const {
+    double energy_time = getDRAMEnergyTime(socket_id);
+    if (!has_run_ || energy_time <= 0 || mean_metric_ <= 0)
+        return 0;
+
+    return (getDRAMEnergy(socket_id) / energy_time) / (mean_metric_ * MB / GB);
+}
+
+std::string ThroughputBenchmark::getEnergyEfficiencyUnits() const {
+    return "J/GB";
+}
+
 bool ThroughputBenchmark::runCore() {
     size_t len_per_thread = len_ / num_worker_threads_; //Carve up memory space so each worker has its own area to play in
     uint8_t mlp = mlp_;
@@ -99,9 +111,7 @@ bool ThroughputBenchmark::runCore() {
 
         //Build pointer indices. Note that the pointers for each thread must stay within its respective region, otherwise sharing may occur.
         for (uint32_t i = 0; i < num_worker_threads_; i++) {
-            if (!build_random_pointer_permutation(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_) + i*len_per_thread), //casts to silence compiler warnings
-                                               reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array_) + (i+1)*len_per_thread), //casts to silence compiler warnings
-                                               chunk_size_)) {
+            if (!buildPermutation(i, len_per_thread, chunk_size_)) {
                 std::cerr << "ERROR: Failed to build a random pointer permutation for a worker thread!" << std::endl;
                 return false;
             }
@@ -143,14 +153,16 @@ bool ThroughputBenchmark::runCore() {
                                                  mlp,
                                                  kernel_fptr_seq,
                                                  kernel_dummy_fptr_seq,
-                                                 cpu_id));
+                                                 cpu_id,
+                                                 0)); //Throughput benchmarks are never rate-limited
             else if (pattern_mode_ == RANDOM)
                 workers.push_back(new LoadWorker(threadmem_array_,
                                                  len_per_thread,
                                                  mlp,
                                                  kernel_fptr_ran,
                                                  kernel_dummy_fptr_ran,
-                                                 cpu_id));
+                                                 cpu_id,
+                                                 0)); //Throughput benchmarks are never rate-limited
             else
                 std::cerr << "WARNING: Invalid benchmark pattern mode." << std::endl;
             worker_threads.push_back(new Thread(workers[t]));
@@ -177,6 +189,7 @@ bool ThroughputBenchmark::runCore() {
             total_adjusted_ticks += workers[t]->getAdjustedTicks();
             total_elapsed_dummy_ticks += workers[t]->getElapsedDummyTicks();
             iter_warning |= workers[t]->hadWarning();
+            addPerfCounts(workers[t]->getPerfCounts());
         }
 
         avg_adjusted_ticks = total_adjusted_ticks / num_worker_threads_;
@@ -34,41 +34,91 @@
 #include <common.h>
 
 //Libraries
+#include <vector>
+#include <algorithm>
+
 #ifdef _WIN32
 #include <windows.h> 
+#include <intrin.h>
 #endif
 
 #ifdef __gnu_linux__
 #include <time.h>
+#ifdef USE_TSC_TIMER
+#include <cpuid.h>
+#endif
 #endif
 
 using namespace xmem;
 
 Timer::Timer() :
     ticks_per_ms_(0),
-    ns_per_tick_(0)
+    ns_per_tick_(0),
+    resolution_ns_(0),
+    overhead_ns_(0),
+    invariant_tsc_(false),
+    core_ghz_(0),
+    backend_overhead_ns_()
 {   
+#ifdef USE_TSC_TIMER
+    invariant_tsc_ = queryInvariantTsc();
+#endif
 
+    if (g_timer_backend == TIMER_OS) {
 #if defined(_WIN32) && defined(USE_QPC_TIMER) //special case
-    LARGE_INTEGER freq;
-    BOOL success = QueryPerformanceFrequency(&freq);
-    ticks_per_ms_ = static_cast<tick_t>(freq.QuadPart)/1000;
-#else
-    tick_t start_tick, stop_tick;
-    start_tick = start_timer();
-#ifdef _WIN32
-    Sleep(BENCHMARK_DURATION_MS);
-#endif
-#ifdef __gnu_linux__
-    struct timespec duration, remainder;
-    duration.tv_sec = BENCHMARK_DURATION_MS / 1000;
-    duration.tv_nsec = (BENCHMARK_DURATION_MS % 1000) * 1e6; 
-    nanosleep(&duration, &remainder);
+        LARGE_INTEGER freq;
+        BOOL success = QueryPerformanceFrequency(&freq);
+        ticks_per_ms_ = static_cast<tick_t>(freq.QuadPart)/1000;
 #endif
-    stop_tick = stop_timer();
-    ticks_per_ms_ = static_cast<tick_t>((stop_tick - start_tick) / BENCHMARK_DURATION_MS);
+
+#ifdef USE_POSIX_TIMER
+        ticks_per_ms_ = 1000000; //Ticks are already nanoseconds, so there is nothing to calibrate
 #endif
+    } else {
+        //Take several short samples against the OS reference clock and keep the median, which shrugs off a sample cut short by preemption
+        std::vector<double> samples;
+        for (uint32_t i = 0; i < TIMER_CALIBRATION_SAMPLES; i++) {
+            double ref_start_ns = referenceNs();
+            tick_t start_tick = start_timer();
+            while (referenceNs() - ref_start_ns < TIMER_CALIBRATION_SAMPLE_MS * 1e6)
+                ;
+            tick_t stop_tick = stop_timer();
+            double ref_stop_ns = referenceNs();
+            samples.push_back(static_cast<double>(stop_tick - start_tick) * 1e6 / (ref_stop_ns - ref_start_ns));
+        }
+        std::sort(samples.begin(), samples.end());
+        ticks_per_ms_ = static_cast<tick_t>(samples[samples.size() / 2]);
+    }
     ns_per_tick_ = 1/(static_cast<float>(ticks_per_ms_)) * static_cast<float>(1e6);
+
+    resolution_ns_ = ns_per_tick_; //Hardware and QPC timers count in whole ticks
+#ifdef USE_POSIX_TIMER
+    struct timespec res;
+    if (g_timer_backend == TIMER_OS && clock_getres(CLOCK_MONOTONIC, &res) == 0)
+        resolution_ns_ = static_cast<float>(res.tv_sec * 1e9 + res.tv_nsec);
+#endif
+
+    //Timer overhead: the shortest time that a back-to-back start and stop can measure
+    tick_t min_ticks = 0;
+    for (uint32_t i = 0; i < TIMER_OVERHEAD_SAMPLES; i++) {
+        tick_t start_tick = start_timer();
+        tick_t stop_tick = stop_timer();
+        if (i == 0 || stop_tick - start_tick < min_ticks)
+            min_ticks = stop_tick - start_tick;
+    }
+    overhead_ns_ = min_ticks * ns_per_tick_;
+
+    //Cost of each backend, measured on the reference clock so that the backends can be compared without calibrating each of them
+    timer_backend_t selected_backend = g_timer_backend;
+    for (uint32_t b = 0; b < NUM_TIMER_BACKENDS; b++) {
+        g_timer_backend = static_cast<timer_backend_t>(b);
+        backend_overhead_ns_.push_back(timer_backend_available(g_timer_backend) ? static_cast<float>(measurePairNs()) : 0);
+    }
+    g_timer_backend = selected_backend;
+
+    double core_ghz = 0;
+    if (measureCoreGhz(core_ghz))
+        core_ghz_ = static_cast<float>(core_ghz);
 }
 
 tick_t Timer::getTicksPerMs() {
@@ -78,3 +128,116 @@ tick_t Timer::getTicksPerMs() {
 float Timer::getNsPerTick() {
     return ns_per_tick_;
 }
+
+float Timer::getResolutionNs() {
+    return resolution_ns_;
+}
+
+float Timer::getOverheadNs() {
+    return overhead_ns_;
+}
+
+bool Timer::hasInvariantTsc() {
+    return invariant_tsc_;
+}
+
+float Timer::getCoreGhz() {
+    return core_ghz_;
+}
+
+std::vector<float> Timer::getBackendOverheadNs() {
+    return backend_overhead_ns_;
+}
+
+double Timer::referenceNs() const {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return static_cast<double>(count.QuadPart) * 1e9 / static_cast<double>(freq.QuadPart);
+#endif
+#ifdef __gnu_linux__
+    struct timespec tp;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &tp); //Not slewed by NTP while calibrating
+    return tp.tv_sec * 1e9 + tp.tv_nsec;
+#endif
+}
+
+double Timer::measurePairNs() const {
+    //Keep the fastest of a few batches, as a batch may be interrupted
+    double best_ns = 0;
+    for (uint32_t i = 0; i < TIMER_CALIBRATION_SAMPLES; i++) {
+        double ref_start_ns = referenceNs();
+        for (uint32_t j = 0; j < TIMER_OVERHEAD_SAMPLES; j++) {
+            start_timer();
+            stop_timer();
+        }
+        double pair_ns = (referenceNs() - ref_start_ns) / TIMER_OVERHEAD_SAMPLES;
+        if (i == 0 || pair_ns < best_ns)
+            best_ns = pair_ns;
+    }
+    return best_ns;
+}
+
+bool Timer::measureCoreGhz(double& ghz) const {
+#if defined(__GNUC__) && (defined(ARCH_INTEL) || defined(ARCH_ARM_64))
+    //Each add depends on the one before it and has a latency of one core cycle, so the chain runs at exactly one add per cycle regardless of the timer.
+    //Register-register adds are used because some cores fold chains of immediate adds together at rename.
+#ifdef ARCH_INTEL
+#define CORE_CLOCK_ADD "add %0, %0\n\t"
+#else
+#define CORE_CLOCK_ADD "add %0, %0, %0\n\t"
+#endif
+#define CORE_CLOCK_ADD_8 CORE_CLOCK_ADD CORE_CLOCK_ADD CORE_CLOCK_ADD CORE_CLOCK_ADD CORE_CLOCK_ADD CORE_CLOCK_ADD CORE_CLOCK_ADD CORE_CLOCK_ADD
+    const uint32_t adds_per_iteration = 32;
+    const uint32_t iterations_per_check = 4096;
+    double best_ghz = 0;
+    for (uint32_t i = 0; i < TIMER_CALIBRATION_SAMPLES; i++) {
+        uintptr_t chain = 0;
+        uint64_t adds = 0;
+        double ref_start_ns = referenceNs();
+        double elapsed_ns = 0;
+        while (elapsed_ns < TIMER_CALIBRATION_SAMPLE_MS * 1e6) {
+            for (uint32_t j = 0; j < iterations_per_check; j++)
+                __asm__ __volatile__ (CORE_CLOCK_ADD_8 CORE_CLOCK_ADD_8 CORE_CLOCK_ADD_8 CORE_CLOCK_ADD_8 : "+r" (chain));
+            adds += adds_per_iteration * iterations_per_check;
+            elapsed_ns = referenceNs() - ref_start_ns;
+        }
+        double ghz = adds / elapsed_ns;
+        if (ghz > best_ghz) //A sample can only be slowed down by preemption, never sped up
+            best_ghz = ghz;
+    }
+#undef CORE_CLOCK_ADD_8
+#undef CORE_CLOCK_ADD
+    ghz = best_ghz;
+    return true;
+#else
+    //The add chain needs GCC-style inline assembly on x86 or 64-bit ARM
+    ghz = 0;
+    return false;
+#endif
+}
+
+#ifdef USE_TSC_TIMER
+
+bool Timer::queryInvariantTsc() const {
+    //CPUID leaf 0x80000007 reports an invariant TSC in EDX bit 8: it ticks at a constant rate in all P-, C-, and T-states
+    uint32_t max_leaf = 0, edx = 0;
+#ifdef _WIN32
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    max_leaf = static_cast<uint32_t>(regs[0]);
+    if (max_leaf >= 0x80000007) {
+        __cpuid(regs, 0x80000007);
+        edx = static_cast<uint32_t>(regs[3]);
+    }
+#endif
+#ifdef __gnu_linux__
+    uint32_t eax = 0, ebx = 0, ecx = 0;
+    max_leaf = __get_cpuid_max(0x80000000, NULL);
+    if (max_leaf >= 0x80000007)
+        __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+#endif
+    return max_leaf >= 0x80000007 && ((edx >> 8) & 1);
+}
+#endif
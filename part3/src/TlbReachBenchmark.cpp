@@ -0,0 +1,211 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the TlbReachBenchmark class.
+ */
+
+//Headers
+#include <TlbReachBenchmark.h>
+#include <common.h>
+#include <benchmark_kernels.h>
+#include <LatencyWorker.h>
+#include <Thread.h>
+
+//Libraries
+#include <iostream>
+#include <cstdio>
+
+using namespace xmem;
+
+TlbReachBenchmark::TlbReachBenchmark(
+        void* mem_array,
+        size_t num_pages,
+        size_t page_size,
+        page_backing_t backing,
+        bool random,
+        uint32_t iterations,
+        uint32_t mem_node,
+        uint32_t cpu_node,
+        std::vector<PowerReader*> dram_power_readers,
+        std::string name
+    ) :
+        Benchmark(
+            mem_array,
+            num_pages * page_size,
+            iterations,
+            1,
+            mem_node,
+            cpu_node,
+            random ? RANDOM : SEQUENTIAL,
+            READ,
+#ifdef HAS_WORD_64
+            CHUNK_64b,
+#else
+            CHUNK_32b,
+#endif
+            0,
+            1, //Only the single chain through the touched lines exists, so there can be no more than one outstanding miss
+            dram_power_readers,
+            "ns/access",
+            name
+        ),
+        num_pages_(num_pages),
+        page_size_(page_size),
+        backing_(backing)
+    {
+}
+
+void TlbReachBenchmark::reportBenchmarkInfo() const {
+    std::cout << "CPU NUMA Node: " << cpu_node_ << std::endl;
+    std::cout << "Memory NUMA Node: " << mem_node_ << std::endl;
+    if (page_size_ == CACHE_LINE_SIZE)
+        std::cout << "Cache lines: " << num_pages_ << ", dense" << std::endl;
+    else
+        std::cout << "Pages: " << num_pages_ << " of " << page_size_ / KB << " KB, one cache line each" << std::endl;
+    std::cout << "Page order: " << (pattern_mode_ == RANDOM ? "random" : "strided") << std::endl;
+    std::cout << std::endl;
+}
+
+void TlbReachBenchmark::reportResults() const {
+    std::cout << std::endl;
+    std::cout << "*** RESULTS";
+    std::cout << "***" << std::endl;
+    std::cout << std::endl;
+
+    if (has_run_) {
+        for (uint32_t i = 0; i < iterations_; i++) {
+            std::printf("Iter #%4d:    %0.3f    %s", i, metric_on_iter_[i], metric_units_.c_str());
+            if (warning_)
+                std::cout << " (WARNING)";
+            std::cout << std::endl;
+        }
+
+        std::cout << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "Mean: " << mean_metric_ << " " << metric_units_;
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << "Median: " << median_metric_ << " " << metric_units_;
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << std::endl;
+
+        reportPowerResults();
+
+        reportPerfCounts();
+    }
+    else
+        std::cerr << "WARNING: Benchmark has not run yet. No reported results." << std::endl;
+}
+
+bool TlbReachBenchmark::runCore() {
+    //Untimed: chain one cache line per page
+    if (!build_page_line_cycle(mem_array_, num_pages_, page_size_, pattern_mode_ == RANDOM)) {
+        std::cerr << "ERROR: Failed to build a page line cycle for the latency measurement thread!" << std::endl;
+        return false;
+    }
+
+    int32_t cpu_id = cpu_id_in_numa_node(cpu_node_, 0);
+    if (cpu_id < 0)
+        std::cerr << "WARNING: Failed to find logical CPU 0 in NUMA node " << cpu_node_ << std::endl;
+
+    //Start power measurement
+    if (g_verbose)
+        std::cout << "Starting power measurement threads...";
+
+    if (!startPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to start power threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run benchmark
+    if (g_verbose)
+        std::cout << "Running benchmark." << std::endl << std::endl;
+
+    for (uint32_t i = 0; i < iterations_; i++) {
+        //The latency thread primes its region by reading all of it, which would read every page in full here. Give it no region to prime; the first lap of the chain warms it up instead.
+        LatencyWorker* worker = new LatencyWorker(mem_array_, 0, 1, &chasePointers, &dummy_chasePointers, cpu_id);
+        Thread* worker_thread = new Thread(worker);
+        worker_thread->create_and_start();
+        if (!worker_thread->join())
+            std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+
+        //Compute metrics for this iteration
+        bool iterwarning = worker->hadWarning();
+        addPerfCounts(worker->getPerfCounts());
+        uint32_t passes = worker->getPasses();
+        tick_t adjusted_ticks = worker->getAdjustedTicks();
+        uint32_t accesses_per_pass = worker->getBytesPerPass() / 8;
+        if (passes > 0 && accesses_per_pass > 0)
+            metric_on_iter_[i] = static_cast<double>(adjusted_ticks * g_ns_per_tick) / (static_cast<double>(accesses_per_pass) * passes);
+        else
+            iterwarning = true;
+
+        if (iterwarning)
+            warning_ = true;
+
+        if (g_verbose) { //Report metrics for this iteration
+            std::cout << "Iter " << i+1 << " had " << passes << " latency measurement passes, with " << accesses_per_pass << " accesses per pass:";
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...lat ns/access == " << metric_on_iter_[i];
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+        }
+
+        delete worker_thread;
+        delete worker;
+    }
+
+    //Stop power measurement
+    if (g_verbose) {
+        std::cout << std::endl;
+        std::cout << "Stopping power measurement threads...";
+    }
+
+    if (!stopPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to stop power measurement threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run metadata
+    has_run_ = true;
+    computeMetrics();
+
+    return true;
+}
@@ -0,0 +1,398 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the WorkloadMixBenchmark class.
+ */
+
+//Headers
+#include <WorkloadMixBenchmark.h>
+#include <common.h>
+#include <benchmark_kernels.h>
+#include <MemoryWorker.h>
+#include <LoadWorker.h>
+#include <LatencyWorker.h>
+#include <Thread.h>
+#include <InitWorker.h>
+
+//Libraries
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+
+using namespace xmem;
+
+WorkloadMixBenchmark::WorkloadMixBenchmark(
+        std::vector<void*> thread_mem_arrays,
+        std::vector<workload_thread_t> workload,
+        uint32_t iterations,
+        uint8_t mlp,
+        std::vector<PowerReader*> dram_power_readers,
+        std::string name
+    ) :
+        Benchmark(
+            thread_mem_arrays.front(),
+            workload.front().working_set_size,
+            iterations,
+            static_cast<uint32_t>(workload.size()),
+            workload.front().mem_node,
+            workload.front().cpu_node,
+            workload.front().pattern_mode,
+            workload.front().rw_mode,
+            workload.front().chunk_size,
+            workload.front().stride_size,
+            mlp,
+            dram_power_readers,
+            "MB/s",
+            name
+        ),
+        thread_mem_arrays_(thread_mem_arrays),
+        workload_(workload),
+        thread_metric_on_iter_(workload.size(), std::vector<double>(iterations, 0)),
+        probe_latency_on_iter_(iterations, 0),
+        cpu_ids_(workload.size(), -1)
+    {
+
+    //Threads sharing a CPU NUMA node get consecutive logical CPUs in it
+    std::vector<uint32_t> threads_on_cpu_node(g_num_numa_nodes, 0);
+    for (uint32_t t = 0; t < workload_.size(); t++) {
+        uint32_t cpu_node = workload_[t].cpu_node;
+        cpu_ids_[t] = cpu_id_in_numa_node(cpu_node, threads_on_cpu_node[cpu_node]);
+        if (cpu_ids_[t] < 0)
+            std::cerr << "WARNING: Failed to find logical CPU " << threads_on_cpu_node[cpu_node] << " in NUMA node " << cpu_node << std::endl;
+        threads_on_cpu_node[cpu_node]++;
+    }
+}
+
+uint32_t WorkloadMixBenchmark::chunkSizeBits(chunk_size_t chunk_size) {
+    switch (chunk_size) {
+        case CHUNK_32b:
+            return 32;
+#ifdef HAS_WORD_64
+        case CHUNK_64b:
+            return 64;
+#endif
+#ifdef HAS_WORD_128
+        case CHUNK_128b:
+            return 128;
+#endif
+#ifdef HAS_WORD_256
+        case CHUNK_256b:
+            return 256;
+#endif
+#ifdef HAS_WORD_512
+        case CHUNK_512b:
+            return 512;
+#endif
+        default:
+            return 0;
+    }
+}
+
+std::string WorkloadMixBenchmark::workloadThreadName(const workload_thread_t& spec) {
+    if (spec.latency_probe)
+        return "latency";
+
+    std::ostringstream name;
+    name << (spec.pattern_mode == SEQUENTIAL ? "seq-" : "rand-") << (spec.rw_mode == READ ? "read" : "write") << " " << chunkSizeBits(spec.chunk_size) << "b";
+    if (spec.pattern_mode == SEQUENTIAL)
+        name << " stride " << spec.stride_size;
+    return name.str();
+}
+
+void WorkloadMixBenchmark::reportBenchmarkInfo() const {
+    std::cout << "Number of worker threads: " << num_worker_threads_ << " (" << getNumLoadThreads() << " load, " << num_worker_threads_ - getNumLoadThreads() << " latency probe)" << std::endl;
+    std::cout << "Thread    CPU node    Memory node    Working set    Workload" << std::endl;
+    for (uint32_t t = 0; t < num_worker_threads_; t++)
+        std::printf("%6u    %8u    %11u    %8llu KB    %s\n", t, workload_[t].cpu_node, workload_[t].mem_node, static_cast<unsigned long long>(workload_[t].working_set_size / KB), workloadThreadName(workload_[t]).c_str());
+    std::cout << std::endl;
+}
+
+void WorkloadMixBenchmark::reportResults() const {
+    std::cout << std::endl;
+    std::cout << "*** RESULTS";
+    std::cout << "***" << std::endl;
+    std::cout << std::endl;
+
+    if (has_run_) {
+        for (uint32_t i = 0; i < iterations_; i++) {
+            std::printf("Iter #%4d:    %0.3f    %s aggregate load", i, metric_on_iter_[i], metric_units_.c_str());
+            if (probe_latency_on_iter_[i] > 0)
+                std::printf(" @    %0.3f ns/access mean probe latency", probe_latency_on_iter_[i]);
+            if (warning_)
+                std::cout << " (WARNING)";
+            std::cout << std::endl;
+        }
+
+        std::cout << std::endl;
+        std::cout << "Per-thread mean results:" << std::endl;
+        for (uint32_t t = 0; t < num_worker_threads_; t++)
+            std::printf("Thread %4u (%s):    %0.3f    %s\n", t, workloadThreadName(workload_[t]).c_str(), getThreadMeanMetric(t), workload_[t].latency_probe ? "ns/access" : metric_units_.c_str());
+
+        std::cout << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "Mean aggregate load throughput: " << mean_metric_ << " " << metric_units_;
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        if (getMeanProbeLatency() > 0) {
+            std::cout << "Mean probe latency: " << getMeanProbeLatency() << " ns/access";
+            if (warning_)
+                std::cout << " (WARNING)";
+            std::cout << std::endl;
+        }
+
+        std::cout << std::endl;
+
+        reportPowerResults();
+
+        reportPerfCounts();
+    }
+    else
+        std::cerr << "WARNING: Benchmark has not run yet. No reported results." << std::endl;
+}
+
+double WorkloadMixBenchmark::getThreadMeanMetric(uint32_t thread) const {
+    if (!has_run_)
+        return -1;
+
+    double total = 0;
+    for (uint32_t i = 0; i < iterations_; i++)
+        total += thread_metric_on_iter_[thread][i];
+    return total / iterations_;
+}
+
+uint32_t WorkloadMixBenchmark::getNumLoadThreads() const {
+    uint32_t num_load_threads = 0;
+    for (uint32_t t = 0; t < num_worker_threads_; t++) {
+        if (!workload_[t].latency_probe)
+            num_load_threads++;
+    }
+    return num_load_threads;
+}
+
+double WorkloadMixBenchmark::getMeanProbeLatency() const {
+    if (!has_run_ || getNumLoadThreads() == num_worker_threads_)
+        return -1;
+
+    double total = 0;
+    for (uint32_t i = 0; i < iterations_; i++)
+        total += probe_latency_on_iter_[i];
+    return total / iterations_;
+}
+
+std::vector<int32_t> WorkloadMixBenchmark::workerCpus() const {
+    return cpu_ids_;
+}
+
+bool WorkloadMixBenchmark::setupCore() {
+    //Every thread's region may be on a different node, so each is initialized on its own thread's logical CPU
+    std::vector<size_t> lens;
+    for (uint32_t t = 0; t < workload_.size(); t++)
+        lens.push_back(workload_[t].working_set_size);
+
+    return InitWorker::initializeRegions(thread_mem_arrays_, lens, cpu_ids_);
+}
+
+bool WorkloadMixBenchmark::runCore() {
+    //Set up kernel function pointers for each thread
+    std::vector<SequentialFunction> kernel_fptr_seq(num_worker_threads_, NULL);
+    std::vector<SequentialFunction> kernel_dummy_fptr_seq(num_worker_threads_, NULL);
+    std::vector<RandomFunction> kernel_fptr_ran(num_worker_threads_, NULL);
+    std::vector<RandomFunction> kernel_dummy_fptr_ran(num_worker_threads_, NULL);
+
+    for (uint32_t t = 0; t < num_worker_threads_; t++) {
+        const workload_thread_t& spec = workload_[t];
+        void* start = thread_mem_arrays_[t];
+        void* end = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(start) + spec.working_set_size);
+
+        if (spec.latency_probe) {
+            kernel_fptr_ran[t] = &chasePointers;
+            kernel_dummy_fptr_ran[t] = &dummy_chasePointers;
+            if (!build_random_pointer_permutation(start, end,
+#ifndef HAS_WORD_64 //special case: 32-bit architectures
+                                                  CHUNK_32b)) {
+#endif
+#ifdef HAS_WORD_64
+                                                  CHUNK_64b)) {
+#endif
+                std::cerr << "ERROR: Failed to build a random pointer permutation for latency probe thread " << t << "!" << std::endl;
+                return false;
+            }
+        } else if (spec.pattern_mode == SEQUENTIAL) {
+            if (!determine_sequential_kernel(spec.rw_mode, spec.chunk_size, spec.stride_size, &kernel_fptr_seq[t], &kernel_dummy_fptr_seq[t])) {
+                std::cerr << "ERROR: Failed to find appropriate benchmark kernel for worker thread " << t << " (" << workloadThreadName(spec) << ")." << std::endl;
+                return false;
+            }
+        } else {
+            if (!determine_random_kernel(spec.rw_mode, spec.chunk_size, &kernel_fptr_ran[t], &kernel_dummy_fptr_ran[t])) {
+                std::cerr << "ERROR: Failed to find appropriate benchmark kernel for worker thread " << t << " (" << workloadThreadName(spec) << ")." << std::endl;
+                return false;
+            }
+            if (!build_random_pointer_permutation(start, end, spec.chunk_size)) {
+                std::cerr << "ERROR: Failed to build a random pointer permutation for worker thread " << t << "!" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    //Start power measurement
+    if (g_verbose)
+        std::cout << "Starting power measurement threads...";
+
+    if (!startPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to start power threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run benchmark
+    if (g_verbose)
+        std::cout << "Running benchmark." << std::endl << std::endl;
+
+    //Do a bunch of iterations of the core benchmark routine
+    for (uint32_t i = 0; i < iterations_; i++) {
+        std::vector<MemoryWorker*> workers;
+        std::vector<Thread*> worker_threads;
+
+        //Create workers and worker threads
+        for (uint32_t t = 0; t < num_worker_threads_; t++) {
+            const workload_thread_t& spec = workload_[t];
+            if (spec.latency_probe)
+                workers.push_back(new LatencyWorker(thread_mem_arrays_[t],
+                                                    spec.working_set_size,
+                                                    mlp_,
+                                                    kernel_fptr_ran[t],
+                                                    kernel_dummy_fptr_ran[t],
+                                                    cpu_ids_[t]));
+            else if (spec.pattern_mode == SEQUENTIAL)
+                workers.push_back(new LoadWorker(thread_mem_arrays_[t],
+                                                 spec.working_set_size,
+                                                 mlp_,
+                                                 kernel_fptr_seq[t],
+                                                 kernel_dummy_fptr_seq[t],
+                                                 cpu_ids_[t],
+                                                 0)); //Load threads in the mix are never rate-limited
+            else
+                workers.push_back(new LoadWorker(thread_mem_arrays_[t],
+                                                 spec.working_set_size,
+                                                 mlp_,
+                                                 kernel_fptr_ran[t],
+                                                 kernel_dummy_fptr_ran[t],
+                                                 cpu_ids_[t],
+                                                 0)); //Load threads in the mix are never rate-limited
+            worker_threads.push_back(new Thread(workers[t]));
+        }
+
+        //Start worker threads! gogogo
+        for (uint32_t t = 0; t < num_worker_threads_; t++)
+            worker_threads[t]->create_and_start();
+
+        //Wait for all threads to complete
+        for (uint32_t t = 0; t < num_worker_threads_; t++)
+            if (!worker_threads[t]->join())
+                std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+
+        //Compute metrics for this iteration
+        bool iterwarning = false;
+        double aggregate_load = 0;
+        double total_probe_latency = 0;
+        uint32_t num_probes = 0;
+        for (uint32_t t = 0; t < num_worker_threads_; t++) {
+            double passes = static_cast<double>(workers[t]->getPasses());
+            double bytes_per_pass = static_cast<double>(workers[t]->getBytesPerPass());
+            double adjusted_ticks = static_cast<double>(workers[t]->getAdjustedTicks());
+            iterwarning |= workers[t]->hadWarning();
+            addPerfCounts(workers[t]->getPerfCounts());
+
+            if (passes == 0 || adjusted_ticks <= 0) {
+                iterwarning = true;
+                continue;
+            }
+
+            if (workload_[t].latency_probe) {
+                thread_metric_on_iter_[t][i] = (adjusted_ticks * g_ns_per_tick) / ((bytes_per_pass / 8) * passes);
+                total_probe_latency += thread_metric_on_iter_[t][i];
+                num_probes++;
+            } else {
+                thread_metric_on_iter_[t][i] = ((passes * bytes_per_pass) / static_cast<double>(MB)) / ((adjusted_ticks * g_ns_per_tick) / 1e9);
+                aggregate_load += thread_metric_on_iter_[t][i];
+            }
+        }
+
+        metric_on_iter_[i] = aggregate_load;
+        if (num_probes > 0)
+            probe_latency_on_iter_[i] = total_probe_latency / num_probes;
+
+        if (iterwarning)
+            warning_ = true;
+
+        if (g_verbose) { //Report metrics for this iteration
+            std::cout << "Iter " << i+1 << ":";
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            for (uint32_t t = 0; t < num_worker_threads_; t++) {
+                std::cout << "...thread " << t << " (" << workloadThreadName(workload_[t]) << ") == " << thread_metric_on_iter_[t][i] << (workload_[t].latency_probe ? " ns/access" : " MB/s");
+                if (iterwarning) std::cout << " -- WARNING";
+                std::cout << std::endl;
+            }
+
+            std::cout << "...aggregate load MB/s == " << metric_on_iter_[i];
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+        }
+
+        //Clean up workers and threads for this iteration
+        for (uint32_t t = 0; t < num_worker_threads_; t++) {
+            delete worker_threads[t];
+            delete workers[t];
+        }
+    }
+
+    //Stop power measurement
+    if (g_verbose) {
+        std::cout << std::endl;
+        std::cout << "Stopping power measurement threads...";
+    }
+
+    if (!stopPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to stop power measurement threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run metadata
+    has_run_ = true;
+    computeMetrics();
+
+    return true;
+}
@@ -46,7 +46,8 @@
 #include <random>
 #include <algorithm>
 #include <time.h>
-#if defined(ARCH_INTEL) && (defined(HAS_WORD_128) || defined(HAS_WORD_256) || defined(HAS_WORD_512))
+#include <vector>
+#if defined(ARCH_INTEL) && (defined(HAS_WORD_128) || defined(HAS_WORD_256) || defined(HAS_WORD_512) || defined(HAS_CACHE_LINE_FLUSH))
 //Intel intrinsics
 #include <emmintrin.h>
 #include <immintrin.h>
@@ -818,6 +819,35 @@ bool xmem::determine_random_kernel(rw_mode_t rw_mode, chunk_size_t chunk_size, R
     return false;
 }
 
+bool xmem::determine_gather_kernel(rw_mode_t rw_mode, gather_kernel_t gather_kernel, GatherFunction* kernel_function) {
+    switch (gather_kernel) {
+        case GATHER_KERNEL_SCALAR:
+            if (rw_mode == READ)
+                *kernel_function = &gatherRead_Word64;
+            else
+                *kernel_function = &scatterWrite_Word64;
+            return true;
+#ifdef HAS_GATHER_256
+        case GATHER_KERNEL_256:
+            if (rw_mode == READ) {
+                *kernel_function = &gatherRead_Word64x4;
+                return true;
+            }
+            return false; //AVX2 has no scatter instruction
+#endif
+#ifdef HAS_GATHER_SCATTER_512
+        case GATHER_KERNEL_512:
+            if (rw_mode == READ)
+                *kernel_function = &gatherRead_Word64x8;
+            else
+                *kernel_function = &scatterWrite_Word64x8;
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
 bool xmem::build_random_pointer_permutation(void* start_address, void* end_address, chunk_size_t chunk_size) {
     if (g_verbose)
         std::cout << "Preparing a memory region under test. This might take a while...";
@@ -975,6 +1005,85 @@ bool xmem::build_random_pointer_permutation(void* start_address, void* end_addre
     return true;
 }
 
+void xmem::place_random_chains(void* start_address, size_t len, uintptr_t** chains, uint8_t num_chains) {
+    //Chain heads go at evenly spaced, cache-line-aligned words, which are valid chunk boundaries for every chunk size.
+    //All chains advance one hop per round, so their distance apart along the permutation never changes and they never catch up with each other.
+    size_t spacing = (len / num_chains) & ~static_cast<size_t>(CACHE_LINE_SIZE-1);
+    for (uint8_t c = 0; c < num_chains; c++)
+        chains[c] = reinterpret_cast<uintptr_t*>(reinterpret_cast<uint8_t*>(start_address) + c * spacing);
+}
+
+bool xmem::build_random_cache_line_cycle(void* start_address, size_t num_lines) {
+    if (num_lines < 2) {
+        std::cerr << "ERROR: A cache line cycle needs at least 2 lines." << std::endl;
+        return false;
+    }
+
+    std::mt19937_64 gen(time(NULL)); //Mersenne Twister random number generator, seeded at current time
+
+    //Sattolo's algorithm: unlike a plain shuffle, the resulting permutation is always a single cycle, so no line is revisited before all others have been touched.
+    std::vector<size_t> next(num_lines);
+    for (size_t i = 0; i < num_lines; i++)
+        next[i] = i;
+    for (size_t i = num_lines-1; i > 0; i--) {
+        std::uniform_int_distribution<size_t> dist(0, i-1);
+        std::swap(next[i], next[dist(gen)]);
+    }
+
+    uint8_t* base = reinterpret_cast<uint8_t*>(start_address);
+    for (size_t i = 0; i < num_lines; i++)
+        *reinterpret_cast<uintptr_t*>(base + i*CACHE_LINE_SIZE) = reinterpret_cast<uintptr_t>(base + next[i]*CACHE_LINE_SIZE);
+
+    return true;
+}
+
+bool xmem::build_page_line_cycle(void* start_address, size_t num_pages, size_t page_size, bool random) {
+    if (num_pages < 1 || page_size < CACHE_LINE_SIZE || (page_size & (page_size-1)) != 0) {
+        std::cerr << "ERROR: A page line cycle needs at least 1 page, and the page size must be a power of two of at least one cache line." << std::endl;
+        return false;
+    }
+
+    //Order in which the pages are visited: a single cycle, either random (Sattolo's algorithm) or in address order
+    std::vector<size_t> next(num_pages);
+    for (size_t i = 0; i < num_pages; i++)
+        next[i] = (i+1) % num_pages;
+    if (random && num_pages > 1) {
+        std::mt19937_64 gen(time(NULL)); //Mersenne Twister random number generator, seeded at current time
+        for (size_t i = 0; i < num_pages; i++)
+            next[i] = i;
+        for (size_t i = num_pages-1; i > 0; i--) {
+            std::uniform_int_distribution<size_t> dist(0, i-1);
+            std::swap(next[i], next[dist(gen)]);
+        }
+    }
+
+    //An odd stagger visits every line slot of a page before reusing one, and the slots of consecutive pages land in different L1 sets for every page size
+    size_t lines_per_page = page_size / CACHE_LINE_SIZE;
+    uint8_t* base = reinterpret_cast<uint8_t*>(start_address);
+    for (size_t i = 0; i < num_pages; i++) {
+        uint8_t* line = base + i*page_size + ((i*67) % lines_per_page)*CACHE_LINE_SIZE;
+        uint8_t* next_line = base + next[i]*page_size + ((next[i]*67) % lines_per_page)*CACHE_LINE_SIZE;
+        *reinterpret_cast<uintptr_t*>(line) = reinterpret_cast<uintptr_t>(next_line);
+    }
+
+    return true;
+}
+
+#ifdef HAS_CACHE_LINE_FLUSH
+void xmem::flush_cache_lines(void* start_address, size_t len) {
+    uint8_t* base = reinterpret_cast<uint8_t*>(start_address);
+#if defined(ARCH_INTEL_X86_64) || defined(ARCH_AMD64)
+    for (size_t offset = 0; offset < len; offset += CACHE_LINE_SIZE)
+        _mm_clflush(base + offset);
+    _mm_mfence();
+#else //AArch64
+    for (size_t offset = 0; offset < len; offset += CACHE_LINE_SIZE)
+        asm volatile("dc civac, %0" : : "r" (base + offset) : "memory");
+    asm volatile("dsb ish" : : : "memory");
+#endif
+}
+#endif
+
 /***********************************************************************
  ***********************************************************************
  ********************** LATENCY-RELATED BENCHMARK KERNELS **************
@@ -2068,7 +2177,7 @@ int32_t __attribute__((optimize("O0"))) xmem::dummy_revStride16Loop_Word512(void
 /* ------------ RANDOM LOOP --------------*/
 
 #ifndef HAS_WORD_64 //special case: 32-bit architectures
-int32_t xmem::dummy_randomLoop_Word32(uintptr_t*, uintptr_t**, size_t len) {
+int32_t xmem::dummy_randomLoop_Word32(uintptr_t*, uintptr_t**, size_t len, uint8_t mlp) {
     volatile uintptr_t* placeholder = NULL; //Try to defeat compiler optimizations removing this method
     return 0;
 }
@@ -2082,7 +2191,7 @@ int32_t xmem::dummy_randomLoop_Word64(uintptr_t*, uintptr_t**, size_t len, uint8
 #endif
 
 #ifdef HAS_WORD_128
-int32_t xmem::dummy_randomLoop_Word128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+int32_t xmem::dummy_randomLoop_Word128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
 #if defined(_WIN32) && defined(ARCH_INTEL_X86_64)
     return 0; //TODO: Implement for Windows.
 #else
@@ -2104,7 +2213,7 @@ int32_t xmem::dummy_randomLoop_Word128(uintptr_t* first_address, uintptr_t** las
 #endif
 
 #ifdef HAS_WORD_256
-int32_t xmem::dummy_randomLoop_Word256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+int32_t xmem::dummy_randomLoop_Word256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
 #if defined(_WIN32) && defined(ARCH_INTEL_X86_64)
     return 0; //TODO: Implement for Windows.
 #else
@@ -2127,10 +2236,10 @@ int32_t xmem::dummy_randomLoop_Word256(uintptr_t* first_address, uintptr_t** las
 
 #ifdef HAS_WORD_512
 #ifdef _WIN32
-int32_t xmem::dummy_randomLoop_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+int32_t xmem::dummy_randomLoop_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
 #else
 //FIXME: We flag GCC/ICC not to optimize this function. The problem is that my_512b_load() -- which maps to _mm512_load_epi64 Intel AVX-512/KNC intrinsic -- cannot accept volatile* arguments. The only way to prevent the entire benchmark loop from being optimized away is to force the compiler not to optimize the function at all. Unfortunately, this will cause extra unwanted code to be included. The only solution seems to be to write inline assembly or allow eventual support for assignment of __m512i variables, e.g., val = *wordptr++; which is how the code for the other word sizes is written.
-int32_t __attribute__((optimize("O0"))) xmem::dummy_randomLoop_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+int32_t __attribute__((optimize("O0"))) xmem::dummy_randomLoop_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
 #endif
 #if defined(_WIN32) && defined(ARCH_INTEL_X86_64)
     return 0; //TODO: Implement for Windows.
@@ -3891,60 +4000,130 @@ int32_t __attribute__((optimize("O0"))) xmem::revStride16Write_Word512(void* sta
 /* ------------ RANDOM READ --------------*/
 
 #ifndef HAS_WORD_64 //special case: 32-bit machine
-int32_t xmem::randomRead_Word32(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
-    volatile uintptr_t* p = first_address;
+int32_t xmem::randomRead_Word32(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
+    if (mlp <= 1 && len == THROUGHPUT_BENCHMARK_BYTES_PER_PASS) { //Single chain of the default length: fully unrolled
+        volatile uintptr_t* p = first_address;
+
+        UNROLL1024(p = reinterpret_cast<uintptr_t*>(*p);)
+        *chains = const_cast<uintptr_t*>(p);
+        return 0;
+    }
 
-    UNROLL1024(p = reinterpret_cast<uintptr_t*>(*p);)
-    *last_touched_address = const_cast<uintptr_t*>(p);
+    //Interleave independent chains. Each round issues one load per chain, and no load depends on another chain.
+    uintptr_t* p[MAX_RANDOM_CHAINS];
+    for (uint8_t c = 0; c < mlp; c++)
+        p[c] = chains[c];
+    for (size_t rounds = len / (mlp * sizeof(Word32_t)); rounds > 0; rounds--) {
+        for (uint8_t c = 0; c < mlp; c++)
+            p[c] = reinterpret_cast<uintptr_t*>(*reinterpret_cast<volatile uintptr_t*>(p[c]));
+    }
+    for (uint8_t c = 0; c < mlp; c++)
+        chains[c] = p[c];
     return 0;
 }
 #endif
 
 #ifdef HAS_WORD_64
-int32_t xmem::randomRead_Word64(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
-    volatile uintptr_t* p = first_address;
+int32_t xmem::randomRead_Word64(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
+    if (mlp <= 1 && len == THROUGHPUT_BENCHMARK_BYTES_PER_PASS) { //Single chain of the default length: fully unrolled
+        volatile uintptr_t* p = first_address;
+
+        UNROLL512(p = reinterpret_cast<uintptr_t*>(*p);)
+        *chains = const_cast<uintptr_t*>(p);
+        return 0;
+    }
 
-    UNROLL512(p = reinterpret_cast<uintptr_t*>(*p);)
-    *last_touched_address = const_cast<uintptr_t*>(p);
+    //Interleave independent chains. Each round issues one load per chain, and no load depends on another chain.
+    uintptr_t* p[MAX_RANDOM_CHAINS];
+    for (uint8_t c = 0; c < mlp; c++)
+        p[c] = chains[c];
+    for (size_t rounds = len / (mlp * sizeof(Word64_t)); rounds > 0; rounds--) {
+        for (uint8_t c = 0; c < mlp; c++)
+            p[c] = reinterpret_cast<uintptr_t*>(*reinterpret_cast<volatile uintptr_t*>(p[c]));
+    }
+    for (uint8_t c = 0; c < mlp; c++)
+        chains[c] = p[c];
     return 0;
 }
 #endif
 
 #ifdef HAS_WORD_128
-int32_t xmem::randomRead_Word128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
+int32_t xmem::randomRead_Word128(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
 #if defined(_WIN32) && defined(ARCH_INTEL_X86_64)
     return 0; //TODO: Implement for Windows.
 #else
-    volatile Word128_t* p = reinterpret_cast<Word128_t*>(first_address);
     register Word128_t val;
 
+    if (mlp <= 1 && len == THROUGHPUT_BENCHMARK_BYTES_PER_PASS) { //Single chain of the default length: fully unrolled
+        volatile Word128_t* p = reinterpret_cast<Word128_t*>(first_address);
+
 #ifdef HAS_WORD_64
-    UNROLL256(val = *p; p = reinterpret_cast<Word128_t*>(my_64b_extractLSB_128b(val));) //Do 128-bit load. Then extract 64 LSB to use as next load address.
+        UNROLL256(val = *p; p = reinterpret_cast<Word128_t*>(my_64b_extractLSB_128b(val));) //Do 128-bit load. Then extract 64 LSB to use as next load address.
 #else //special case: 32-bit machine
-    UNROLL256(val = *p; p = reinterpret_cast<Word128_t*>(my_32b_extractLSB_128b(val));) //Do 128-bit load. Then extract 32 LSB to use as next load address.
+        UNROLL256(val = *p; p = reinterpret_cast<Word128_t*>(my_32b_extractLSB_128b(val));) //Do 128-bit load. Then extract 32 LSB to use as next load address.
 #endif
 
-    *last_touched_address = reinterpret_cast<uintptr_t*>(const_cast<Word128_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+        *chains = reinterpret_cast<uintptr_t*>(const_cast<Word128_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+        return 0;
+    }
+
+    //Interleave independent chains. Each round issues one load per chain, and no load depends on another chain.
+    Word128_t* p[MAX_RANDOM_CHAINS];
+    for (uint8_t c = 0; c < mlp; c++)
+        p[c] = reinterpret_cast<Word128_t*>(chains[c]);
+    for (size_t rounds = len / (mlp * sizeof(Word128_t)); rounds > 0; rounds--) {
+        for (uint8_t c = 0; c < mlp; c++) {
+            val = *reinterpret_cast<volatile Word128_t*>(p[c]);
+#ifdef HAS_WORD_64
+            p[c] = reinterpret_cast<Word128_t*>(my_64b_extractLSB_128b(val)); //Extract 64 LSB to use as next load address.
+#else //special case: 32-bit machine
+            p[c] = reinterpret_cast<Word128_t*>(my_32b_extractLSB_128b(val)); //Extract 32 LSB to use as next load address.
+#endif
+        }
+    }
+    for (uint8_t c = 0; c < mlp; c++)
+        chains[c] = reinterpret_cast<uintptr_t*>(p[c]);
     return 0;
 #endif
 }
 #endif
 
 #ifdef HAS_WORD_256
-int32_t xmem::randomRead_Word256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
+int32_t xmem::randomRead_Word256(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
 #if defined(_WIN32) && defined(ARCH_INTEL_X86_64)
     return 0; //TODO: Implement for Windows.
 #else
-    volatile Word256_t* p = reinterpret_cast<Word256_t*>(first_address);
     register Word256_t val;
 
+    if (mlp <= 1 && len == THROUGHPUT_BENCHMARK_BYTES_PER_PASS) { //Single chain of the default length: fully unrolled
+        volatile Word256_t* p = reinterpret_cast<Word256_t*>(first_address);
+
 #ifdef HAS_WORD_64
-    UNROLL128(val = *p; p = reinterpret_cast<Word256_t*>(my_64b_extractLSB_256b(val));) //Do 256-bit load. Then extract 64 LSB to use as next load address.
+        UNROLL128(val = *p; p = reinterpret_cast<Word256_t*>(my_64b_extractLSB_256b(val));) //Do 256-bit load. Then extract 64 LSB to use as next load address.
 #else //special case: 32-bit machine
-    UNROLL128(val = *p; p = reinterpret_cast<Word256_t*>(my_32b_extractLSB_256b(val));) //Do 256-bit load. Then extract 32 LSB to use as next load address.
+        UNROLL128(val = *p; p = reinterpret_cast<Word256_t*>(my_32b_extractLSB_256b(val));) //Do 256-bit load. Then extract 32 LSB to use as next load address.
 #endif
 
-    *last_touched_address = reinterpret_cast<uintptr_t*>(const_cast<Word256_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+        *chains = reinterpret_cast<uintptr_t*>(const_cast<Word256_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+        return 0;
+    }
+
+    //Interleave independent chains. Each round issues one load per chain, and no load depends on another chain.
+    Word256_t* p[MAX_RANDOM_CHAINS];
+    for (uint8_t c = 0; c < mlp; c++)
+        p[c] = reinterpret_cast<Word256_t*>(chains[c]);
+    for (size_t rounds = len / (mlp * sizeof(Word256_t)); rounds > 0; rounds--) {
+        for (uint8_t c = 0; c < mlp; c++) {
+            val = *reinterpret_cast<volatile Word256_t*>(p[c]);
+#ifdef HAS_WORD_64
+            p[c] = reinterpret_cast<Word256_t*>(my_64b_extractLSB_256b(val)); //Extract 64 LSB to use as next load address.
+#else //special case: 32-bit machine
+            p[c] = reinterpret_cast<Word256_t*>(my_32b_extractLSB_256b(val)); //Extract 32 LSB to use as next load address.
+#endif
+        }
+    }
+    for (uint8_t c = 0; c < mlp; c++)
+        chains[c] = reinterpret_cast<uintptr_t*>(p[c]);
     return 0;
 #endif
 }
@@ -3952,24 +4131,42 @@ int32_t xmem::randomRead_Word256(uintptr_t* first_address, uintptr_t** last_touc
 
 #ifdef HAS_WORD_512
 #ifdef _WIN32
-int32_t xmem::randomRead_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
+int32_t xmem::randomRead_Word512(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
 #else
 //FIXME: We flag GCC/ICC not to optimize this function. The problem is that my_512b_load() -- which maps to _mm512_load_epi64 Intel AVX-512/KNC intrinsic -- cannot accept volatile* arguments. The only way to prevent the entire benchmark loop from being optimized away is to force the compiler not to optimize the function at all. Unfortunately, this will cause extra unwanted code to be included. The only solution seems to be to write inline assembly or allow eventual support for assignment of __m512i variables, e.g., val = *wordptr++; which is how the code for the other word sizes is written.
-int32_t __attribute__((optimize("O0"))) xmem::randomRead_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
+int32_t __attribute__((optimize("O0"))) xmem::randomRead_Word512(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
 #endif
 #if defined(_WIN32) && defined(ARCH_INTEL_X86_64)
     #error 512-bit words are not supported on Windows.
 #else
-    //volatile Word512_t* p = reinterpret_cast<Word512_t*>(first_address);
-    Word512_t* p = reinterpret_cast<Word512_t*>(first_address);
     register Word512_t val;
-
-    //UNROLL64(val = *p; p = reinterpret_cast<Word512_t*>(my_64b_extractLSB_512b(val));) //Do 512-bit load. Then extract 64 LSB to use as next load address.
     uint64_t scratchptr[8] __attribute__ ((aligned(512)));
     uint64_t tmp;
-    UNROLL64(val = my_512b_load(p); my_64b_extractLSB_512b(tmp, scratchptr, val); p = reinterpret_cast<Word512_t*>(tmp);) //Do 512-bit load. Then extract 64 LSB to use as next load address.
 
-    *last_touched_address = reinterpret_cast<uintptr_t*>(const_cast<Word512_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+    if (mlp <= 1 && len == THROUGHPUT_BENCHMARK_BYTES_PER_PASS) { //Single chain of the default length: fully unrolled
+        //volatile Word512_t* p = reinterpret_cast<Word512_t*>(first_address);
+        Word512_t* p = reinterpret_cast<Word512_t*>(first_address);
+
+        //UNROLL64(val = *p; p = reinterpret_cast<Word512_t*>(my_64b_extractLSB_512b(val));) //Do 512-bit load. Then extract 64 LSB to use as next load address.
+        UNROLL64(val = my_512b_load(p); my_64b_extractLSB_512b(tmp, scratchptr, val); p = reinterpret_cast<Word512_t*>(tmp);) //Do 512-bit load. Then extract 64 LSB to use as next load address.
+
+        *chains = reinterpret_cast<uintptr_t*>(const_cast<Word512_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+        return 0;
+    }
+
+    //Interleave independent chains. Each round issues one load per chain, and no load depends on another chain.
+    Word512_t* p[MAX_RANDOM_CHAINS];
+    for (uint8_t c = 0; c < mlp; c++)
+        p[c] = reinterpret_cast<Word512_t*>(chains[c]);
+    for (size_t rounds = len / (mlp * sizeof(Word512_t)); rounds > 0; rounds--) {
+        for (uint8_t c = 0; c < mlp; c++) {
+            val = my_512b_load(p[c]); //Do 512-bit load. Then extract 64 LSB to use as next load address.
+            my_64b_extractLSB_512b(tmp, scratchptr, val);
+            p[c] = reinterpret_cast<Word512_t*>(tmp);
+        }
+    }
+    for (uint8_t c = 0; c < mlp; c++)
+        chains[c] = reinterpret_cast<uintptr_t*>(p[c]);
     return 0;
 #endif
 }
@@ -3978,62 +4175,146 @@ int32_t __attribute__((optimize("O0"))) xmem::randomRead_Word512(uintptr_t* firs
 /* ------------ RANDOM WRITE --------------*/
 
 #ifndef HAS_WORD_64 //special case: 32-bit machine
-int32_t xmem::randomWrite_Word32(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
-    volatile uintptr_t* p = first_address;
-    volatile uintptr_t* p2 = NULL;
+int32_t xmem::randomWrite_Word32(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
+    if (mlp <= 1 && len == THROUGHPUT_BENCHMARK_BYTES_PER_PASS) { //Single chain of the default length: fully unrolled
+        volatile uintptr_t* p = first_address;
+        volatile uintptr_t* p2 = NULL;
 
-    UNROLL1024(p2 = reinterpret_cast<uintptr_t*>(*p); *p = reinterpret_cast<uintptr_t>(p2); p = p2;)
-    *last_touched_address = const_cast<uintptr_t*>(p);
+        UNROLL1024(p2 = reinterpret_cast<uintptr_t*>(*p); *p = reinterpret_cast<uintptr_t>(p2); p = p2;)
+        *chains = const_cast<uintptr_t*>(p);
+        return 0;
+    }
+
+    //Interleave independent chains. Each round reads and writes back one pointer per chain, and no access depends on another chain.
+    uintptr_t* p[MAX_RANDOM_CHAINS];
+    uintptr_t* p2 = NULL;
+    for (uint8_t c = 0; c < mlp; c++)
+        p[c] = chains[c];
+    for (size_t rounds = len / (mlp * sizeof(Word32_t)); rounds > 0; rounds--) {
+        for (uint8_t c = 0; c < mlp; c++) {
+            volatile uintptr_t* q = p[c];
+            p2 = reinterpret_cast<uintptr_t*>(*q);
+            *q = reinterpret_cast<uintptr_t>(p2);
+            p[c] = p2;
+        }
+    }
+    for (uint8_t c = 0; c < mlp; c++)
+        chains[c] = p[c];
     return 0;
 }
 #endif
 
 #ifdef HAS_WORD_64
-int32_t xmem::randomWrite_Word64(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
-    volatile uintptr_t* p = first_address;
-    volatile uintptr_t* p2 = NULL;
+int32_t xmem::randomWrite_Word64(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
+    if (mlp <= 1 && len == THROUGHPUT_BENCHMARK_BYTES_PER_PASS) { //Single chain of the default length: fully unrolled
+        volatile uintptr_t* p = first_address;
+        volatile uintptr_t* p2 = NULL;
 
-    UNROLL512(p2 = reinterpret_cast<uintptr_t*>(*p); *p = reinterpret_cast<uintptr_t>(p2); p = p2;)
-    *last_touched_address = const_cast<uintptr_t*>(p);
+        UNROLL512(p2 = reinterpret_cast<uintptr_t*>(*p); *p = reinterpret_cast<uintptr_t>(p2); p = p2;)
+        *chains = const_cast<uintptr_t*>(p);
+        return 0;
+    }
+
+    //Interleave independent chains. Each round reads and writes back one pointer per chain, and no access depends on another chain.
+    uintptr_t* p[MAX_RANDOM_CHAINS];
+    uintptr_t* p2 = NULL;
+    for (uint8_t c = 0; c < mlp; c++)
+        p[c] = chains[c];
+    for (size_t rounds = len / (mlp * sizeof(Word64_t)); rounds > 0; rounds--) {
+        for (uint8_t c = 0; c < mlp; c++) {
+            volatile uintptr_t* q = p[c];
+            p2 = reinterpret_cast<uintptr_t*>(*q);
+            *q = reinterpret_cast<uintptr_t>(p2);
+            p[c] = p2;
+        }
+    }
+    for (uint8_t c = 0; c < mlp; c++)
+        chains[c] = p[c];
     return 0;
 }
 #endif
 
 #ifdef HAS_WORD_128
-int32_t xmem::randomWrite_Word128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
+int32_t xmem::randomWrite_Word128(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
 #if defined(_WIN32) && defined(ARCH_INTEL_X86_64)
     return 0; //TODO: Implement for Windows.
 #else
-    volatile Word128_t* p = reinterpret_cast<Word128_t*>(first_address);
     register Word128_t val;
 
+    if (mlp <= 1 && len == THROUGHPUT_BENCHMARK_BYTES_PER_PASS) { //Single chain of the default length: fully unrolled
+        volatile Word128_t* p = reinterpret_cast<Word128_t*>(first_address);
+
 #ifdef HAS_WORD_64
-    UNROLL256(val = *p; *p = val; p = reinterpret_cast<Word128_t*>(my_64b_extractLSB_128b(val));) //Do 128-bit load. Then do 128-bit store. Then extract 64 LSB to use as next load address.
+        UNROLL256(val = *p; *p = val; p = reinterpret_cast<Word128_t*>(my_64b_extractLSB_128b(val));) //Do 128-bit load. Then do 128-bit store. Then extract 64 LSB to use as next load address.
 #else //special case: 32-bit machine
-    UNROLL256(val = *p; *p = val; p = reinterpret_cast<Word128_t*>(my_32b_extractLSB_128b(val));) //Do 128-bit load. Then do 128-bit store. Then extract 32 LSB to use as next load address.
+        UNROLL256(val = *p; *p = val; p = reinterpret_cast<Word128_t*>(my_32b_extractLSB_128b(val));) //Do 128-bit load. Then do 128-bit store. Then extract 32 LSB to use as next load address.
 #endif
 
-    *last_touched_address = reinterpret_cast<uintptr_t*>(const_cast<Word128_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+        *chains = reinterpret_cast<uintptr_t*>(const_cast<Word128_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+        return 0;
+    }
+
+    //Interleave independent chains. Each round reads and writes back one word per chain, and no access depends on another chain.
+    Word128_t* p[MAX_RANDOM_CHAINS];
+    for (uint8_t c = 0; c < mlp; c++)
+        p[c] = reinterpret_cast<Word128_t*>(chains[c]);
+    for (size_t rounds = len / (mlp * sizeof(Word128_t)); rounds > 0; rounds--) {
+        for (uint8_t c = 0; c < mlp; c++) {
+            volatile Word128_t* q = p[c];
+            val = *q;
+            *q = val;
+#ifdef HAS_WORD_64
+            p[c] = reinterpret_cast<Word128_t*>(my_64b_extractLSB_128b(val)); //Extract 64 LSB to use as next load address.
+#else //special case: 32-bit machine
+            p[c] = reinterpret_cast<Word128_t*>(my_32b_extractLSB_128b(val)); //Extract 32 LSB to use as next load address.
+#endif
+        }
+    }
+    for (uint8_t c = 0; c < mlp; c++)
+        chains[c] = reinterpret_cast<uintptr_t*>(p[c]);
     return 0;
 #endif
 }
 #endif
 
 #ifdef HAS_WORD_256
-int32_t xmem::randomWrite_Word256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
+int32_t xmem::randomWrite_Word256(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
 #if defined(_WIN32) && defined(ARCH_INTEL_X86_64)
     return 0; //TODO: Implement for Windows.
 #else
-    volatile Word256_t* p = reinterpret_cast<Word256_t*>(first_address);
     register Word256_t val;
 
+    if (mlp <= 1 && len == THROUGHPUT_BENCHMARK_BYTES_PER_PASS) { //Single chain of the default length: fully unrolled
+        volatile Word256_t* p = reinterpret_cast<Word256_t*>(first_address);
+
 #ifdef HAS_WORD_64
-    UNROLL128(val = *p; *p = val; p = reinterpret_cast<Word256_t*>(my_64b_extractLSB_256b(val));) //Do 256-bit load. Then do 256-bit store. Then extract 64 LSB to use as next load address.
+        UNROLL128(val = *p; *p = val; p = reinterpret_cast<Word256_t*>(my_64b_extractLSB_256b(val));) //Do 256-bit load. Then do 256-bit store. Then extract 64 LSB to use as next load address.
 #else //special case: 32-bit machine
-    UNROLL128(val = *p; *p = val; p = reinterpret_cast<Word256_t*>(my_32b_extractLSB_256b(val));) //Do 256-bit load. Then do 256-bit store. Then extract 32 LSB to use as next load address.
+        UNROLL128(val = *p; *p = val; p = reinterpret_cast<Word256_t*>(my_32b_extractLSB_256b(val));) //Do 256-bit load. Then do 256-bit store. Then extract 32 LSB to use as next load address.
 #endif
 
-    *last_touched_address = reinterpret_cast<uintptr_t*>(const_cast<Word256_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+        *chains = reinterpret_cast<uintptr_t*>(const_cast<Word256_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+        return 0;
+    }
+
+    //Interleave independent chains. Each round reads and writes back one word per chain, and no access depends on another chain.
+    Word256_t* p[MAX_RANDOM_CHAINS];
+    for (uint8_t c = 0; c < mlp; c++)
+        p[c] = reinterpret_cast<Word256_t*>(chains[c]);
+    for (size_t rounds = len / (mlp * sizeof(Word256_t)); rounds > 0; rounds--) {
+        for (uint8_t c = 0; c < mlp; c++) {
+            volatile Word256_t* q = p[c];
+            val = *q;
+            *q = val;
+#ifdef HAS_WORD_64
+            p[c] = reinterpret_cast<Word256_t*>(my_64b_extractLSB_256b(val)); //Extract 64 LSB to use as next load address.
+#else //special case: 32-bit machine
+            p[c] = reinterpret_cast<Word256_t*>(my_32b_extractLSB_256b(val)); //Extract 32 LSB to use as next load address.
+#endif
+        }
+    }
+    for (uint8_t c = 0; c < mlp; c++)
+        chains[c] = reinterpret_cast<uintptr_t*>(p[c]);
     return 0;
 #endif
 }
@@ -4041,25 +4322,99 @@ int32_t xmem::randomWrite_Word256(uintptr_t* first_address, uintptr_t** last_tou
 
 #ifdef HAS_WORD_512
 #ifdef _WIN32
-int32_t xmem::randomWrite_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
+int32_t xmem::randomWrite_Word512(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
 #else
 //FIXME: We flag GCC/ICC not to optimize this function. The problem is that my_512b_load() -- which maps to _mm512_load_epi64 Intel AVX-512/KNC intrinsic -- cannot accept volatile* arguments. The only way to prevent the entire benchmark loop from being optimized away is to force the compiler not to optimize the function at all. Unfortunately, this will cause extra unwanted code to be included. The only solution seems to be to write inline assembly or allow eventual support for assignment of __m512i variables, e.g., val = *wordptr++; which is how the code for the other word sizes is written.
-int32_t __attribute__((optimize("O0"))) xmem::randomWrite_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp) {
+int32_t __attribute__((optimize("O0"))) xmem::randomWrite_Word512(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp) {
 #endif
 #if defined(_WIN32) && defined(ARCH_INTEL_X86_64)
 #error 512-bit words are not supported on Windows.
 #else
-    //volatile Word512_t* p = reinterpret_cast<Word512_t*>(first_address);
-    Word512_t* p = reinterpret_cast<Word512_t*>(first_address);
     register Word512_t val;
-
-    //UNROLL64(val = *p; *p = val; p = reinterpret_cast<Word512_t*>(my_64b_extractLSB_512b(val));) //Do 512-bit load. Then do 512-bit store. Then extract 64 LSB to use as next load address.
     uint64_t scratchptr[8] __attribute__ ((aligned(512)));
     uint64_t tmp;
-    UNROLL64(val = my_512b_load(p); *p = val; my_64b_extractLSB_512b(tmp, scratchptr, val); p = reinterpret_cast<Word512_t*>(tmp);) //Do 512-bit load. Then do 512-bit store. Then extract 64 LSB to use as next load address.
 
-    *last_touched_address = reinterpret_cast<uintptr_t*>(const_cast<Word512_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+    if (mlp <= 1 && len == THROUGHPUT_BENCHMARK_BYTES_PER_PASS) { //Single chain of the default length: fully unrolled
+        //volatile Word512_t* p = reinterpret_cast<Word512_t*>(first_address);
+        Word512_t* p = reinterpret_cast<Word512_t*>(first_address);
+
+        //UNROLL64(val = *p; *p = val; p = reinterpret_cast<Word512_t*>(my_64b_extractLSB_512b(val));) //Do 512-bit load. Then do 512-bit store. Then extract 64 LSB to use as next load address.
+        UNROLL64(val = my_512b_load(p); *p = val; my_64b_extractLSB_512b(tmp, scratchptr, val); p = reinterpret_cast<Word512_t*>(tmp);) //Do 512-bit load. Then do 512-bit store. Then extract 64 LSB to use as next load address.
+
+        *chains = reinterpret_cast<uintptr_t*>(const_cast<Word512_t*>(p)); //Trick compiler. First get rid of volatile qualifier, and then reinterpret pointer
+        return 0;
+    }
+
+    //Interleave independent chains. Each round reads and writes back one word per chain, and no access depends on another chain.
+    Word512_t* p[MAX_RANDOM_CHAINS];
+    for (uint8_t c = 0; c < mlp; c++)
+        p[c] = reinterpret_cast<Word512_t*>(chains[c]);
+    for (size_t rounds = len / (mlp * sizeof(Word512_t)); rounds > 0; rounds--) {
+        for (uint8_t c = 0; c < mlp; c++) {
+            val = my_512b_load(p[c]); //Do 512-bit load. Then do 512-bit store. Then extract 64 LSB to use as next load address.
+            *p[c] = val;
+            my_64b_extractLSB_512b(tmp, scratchptr, val);
+            p[c] = reinterpret_cast<Word512_t*>(tmp);
+        }
+    }
+    for (uint8_t c = 0; c < mlp; c++)
+        chains[c] = reinterpret_cast<uintptr_t*>(p[c]);
     return 0;
 #endif
 }
 #endif
+
+/***********************************************************************
+ ***********************************************************************
+ ******************* GATHER/SCATTER BENCHMARK KERNELS ******************
+ ***********************************************************************
+ ***********************************************************************/
+
+int32_t xmem::gatherRead_Word64(uint64_t* table, uint32_t* indices, size_t num_indices) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < num_indices; i += 8) {
+        UNROLL8(sum += table[*indices++];)
+    }
+    volatile uint64_t sink = sum; //Keep the loads from being optimized away
+    return 0;
+}
+
+int32_t xmem::scatterWrite_Word64(uint64_t* table, uint32_t* indices, size_t num_indices) {
+    for (size_t i = 0; i < num_indices; i += 8) {
+        UNROLL8(table[*indices] = *indices; indices++;)
+    }
+    return 0;
+}
+
+#ifdef HAS_GATHER_256
+int32_t xmem::gatherRead_Word64x4(uint64_t* table, uint32_t* indices, size_t num_indices) {
+    const long long* base = reinterpret_cast<const long long*>(table);
+    __m256i sum = _mm256_setzero_si256();
+    for (size_t i = 0; i < num_indices; i += 8) {
+        UNROLL2(sum = _mm256_add_epi64(sum, _mm256_i32gather_epi64(base, _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices)), 8)); indices += 4;)
+    }
+    volatile uint64_t sink = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm256_castsi256_si128(sum))); //Keep the gathers from being optimized away
+    return 0;
+}
+#endif
+
+#ifdef HAS_GATHER_SCATTER_512
+int32_t xmem::gatherRead_Word64x8(uint64_t* table, uint32_t* indices, size_t num_indices) {
+    __m512i sum = _mm512_setzero_si512();
+    for (size_t i = 0; i < num_indices; i += 8) {
+        sum = _mm512_add_epi64(sum, _mm512_i32gather_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices)), table, 8));
+        indices += 8;
+    }
+    volatile uint64_t sink = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm512_castsi512_si128(sum))); //Keep the gathers from being optimized away
+    return 0;
+}
+
+int32_t xmem::scatterWrite_Word64x8(uint64_t* table, uint32_t* indices, size_t num_indices) {
+    for (size_t i = 0; i < num_indices; i += 8) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices));
+        _mm512_i32scatter_epi64(table, idx, _mm512_cvtepu32_epi64(idx), 8); //Store each element's own index, like the scalar kernel
+        indices += 8;
+    }
+    return 0;
+}
+#endif
@@ -50,6 +50,8 @@
 #endif
 #include <fstream> //for std::ifstream
 #include <algorithm> //for std::find
+#include <string>
+#include <cstdlib> //for strtoull()
 
 #ifdef ARCH_INTEL
 #include <immintrin.h> //for timer
@@ -61,18 +63,15 @@
 #include <time.h>
 #endif
 
-#ifdef HAS_LARGE_PAGES
-extern "C" {
-#include <hugetlbfs.h> //for getting huge page size
-}
-#endif
 #endif
 
 namespace xmem {
     bool g_verbose = false; /**< If true, be more verbose with console reporting. */
     size_t g_page_size; /**< Default page size on the system, in bytes. */
     size_t g_large_page_size; /**< Large page size on the system, in bytes. */
+    size_t g_thp_page_size; /**< Transparent huge page size on the system, in bytes. This is the PMD size, which can differ from the default explicit huge page size. */
     uint32_t g_num_numa_nodes; /**< Number of NUMA nodes in the system. */
+    uint32_t g_num_cpu_numa_nodes; /**< Number of NUMA nodes in the system that have logical CPUs. The rest are memory-only nodes. */
     uint32_t g_num_logical_cpus; /**< Number of logical CPU cores in the system. This may be different than physical CPUs, e.g. simultaneous multithreading. */
     uint32_t g_num_physical_cpus; /**< Number of physical CPU cores in the system. */
     uint32_t g_num_physical_packages; /**< Number of physical CPU packages in the system. Generally this is the same as number of NUMA nodes, unless UMA emulation is done in hardware. */
@@ -82,8 +81,15 @@ namespace xmem {
     uint32_t g_total_l4_caches; /**< Total number of L4 caches in the system. */
     uint32_t g_starting_test_index; /**< Numeric identifier for the first benchmark test. */
     uint32_t g_test_index; /**< Numeric identifier for the current benchmark test. */
+    timer_backend_t g_timer_backend; /**< Timer that start_timer() and stop_timer() read. */
     tick_t g_ticks_per_ms; /**< Timer ticks per ms. */
     float g_ns_per_tick; /**< Nanoseconds per timer tick. */
+    float g_timer_resolution_ns; /**< Timer resolution in nanoseconds. */
+    float g_timer_overhead_ns; /**< Overhead of a back-to-back timer start and stop in nanoseconds. */
+    bool g_invariant_tsc; /**< True if the time stamp counter is invariant. Only queried on x86. */
+    bool g_perf_counters; /**< If true, memory workers collect hardware performance counters on their timed passes. */
+    float g_core_ghz; /**< Measured core clock frequency in GHz, used to report results in core cycles. 0 if unknown. */
+    std::vector<float> g_timer_backend_overhead_ns; /**< Mean cost of a start_timer() and stop_timer() pair in nanoseconds for each timer backend. 0 for backends that are not available. */
 };
 
 using namespace xmem;
@@ -253,6 +259,9 @@ void xmem::print_compile_time_options() {
 #ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
     std::cout << "EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK" << std::endl;
 #endif
+#ifdef EXT_MEMCPY_BENCHMARK
+    std::cout << "EXT_MEMCPY_BENCHMARK" << std::endl;
+#endif
 #ifdef EXT_STREAM_BENCHMARK
     std::cout << "EXT_STREAM_BENCHMARK" << std::endl;
 #endif
@@ -265,15 +274,47 @@ void xmem::setup_timer() {
 
     Timer timer;
     g_ticks_per_ms = timer.getTicksPerMs();
+    g_core_ghz = timer.getCoreGhz();
+    g_timer_backend_overhead_ns = timer.getBackendOverheadNs();
     g_ns_per_tick = timer.getNsPerTick();
+    g_timer_resolution_ns = timer.getResolutionNs();
+    g_timer_overhead_ns = timer.getOverheadNs();
+    g_invariant_tsc = timer.hasInvariantTsc();
 
     if (g_verbose)
         std::cout << "done" << std::endl;
+
+#ifdef USE_TSC_TIMER
+    if (g_timer_backend != TIMER_OS && !g_invariant_tsc)
+        std::cerr << "WARNING: The CPU does not report an invariant TSC, so the hardware timer may drift with frequency scaling and sleep states. Results may not be correct." << std::endl;
+#endif
 }
 
 void xmem::report_timer() {
+    std::cout << "Timer: " << timer_backend_name(g_timer_backend) << std::endl;
     std::cout << "Calculated timer frequency: " << g_ticks_per_ms * 1000 << " Hz == " << (double)(g_ticks_per_ms*1000) / (1e6) << " MHz" << std::endl;
     std::cout << "Derived timer ns per tick: " << g_ns_per_tick << std::endl;
+    std::cout << "Timer resolution: " << g_timer_resolution_ns << " ns" << std::endl;
+    std::cout << "Timer overhead: " << g_timer_overhead_ns << " ns per back-to-back start and stop" << std::endl;
+#ifdef USE_TSC_TIMER
+    std::cout << "Invariant TSC: " << (g_invariant_tsc ? "yes" : "no") << std::endl;
+#endif
+    if (g_core_ghz > 0)
+        std::cout << "Measured core clock: " << g_core_ghz << " GHz" << std::endl;
+    else
+        std::cout << "Measured core clock: unavailable on this platform, so results are not reported in core cycles" << std::endl;
+    std::cout << "Mean cost of a start_timer() and stop_timer() pair:" << std::endl;
+    for (uint32_t b = 0; b < NUM_TIMER_BACKENDS; b++) {
+        timer_backend_t backend = static_cast<timer_backend_t>(b);
+        if (!timer_backend_available(backend))
+            continue;
+        std::cout << "    " << timer_backend_name(backend) << ": " << g_timer_backend_overhead_ns[b] << " ns";
+        if (g_core_ghz > 0)
+            std::cout << " == " << g_timer_backend_overhead_ns[b] * g_core_ghz << " core cycles";
+        if (backend == g_timer_backend)
+            std::cout << " (in use)";
+        std::cout << std::endl;
+    }
     std::cout << std::endl;
 }
     
@@ -446,11 +487,29 @@ int32_t xmem::cpu_id_in_numa_node(uint32_t numa_node, uint32_t cpu_in_node) {
     return cpu_id;
 #endif
 }
+
+bool xmem::numa_node_has_cpus(uint32_t numa_node) {
+#ifndef HAS_NUMA
+    return numa_node == 0;
+#else
+    return cpu_id_in_numa_node(numa_node, 0) >= 0;
+#endif
+}
+
+uint32_t xmem::numa_node_distance(uint32_t from_node, uint32_t to_node) {
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+    int distance = numa_distance(static_cast<int>(from_node), static_cast<int>(to_node)); //0 if the firmware does not provide a distance table
+    return distance > 0 ? static_cast<uint32_t>(distance) : 0;
+#else
+    return 0; //Not exposed by the OS
+#endif
+}
     
 void xmem::init_globals() {
     //Initialize global variables to defaults.
     g_verbose = false;
     g_num_numa_nodes = DEFAULT_NUM_NODES;
+    g_num_cpu_numa_nodes = DEFAULT_NUM_NODES;
     g_num_physical_packages = DEFAULT_NUM_PHYSICAL_PACKAGES;
     g_num_physical_cpus = DEFAULT_NUM_PHYSICAL_CPUS;
     g_num_logical_cpus = DEFAULT_NUM_LOGICAL_CPUS;
@@ -460,9 +519,21 @@ void xmem::init_globals() {
     g_total_l4_caches = DEFAULT_NUM_L4_CACHES;
     g_page_size = DEFAULT_PAGE_SIZE;
     g_large_page_size = DEFAULT_LARGE_PAGE_SIZE; 
+    g_thp_page_size = DEFAULT_LARGE_PAGE_SIZE;
 
+#if defined(USE_HW_TIMER) && defined(USE_TSC_TIMER)
+    g_timer_backend = TIMER_RDTSCP;
+#else
+    g_timer_backend = TIMER_OS;
+#endif
     g_ticks_per_ms = 0;
     g_ns_per_tick = 0;
+    g_timer_resolution_ns = 0;
+    g_timer_overhead_ns = 0;
+    g_invariant_tsc = false;
+    g_core_ghz = 0;
+    g_timer_backend_overhead_ns.clear();
+    g_perf_counters = false;
 }
 
 int32_t xmem::query_sys_info() {
@@ -630,6 +701,13 @@ int32_t xmem::query_sys_info() {
     g_total_l4_caches = 0; 
 #endif
 
+    //Count the nodes with CPUs. Memory-only nodes can still be used as memory targets, but not as CPU nodes.
+    g_num_cpu_numa_nodes = 0;
+    for (uint32_t numa_node = 0; numa_node < g_num_numa_nodes; numa_node++) {
+        if (numa_node_has_cpus(numa_node))
+            g_num_cpu_numa_nodes++;
+    }
+
     //Get page size
 #ifdef _WIN32
     SYSTEM_INFO sysinfo;
@@ -643,8 +721,19 @@ int32_t xmem::query_sys_info() {
 #ifdef __gnu_linux__
     g_page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
 #ifdef HAS_LARGE_PAGES
-    g_large_page_size = gethugepagesize(); 
+    std::ifstream meminfo("/proc/meminfo"); //Default huge page size, e.g. "Hugepagesize:    2048 kB"
+    std::string meminfo_line;
+    while (std::getline(meminfo, meminfo_line)) {
+        if (meminfo_line.compare(0, 13, "Hugepagesize:") == 0) {
+            g_large_page_size = static_cast<size_t>(strtoull(meminfo_line.c_str() + 13, NULL, 10)) * KB;
+            break;
+        }
+    }
 #endif
+    std::ifstream pmd_size_file("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size"); //Transparent huge pages only come in the PMD size, whatever default_hugepagesz is
+    size_t pmd_size = 0;
+    if (pmd_size_file >> pmd_size && pmd_size > 0)
+        g_thp_page_size = pmd_size;
     in.close();
 #endif
 
@@ -661,6 +750,8 @@ void xmem::report_sys_info() {
     std::cout << "Number of NUMA nodes: " << g_num_numa_nodes;
     if (g_num_numa_nodes == DEFAULT_NUM_NODES)
         std::cout << "?";
+    if (g_num_cpu_numa_nodes < g_num_numa_nodes)
+        std::cout << " (" << g_num_numa_nodes - g_num_cpu_numa_nodes << " memory-only)";
     std::cout << std::endl;
     std::cout << "Number of physical processor packages: " << g_num_physical_packages;
     if (g_num_physical_packages == DEFAULT_NUM_PHYSICAL_PACKAGES)
@@ -698,34 +789,60 @@ void xmem::report_sys_info() {
 #ifdef HAS_LARGE_PAGES
     std::cout << "Large page size: " << g_large_page_size << " B" << std::endl;
 #endif
+#ifdef __gnu_linux__
+    std::cout << "Transparent huge page size: " << g_thp_page_size << " B" << std::endl;
+#endif
+
+    //NUMA distance matrix as reported by the firmware. Memory-only nodes are marked with a *.
+    if (g_num_numa_nodes > 1 && numa_node_distance(0, 0) > 0) {
+        std::cout << "NUMA node distances (* = memory-only node):" << std::endl;
+        std::cout << "node";
+        for (uint32_t to_node = 0; to_node < g_num_numa_nodes; to_node++)
+            std::cout << "\t" << to_node << (numa_node_has_cpus(to_node) ? "" : "*");
+        std::cout << std::endl;
+        for (uint32_t from_node = 0; from_node < g_num_numa_nodes; from_node++) {
+            std::cout << from_node << (numa_node_has_cpus(from_node) ? "" : "*");
+            for (uint32_t to_node = 0; to_node < g_num_numa_nodes; to_node++)
+                std::cout << "\t" << numa_node_distance(from_node, to_node);
+            std::cout << std::endl;
+        }
+    }
 }
 
 tick_t xmem::start_timer() {
 #ifdef USE_TSC_TIMER
+    switch (g_timer_backend) {
+        case TIMER_RDTSC: {
+            _mm_lfence(); //Wait for all previous instructions to finish
+            tick_t tick = __rdtsc(); //Get clock tick
+            _mm_lfence(); //Keep later instructions from starting before the tick is read
+            return tick;
+        }
+
+        case TIMER_RDTSCP: {
+            uint32_t filler;
+            tick_t tick = __rdtscp(&filler); //Get clock tick. This is a partially serializing instruction. All previous instructions must finish
+            _mm_lfence(); //Keep later instructions from starting before the tick is read
+            return tick;
+        }
+
+        case TIMER_CPUID: {
 #ifdef _WIN32
-    int32_t dontcare[4];
-    __cpuid(dontcare, 0); //Serializing instruction. This forces all previous instructions to finish
-    return __rdtsc(); //Get clock tick
+            int32_t dontcare[4];
+            __cpuid(dontcare, 0); //Serializing instruction. This forces all previous instructions to finish
+            return __rdtsc(); //Get clock tick
 #endif
 #ifdef __gnu_linux__
-    volatile int32_t dc0 = 0;
-    volatile int32_t dc1, dc2, dc3, dc4;
-    __cpuid(dc0, dc1, dc2, dc3, dc4); //Serializing instruction. This forces all previous instructions to finish
-    return __rdtsc(); //Get clock tick
-
-    /*
-    uint32_t low, high;
-    __asm__ __volatile__ (
-        "cpuid\n\t"
-        "rdtsc\n\t"
-        "mov %%eax, %0\n\t"
-        "mov %%edx, %1\n\n"
-        : "=r" (low), "=r" (high)
-        : : "%rax", "%rbx", "%rcx", "%rdx");
-
-    return ((static_cast<uint64_t>(high) << 32) | low);
-    */
+            volatile int32_t dc0 = 0;
+            volatile int32_t dc1, dc2, dc3, dc4;
+            __cpuid(dc0, dc1, dc2, dc3, dc4); //Serializing instruction. This forces all previous instructions to finish
+            return __rdtsc(); //Get clock tick
 #endif
+        }
+
+        default:
+            break;
+    }
 #endif
     
     //TODO: ARM hardware timer
@@ -744,37 +861,45 @@ tick_t xmem::start_timer() {
 }
 
 tick_t xmem::stop_timer() {
-    //TODO: ARM hardware timer
 #ifdef USE_TSC_TIMER
+    switch (g_timer_backend) {
+        case TIMER_RDTSC: {
+            _mm_lfence(); //Wait for all previous instructions to finish
+            tick_t tick = __rdtsc(); //Get clock tick
+            _mm_lfence(); //Keep later instructions from being moved inside the timed section
+            return tick;
+        }
+
+        case TIMER_RDTSCP: {
+            uint32_t filler;
+            tick_t tick = __rdtscp(&filler); //Get clock tick. This is a partially serializing instruction. All previous instructions must finish
+            _mm_lfence(); //Keep later instructions from being moved inside the timed section
+            return tick;
+        }
+
+        case TIMER_CPUID: {
 #ifdef _WIN32
-    tick_t tick;
-    uint32_t filler;
-    int32_t dontcare[4];
-    tick = __rdtscp(&filler); //Get clock tick. This is a partially serializing instruction. All previous instructions must finish
-    __cpuid(dontcare, 0); //Fully serializing instruction. We do this to prevent later instructions from being moved inside the timed section
-    return tick;
+            tick_t tick;
+            uint32_t filler;
+            int32_t dontcare[4];
+            tick = __rdtscp(&filler); //Get clock tick. This is a partially serializing instruction. All previous instructions must finish
+            __cpuid(dontcare, 0); //Fully serializing instruction. We do this to prevent later instructions from being moved inside the timed section
+            return tick;
 #endif
 #ifdef __gnu_linux__
-    tick_t tick;
-    uint32_t filler;
-    volatile int32_t dc0 = 0;
-    volatile int32_t dc1, dc2, dc3, dc4;
-    tick = __rdtscp(&filler); //Get clock tick. This is a partially serializing instruction. All previous instructions must finish
-    __cpuid(dc0, dc1, dc2, dc3, dc4); //Serializing instruction. This forces all previous instructions to finish
-    return tick;
-    
-    /*
-    uint32_t low, high;
-    __asm__ __volatile__ (
-        "rdtscp\n\t"
-        "mov %%eax, %0\n\t"
-        "mov %%edx, %1\n\t"
-        "cpuid\n\t"
-        : "=r" (low), "=r" (high)
-        : : "%rax", "%rbx", "%rcx", "%rdx");
-    return ((static_cast<uint64_t>(high) << 32) | low);
-    */
+            tick_t tick;
+            uint32_t filler;
+            volatile int32_t dc0 = 0;
+            volatile int32_t dc1, dc2, dc3, dc4;
+            tick = __rdtscp(&filler); //Get clock tick. This is a partially serializing instruction. All previous instructions must finish
+            __cpuid(dc0, dc1, dc2, dc3, dc4); //Serializing instruction. This forces all previous instructions to finish
+            return tick;
 #endif
+        }
+
+        default:
+            break;
+    }
 #endif
     
     //TODO: ARM hardware timer
@@ -792,6 +917,31 @@ tick_t xmem::stop_timer() {
 #endif
 }
 
+std::string xmem::timer_backend_name(timer_backend_t backend) {
+    switch (backend) {
+        case TIMER_OS:
+            return "os";
+        case TIMER_RDTSC:
+            return "rdtsc";
+        case TIMER_RDTSCP:
+            return "rdtscp";
+        case TIMER_CPUID:
+            return "cpuid";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+bool xmem::timer_backend_available(timer_backend_t backend) {
+    if (backend == TIMER_OS)
+        return true;
+#ifdef USE_TSC_TIMER
+    return backend < NUM_TIMER_BACKENDS;
+#else
+    return false;
+#endif
+}
+
 #ifdef _WIN32
 bool xmem::boost_scheduling_priority(DWORD& original_priority_class, DWORD& original_priority) {
     original_priority_class = GetPriorityClass(GetCurrentProcess());  
@@ -79,6 +79,7 @@ DelayInjectedLoadedLatencyBenchmark::DelayInjectedLoadedLatencyBenchmark(
             chunk_size,
             1,
             mlp,
+            0,
             dram_power_readers,
             name
         ),
@@ -402,7 +403,8 @@ bool DelayInjectedLoadedLatencyBenchmark::runCore() {
                                                  mlp,
                                                  load_kernel_fptr,
                                                  load_kernel_dummy_fptr,
-                                                 cpu_id));
+                                                 cpu_id,
+                                                 0)); //Load is controlled by delay injection, not rate limiting
             }
             worker_threads.push_back(new Thread(workers[t]));
         }
@@ -429,6 +431,7 @@ bool DelayInjectedLoadedLatencyBenchmark::runCore() {
         uint32_t lat_bytes_per_pass = workers[0]->getBytesPerPass();
         uint32_t lat_accesses_per_pass = lat_bytes_per_pass / 8;
         iterwarning_ |= workers[0]->hadWarning();
+        addPerfCounts(workers[0]->getPerfCounts());
 
         //Compute throughput generated by load threads
         uint32_t load_total_passes = 0;
@@ -442,6 +445,7 @@ bool DelayInjectedLoadedLatencyBenchmark::runCore() {
             load_total_elapsed_dummy_ticks += workers[t]->getElapsedDummyTicks();
             load_bytes_per_pass = workers[t]->getBytesPerPass(); //all should be the same.
             iterwarning_ |= workers[t]->hadWarning();
+            addPerfCounts(workers[t]->getPerfCounts());
         }
 
         //Compute load metrics for this iteration
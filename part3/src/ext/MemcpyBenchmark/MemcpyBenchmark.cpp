@@ -0,0 +1,225 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the MemcpyBenchmark class.
+ */
+
+//Headers
+#include <common.h>
+
+#ifdef EXT_MEMCPY_BENCHMARK
+
+#include <MemcpyBenchmark.h>
+#include <MemcpyWorker.h>
+#include <Thread.h>
+
+//Libraries
+#include <iostream>
+#include <cstdio>
+
+using namespace xmem;
+
+MemcpyBenchmark::MemcpyBenchmark(
+        void* mem_array,
+        size_t len,
+        uint32_t iterations,
+        uint32_t mem_node,
+        uint32_t cpu_node,
+        bool fill,
+        bulk_strategy_t strategy,
+        bool misaligned,
+        size_t size,
+        std::vector<PowerReader*> dram_power_readers,
+        std::string name
+    ) :
+        Benchmark(
+            mem_array,
+            len,
+            iterations,
+            1,
+            mem_node,
+            cpu_node,
+            SEQUENTIAL,
+            WRITE,
+#ifdef HAS_WORD_64
+            CHUNK_64b,
+#else
+            CHUNK_32b,
+#endif
+            1,
+            1,
+            dram_power_readers,
+            "MB/s",
+            name
+        ),
+        fill_(fill),
+        strategy_(strategy),
+        misaligned_(misaligned),
+        size_(size)
+    {
+}
+
+size_t MemcpyBenchmark::getRequiredLen(size_t size) {
+    //Destination rounded up to a cache line, a spacer line, then the source with up to a line of misalignment
+    return 2 * size + 3 * CACHE_LINE_SIZE;
+}
+
+void MemcpyBenchmark::reportBenchmarkInfo() const {
+    std::cout << "CPU NUMA Node: " << cpu_node_ << std::endl;
+    std::cout << "Memory NUMA Node: " << mem_node_ << std::endl;
+    std::cout << "Operation: " << (fill_ ? "fill" : "copy") << std::endl;
+    std::cout << "Strategy: " << bulk_strategy_name(strategy_) << std::endl;
+    std::cout << "Size: " << size_ << " B" << std::endl;
+    if (!fill_)
+        std::cout << "Source alignment: " << (misaligned_ ? "misaligned" : "aligned") << std::endl;
+    std::cout << std::endl;
+}
+
+void MemcpyBenchmark::reportResults() const {
+    std::cout << std::endl;
+    std::cout << "*** RESULTS";
+    std::cout << "***" << std::endl;
+    std::cout << std::endl;
+
+    if (has_run_) {
+        for (uint32_t i = 0; i < iterations_; i++) {
+            std::printf("Iter #%4d:    %0.3f    %s", i, metric_on_iter_[i], metric_units_.c_str());
+            if (warning_)
+                std::cout << " (WARNING)";
+            std::cout << std::endl;
+        }
+
+        std::cout << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "Mean: " << mean_metric_ << " " << metric_units_;
+        if (warning_)
+            std::cout << " (WARNING)";
+        std::cout << std::endl;
+
+        std::cout << std::endl;
+
+        reportPowerResults();
+    }
+    else
+        std::cerr << "WARNING: Benchmark has not run yet. No reported results." << std::endl;
+}
+
+bool MemcpyBenchmark::runCore() {
+    if (len_ < getRequiredLen(size_)) {
+        std::cerr << "ERROR: Memory region of " << len_ << " B is too small for a " << size_ << " B bulk " << (fill_ ? "fill" : "copy") << "." << std::endl;
+        return false;
+    }
+
+    BulkFunction kernel_fptr = NULL;
+    if (!determine_bulk_kernel(fill_, strategy_, &kernel_fptr)) {
+        std::cerr << "ERROR: Bulk " << (fill_ ? "fill" : "copy") << " strategy " << bulk_strategy_name(strategy_) << " is not available in this build." << std::endl;
+        return false;
+    }
+
+    uint8_t* dst = static_cast<uint8_t*>(mem_array_);
+    uint8_t* src = dst + ((size_ + CACHE_LINE_SIZE-1) / CACHE_LINE_SIZE + 1) * CACHE_LINE_SIZE;
+    if (misaligned_)
+        src += MEMCPY_BENCHMARK_MISALIGNMENT;
+
+    //Start power measurement
+    if (g_verbose)
+        std::cout << "Starting power measurement threads...";
+
+    if (!startPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to start power threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run benchmark
+    if (g_verbose)
+        std::cout << "Running benchmark." << std::endl << std::endl;
+
+    int32_t cpu_id = cpu_id_in_numa_node(cpu_node_, 0);
+    if (cpu_id < 0)
+        std::cerr << "WARNING: Failed to find a logical CPU in NUMA node " << cpu_node_ << std::endl;
+
+    //Do a bunch of iterations of the core benchmark routine
+    for (uint32_t i = 0; i < iterations_; i++) {
+        MemcpyWorker* worker = new MemcpyWorker(dst, src, size_, kernel_fptr, cpu_id);
+        Thread* worker_thread = new Thread(worker);
+
+        worker_thread->create_and_start();
+        if (!worker_thread->join())
+            std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+
+        //Compute metrics for this iteration
+        bool iterwarning = worker->hadWarning();
+        double bytes = static_cast<double>(worker->getPasses()) * static_cast<double>(worker->getBytesPerPass());
+        double adjusted_ticks = static_cast<double>(worker->getAdjustedTicks());
+        if (adjusted_ticks > 0)
+            metric_on_iter_[i] = (bytes / static_cast<double>(MB)) / ((adjusted_ticks * g_ns_per_tick) / 1e9);
+        else
+            iterwarning = true;
+
+        if (iterwarning)
+            warning_ = true;
+
+        if (g_verbose) { //Report metrics for this iteration
+            std::cout << "Iter " << i+1 << " had " << worker->getPasses() << " passes of " << worker->getBytesPerPass() << " B:";
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+
+            std::cout << "...MB/s == " << metric_on_iter_[i];
+            if (iterwarning) std::cout << " -- WARNING";
+            std::cout << std::endl;
+        }
+
+        //Clean up workers and threads for this iteration
+        delete worker_thread;
+        delete worker;
+    }
+
+    //Stop power measurement
+    if (g_verbose) {
+        std::cout << std::endl;
+        std::cout << "Stopping power measurement threads...";
+    }
+
+    if (!stopPowerThreads()) {
+        if (g_verbose)
+            std::cout << "FAIL" << std::endl;
+        std::cerr << "WARNING: Failed to stop power measurement threads." << std::endl;
+    } else if (g_verbose)
+        std::cout << "done" << std::endl;
+
+    //Run metadata
+    has_run_ = true;
+    computeMetrics();
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,179 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for the MemcpyWorker class.
+ */
+
+//Headers
+#include <common.h>
+
+#ifdef EXT_MEMCPY_BENCHMARK
+
+#include <MemcpyWorker.h>
+
+//Libraries
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <processthreadsapi.h>
+#endif
+
+using namespace xmem;
+
+/**
+ * @brief Does nothing. Used to measure the loop and call overhead of the timed kernel calls.
+ */
+static void dummy_bulk(void*, const void*, size_t) {
+}
+
+MemcpyWorker::MemcpyWorker(
+        void* dst,
+        const void* src,
+        size_t len,
+        BulkFunction kernel_fptr,
+        int32_t cpu_affinity
+    ) :
+        MemoryWorker(
+            dst,
+            len,
+            1,
+            cpu_affinity
+        ),
+        src_(src),
+        kernel_fptr_(kernel_fptr)
+    {
+}
+
+MemcpyWorker::~MemcpyWorker() {
+}
+
+void MemcpyWorker::run() {
+    //Set up relevant state -- localized to this thread's stack
+    int32_t cpu_affinity = 0;
+    BulkFunction kernel_fptr = NULL;
+    BulkFunction volatile dummy_kernel_fptr = &dummy_bulk; //volatile so the compiler cannot inline the empty call away
+    void* dst = NULL;
+    const void* src = NULL;
+    size_t len = 0;
+    size_t calls_per_pass = 1;
+    uint32_t passes = 0;
+    uint32_t p = 0;
+    size_t c = 0;
+    tick_t start_tick = 0;
+    tick_t stop_tick = 0;
+    tick_t elapsed_ticks = 0;
+    tick_t elapsed_dummy_ticks = 0;
+    tick_t adjusted_ticks = 0;
+    bool warning = false;
+    tick_t target_ticks = g_ticks_per_ms * MEMCPY_BENCHMARK_DURATION_MS; //Rough target run duration in ticks
+
+    //Grab relevant setup state thread-safely and keep it local
+    if (acquireLock(-1)) {
+        dst = mem_array_;
+        src = src_;
+        len = len_;
+        kernel_fptr = kernel_fptr_;
+        cpu_affinity = cpu_affinity_;
+        releaseLock();
+    }
+
+    if (len < MEMCPY_BENCHMARK_BATCH_BYTES)
+        calls_per_pass = MEMCPY_BENCHMARK_BATCH_BYTES / len;
+
+    //Set processor affinity
+    bool locked = lock_thread_to_cpu(cpu_affinity);
+    if (!locked)
+        std::cerr << "WARNING: Failed to lock thread to logical CPU " << cpu_affinity << "! Results may not be correct." << std::endl;
+
+    //Increase scheduling priority
+#ifdef _WIN32
+    DWORD original_priority_class;
+    DWORD original_priority;
+    if (!boost_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!boost_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to boost scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Prime the buffers, TLB and branch predictors so the first pass is not an outlier
+    (*kernel_fptr)(dst, src, len);
+
+    //Run benchmark
+    while (elapsed_ticks < target_ticks) {
+        start_tick = start_timer();
+        for (c = 0; c < calls_per_pass; c++)
+            (*kernel_fptr)(dst, src, len);
+        stop_tick = stop_timer();
+        elapsed_ticks += (stop_tick - start_tick);
+        passes++;
+    }
+
+    //Run dummy version of benchmark to subtract the loop and call overhead
+    for (p = 0; p < passes; p++) {
+        start_tick = start_timer();
+        for (c = 0; c < calls_per_pass; c++)
+            (*dummy_kernel_fptr)(dst, src, len);
+        stop_tick = stop_timer();
+        elapsed_dummy_ticks += (stop_tick - start_tick);
+    }
+
+    adjusted_ticks = elapsed_ticks - elapsed_dummy_ticks;
+
+    //Warn if something looks fishy
+    if (elapsed_dummy_ticks >= elapsed_ticks || elapsed_ticks < MIN_ELAPSED_TICKS || adjusted_ticks < 0.5 * elapsed_ticks)
+        warning = true;
+
+    //Unset processor affinity
+    if (locked)
+        unlock_thread_to_numa_node();
+
+    //Revert thread priority
+#ifdef _WIN32
+    if (!revert_scheduling_priority(original_priority_class, original_priority))
+#endif
+#ifdef __gnu_linux__
+    if (!revert_scheduling_priority())
+#endif
+        std::cerr << "WARNING: Failed to revert scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+
+    //Update the object state thread-safely
+    if (acquireLock(-1)) {
+        adjusted_ticks_ = adjusted_ticks;
+        elapsed_ticks_ = elapsed_ticks;
+        elapsed_dummy_ticks_ = elapsed_dummy_ticks;
+        warning_ = warning || !locked;
+        bytes_per_pass_ = static_cast<uint32_t>(calls_per_pass * len);
+        completed_ = true;
+        passes_ = passes;
+        releaseLock();
+    }
+}
+
+#endif
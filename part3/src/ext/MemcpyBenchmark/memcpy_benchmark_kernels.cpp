@@ -0,0 +1,277 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation file for bulk copy and bulk fill kernels used by the memcpy/memset throughput extension.
+ */
+
+//Headers
+#include <common.h>
+
+#ifdef EXT_MEMCPY_BENCHMARK
+
+#include <memcpy_benchmark_kernels.h>
+
+//Libraries
+#include <cstring>
+#include <iostream>
+
+#if defined(ARCH_INTEL_X86_64) || defined(ARCH_AMD64)
+#ifdef _WIN32
+#include <intrin.h>
+#endif
+#ifdef __gnu_linux__
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+#endif
+
+#define BULK_FILL_BYTE 0x5A /**< Byte value written by the fill kernels. */
+
+using namespace xmem;
+
+/* ------------------------- C LIBRARY ------------------------------------- */
+
+static void libc_copy(void* dst, const void* src, size_t len) {
+    std::memcpy(dst, src, len);
+}
+
+static void libc_fill(void* dst, const void*, size_t len) {
+    std::memset(dst, BULK_FILL_BYTE, len);
+}
+
+#if defined(ARCH_INTEL_X86_64) || defined(ARCH_AMD64)
+/* ------------------------- REP STRING ------------------------------------ */
+
+static void rep_copy(void* dst, const void* src, size_t len) {
+#ifdef _WIN32
+    __movsb(static_cast<unsigned char*>(dst), static_cast<const unsigned char*>(src), len);
+#endif
+#ifdef __gnu_linux__
+    asm volatile("rep movsb" : "+D" (dst), "+S" (src), "+c" (len) : : "memory");
+#endif
+}
+
+static void rep_fill(void* dst, const void*, size_t len) {
+#ifdef _WIN32
+    __stosb(static_cast<unsigned char*>(dst), BULK_FILL_BYTE, len);
+#endif
+#ifdef __gnu_linux__
+    asm volatile("rep stosb" : "+D" (dst), "+c" (len) : "a" (BULK_FILL_BYTE) : "memory");
+#endif
+}
+
+/* ------------------------- 128-BIT NON-TEMPORAL -------------------------- */
+
+static void sse2_nt_copy(void* dst, const void* src, size_t len) {
+    __m128i* d = static_cast<__m128i*>(dst);
+    const __m128i* s = static_cast<const __m128i*>(src);
+    size_t n = len / sizeof(__m128i);
+    for (size_t i = 0; i < n; i++)
+        _mm_stream_si128(d+i, _mm_loadu_si128(s+i));
+    _mm_sfence();
+    std::memcpy(d+n, s+n, len % sizeof(__m128i)); //tail
+}
+
+static void sse2_nt_fill(void* dst, const void*, size_t len) {
+    __m128i* d = static_cast<__m128i*>(dst);
+    __m128i v = _mm_set1_epi8(BULK_FILL_BYTE);
+    size_t n = len / sizeof(__m128i);
+    for (size_t i = 0; i < n; i++)
+        _mm_stream_si128(d+i, v);
+    _mm_sfence();
+    std::memset(d+n, BULK_FILL_BYTE, len % sizeof(__m128i)); //tail
+}
+#endif
+
+#ifdef ARCH_INTEL_AVX
+/* ------------------------- 256-BIT --------------------------------------- */
+
+static void avx_copy(void* dst, const void* src, size_t len) {
+    __m256i* d = static_cast<__m256i*>(dst);
+    const __m256i* s = static_cast<const __m256i*>(src);
+    size_t n = len / sizeof(__m256i);
+    for (size_t i = 0; i < n; i++)
+        _mm256_storeu_si256(d+i, _mm256_loadu_si256(s+i));
+    std::memcpy(d+n, s+n, len % sizeof(__m256i)); //tail
+}
+
+static void avx_nt_copy(void* dst, const void* src, size_t len) {
+    __m256i* d = static_cast<__m256i*>(dst);
+    const __m256i* s = static_cast<const __m256i*>(src);
+    size_t n = len / sizeof(__m256i);
+    for (size_t i = 0; i < n; i++)
+        _mm256_stream_si256(d+i, _mm256_loadu_si256(s+i));
+    _mm_sfence();
+    std::memcpy(d+n, s+n, len % sizeof(__m256i)); //tail
+}
+
+static void avx_fill(void* dst, const void*, size_t len) {
+    __m256i* d = static_cast<__m256i*>(dst);
+    __m256i v = _mm256_set1_epi8(BULK_FILL_BYTE);
+    size_t n = len / sizeof(__m256i);
+    for (size_t i = 0; i < n; i++)
+        _mm256_storeu_si256(d+i, v);
+    std::memset(d+n, BULK_FILL_BYTE, len % sizeof(__m256i)); //tail
+}
+
+static void avx_nt_fill(void* dst, const void*, size_t len) {
+    __m256i* d = static_cast<__m256i*>(dst);
+    __m256i v = _mm256_set1_epi8(BULK_FILL_BYTE);
+    size_t n = len / sizeof(__m256i);
+    for (size_t i = 0; i < n; i++)
+        _mm256_stream_si256(d+i, v);
+    _mm_sfence();
+    std::memset(d+n, BULK_FILL_BYTE, len % sizeof(__m256i)); //tail
+}
+#endif
+
+#ifdef MEMCPY_BENCHMARK_HAS_AVX512
+/* ------------------------- 512-BIT --------------------------------------- */
+
+static void avx512_copy(void* dst, const void* src, size_t len) {
+    __m512i* d = static_cast<__m512i*>(dst);
+    const __m512i* s = static_cast<const __m512i*>(src);
+    size_t n = len / sizeof(__m512i);
+    for (size_t i = 0; i < n; i++)
+        _mm512_storeu_si512(d+i, _mm512_loadu_si512(s+i));
+    std::memcpy(d+n, s+n, len % sizeof(__m512i)); //tail
+}
+
+static void avx512_nt_copy(void* dst, const void* src, size_t len) {
+    __m512i* d = static_cast<__m512i*>(dst);
+    const __m512i* s = static_cast<const __m512i*>(src);
+    size_t n = len / sizeof(__m512i);
+    for (size_t i = 0; i < n; i++)
+        _mm512_stream_si512(d+i, _mm512_loadu_si512(s+i));
+    _mm_sfence();
+    std::memcpy(d+n, s+n, len % sizeof(__m512i)); //tail
+}
+
+static void avx512_fill(void* dst, const void*, size_t len) {
+    __m512i* d = static_cast<__m512i*>(dst);
+    __m512i v = _mm512_set1_epi8(BULK_FILL_BYTE);
+    size_t n = len / sizeof(__m512i);
+    for (size_t i = 0; i < n; i++)
+        _mm512_storeu_si512(d+i, v);
+    std::memset(d+n, BULK_FILL_BYTE, len % sizeof(__m512i)); //tail
+}
+
+static void avx512_nt_fill(void* dst, const void*, size_t len) {
+    __m512i* d = static_cast<__m512i*>(dst);
+    __m512i v = _mm512_set1_epi8(BULK_FILL_BYTE);
+    size_t n = len / sizeof(__m512i);
+    for (size_t i = 0; i < n; i++)
+        _mm512_stream_si512(d+i, v);
+    _mm_sfence();
+    std::memset(d+n, BULK_FILL_BYTE, len % sizeof(__m512i)); //tail
+}
+#endif
+
+bool xmem::determine_bulk_kernel(bool fill, bulk_strategy_t strategy, BulkFunction* kernel_function) {
+    switch (strategy) {
+        case BULK_LIBC:
+            *kernel_function = fill ? &libc_fill : &libc_copy;
+            return true;
+#if defined(ARCH_INTEL_X86_64) || defined(ARCH_AMD64)
+        case BULK_REP:
+            *kernel_function = fill ? &rep_fill : &rep_copy;
+            return true;
+        case BULK_SSE2_NT:
+            *kernel_function = fill ? &sse2_nt_fill : &sse2_nt_copy;
+            return true;
+#endif
+#ifdef ARCH_INTEL_AVX
+        case BULK_AVX:
+            *kernel_function = fill ? &avx_fill : &avx_copy;
+            return true;
+        case BULK_AVX_NT:
+            *kernel_function = fill ? &avx_nt_fill : &avx_nt_copy;
+            return true;
+#endif
+#ifdef MEMCPY_BENCHMARK_HAS_AVX512
+        case BULK_AVX512:
+            *kernel_function = fill ? &avx512_fill : &avx512_copy;
+            return true;
+        case BULK_AVX512_NT:
+            *kernel_function = fill ? &avx512_nt_fill : &avx512_nt_copy;
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+std::string xmem::bulk_strategy_name(bulk_strategy_t strategy) {
+    switch (strategy) {
+        case BULK_LIBC:
+            return "libc";
+        case BULK_REP:
+            return "rep";
+        case BULK_SSE2_NT:
+            return "sse2-nt";
+        case BULK_AVX:
+            return "avx";
+        case BULK_AVX_NT:
+            return "avx-nt";
+        case BULK_AVX512:
+            return "avx512";
+        case BULK_AVX512_NT:
+            return "avx512-nt";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+void xmem::report_bulk_cpu_features() {
+#if defined(ARCH_INTEL_X86_64) || defined(ARCH_AMD64)
+    uint32_t ebx = 0, edx = 0;
+#ifdef _WIN32
+    int regs[4];
+    __cpuidex(regs, 7, 0);
+    ebx = static_cast<uint32_t>(regs[1]);
+    edx = static_cast<uint32_t>(regs[3]);
+#endif
+#ifdef __gnu_linux__
+    uint32_t eax = 0, ecx = 0;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        std::cout << "CPU copy features: unknown (CPUID leaf 7 not supported)" << std::endl;
+        return;
+    }
+#endif
+    std::cout << "CPU copy features:";
+    std::cout << " ERMSB=" << ((ebx >> 9) & 1);
+    std::cout << " FSRM=" << ((edx >> 4) & 1);
+    std::cout << " AVX2=" << ((ebx >> 5) & 1);
+    std::cout << " AVX512F=" << ((ebx >> 16) & 1);
+    std::cout << std::endl;
+#else
+    std::cout << "CPU copy features: not queried on this architecture" << std::endl;
+#endif
+}
+
+#endif
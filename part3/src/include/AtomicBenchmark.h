@@ -0,0 +1,159 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the AtomicBenchmark class.
+ */
+
+#ifndef ATOMIC_BENCHMARK_H
+#define ATOMIC_BENCHMARK_H
+
+//Headers
+#include <Benchmark.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+
+    /**
+     * @brief A type of benchmark that measures the throughput and latency of atomic read-modify-write operations when several threads contend on a small set of shared cache lines.
+     *
+     * The per-iteration metric is the mean latency per operation over all threads. Aggregate throughput and the distribution of per-operation latency are kept separately.
+     */
+    class AtomicBenchmark : public Benchmark {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param mem_array A pointer to a contiguous chunk of memory holding the shared lines.
+         * @param num_lines Number of shared cache lines to contend on.
+         * @param iterations Number of iterations of the complete benchmark. Used to gather more statistics.
+         * @param num_worker_threads The number of contending worker threads.
+         * @param mem_node The memory NUMA node that mem_array belongs to.
+         * @param cpu_node The CPU NUMA node of the worker threads.
+         * @param spread_cpu_nodes CPU NUMA nodes to spread the worker threads over round-robin, so that threads on different sockets contend for the same lines. If empty, all worker threads run on cpu_node.
+         * @param op The atomic operation to perform.
+         * @param dram_power_readers A group of PowerReader objects for measuring DRAM power.
+         * @param name The name of the benchmark to use when reporting to console.
+         */
+        AtomicBenchmark(
+            void* mem_array,
+            uint32_t num_lines,
+            uint32_t iterations,
+            uint32_t num_worker_threads,
+            uint32_t mem_node,
+            uint32_t cpu_node,
+            std::vector<uint32_t> spread_cpu_nodes,
+            atomic_op_t op,
+            std::vector<PowerReader*> dram_power_readers,
+            std::string name
+        );
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~AtomicBenchmark() {}
+
+        /**
+         * @brief Reports benchmark configuration details to the console.
+         */
+        virtual void reportBenchmarkInfo() const;
+
+        /**
+         * @brief Reports results to the console.
+         */
+        virtual void reportResults() const;
+
+        /**
+         * @brief Gets the number of shared cache lines.
+         * @returns The number of lines.
+         */
+        uint32_t getNumLines() const { return num_lines_; }
+
+        /**
+         * @brief Gets the atomic operation that is benchmarked.
+         * @returns The atomic operation.
+         */
+        atomic_op_t getAtomicOp() const { return op_; }
+
+        /**
+         * @brief Gets the CPU NUMA nodes that the worker threads are spread over.
+         * @returns The CPU NUMA nodes, or an empty vector if all worker threads run on the CPU NUMA node.
+         */
+        std::vector<uint32_t> getSpreadCPUNodes() const { return spread_cpu_nodes_; }
+
+        /**
+         * @brief Gets the mean aggregate throughput over all iterations.
+         * @returns The throughput in millions of operations per second, or -1 if the benchmark has not run.
+         */
+        double getMeanThroughput() const;
+
+        /**
+         * @brief Gets a percentile of the per-operation latency distribution over all threads and iterations.
+         * @param percentile The percentile, from 0 to 100.
+         * @returns The latency in ns at 1 ns resolution, or -1 if the benchmark has not run.
+         */
+        double getLatencyPercentile(double percentile) const;
+
+        /**
+         * @brief Gets the most common per-operation latency over all threads and iterations.
+         * @returns The latency in ns at 1 ns resolution, or -1 if the benchmark has not run.
+         */
+        double getLatencyMode() const;
+
+        /**
+         * @brief Gets a short name for an atomic operation.
+         * @param op The atomic operation.
+         * @returns The name.
+         */
+        static std::string atomicOpName(atomic_op_t op);
+
+    protected:
+        virtual bool runCore();
+        virtual std::vector<int32_t> workerCpus() const;
+
+    private:
+        /**
+         * @brief Gets the logical CPU of a worker thread. With spread CPU NUMA nodes, thread t runs on node t mod N, on the (t / N)th logical CPU of that node.
+         * @param t The worker thread index.
+         * @returns The logical CPU ID, or -1 if it does not exist.
+         */
+        int32_t workerCpu(uint32_t t) const;
+
+        uint32_t num_lines_; /**< Number of shared cache lines. */
+        std::vector<uint32_t> spread_cpu_nodes_; /**< CPU NUMA nodes to spread the worker threads over round-robin. Empty if all of them run on cpu_node_. */
+        atomic_op_t op_; /**< The atomic operation to perform. */
+        std::vector<double> throughput_on_iter_; /**< Aggregate throughput in millions of operations per second for each iteration. */
+        std::vector<uint64_t> latency_histogram_; /**< Per-operation latency histogram over all threads and iterations, with 1 ns wide bins. */
+    };
+};
+
+#endif
@@ -0,0 +1,91 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the AtomicWorker class.
+ */
+
+#ifndef ATOMIC_WORKER_H
+#define ATOMIC_WORKER_H
+
+//Headers
+#include <MemoryWorker.h>
+#include <common.h>
+
+//Libraries
+#include <vector>
+
+namespace xmem {
+    /**
+     * @brief Multithreading-friendly class to hammer a set of shared cache lines with atomic read-modify-write operations.
+     *
+     * Each line holds one 64-bit counter in its first word. The worker visits the lines round-robin, starting at its own line, and times batches of ATOMIC_BENCHMARK_BATCH_OPS operations. Each batch adds one sample to a per-operation latency histogram.
+     */
+    class AtomicWorker : public MemoryWorker {
+        public:
+
+            /**
+             * @brief Constructor.
+             * @param mem_array Pointer to the first shared cache line.
+             * @param num_lines Number of shared cache lines.
+             * @param op The atomic operation to perform.
+             * @param first_line Index of the line this worker starts on.
+             * @param cpu_affinity Logical CPU identifier to lock this worker's thread to.
+             */
+            AtomicWorker(
+                void* mem_array,
+                uint32_t num_lines,
+                atomic_op_t op,
+                uint32_t first_line,
+                int32_t cpu_affinity
+            );
+
+            /**
+             * @brief Destructor.
+             */
+            virtual ~AtomicWorker();
+
+            /**
+             * @brief Thread-safe worker method.
+             */
+            virtual void run();
+
+            /**
+             * @brief Gets the per-operation latency histogram. Bin i counts batches whose mean latency per operation was i ns, and the last bin also holds all slower batches.
+             * @returns The histogram.
+             */
+            std::vector<uint64_t> getLatencyHistogram();
+
+        private:
+            // ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
+            atomic_op_t op_; /**< The atomic operation to perform. */
+            uint32_t first_line_; /**< Index of the line this worker starts on. */
+            std::vector<uint64_t> latency_histogram_; /**< Per-operation latency histogram with 1 ns wide bins. */
+    };
+};
+
+#endif
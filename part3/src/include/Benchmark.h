@@ -60,7 +60,7 @@ namespace xmem {
     public:
         /**
          * @brief Constructor.
-         * @param mem_array A pointer to a contiguous chunk of memory that has been allocated for benchmarking among potentially several worker threads. This should be aligned to a 256-bit boundary.
+         * @param mem_array A pointer to a contiguous chunk of memory that has been allocated for benchmarking among potentially several worker threads. This should be aligned to a 256-bit boundary. May be NULL for benchmarks that map their own memory.
          * @param len Length of mem_array in bytes. This must be a multiple of 4 KB and should be at least the per-thread working set size times the number of worker threads.
          * @param iterations Number of iterations of the complete benchmark. Used to average results and provide a measure of consistency and reproducibility.
          * @param num_worker_threads The number of worker threads to use in the benchmark.
@@ -195,6 +195,18 @@ namespace xmem {
          */
         std::string getMetricUnits() const;
 
+        /**
+         * @brief Gets the time spent initializing the memory under test before the benchmark proper. This is not part of any metric.
+         * @returns The setup time in milliseconds.
+         */
+        double getSetupTime() const;
+
+        /**
+         * @brief Shares what is known about the contents of the memory region with other benchmarks on the same region. Setup is then skipped if the region is already resident, and random pointer permutations are reused where they still fit.
+         * @param region_layout The layout of the memory region, which must outlive this benchmark, or NULL to always set the region up from scratch.
+         */
+        void setRegionLayout(region_layout_t* region_layout);
+
         /**
          * @brief Gets the arithmetic mean DRAM power over the benchmark.
          * @returns The mean DRAM power for a given socket in watts, or 0 if the data does not exist (power was unable to be collected or the benchmark has not run).
@@ -207,6 +219,36 @@ namespace xmem {
          */
         double getPeakDRAMPower(uint32_t socket_id) const;
 
+        /**
+         * @brief Gets the energy used over the benchmark, integrated from the start to the end of power measurement rather than estimated from the power samples.
+         * @returns The energy for a given power reader in joules, or 0 if the data does not exist (power was unable to be collected or the benchmark has not run).
+         */
+        double getDRAMEnergy(uint32_t socket_id) const;
+
+        /**
+         * @brief Gets the length of the power measurement that getDRAMEnergy() covers.
+         * @returns The measured time for a given power reader in seconds, or 0 if the data does not exist.
+         */
+        double getDRAMEnergyTime(uint32_t socket_id) const;
+
+        /**
+         * @brief Gets the energy used per unit of work done by the benchmark, e.g., per byte moved or per memory access. This is the mean power over the measurement, from getDRAMEnergy() and getDRAMEnergyTime(), applied to the mean metric.
+         * @returns The energy per unit of work for a given power reader in the units given by getEnergyEfficiencyUnits(), or 0 if it does not exist. The base class has no notion of work, so it always returns 0.
+         */
+        virtual double getEnergyEfficiency(uint32_t socket_id) const;
+
+        /**
+         * @brief Gets the units of getEnergyEfficiency().
+         * @returns The units, or an empty string if this benchmark does not report energy per unit of work.
+         */
+        virtual std::string getEnergyEfficiencyUnits() const;
+
+        /**
+         * @brief Gets the hardware performance counters over the benchmark, summed over all worker threads and iterations. Only the timed passes of each worker are counted.
+         * @returns The counts. A counter is invalid if any worker could not collect it, or if no worker reported counters.
+         */
+        perf_counts_t getPerfCounts() const;
+
         /**
          * @brief Gets the length of the memory region in bytes. This is not necessarily the "working set size" depending on multithreading configuration.
          * @returns Length of the memory region in bytes.
@@ -282,6 +324,21 @@ namespace xmem {
          */
         virtual bool runCore() = 0;
 
+        /**
+         * @brief Makes the memory under test physically resident before runCore() is called. By default, each worker thread's equal share of the memory region is written in parallel from the logical CPU that thread will run on.
+         * @returns True if all of the memory was initialized where intended.
+         */
+        virtual bool setupCore();
+
+        /**
+         * @brief Builds a random pointer permutation over one worker thread's slice of the memory region, unless the region layout shows that the slice already holds a matching one.
+         * @param slice Index of the slice.
+         * @param slice_len Length of each slice in bytes.
+         * @param chunk_size Chunk size of the permutation.
+         * @returns True on success.
+         */
+        bool buildPermutation(uint32_t slice, size_t slice_len, chunk_size_t chunk_size);
+
         /**
          * @brief Computes the metrics across iterations.
          */
@@ -300,6 +357,34 @@ namespace xmem {
          */
         bool stopPowerThreads();
 
+        /**
+         * @brief Gets the logical CPUs that this benchmark's worker threads, including any probe or helper threads, run on. By default, these are the first num_worker_threads_ logical CPUs of the CPU NUMA node, like in setupCore(). Benchmarks that place their threads otherwise must override this.
+         * @returns The logical CPUs. Negative entries are threads that could not be placed.
+         */
+        virtual std::vector<int32_t> workerCpus() const;
+
+        /**
+         * @brief Picks a logical CPU for the power measurement threads that is not in workerCpus(). The highest-numbered such CPU is used, as workers fill each node from its lowest-numbered CPU.
+         * @returns The logical CPU, or -1 if the workers use every CPU.
+         */
+        int32_t powerThreadCpu() const;
+
+        /**
+         * @brief Reports the power, energy and energy per unit of work of each power reader to the console.
+         */
+        void reportPowerResults() const;
+
+        /**
+         * @brief Adds the hardware performance counters of one worker thread to the benchmark totals.
+         * @param counts The worker's counts.
+         */
+        void addPerfCounts(const perf_counts_t& counts);
+
+        /**
+         * @brief Reports the hardware performance counter totals and some ratios derived from them to the console, if counters were requested.
+         */
+        void reportPerfCounts() const;
+
 
         //Memory region under test
         void* mem_array_; /**< Pointer to the memory region to use in this benchmark. */
@@ -340,6 +425,12 @@ namespace xmem {
         std::string metric_units_; /**< String representing the units of measurement for the metric. */
         std::vector<double> mean_dram_power_socket_; /**< The mean DRAM power in this benchmark, per socket. */
         std::vector<double> peak_dram_power_socket_; /**< The peak DRAM power in this benchmark, per socket. */
+        std::vector<double> dram_energy_socket_; /**< The energy used in this benchmark in joules, per socket. */
+        std::vector<double> dram_energy_time_socket_; /**< The time covered by dram_energy_socket_ in seconds, per socket. */
+        perf_counts_t perf_counts_; /**< Hardware performance counters summed over all worker threads and iterations. */
+        uint32_t perf_counts_added_; /**< Number of times a worker thread's counters were added to perf_counts_, i.e., worker threads times iterations. */
+        tick_t setup_ticks_; /**< Time spent in setupCore(). */
+        region_layout_t* region_layout_; /**< What is known about the contents of the memory region, shared with other benchmarks on it. May be NULL. */
 
         //Metadata
         std::string name_; /**< Name of this benchmark. */
@@ -39,11 +39,24 @@
 #include <Benchmark.h>
 #include <ThroughputBenchmark.h>
 #include <LatencyBenchmark.h>
+#include <CoreToCoreLatencyBenchmark.h>
+#include <CoherenceLatencyBenchmark.h>
+#include <AtomicBenchmark.h>
+#include <GatherBenchmark.h>
+#include <PageFaultBenchmark.h>
+#include <PageMigrationBenchmark.h>
+#include <TlbReachBenchmark.h>
+#include <WorkloadMixBenchmark.h>
 #include <Configurator.h>
 
+#ifdef EXT_MEMCPY_BENCHMARK
+#include <MemcpyBenchmark.h>
+#endif
+
 //Libraries
 #include <cstdint>
 #include <vector>
+#include <string>
 #include <fstream>
 
 namespace xmem {
@@ -81,6 +94,78 @@ namespace xmem {
          */
         bool runLatencyBenchmarks();
 
+        /**
+         * @brief Runs the loaded latency curve mode. For each CPU/memory NUMA node combination, load intensity is stepped from unloaded to fully loaded using the configured knob, and latency is measured at each level.
+         * @returns True on benchmarking success.
+         */
+        bool runLatencyCurve();
+
+        /**
+         * @brief Runs the core-to-core cache line transfer latency benchmark. The matrix is measured once for each selected memory NUMA node, which holds the cache line.
+         * @returns True on benchmarking success.
+         */
+        bool runCoreToCoreLatencyBenchmark();
+
+        /**
+         * @brief Runs the coherence-state-aware latency benchmarks for every combination of memory NUMA node, latency thread CPU NUMA node, preparer CPU NUMA node, and selected coherence state.
+         * @returns True on benchmarking success.
+         */
+        bool runCoherenceLatencyBenchmarks();
+
+        /**
+         * @brief Runs the atomic operation benchmarks for every combination of NUMA nodes, atomic operation, number of shared cache lines, and number of contending threads.
+         * @returns True on benchmarking success.
+         */
+        bool runAtomicBenchmarks();
+
+        /**
+         * @brief Runs the gather/scatter benchmarks for every combination of NUMA nodes, read/write mode, available kernel, and table size, then prints a summary table per read/write mode.
+         * @returns True on benchmarking success.
+         */
+        bool runGatherBenchmarks();
+
+        /**
+         * @brief Runs the heterogeneous workload mix, with each worker thread carved out of the memory allocated on its own memory NUMA node.
+         * @returns True on benchmarking success.
+         */
+        bool runWorkloadMixBenchmark();
+
+        /**
+         * @brief Runs the page fault and first-touch benchmarks for every combination of NUMA nodes, kind of page, mapping type, fault mode, and number of threads. Explicit huge page settings are skipped if not enough huge pages are reserved.
+         * @returns True on benchmarking success.
+         */
+        bool runPageFaultBenchmarks();
+
+        /**
+         * @brief Runs the NUMA matrix: unloaded latency and sequential read throughput from every selected CPU NUMA node to every selected memory NUMA node, including memory-only nodes, then prints both matrices next to the firmware NUMA distances.
+         * @returns True on benchmarking success.
+         */
+        bool runNumaMatrixBenchmarks();
+
+        /**
+         * @brief Runs the all-to-all NUMA traffic mix, in which every selected CPU NUMA node drives load traffic to local and remote memory NUMA nodes at the same time while a probe thread measures latency, then prints the achieved bandwidth of every CPU node and memory node pair.
+         * @returns True on benchmarking success.
+         */
+        bool runAllToAllBenchmark();
+
+        /**
+         * @brief Runs the transparent huge page comparison for every combination of NUMA nodes. For each THP policy, a fresh region is mapped and faulted in, its huge page coverage is read, and latency and throughput are measured on it. Optionally, collapse by khugepaged is observed over time as well.
+         * @returns True on benchmarking success.
+         */
+        bool runThpBenchmarks();
+
+        /**
+         * @brief Runs the page migration benchmarks for every CPU NUMA node, every pair of distinct source and destination memory NUMA nodes, and every kind of page. Explicit huge page settings are skipped if not enough huge pages are free on both nodes.
+         * @returns True on benchmarking success.
+         */
+        bool runPageMigrationBenchmarks();
+
+        /**
+         * @brief Runs the TLB reach benchmarks for every combination of NUMA nodes. For regular pages, transparent huge pages, and each explicit huge page size with free huge pages, latency is measured while touching one cache line in each of 1, 2, 4, ... pages, and compared with the same number of densely packed lines to find the first- and second-level DTLB reach and the page walk latency.
+         * @returns True on benchmarking success.
+         */
+        bool runTlbReachBenchmarks();
+
 #ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
         /**
          * @brief Runs the delay-injected loaded latency benchmark extension.
@@ -89,6 +174,14 @@ namespace xmem {
         bool runExtDelayInjectedLoadedLatencyBenchmark();
 #endif
 
+#ifdef EXT_MEMCPY_BENCHMARK
+        /**
+         * @brief Runs the memcpy/memset benchmark extension. Every available bulk copy and fill strategy is run at power-of-two sizes up to what fits in the working set, and the fastest strategy at each size is reported.
+         * @returns True on success.
+         */
+        bool runExtMemcpyBenchmark();
+#endif
+
 #ifdef EXT_STREAM_BENCHMARK
         /**
          * @brief Runs the STREAM-like benchmark extension.
@@ -110,6 +203,210 @@ namespace xmem {
          */
         bool buildBenchmarks();
 
+        /**
+         * @brief Writes one row of throughput benchmark results to the results file.
+         * @param benchmark The throughput benchmark that has finished running.
+         * @param extension_info Contents of the "Extension Info" column.
+         * @param notes Contents of the "Notes" column. Must not contain commas.
+         */
+        void writeThroughputResults(ThroughputBenchmark* benchmark, std::string extension_info, std::string notes);
+
+        /**
+         * @brief Writes one row of latency benchmark results to the results file.
+         * @param benchmark The latency benchmark that has finished running.
+         * @param extension_info Contents of the "Extension Info" column.
+         * @param notes Contents of the "Notes" column. Must not contain commas.
+         */
+        void writeLatencyResults(LatencyBenchmark* benchmark, std::string extension_info, std::string notes);
+
+        /**
+         * @brief Writes the core-to-core latency matrix to the results file, one row per ordered CPU pair.
+         * @param benchmark The core-to-core latency benchmark that has finished running.
+         */
+        void writeCoreToCoreResults(CoreToCoreLatencyBenchmark* benchmark);
+
+        /**
+         * @brief Writes one row of coherence-state-aware latency results to the results file.
+         * @param benchmark The coherence-state-aware latency benchmark that has finished running.
+         */
+        void writeCoherenceLatencyResults(CoherenceLatencyBenchmark* benchmark);
+
+        /**
+         * @brief Writes one row of atomic operation results to the results file.
+         * @param benchmark The atomic operation benchmark that has finished running.
+         */
+        void writeAtomicResults(AtomicBenchmark* benchmark);
+
+        /**
+         * @brief Writes one row of gather/scatter results to the results file.
+         * @param benchmark The gather/scatter benchmark that has finished running.
+         */
+        void writeGatherResults(GatherBenchmark* benchmark);
+
+        /**
+         * @brief Writes the results of a workload mix to the results file: one row per worker thread, then one row for the aggregate.
+         * @param benchmark The workload mix benchmark that has finished running.
+         * @param extension_info Contents of the "Extension Info" column of the aggregate row.
+         */
+        void writeWorkloadMixResults(WorkloadMixBenchmark* benchmark, std::string extension_info);
+
+        /**
+         * @brief Writes one row of page fault results to the results file.
+         * @param benchmark The page fault benchmark that has finished running.
+         */
+        void writePageFaultResults(PageFaultBenchmark* benchmark);
+
+        /**
+         * @brief Writes one row of page migration results to the results file.
+         * @param benchmark The page migration benchmark that has finished running.
+         */
+        void writePageMigrationResults(PageMigrationBenchmark* benchmark);
+
+        /**
+         * @brief Writes one row of TLB reach results to the results file.
+         * @param benchmark The TLB reach benchmark that has finished running.
+         * @param extension_info Contents of the "Extension Info" column, such as the kind of page and number of pages. Must not contain commas.
+         * @param notes Contents of the "Notes" column. Must not contain commas.
+         */
+        void writeTlbReachResults(TlbReachBenchmark* benchmark, std::string extension_info, std::string notes);
+
+#ifdef EXT_MEMCPY_BENCHMARK
+        /**
+         * @brief Writes one row of memcpy/memset results to the results file.
+         * @param benchmark The memcpy/memset benchmark that has finished running.
+         * @param notes Contents of the "Notes" column. Must not contain commas.
+         */
+        void writeMemcpyResults(MemcpyBenchmark* benchmark, std::string notes);
+#endif
+
+        /**
+         * @brief Finds the knee of a loaded latency curve, i.e., the point where latency starts to climb steeply with load. Both axes are normalized and the point lying furthest below the chord between the first and last points is picked.
+         * @param load Achieved load throughput at each level, in increasing order of load intensity.
+         * @param latency Measured latency at each level.
+         * @returns Index of the knee point, or 0 if the curve has no convex knee.
+         */
+        uint32_t findLatencyCurveKnee(const std::vector<double>& load, const std::vector<double>& latency) const;
+
+#if defined(__gnu_linux__) && defined(HAS_LARGE_PAGES)
+        /**
+         * @brief Maps memory backed by large pages of the configured size and binds it to a NUMA node. If not enough such pages are reserved on the node, falls back to transparent huge pages with a warning.
+         * @param allocation_size Length of the region to map in bytes. Must be a multiple of the large page size.
+         * @param numa_node The memory NUMA node to bind the region to.
+         * @returns Start of the mapping, or nullptr on failure. The mapping is recorded so it can be unmapped later.
+         */
+        void* mapLargePages(size_t allocation_size, uint32_t numa_node);
+#endif
+
+        /**
+         * @brief Checks the placement of each memory region once, after a benchmark has made the whole region resident. Does nothing without NUMA support on GNU/Linux.
+         */
+        void checkPlacementOfResidentRegions();
+
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+        /**
+         * @brief Applies the configured placement policy to a region that has not been faulted in yet.
+         * @param addr Start of the region. Must be page-aligned.
+         * @param len Length of the region in bytes.
+         * @param numa_node The memory NUMA node the region is set up for. Ignored for interleaved placement, which spreads the region across all selected memory nodes.
+         * @returns True on success.
+         */
+        bool bindRegion(void* addr, size_t len, uint32_t numa_node);
+
+        /**
+         * @brief Checks with move_pages() that the pages of a memory region landed where the placement policy wants them, and reports how they are spread across nodes. The region must already be faulted in.
+         * @param numa_node The memory NUMA node whose region should be checked.
+         */
+        void verifyPlacement(uint32_t numa_node);
+
+        /**
+         * @brief Creates a memfd or a temporary file as configured, maps it, and binds it to a NUMA node. With large pages, a memfd tries explicit huge pages first and falls back to transparent huge pages with a warning.
+         * @param allocation_size Length of the region to map in bytes. Must be a multiple of the page size in use.
+         * @param numa_node The memory NUMA node to bind the region to.
+         * @returns Start of the mapping, aligned to the page size in use, or nullptr on failure. The mapping and file are recorded so they can be released later.
+         */
+        void* mapBackedRegion(size_t allocation_size, uint32_t numa_node);
+
+        /**
+         * @brief Creates the file that backs a working set.
+         * @param len Length of the file in bytes.
+         * @param hugetlb If true, create a memfd of explicit huge pages of the configured large page size.
+         * @returns The file descriptor, or -1 on failure.
+         */
+        int createBackingFile(size_t len, bool hugetlb);
+
+        /**
+         * @brief Maps an anonymous region for THP comparison mode, aligned to the transparent huge page size, binds it to a NUMA node, and applies a THP policy to it. Nothing is faulted in.
+         * @param len Length of the region in bytes. Must be a multiple of thp_size.
+         * @param thp_size The transparent huge page size in bytes.
+         * @param numa_node The memory NUMA node to bind the region to.
+         * @param policy The THP policy. The collapse policy starts out like MADV_NOHUGEPAGE.
+         * @param map Set to the start of the whole mapping, which may lie below the aligned region.
+         * @param map_len Set to the length of the whole mapping.
+         * @returns Start of the aligned region, or nullptr on failure.
+         */
+        void* mapThpRegion(size_t len, size_t thp_size, uint32_t numa_node, thp_policy_t policy, void** map, size_t* map_len);
+
+        /**
+         * @brief Reads how much of a region is backed by transparent huge pages from the AnonHugePages fields in /proc/self/smaps.
+         * @param addr Start of the region.
+         * @param len Length of the region in bytes.
+         * @returns The covered fraction of the region between 0 and 1, or -1 if smaps could not be read.
+         */
+        double thpCoverage(void* addr, size_t len) const;
+#endif
+
+        /**
+         * @brief Gets the largest chunk size selected by the user, which gets closest to peak bandwidth.
+         * @returns The chunk size.
+         */
+        chunk_size_t largestSelectedChunk() const;
+
+        /**
+         * @brief Gets a short name for a kind of page in TLB reach mode, such as "thp 2048 KB".
+         * @param backing Kind of pages.
+         * @param page_size Size of the pages in bytes, or the cache line size for the dense reference chain.
+         * @returns The name.
+         */
+        std::string tlbReachKindName(page_backing_t backing, size_t page_size) const;
+
+        /**
+         * @brief Gets a short name for a transparent huge page policy, such as "nohugepage".
+         * @param policy The THP policy.
+         * @returns The name.
+         */
+        std::string thpPolicyName(thp_policy_t policy) const;
+
+        /**
+         * @brief Determines whether a memory node and CPU node combination is benchmarked under the placement policy. With local placement, only threads running on the memory's own node are.
+         * @param mem_node The memory NUMA node.
+         * @param cpu_node The CPU NUMA node.
+         * @returns True if the combination should be benchmarked.
+         */
+        bool usesNodePair(uint32_t mem_node, uint32_t cpu_node) const;
+
+        /**
+         * @brief Describes the placement and backing of the memory under test for the "Notes" column of the results file.
+         * @returns The description, or an empty string for anonymous memory placed on a single node.
+         */
+        std::string placementNotes() const;
+
+        /**
+         * @brief Writes the results file columns of each power reader: mean power, peak power, energy and energy per unit of work, followed by the units of energy per unit of work if there are any readers.
+         * @param benchmark The benchmark whose power results to write, or NULL to write N/A in every column.
+         */
+        void writePowerResults(Benchmark* benchmark);
+
+        /**
+         * @brief Writes one results file column per hardware performance counter, if counters were requested.
+         * @param benchmark The benchmark whose counters to write, or NULL to write N/A in every column. Counters the benchmark did not collect are written as N/A.
+         */
+        void writePerfCounts(Benchmark* benchmark);
+
+        /**
+         * @brief Forgets the random pointer permutations recorded in the region layouts. Must be called before running benchmarks that overwrite the memory regions without tracking it.
+         */
+        void forgetPermutations();
+
         Configurator config_;
 
         std::list<uint32_t> cpu_numa_node_affinities_; /**< List of CPU nodes to affinitize for benchmark experiments. */
@@ -119,6 +416,17 @@ namespace xmem {
         void* orig_malloc_addr_; /**< Points to the original address returned by the malloc() for __mem_arrays on non-NUMA machines. Special case. FIXME: do we need this? seems awkward */
 #endif
         std::vector<size_t> mem_array_lens_; /**< Length of each memory region to use in benchmarks. */
+        std::vector<region_layout_t> region_layouts_; /**< What is known about the contents of each memory region, shared by the throughput and latency benchmarks on it. */
+        std::vector<bool> placement_checked_; /**< True for each memory region whose placement has been checked. */
+#if defined(__gnu_linux__) && defined(HAS_LARGE_PAGES)
+        std::vector<void*> large_page_maps_; /**< Start of the mapping backing each large-page memory region. This may lie below the aligned region in mem_arrays_. */
+        std::vector<size_t> large_page_map_lens_; /**< Length of the mapping backing each large-page memory region. */
+#endif
+#if defined(__gnu_linux__) && defined(HAS_NUMA)
+        std::vector<void*> backed_maps_; /**< Start of the mapping of each memfd or file-backed memory region, including any alignment headroom. */
+        std::vector<size_t> backed_map_lens_; /**< Length of the mapping of each memfd or file-backed memory region. */
+        std::vector<int> backed_fds_; /**< The memfd or file descriptor backing each memory region. */
+#endif
         std::vector<ThroughputBenchmark*> tp_benchmarks_; /**< Set of throughput benchmarks. */
         std::vector<LatencyBenchmark*> lat_benchmarks_; /**< Set of latency benchmarks. */
         std::vector<PowerReader*> dram_power_readers_; /**< Set of power measurement objects for DRAM on each NUMA node. */
@@ -0,0 +1,131 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the CoherenceLatencyBenchmark class.
+ */
+
+#ifndef COHERENCE_LATENCY_BENCHMARK_H
+#define COHERENCE_LATENCY_BENCHMARK_H
+
+//Headers
+#include <Benchmark.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+
+    /**
+     * @brief A type of benchmark that measures read latency to cache lines that another core has just left in a particular coherence state (Modified, Exclusive, Shared, or Invalid).
+     *
+     * One latency thread on the first logical CPU of the CPU NUMA node chases a random cycle of LATENCY_BENCHMARK_UNROLL_LENGTH cache lines. Before each pass, one or two preparer threads on the preparer NUMA node put the lines into the requested state.
+     */
+    class CoherenceLatencyBenchmark : public Benchmark {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param mem_array A pointer to a contiguous chunk of memory. It must hold the cache line cycle plus two control lines; see getRequiredLen().
+         * @param len Length of mem_array in bytes.
+         * @param iterations Number of iterations of the complete benchmark. Used to gather more statistics.
+         * @param mem_node The memory NUMA node that mem_array belongs to.
+         * @param cpu_node The CPU NUMA node of the latency thread.
+         * @param preparer_cpu_node The CPU NUMA node of the preparer threads.
+         * @param state The coherence state to put the lines into before each pass.
+         * @param dram_power_readers A group of PowerReader objects for measuring DRAM power.
+         * @param name The name of the benchmark to use when reporting to console.
+         */
+        CoherenceLatencyBenchmark(
+            void* mem_array,
+            size_t len,
+            uint32_t iterations,
+            uint32_t mem_node,
+            uint32_t cpu_node,
+            uint32_t preparer_cpu_node,
+            coherence_state_t state,
+            std::vector<PowerReader*> dram_power_readers,
+            std::string name
+        );
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~CoherenceLatencyBenchmark() {}
+
+        /**
+         * @brief Reports benchmark configuration details to the console.
+         */
+        virtual void reportBenchmarkInfo() const;
+
+        /**
+         * @brief Gets the CPU NUMA node of the preparer threads.
+         * @returns The preparer NUMA node.
+         */
+        uint32_t getPreparerCPUNode() const { return preparer_cpu_node_; }
+
+        /**
+         * @brief Gets the coherence state the lines are put into before each pass.
+         * @returns The coherence state.
+         */
+        coherence_state_t getCoherenceState() const { return state_; }
+
+        /**
+         * @brief Gets the minimum memory region length needed by this benchmark.
+         * @returns The length in bytes.
+         */
+        static size_t getRequiredLen() { return (LATENCY_BENCHMARK_UNROLL_LENGTH + 2) * CACHE_LINE_SIZE; }
+
+        /**
+         * @brief Gets a short name for a coherence state.
+         * @param state The coherence state.
+         * @returns "M", "E", "S", "I", or "UNKNOWN".
+         */
+        static std::string coherenceStateName(coherence_state_t state);
+
+    protected:
+        virtual bool runCore();
+        virtual std::vector<int32_t> workerCpus() const;
+
+    private:
+        /**
+         * @brief Finds the logical CPUs for the latency thread and the preparer threads.
+         * @param latency_cpu Set to the logical CPU of the latency thread.
+         * @param owner_cpu Set to the logical CPU of the first preparer thread.
+         * @param sharer_cpu Set to the logical CPU of the second preparer thread.
+         */
+        void findCpus(int32_t& latency_cpu, int32_t& owner_cpu, int32_t& sharer_cpu) const;
+
+        uint32_t preparer_cpu_node_; /**< CPU NUMA node of the preparer threads. */
+        coherence_state_t state_; /**< The coherence state the lines are put into before each pass. */
+    };
+};
+
+#endif
@@ -0,0 +1,91 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the CoherenceLatencyWorker class.
+ */
+
+#ifndef COHERENCE_LATENCY_WORKER_H
+#define COHERENCE_LATENCY_WORKER_H
+
+//Headers
+#include <MemoryWorker.h>
+#include <benchmark_kernels.h>
+#include <common.h>
+
+namespace xmem {
+    /**
+     * @brief Multithreading-friendly class to measure the latency of reading cache lines that have just been put into a given coherence state by up to two CoherencePreparerWorkers on other logical CPUs.
+     *
+     * Before each timed pass, lines are flushed from all caches if needed and the preparers are asked to touch them. Only the pointer chase itself is timed.
+     */
+    class CoherenceLatencyWorker : public MemoryWorker {
+        public:
+
+            /**
+             * @brief Constructor.
+             * @param mem_array Pointer to the cache line cycle to chase. It must hold exactly LATENCY_BENCHMARK_UNROLL_LENGTH lines, so one kernel call visits every line once.
+             * @param len Length of the cache line cycle in bytes.
+             * @param state The coherence state the lines are put into before each pass.
+             * @param owner_control Control word of the preparer that reads or writes the lines first, or NULL if the state does not need one.
+             * @param sharer_control Control word of the preparer that reads the lines second, or NULL if the state does not need one.
+             * @param kernel_fptr Pointer to the pointer-chasing core benchmark kernel to use.
+             * @param kernel_dummy_fptr Pointer to the dummy version of the core benchmark kernel to use.
+             * @param cpu_affinity Logical CPU identifier to lock this worker's thread to.
+             */
+            CoherenceLatencyWorker(
+                void* mem_array,
+                size_t len,
+                coherence_state_t state,
+                void* owner_control,
+                void* sharer_control,
+                RandomFunction kernel_fptr,
+                RandomFunction kernel_dummy_fptr,
+                int32_t cpu_affinity
+            );
+
+            /**
+             * @brief Destructor.
+             */
+            virtual ~CoherenceLatencyWorker();
+
+            /**
+             * @brief Thread-safe worker method.
+             */
+            virtual void run();
+
+        private:
+            // ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
+            coherence_state_t state_; /**< The coherence state the lines are put into before each pass. */
+            void* owner_control_; /**< Control word of the first preparer, or NULL. */
+            void* sharer_control_; /**< Control word of the second preparer, or NULL. */
+            RandomFunction kernel_fptr_; /**< Points to the memory test core routine to use. */
+            RandomFunction kernel_dummy_fptr_; /**< Points to a dummy version of the memory test core routine to use. */
+    };
+};
+
+#endif
@@ -0,0 +1,83 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the CoherencePreparerWorker class.
+ */
+
+#ifndef COHERENCE_PREPARER_WORKER_H
+#define COHERENCE_PREPARER_WORKER_H
+
+//Headers
+#include <MemoryWorker.h>
+#include <common.h>
+
+#define COHERENCE_PREPARER_STOP_COMMAND 0xFFFFFFFFFFFFFFFFULL /**< Written to a preparer's control word to make it exit. */
+
+namespace xmem {
+    /**
+     * @brief Multithreading-friendly class that puts a set of cache lines into a given coherence state on its own logical CPU whenever it is asked to.
+     *
+     * The preparer waits on a 64-bit control word. For round k, the measuring worker writes 2k+1 and waits for the preparer to touch every line and answer with 2k+2. Writing COHERENCE_PREPARER_STOP_COMMAND makes the preparer exit.
+     */
+    class CoherencePreparerWorker : public MemoryWorker {
+        public:
+
+            /**
+             * @brief Constructor.
+             * @param mem_array Pointer to the cache lines to prepare.
+             * @param len Length of the region to prepare in bytes.
+             * @param write If true, each line is written so that it becomes Modified in this core's cache. Otherwise each line is only read.
+             * @param control Pointer to the 64-bit control word. It must be on a cache line of its own and the caller must zero it before starting the worker.
+             * @param cpu_affinity Logical CPU identifier to lock this worker's thread to.
+             */
+            CoherencePreparerWorker(
+                void* mem_array,
+                size_t len,
+                bool write,
+                void* control,
+                int32_t cpu_affinity
+            );
+
+            /**
+             * @brief Destructor.
+             */
+            virtual ~CoherencePreparerWorker();
+
+            /**
+             * @brief Thread-safe worker method.
+             */
+            virtual void run();
+
+        private:
+            // ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
+            bool write_; /**< If true, lines are written rather than read. */
+            void* control_; /**< The control word shared with the measuring worker. */
+    };
+};
+
+#endif
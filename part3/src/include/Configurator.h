@@ -41,6 +41,7 @@
 #include <cstdint>
 #include <string>
 #include <list>
+#include <vector>
 
 namespace xmem {
     /**
@@ -69,7 +70,32 @@ namespace xmem {
         USE_READS,
         USE_WRITES,
         STRIDE_SIZE,
-        MLP
+        MLP,
+        LOAD_RATE,
+        LATENCY_CURVE,
+        LATENCY_CURVE_KNOB,
+        CORE_TO_CORE,
+        COHERENCE_LATENCY,
+        COHERENCE_STATE,
+        ATOMICS,
+        ATOMIC_OP,
+        GATHER,
+        WORKLOAD,
+        LARGE_PAGE_SIZE,
+        PLACEMENT,
+        PAGE_FAULTS,
+        BACKING,
+        PRIVATE_MAPPING,
+        NUMA_MATRIX,
+        ALL_TO_ALL,
+        THP_COMPARE,
+        THP_COLLAPSE_SECONDS,
+        MIGRATION,
+        TLB_REACH,
+        TIMER,
+        PERF_COUNTERS,
+        RAPL_ROOT,
+        POWER_PERIOD
     };
 
     /**
@@ -90,16 +116,41 @@ namespace xmem {
         { RANDOM_ACCESS_PATTERN, 0, "r", "random_access", Arg::None, "    -r, --random_access    \tUse a random access pattern for load traffic-generating threads used in throughput and loaded latency benchmarks." },
         { SEQUENTIAL_ACCESS_PATTERN, 0, "s", "sequential_access", Arg::None, "    -s, --sequential_access    \tUse a sequential and/or strided access pattern for load traffic generating-threads used in throughput and loaded latency benchmarks." },
         { MEAS_THROUGHPUT, 0, "t", "throughput", Arg::None, "    -t, --throughput    \tThroughput benchmarking mode. Aggregate throughput is measured across all worker threads. Each load traffic-generating worker in a particular benchmark runs an identical kernel. Multiple distinct benchmarks may be run depending on the specified benchmark settings (e.g., aggregated 64-bit and 256-bit sequential read throughput using strides of 1 and -8 chunks)." },
-        { NUMA_DISABLE, 0, "u", "ignore_numa", Arg::None, "    -u, --ignore_numa    \tForce uniform memory access (UMA) mode. This only has an effect in non-uniform memory access (NUMA) systems. Limits benchmarking to CPU and memory NUMA node 0 instead of all intra-node and inter-node combinations. This mode can be useful in situations where the user is not interested in cross-node effects or node asymmetry. This option is the same as independently setting CPU and memory node affinities to 0 using the \"-C\" and \"-M\" options, but this cannot be used in tandem with those options. This option may also be required if large pages are desired on GNU/Linux systems due to lack of NUMA support in current versions of hugetlbfs. See the large_pages option." },
+        { NUMA_DISABLE, 0, "u", "ignore_numa", Arg::None, "    -u, --ignore_numa    \tForce uniform memory access (UMA) mode. This only has an effect in non-uniform memory access (NUMA) systems. Limits benchmarking to CPU and memory NUMA node 0 instead of all intra-node and inter-node combinations. This mode can be useful in situations where the user is not interested in cross-node effects or node asymmetry. This option is the same as independently setting CPU and memory node affinities to 0 using the \"-C\" and \"-M\" options, but this cannot be used in tandem with those options." },
         { VERBOSE, 0, "v", "verbose", Arg::None, "    -v, --verbose    \tVerbose mode increases the level of detail in X-Mem console reporting." },
         { WORKING_SET_SIZE_PER_THREAD, 0, "w", "working_set_size", MyArg::PositiveInteger, "    -w, --working_set_size    \tWorking set size per worker thread in KB. This must be a multiple of 4KB. In all benchmarks, each worker thread works on its own \"private\" region of memory. For example, 4-thread throughput benchmarking with a working set size of 4 KB might result in measuring the aggregate throughput of four L1 caches corresponding to four physical cores, with no data sharing between threads. Similarly, an 8-thread loaded latency benchmark with a working set size of 64 MB would use 512 MB of memory in total for benchmarking, with no data sharing between threads. This would result in performance measurement of the shared DRAM physical interface, the shared L3 cache, etc." },
         { CPU_NUMA_NODE_AFFINITY, 0, "C", "cpu_numa_node_affinity", MyArg::NonnegativeInteger, "    -C, --cpu_numa_node_affinity    \tInclude the specified NUMA node in all selected benchmark experiments. This does not specify logical/physical CPU core affinity, just the NUMA node (socket). Setting core affinities is not supported at this time. This option may be specified multiple times with multiple nodes. Note that all possible combinations of selected CPU and memory NUMA node affinities will be used. If left unspecified, then all available nodes will be used." },
-        { USE_LARGE_PAGES, 1, "L", "large_pages", Arg::None, "    -L, --large_pages    \tUse large pages. This might enable better memory performance by reducing the translation-lookaside buffer (TLB) bottleneck. However, this is not supported on all systems. On GNU/Linux, you need hugetlbfs support with pre-reserved huge pages prior to running X-Mem. On GNU/Linux, you also must use the ignore_numa option, as hugetlbfs is not NUMA-aware at this time." },
+        { USE_LARGE_PAGES, 1, "L", "large_pages", Arg::None, "    -L, --large_pages    \tUse large pages. This might enable better memory performance by reducing the translation-lookaside buffer (TLB) bottleneck. However, this is not supported on all systems. On GNU/Linux, huge pages must be reserved on each memory NUMA node under test prior to running X-Mem (e.g., through /sys/devices/system/node/node<N>/hugepages/). Memory is bound to the node under test, so every CPU node and memory node combination can be measured. If not enough huge pages are reserved on a node, X-Mem warns and falls back to transparent huge pages. See the large_page_size option." },
         { MEMORY_NUMA_NODE_AFFINITY, 0, "M", "memory_numa_node_affinity", MyArg::NonnegativeInteger, "    -M, --memory_numa_node_affinity    \tInclude the specified NUMA node in all selected benchmark experiments for placement of memory regions under test. This does not specify thread placement for the experiments (CPU affinity). This option may be specified multiple times with multiple nodes. Note that all possible combinations of selected CPU and memory NUMA node affinities will be used. If left unspecified, then all available nodes will be used." },
         { USE_READS, 0, "R", "reads", Arg::None, "    -R, --reads    \tUse memory read-based patterns in load traffic-generating threads." },
         { USE_WRITES, 0, "W", "writes", Arg::None, "    -W, --writes    \tUse memory write-based patterns in load traffic-generating threads." },
         { STRIDE_SIZE, 0, "S", "stride_size", MyArg::Integer, "    -S, --stride_size    \tA stride size to use for load traffic-generating threads, specified in powers-of-two multiples of the chunk size(s). Allowed values: 1, -1, 2, -2, 4, -4, 8, -8, 16, -16. Positive indicates the forward direction (increasing addresses), while negative indicates the reverse direction." },
-        { MLP, 0, "m", "mlp", MyArg::PositiveInteger, "    -m, --mlp  \tAn MLP (memory-level parallelism) value to use. Allowed values: 1, 2, 4, 6, 8, 16, 32."},
+        { MLP, 0, "m", "mlp", MyArg::PositiveInteger, "    -m, --mlp  \tAn MLP (memory-level parallelism) value to use. Random-access load threads interleave this many independent pointer chains, so random throughput is measured with up to this many misses outstanding per thread. Allowed values: 1, 2, 4, 6, 8, 16, 32. DEFAULT: 1"},
+        { LOAD_RATE, 0, "b", "load_rate", MyArg::NonnegativeInteger, "    -b, --load_rate    \tBandwidth in MB/s that each load traffic-generating thread should impose in loaded latency benchmarks. Load threads pace themselves with a token bucket (open-loop) instead of running as fast as possible, and the achieved load is reported next to the requested load. A value of 0 disables rate limiting. This has no effect on throughput benchmarks or when only 1 worker thread is used. DEFAULT: 0" },
+        { LATENCY_CURVE, 0, "k", "latency_curve", MyArg::PositiveInteger, "    -k, --latency_curve    \tLoaded latency curve mode. Steps load intensity from unloaded to fully loaded and measures latency with the dedicated latency thread at each level, then reports the whole bandwidth-vs-latency curve and its knee point. The integer argument is the number of load levels for the rate knob; for example, 10 gives loads of 10%, 20%, ... 90% of calibrated peak bandwidth plus an unthrottled 100% level. The first selected access pattern, read/write mode, chunk size and stride are used for load traffic. At least 2 worker threads are required. This mode is not run by the all option." },
+        { LATENCY_CURVE_KNOB, 0, "K", "latency_curve_knob", MyArg::Required, "    -K, --latency_curve_knob    \tThe load intensity knob stepped in loaded latency curve mode. Allowed values: rate (each load thread is rate-limited to a fraction of the peak bandwidth, which is calibrated first with a throughput benchmark), threads (1, 2, ... all load threads run as fast as possible; the number of levels follows the number of worker threads), and delay (delay-injected sequential read load threads from 1024 down to 0 nops, only if the delay-injected extension is built in). DEFAULT: rate" },
+        { CORE_TO_CORE, 0, "P", "core_to_core", MyArg::PositiveInteger, "    -P, --core_to_core    \tCore-to-core latency mode. Bounces a single cache line between every ordered pair of logical CPUs and reports the one-way cache line transfer latency as a matrix, plus averages by NUMA node pair. The integer argument is a CPU sampling stride: 1 measures every logical CPU in the selected CPU NUMA nodes, 2 measures every other one, and so on, which keeps the number of pairs manageable on large systems. The cache line is placed on each selected memory NUMA node in turn. This mode is not run by the all option." },
+        { COHERENCE_LATENCY, 0, "H", "coherence_latency", Arg::None, "    -H, --coherence_latency    \tCoherence-state-aware latency mode. Before each pass, one or two preparer threads put a set of cache lines into a chosen coherence state, and then a latency thread on the first logical CPU of a CPU NUMA node chases them with random dependent reads. This shows how much a read of a line that is dirty or clean in another core's cache costs compared to a memory access. Preparer threads are placed on each selected CPU NUMA node in turn, so both local and cross-node transfers are measured. This mode is not run by the all option." },
+        { COHERENCE_STATE, 0, "Q", "coherence_state", MyArg::Required, "    -Q, --coherence_state    \tA source coherence state to measure in coherence-state-aware latency mode. Allowed values: M (Modified: written by one preparer), E (Exclusive: read by one preparer only), S (Shared: read by two preparers), and I (Invalid: flushed from all caches, so the access goes to memory). This option may be specified multiple times. States other than M need cache line flush instructions and are only available on x86-64 and AArch64. DEFAULT: all available states" },
+        { ATOMICS, 0, "A", "atomics", MyArg::PositiveInteger, "    -A, --atomics    \tAtomic operation mode. Worker threads hammer a small set of shared cache lines with atomic read-modify-write operations, and aggregate throughput plus the per-operation latency distribution are reported. The integer argument is the largest number of shared cache lines; 1, 2, 4, ... lines up to it are used. The number of contending threads is stepped 1, 2, 4, ... up to the number of worker threads. Lines are placed on each selected memory NUMA node and threads on each selected CPU NUMA node, so both local and remote contention are measured. When several CPU NUMA nodes are selected, threads are also spread round-robin over all of them, so that different sockets contend for the same lines. This mode is not run by the all option." },
+        { ATOMIC_OP, 0, "O", "atomic_op", MyArg::Required, "    -O, --atomic_op    \tAn atomic operation to use in atomic operation mode. Allowed values: xadd (fetch-and-add), cmpxchg (compare-and-swap increment loop; one operation is one successful increment), and xchg (swap). This option may be specified multiple times. DEFAULT: all" },
+        { GATHER, 0, "G", "gather", Arg::None, "    -G, --gather    \tGather/scatter mode. Each worker thread gathers from (reads) or scatters to (writes) its own table of 64-bit elements using precomputed, independent random indices, so many lookups are in flight at once as in vectorized hash probes and embedding lookups. Scalar, AVX2 (gather only) and AVX-512 kernels are compared where the build supports them. The table size per thread is stepped 4 KB, 8 KB, ... up to the working set size, so results can be read off per cache level. Effective throughput counts only the elements accessed. The read/write options select gathers and scatters. This mode is not run by the all option." },
+        { WORKLOAD, 0, "X", "workload", MyArg::Required, "    -X, --workload    \tWorkload mix mode. Adds a group of worker threads to a heterogeneous workload in which every thread can have its own access pattern, read/write mode, chunk size, stride, working set size and NUMA nodes. All threads of the mix run at the same time, and per-thread results are reported next to the aggregate load throughput and mean probe latency. The argument is <count>:<kind>[:chunk=<bits>][:stride=<n>][:ws=<KB>][:mem=<node>][:cpu=<node>], where kind is one of seq-read, seq-write, rand-read, rand-write and latency (a 64-bit random pointer-chasing latency probe, which takes only the ws, mem and cpu fields). Unspecified fields default to the chunk size 64 (32 on 32-bit systems), stride 1, the working set size option, and the first selected memory and CPU NUMA nodes. The mem node must be one of the selected memory NUMA nodes. This option may be specified multiple times; for example, -X 4:seq-write -X 2:rand-read -X 1:latency runs 4 sequential writers, 2 random readers and 1 latency probe together. This mode is not run by the all option." },
+        { LARGE_PAGE_SIZE, 0, "Z", "large_page_size", MyArg::PositiveInteger, "    -Z, --large_page_size    \tLarge page size in KB to use on GNU/Linux, e.g., 2048 for 2 MB pages or 1048576 for 1 GB pages on x86-64. The kernel must support this page size. This option implies the large_pages option. Transparent huge pages, the fallback, are always of the kernel's default size. DEFAULT: the system default huge page size" },
+        { PLACEMENT, 0, "p", "placement", MyArg::Required, "    -p, --placement    \tPolicy for placing the memory under test across NUMA nodes. \"node\" gives each selected memory node its own region bound to it and measures every CPU node and memory node combination. \"interleave\" or \"interleave:<KB>\" spreads a single region round-robin across all selected memory nodes like numactl --interleave, at the given granularity in KB, which must be a multiple of the page size in use. Results list the first selected memory node. \"local\" puts the memory of each worker thread on the node of its own CPU, as first-touch allocation by the threads would, so memory node affinities are ignored. In workload mix mode, the mem field of a workload group cannot be combined with the interleave or local policies. The actual placement is checked with move_pages() after the memory is allocated. This option is only fully supported on GNU/Linux. DEFAULT: node, with interleave granularity of one page" },
+        { PAGE_FAULTS, 0, "F", "page_faults", Arg::None, "    -F, --page_faults    \tPage fault mode. Measures the cost of first touch on freshly mapped memory, which dominates the cold start of many services. Every iteration maps a new region of the working set size times the number of worker threads, faults it in, and unmaps it again. Regular pages, transparent huge pages and explicit huge pages (of the large_page_size option) are each measured with private anonymous memory and with memfd mappings. Regions are faulted in lazily by 1 thread and by all worker threads in parallel, populated by the kernel at mmap() time, and, for anonymous memory, written again after fork() to take copy-on-write faults. First-touch throughput and the page fault rate are reported. Explicit huge page settings are skipped if not enough huge pages are reserved on the memory NUMA node. This mode is only supported on GNU/Linux and is not run by the all option." },
+        { BACKING, 0, "B", "backing", MyArg::Required, "    -B, --backing    \tWhat backs the working sets of all benchmarks that use them. \"anon\" is anonymous memory. \"memfd\" is an in-memory file from memfd_create(), i.e., shared memory as used for inter-process communication. \"file:<directory>\" is a temporary file created in the given directory, so a tmpfs mount gives shared memory, a disk file system gives page-cache-backed memory, and a file system mounted with -o dax gives direct access to persistent memory. The file is deleted when X-Mem exits. Memory is still bound to the memory NUMA node under test where the kernel supports it, and the actual placement is reported. With the large_pages option, memfd tries explicit huge pages first, and all others ask for transparent huge pages. This option is only supported on GNU/Linux. DEFAULT: anon" },
+        { PRIVATE_MAPPING, 0, "Y", "map_private", Arg::None, "    -Y, --map_private    \tMap memfd and file working sets with MAP_PRIVATE instead of MAP_SHARED. X-Mem writes to all memory during setup, so every page becomes a private copy of the file's page before benchmarking starts. The cost of making these copies shows up in the setup time." },
+        { NUMA_MATRIX, 0, "D", "numa_matrix", Arg::None, "    -D, --numa_matrix    \tNUMA matrix mode. Measures unloaded random read latency with 1 thread and sequential read throughput with all worker threads from every selected CPU NUMA node to every selected memory NUMA node, and prints both matrices next to the NUMA distances reported by the firmware. Memory-only NUMA nodes without CPUs, such as CXL memory expanders or high-bandwidth memory tiers, are measured as memory targets; they are not used as CPU nodes. The largest selected chunk size is used for the throughput measurements. This mode requires node placement and is not run by the all option." },
+        { ALL_TO_ALL, 0, "T", "all_to_all", MyArg::Required, "    -T, --all_to_all    \tAll-to-all NUMA traffic mode. Every selected CPU NUMA node runs the given number of worker threads at the same time, and each thread drives load traffic to its own working set on either its local memory NUMA node or one of the remote ones. The integer argument is the percentage of threads per CPU node that use local memory, e.g., 70 for a 70/30 local/remote split; remote threads are spread round-robin over the other selected memory NUMA nodes, including memory-only nodes. One extra latency probe thread on the first CPU NUMA node chases pointers on its first remote memory node, where contention on the inter-socket links shows up. The achieved bandwidth of every CPU node and memory node pair is reported next to the probe latency. Load threads use the first selected access pattern, read/write mode and chunk size, with a stride of 1. This mode requires node placement and is not run by the all option." },
+        { THP_COMPARE, 0, "U", "thp_compare", Arg::None, "    -U, --thp_compare    \tTransparent huge page comparison mode. A fresh anonymous region of the working set size times the number of worker threads is mapped for each THP policy in turn: the system default without any madvise() call, madvise(MADV_HUGEPAGE), and madvise(MADV_NOHUGEPAGE). Each region is faulted in by the worker threads, its AnonHugePages coverage is read from /proc/self/smaps, and then unloaded random read latency with 1 thread and sequential and random read throughput with all worker threads are measured on it. The system-wide THP settings are reported, as they decide what the default policy does. The largest selected chunk size is used. This mode ignores the large_pages and backing options, is only supported on GNU/Linux, and is not run by the all option." },
+        { THP_COLLAPSE_SECONDS, 0, "E", "thp_collapse", MyArg::PositiveInteger, "    -E, --thp_collapse    \tIn THP comparison mode, also measure collapse by khugepaged. A region is faulted in with regular pages and then given madvise(MADV_HUGEPAGE), its AnonHugePages coverage is sampled once per second for the given number of seconds, and then it is measured like the other policies. How fast khugepaged works is set in /sys/kernel/mm/transparent_hugepage/khugepaged." },
+        { MIGRATION, 0, "I", "migration", Arg::None, "    -I, --migration    \tPage migration mode. Measures how fast the kernel moves pages between NUMA nodes, as automatic NUMA balancing and memory tiering do all the time. For every pair of distinct memory NUMA nodes, every iteration maps a fresh region of the working set size times the number of worker threads and faults it in on the source node. Its pages are then moved to the destination node and back again with move_pages() for the benchmark duration, while a latency thread chases pointers through the first working set size of the region. Only moves to the destination node are timed. Migration throughput in MB/s and pages/s is reported, along with the latency seen by the reader during migration and, as a baseline, without it. Regular pages, transparent huge pages and explicit huge pages (of the large_page_size option) are measured. Explicit huge page settings are skipped if not enough huge pages are free on both nodes. This mode requires at least two memory NUMA nodes, is only supported on GNU/Linux, and is not run by the all option." },
+        { TLB_REACH, 0, "N", "tlb_reach", MyArg::PositiveInteger, "    -N, --tlb_reach    \tTLB reach mode. Measures unloaded latency while touching exactly one cache line per page, over 1, 2, 4, ... pages, to find how much memory the first- and second-level data TLBs can map and what a page walk costs. Regular pages, transparent huge pages, and every explicit huge page size with free huge pages on the memory NUMA node are measured. The line touched in each page is staggered, so the same number of pages touches the same cache lines for every page size, and the same number of lines packed densely gives the latency without TLB misses. The extra latency over the dense lines is reported for each page size, along with the reach at which it appears and the page walk latency. Pages are visited in random order if the random access pattern is selected, and in address order, one page apart, if the sequential access pattern is selected. The integer argument is the largest region in MB to map for each page size. At most 16384 pages are touched. This mode is only supported on GNU/Linux and is not run by the all option." },
+        { TIMER, 0, "J", "timer", MyArg::Required, "    -J, --timer    \tThe timer used for all timed sections of code. Allowed values: os (QueryPerformanceCounter on Windows, or clock_gettime() on GNU/Linux, which is served from the vDSO without a system call), rdtsc (rdtsc fenced by lfence on both sides), rdtscp (rdtscp followed by lfence), and cpuid (rdtsc and rdtscp serialized by cpuid, which costs hundreds of cycles and traps to the hypervisor in a virtual machine). The TSC timers are only available on x86. The verbose timer report lists the measured cost of every available timer in ns and core cycles, and latency results are also reported in core cycles. DEFAULT: os, or rdtscp if X-Mem was built with USE_HW_TIMER" },
+        { PERF_COUNTERS, 0, "o", "perf_counters", Arg::None, "    -o, --perf_counters    \tCollect hardware performance counters on every worker thread of the throughput, latency, TLB reach and workload mix benchmarks, including the loaded latency modes. Cycles, instructions, LLC loads and misses, dTLB load misses, L1D replacements, and on Intel CPUs offcore data read requests are counted in user mode over the timed passes only, scaled up if the kernel had to multiplex them, and summed over all threads and iterations. The totals are added as columns to the results file, and are reported with IPC and misses per 1000 instructions on the console. Counters that cannot be opened, for example because of perf_event_paranoid or a virtual machine without a PMU, are reported as N/A. This option is only supported on GNU/Linux." },
+        { RAPL_ROOT, 0, "", "rapl_root", MyArg::Required, "        --rapl_root    \tGNU/Linux only. The powercap sysfs directory to read RAPL energy counters from. The package and DRAM domains of each physical package found there are sampled during every benchmark, and their mean and peak power and the energy they used are reported. Domains that do not exist or cannot be read, which usually requires root, are left out. A directory with the same layout can be given to test against a fake tree. DEFAULT: /sys/class/powercap" },
+        { POWER_PERIOD, 0, "", "power_period", MyArg::PositiveInteger, "        --power_period    \tPower sampling period in milliseconds, at least 10. Energy is integrated over each whole benchmark whatever the period, so the period only sets the resolution of the power trace and of peak power. Short periods wake the power thread often, which is why it runs on a logical CPU that no worker thread of the benchmark uses whenever there is one. DEFAULT: 1000" },
         { UNKNOWN, 0, "", "", Arg::None,
         "\n"
         "If a given option is not specified, X-Mem defaults will be used where appropriate.\n"
@@ -138,6 +189,98 @@ namespace xmem {
         "\n"
         "        xmem -a -v -ftest.csv -L\n"
         "\n"
+        "\n"
+        "Measure loaded latency on NUMA node 0 with 4 worker threads, where each of the 3 load traffic-generating threads imposes exactly 2000 MB/s of random reads instead of running as fast as possible.\n"
+        "\n"
+        "        xmem -l -j4 -r -R -u -w262144 --load_rate=2000\n"
+        "\n"
+        "\n"
+        "Trace the loaded latency curve for local DRAM on NUMA node 0 with 8 worker threads: calibrate peak sequential read bandwidth of the 7 load threads, then measure latency at 5%, 10%, ... 95% of that peak and unthrottled, and report the knee of the curve.\n"
+        "\n"
+        "        xmem -k20 -j8 -s -R -C0 -M0 -w262144 -f curve.csv\n"
+        "\n"
+        "\n"
+        "Measure the core-to-core cache line transfer latency matrix between every other logical CPU in the system, with the cache line homed on NUMA node 0.\n"
+        "\n"
+        "        xmem -P2 -M0\n"
+        "\n"
+        "\n"
+        "Compare the latency of reading lines that are dirty in another core's cache on the same socket and on the other socket against a plain DRAM access, with the latency thread and memory on socket 0.\n"
+        "\n"
+        "        xmem -H -QM -QI -C0 -M0\n"
+        "\n"
+        "\n"
+        "Measure fetch-and-add throughput and latency on 1, 2 and 4 shared counters with 1, 2, 4 and 8 contending threads on socket 0, for counters on both sockets.\n"
+        "\n"
+        "        xmem -A4 -Oxadd -j8 -C0\n"
+        "\n"
+        "\n"
+        "Run 4 sequential writers on 256 MB each, 2 random readers on 1 GB each in the memory of socket 1, and 1 latency probe together on socket 0, reporting each thread and the aggregate.\n"
+        "\n"
+        "        xmem -X 4:seq-write:ws=262144 -X 2:rand-read:ws=1048576:mem=1 -X 1:latency -C0 -M0 -M1 -w262144\n"
+        "\n"
+        "\n"
+        "Measure throughput and latency on 1 GB pages for every CPU NUMA node and memory NUMA node combination, with 4 worker threads of 1 GB each.\n"
+        "\n"
+        "        xmem -t -l -j4 -Z1048576 -w1048576\n"
+        "\n"
+        "\n"
+        "Compare sequential read throughput with 8 threads on socket 0 for memory on socket 0 only, and for memory interleaved across both sockets in 2 MB granules.\n"
+        "\n"
+        "        xmem -t -s -R -j8 -C0 -M0 -w262144\n"
+        "        xmem -t -s -R -j8 -C0 -M0 -M1 -w262144 --placement=interleave:2048\n"
+        "\n"
+        "\n"
+        "Measure page fault and first-touch cost of 256 MB regions with 1 and 4 threads on socket 0.\n"
+        "\n"
+        "        xmem -F -j4 -C0 -M0 -w65536\n"
+        "\n"
+        "\n"
+        "Compare random read latency on 1 GB of anonymous memory with 1 GB of a file in the page cache of the file system mounted on /data.\n"
+        "\n"
+        "        xmem -l -r -R -w1048576\n"
+        "        xmem -l -r -R -w1048576 --backing=file:/data\n"
+        "\n"
+        "\n"
+        "Measure latency and bandwidth from every socket to every memory node, including CPU-less memory expander nodes, with 8 threads.\n"
+        "\n"
+        "        xmem -D -j8 -w262144\n"
+        "\n"
+        "\n"
+        "Drive sequential reads from 8 threads on every socket at once, with 70% of each socket's threads reading local memory and 30% reading remote memory.\n"
+        "\n"
+        "        xmem -T70 -j8 -s -R -w262144\n"
+        "\n"
+        "\n"
+        "Compare latency and bandwidth of 1 GB with the default THP policy, with MADV_HUGEPAGE and with MADV_NOHUGEPAGE, and watch khugepaged collapse a region for 60 seconds.\n"
+        "\n"
+        "        xmem -U -E60 -j4 -w262144\n"
+        "\n"
+        "\n"
+        "Measure how fast 256 MB of regular and huge pages migrate from node 0 to node 1 and back, and what a reader on node 0 sees meanwhile.\n"
+        "\n"
+        "        xmem -I -C0 -M0 -M1 -j4 -w65536\n"
+        "\n"
+        "\n"
+        "Find the L1 and L2 DTLB reach and the page walk latency for 4 KB pages and for huge pages, mapping at most 4 GB per page size, with pages touched in random order.\n"
+        "\n"
+        "        xmem -N4096 -r -C0 -M0\n"
+        "\n"
+        "\n"
+        "Measure unloaded latency using the lfence-fenced rdtsc timer, and report the cost of each timer.\n"
+        "\n"
+        "        xmem -l -J rdtsc -v -C0 -M0\n"
+        "\n"
+        "\n"
+        "Measure sequential read throughput with hardware performance counters, to compare two hosts by IPC, cache misses and TLB misses.\n"
+        "\n"
+        "        xmem -t -s -R -o -j4 -w65536 -f counters.csv\n"
+        "\n"
+        "\n"
+        "Measure DRAM throughput and loaded latency with RAPL power sampled every 50 ms, to get the energy per GB moved and per access.\n"
+        "\n"
+        "        sudo xmem -t -l -j4 -w262144 --power_period=50 -f energy.csv\n"
+        "\n"
         "Have fun! =]\n"
         },
         { 0, 0, 0, 0, 0, 0 }
@@ -175,6 +318,14 @@ namespace xmem {
         bool runExtDelayInjectedLoadedLatencyBenchmark() const { return run_ext_delay_injected_loaded_latency_benchmark_; }
 #endif
 
+#ifdef EXT_MEMCPY_BENCHMARK
+        /**
+         * @brief If included at compile-time, determines whether the memcpy/memset benchmark extension should be run.
+         * @returns True if it should be run.
+         */
+        bool runExtMemcpyBenchmark() const { return run_ext_memcpy_benchmark_; }
+#endif
+
 #ifdef EXT_STREAM_BENCHMARK
         /**
          * @brief If included at compile-time, determines whether the STREAM-like benchmark extension should be run.
@@ -317,6 +468,42 @@ namespace xmem {
          */
         bool useLargePages() const { return use_large_pages_; }
 
+        /**
+         * @brief Gets the large page size to use when large pages are enabled.
+         * @returns The large page size in bytes.
+         */
+        size_t getLargePageSize() const { return large_page_size_; }
+
+        /**
+         * @brief Gets the policy for placing the memory under test across NUMA nodes.
+         * @returns The placement policy.
+         */
+        placement_policy_t getPlacementPolicy() const { return placement_policy_; }
+
+        /**
+         * @brief Gets the granularity of interleaved placement.
+         * @returns The number of contiguous bytes placed on one node before moving to the next. This is a multiple of the page size in use.
+         */
+        size_t getInterleaveGranularity() const { return interleave_granularity_; }
+
+        /**
+         * @brief Gets what backs the working sets under test.
+         * @returns The working set backing.
+         */
+        working_set_backing_t getWorkingSetBacking() const { return working_set_backing_; }
+
+        /**
+         * @brief Gets the directory to create the file backing the working sets in.
+         * @returns The directory. Only meaningful for BACKING_FILE.
+         */
+        std::string getBackingDirectory() const { return backing_directory_; }
+
+        /**
+         * @brief Indicates whether memfd and file working sets are mapped private instead of shared.
+         * @returns True for MAP_PRIVATE, false for MAP_SHARED.
+         */
+        bool useMapPrivate() const { return map_private_; }
+
         /**
          * @brief Determines whether reads should be used in throughput benchmarks.
          * @returns True if reads should be used.
@@ -406,6 +593,168 @@ namespace xmem {
         //TODOJ: wrong?
         uint8_t getMlp() const { return mlp_; }
 
+        /**
+         * @brief Gets the bandwidth each load thread should impose in loaded latency benchmarks.
+         * @returns The per-thread load rate in MB/s, or 0 if load threads should not be rate-limited.
+         */
+        uint32_t getLoadRatePerThread() const { return load_rate_per_thread_; }
+
+        /**
+         * @brief Indicates if the loaded latency curve mode has been selected.
+         * @returns True if the loaded latency curve should be measured.
+         */
+        bool latencyCurveSelected() const { return run_latency_curve_; }
+
+        /**
+         * @brief Gets the number of load levels to use in loaded latency curve mode.
+         * @returns The number of load levels.
+         */
+        uint32_t getLatencyCurveLevels() const { return latency_curve_levels_; }
+
+        /**
+         * @brief Gets the load intensity knob to step in loaded latency curve mode.
+         * @returns The knob.
+         */
+        curve_knob_t getLatencyCurveKnob() const { return latency_curve_knob_; }
+
+        /**
+         * @brief Indicates if the core-to-core latency mode has been selected.
+         * @returns True if the core-to-core cache line transfer latency matrix should be measured.
+         */
+        bool coreToCoreSelected() const { return run_core_to_core_; }
+
+        /**
+         * @brief Gets the logical CPU sampling stride to use in core-to-core latency mode.
+         * @returns The stride. 1 means every logical CPU in the selected CPU NUMA nodes is measured.
+         */
+        uint32_t getCoreToCoreCpuStride() const { return core_to_core_cpu_stride_; }
+
+        /**
+         * @brief Indicates if the coherence-state-aware latency mode has been selected.
+         * @returns True if coherence-state-aware latency should be measured.
+         */
+        bool coherenceLatencySelected() const { return run_coherence_latency_; }
+
+        /**
+         * @brief Gets the source coherence states to measure in coherence-state-aware latency mode.
+         * @returns The coherence states.
+         */
+        std::list<coherence_state_t> getCoherenceStates() const { return coherence_states_; }
+
+        /**
+         * @brief Indicates if the atomic operation mode has been selected.
+         * @returns True if atomic operation benchmarks should be run.
+         */
+        bool atomicsSelected() const { return run_atomics_; }
+
+        /**
+         * @brief Gets the largest number of shared cache lines to use in atomic operation mode.
+         * @returns The number of lines.
+         */
+        uint32_t getAtomicMaxLines() const { return atomic_max_lines_; }
+
+        /**
+         * @brief Gets the atomic operations to use in atomic operation mode.
+         * @returns The atomic operations.
+         */
+        std::list<atomic_op_t> getAtomicOps() const { return atomic_ops_; }
+
+        /**
+         * @brief Indicates if the gather/scatter mode has been selected.
+         * @returns True if gather/scatter benchmarks should be run.
+         */
+        bool gatherSelected() const { return run_gather_; }
+
+        /**
+         * @brief Indicates if the workload mix mode has been selected.
+         * @returns True if a heterogeneous workload mix should be run.
+         */
+        bool workloadSelected() const { return run_workload_; }
+
+        /**
+         * @brief Indicates if the page fault mode has been selected.
+         * @returns True if page fault and first-touch benchmarks should be run.
+         */
+        bool pageFaultsSelected() const { return run_page_faults_; }
+
+        /**
+         * @brief Indicates if the NUMA matrix mode has been selected.
+         * @returns True if latency and bandwidth should be measured between every pair of CPU and memory NUMA nodes.
+         */
+        bool numaMatrixSelected() const { return run_numa_matrix_; }
+
+        /**
+         * @brief Indicates if the all-to-all NUMA traffic mode has been selected.
+         * @returns True if every CPU NUMA node should drive traffic to local and remote memory NUMA nodes at the same time.
+         */
+        bool allToAllSelected() const { return run_all_to_all_; }
+
+        /**
+         * @brief Gets the share of threads per CPU NUMA node that use local memory in all-to-all NUMA traffic mode.
+         * @returns The share in percent.
+         */
+        uint32_t getAllToAllLocalPercent() const { return all_to_all_local_percent_; }
+
+        /**
+         * @brief Gets the per-thread specification of the all-to-all NUMA traffic mode. The latency probe is the last thread.
+         * @returns The specification of each worker thread.
+         */
+        std::vector<workload_thread_t> getAllToAllWorkload() const { return all_to_all_workload_; }
+
+        /**
+         * @brief Indicates if the transparent huge page comparison mode has been selected.
+         * @returns True if latency and bandwidth should be compared across THP policies.
+         */
+        bool thpCompareSelected() const { return run_thp_compare_; }
+
+        /**
+         * @brief Gets how long khugepaged collapse is observed in THP comparison mode.
+         * @returns The duration in seconds, or 0 if collapse is not measured.
+         */
+        uint32_t getThpCollapseSeconds() const { return thp_collapse_seconds_; }
+
+        /**
+         * @brief Indicates if the page migration mode has been selected.
+         * @returns True if page migration throughput between memory NUMA nodes should be measured.
+         */
+        bool migrationSelected() const { return run_migration_; }
+
+        /**
+         * @brief Indicates if the TLB reach mode has been selected.
+         * @returns True if latency should be measured over a growing number of pages with one cache line touched per page.
+         */
+        bool tlbReachSelected() const { return run_tlb_reach_; }
+
+        /**
+         * @brief Gets the largest region to map for each page size in TLB reach mode.
+         * @returns The size in bytes.
+         */
+        size_t getTlbReachMaxRegionSize() const { return tlb_reach_max_region_size_; }
+
+        /**
+         * @brief Indicates if hardware performance counters were requested.
+         * @returns True if the results file should have a column per counter.
+         */
+        bool perfCountersSelected() const { return perf_counters_; }
+
+        /**
+         * @brief Gets the powercap sysfs directory to read RAPL energy counters from.
+         * @returns The directory.
+         */
+        std::string getRaplRoot() const { return rapl_root_; }
+
+        /**
+         * @brief Gets the power sampling period.
+         * @returns The period in milliseconds.
+         */
+        uint32_t getPowerSamplingPeriod() const { return power_sampling_period_; }
+
+        /**
+         * @brief Gets the per-thread specification of the workload mix.
+         * @returns One entry per worker thread, in the order the groups were given on the command line.
+         */
+        std::vector<workload_thread_t> getWorkload() const { return workload_; }
+
     private:
         /**
          * @brief Inspects a command line option (switch) to see if it occurred more than once, and warns the user if this is the case. The program only uses the first occurrence of any switch.
@@ -414,18 +763,59 @@ namespace xmem {
          */
         bool check_single_option_occurrence(Option* opt) const;
 
+        /**
+         * @brief Parses one workload mix group of the form <count>:<kind>[:key=value]... and appends one entry per thread to the workload. Errors are reported to the console.
+         * @param spec The group as given on the command line.
+         * @returns True on success.
+         */
+        bool parse_workload_group(const std::string& spec);
+
+        /**
+         * @brief Builds the per-thread specification of the all-to-all NUMA traffic mode from the selected NUMA nodes, number of worker threads, working set size and load traffic options.
+         */
+        void build_all_to_all_workload();
+
         bool configured_; /**< If true, this object has been configured. configureFromInput() will only work if this is false. */
 
         bool run_extensions_; /**< If true, run extensions. */
 #ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
         bool run_ext_delay_injected_loaded_latency_benchmark_; /**< If true, then run the delay-injected loaded latency benchmark extension. */
 #endif
+#ifdef EXT_MEMCPY_BENCHMARK
+        bool run_ext_memcpy_benchmark_; /**< If true, then run the memcpy/memset benchmark extension. */
+#endif
 #ifdef EXT_STREAM_BENCHMARK
         bool run_ext_stream_benchmark_; /**< If true, then run the STREAM-like benchmark extension. */
 #endif
 
         bool run_latency_; /**< True if latency tests should be run. */
         bool run_throughput_; /**< True if throughput tests should be run. */
+        bool run_latency_curve_; /**< True if the loaded latency curve should be measured. */
+        uint32_t latency_curve_levels_; /**< Number of load levels in loaded latency curve mode when stepping the rate knob. */
+        curve_knob_t latency_curve_knob_; /**< Load intensity knob to step in loaded latency curve mode. */
+        bool run_core_to_core_; /**< True if the core-to-core cache line transfer latency matrix should be measured. */
+        uint32_t core_to_core_cpu_stride_; /**< Logical CPU sampling stride in core-to-core latency mode. */
+        bool run_coherence_latency_; /**< True if coherence-state-aware latency should be measured. */
+        std::list<coherence_state_t> coherence_states_; /**< Source coherence states to measure in coherence-state-aware latency mode. */
+        bool run_atomics_; /**< True if atomic operation benchmarks should be run. */
+        uint32_t atomic_max_lines_; /**< Largest number of shared cache lines in atomic operation mode. */
+        std::list<atomic_op_t> atomic_ops_; /**< Atomic operations to use in atomic operation mode. */
+        bool run_gather_; /**< True if gather/scatter benchmarks should be run. */
+        bool run_workload_; /**< True if a heterogeneous workload mix should be run. */
+        std::vector<workload_thread_t> workload_; /**< Per-thread specification of the workload mix. */
+        bool run_page_faults_; /**< True if page fault and first-touch benchmarks should be run. */
+        bool run_numa_matrix_; /**< True if latency and bandwidth should be measured between every pair of CPU and memory NUMA nodes. */
+        bool run_all_to_all_; /**< True if every CPU NUMA node should drive traffic to local and remote memory NUMA nodes at the same time. */
+        uint32_t all_to_all_local_percent_; /**< Share of threads per CPU NUMA node that use local memory in all-to-all NUMA traffic mode, in percent. */
+        std::vector<workload_thread_t> all_to_all_workload_; /**< Per-thread specification of the all-to-all NUMA traffic mode. */
+        bool run_thp_compare_; /**< True if latency and bandwidth should be compared across transparent huge page policies. */
+        uint32_t thp_collapse_seconds_; /**< How long khugepaged collapse is observed in THP comparison mode in seconds, or 0 to not measure it. */
+        bool run_migration_; /**< True if page migration throughput between memory NUMA nodes should be measured. */
+        bool run_tlb_reach_; /**< True if latency should be measured over a growing number of pages with one cache line touched per page. */
+        size_t tlb_reach_max_region_size_; /**< Largest region in bytes to map for each page size in TLB reach mode. */
+        bool perf_counters_; /**< True if hardware performance counters were requested. */
+        std::string rapl_root_; /**< Powercap sysfs directory to read RAPL energy counters from. */
+        uint32_t power_sampling_period_; /**< Power sampling period in milliseconds. */
         size_t working_set_size_per_thread_; /**< Working set size in bytes for each thread, if applicable. */
         uint32_t num_worker_threads_; /**< Number of load threads to use for throughput benchmarks, loaded latency benchmarks, and stress tests. */
         bool use_chunk_32b_; /**< If true, use chunk sizes of 32-bits where applicable. */
@@ -452,6 +842,12 @@ namespace xmem {
         bool use_output_file_; /**< If true, generate a CSV output file for results. */
         bool verbose_; /**< If true, then console reporting should be more detailed. */
         bool use_large_pages_; /**< If true, then large pages should be used. */
+        size_t large_page_size_; /**< Large page size in bytes to use if large pages are enabled. */
+        placement_policy_t placement_policy_; /**< Policy for placing the memory under test across NUMA nodes. */
+        size_t interleave_granularity_; /**< Granularity in bytes of interleaved placement. */
+        working_set_backing_t working_set_backing_; /**< What backs the working sets under test. */
+        std::string backing_directory_; /**< Directory to create the file backing the working sets in. */
+        bool map_private_; /**< If true, memfd and file working sets are mapped with MAP_PRIVATE. */
         bool use_reads_; /**< If true, throughput benchmarks should use reads. */
         bool use_writes_; /**< If true, throughput benchmarks should use writes. */
         bool use_stride_p1_; /**< If true, use a stride of +1 in relevant benchmarks. */
@@ -472,6 +868,7 @@ namespace xmem {
         bool use_mlp_16_; /**< If true, use an MLP of 16 in relevant benchmarks. */
         bool use_mlp_32_; /**< If true, use an MLP of 32 in relevant benchmarks. */
         uint8_t mlp_;
+        uint32_t load_rate_per_thread_; /**< Bandwidth in MB/s that each load thread should impose in loaded latency benchmarks. If 0, no rate limiting is done. */
     };
 };
 
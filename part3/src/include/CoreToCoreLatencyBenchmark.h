@@ -0,0 +1,122 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the CoreToCoreLatencyBenchmark class.
+ */
+
+#ifndef CORE_TO_CORE_LATENCY_BENCHMARK_H
+#define CORE_TO_CORE_LATENCY_BENCHMARK_H
+
+//Headers
+#include <Benchmark.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+
+    /**
+     * @brief A type of benchmark that measures cache-to-cache transfer latency between every ordered pair of a set of logical CPUs by bouncing a single cache line between them.
+     *
+     * The per-iteration metric is the mean one-way transfer latency over all measured pairs. The full matrix is kept separately.
+     */
+    class CoreToCoreLatencyBenchmark : public Benchmark {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param mem_array Memory holding the cache line to bounce. Its NUMA node is the home node of the line.
+         * @param len Length of mem_array in bytes. Must be at least one page.
+         * @param iterations Number of iterations over the complete matrix.
+         * @param mem_node The memory NUMA node that mem_array belongs to.
+         * @param cpus Logical CPU IDs to measure between.
+         * @param cpu_nodes NUMA node of each logical CPU in cpus.
+         * @param dram_power_readers A group of PowerReader objects for measuring DRAM power.
+         * @param name The name of the benchmark to use when reporting to console.
+         */
+        CoreToCoreLatencyBenchmark(
+            void* mem_array,
+            size_t len,
+            uint32_t iterations,
+            uint32_t mem_node,
+            std::vector<int32_t> cpus,
+            std::vector<uint32_t> cpu_nodes,
+            std::vector<PowerReader*> dram_power_readers,
+            std::string name
+        );
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~CoreToCoreLatencyBenchmark() {}
+
+        /**
+         * @brief Reports benchmark configuration details to the console.
+         */
+        virtual void reportBenchmarkInfo() const;
+
+        /**
+         * @brief Reports results to the console.
+         */
+        virtual void reportResults() const;
+
+        /**
+         * @brief Gets the logical CPU IDs that were measured, in matrix order.
+         * @returns The logical CPU IDs.
+         */
+        std::vector<int32_t> getCpus() const { return cpus_; }
+
+        /**
+         * @brief Gets the NUMA node of each measured logical CPU, in matrix order.
+         * @returns The NUMA node IDs.
+         */
+        std::vector<uint32_t> getCpuNodes() const { return cpu_nodes_; }
+
+        /**
+         * @brief Gets the mean one-way transfer latency from one measured CPU to another.
+         * @param from Index into getCpus() of the CPU that starts each round trip.
+         * @param to Index into getCpus() of the CPU that answers.
+         * @returns The mean one-way latency in ns, or -1 if the benchmark has not run or the indices are invalid.
+         */
+        double getTransferLatency(uint32_t from, uint32_t to) const;
+
+    protected:
+        virtual bool runCore();
+        virtual std::vector<int32_t> workerCpus() const;
+
+    private:
+        std::vector<int32_t> cpus_; /**< Logical CPUs to measure between. */
+        std::vector<uint32_t> cpu_nodes_; /**< NUMA node of each logical CPU in cpus_. */
+        std::vector<std::vector<double> > transfer_latency_; /**< Mean one-way transfer latency in ns, indexed [from][to]. The diagonal is unused. */
+    };
+};
+
+#endif
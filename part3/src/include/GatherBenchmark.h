@@ -0,0 +1,130 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the GatherBenchmark class.
+ */
+
+#ifndef GATHER_BENCHMARK_H
+#define GATHER_BENCHMARK_H
+
+//Headers
+#include <Benchmark.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+
+    /**
+     * @brief A type of benchmark that measures random-access throughput when many independent lookups are in flight, as in vectorized hash probes and embedding lookups. Each worker thread gathers from or scatters to its own table with precomputed random indices.
+     *
+     * The per-iteration metric is the aggregate effective throughput in MB/s, counting only the 64-bit elements gathered or scattered. The element rate is kept separately.
+     */
+    class GatherBenchmark : public Benchmark {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param mem_array A pointer to a contiguous chunk of memory holding one table per worker thread.
+         * @param len Length of the memory region in bytes. Each worker thread gets len / num_worker_threads bytes.
+         * @param iterations Number of iterations of the complete benchmark. Used to gather more statistics.
+         * @param num_worker_threads The number of worker threads.
+         * @param mem_node The memory NUMA node that mem_array belongs to.
+         * @param cpu_node The CPU NUMA node of the worker threads.
+         * @param rw_mode READ to gather, WRITE to scatter.
+         * @param gather_kernel The instruction flavor.
+         * @param dram_power_readers A group of PowerReader objects for measuring DRAM power.
+         * @param name The name of the benchmark to use when reporting to console.
+         */
+        GatherBenchmark(
+            void* mem_array,
+            size_t len,
+            uint32_t iterations,
+            uint32_t num_worker_threads,
+            uint32_t mem_node,
+            uint32_t cpu_node,
+            rw_mode_t rw_mode,
+            gather_kernel_t gather_kernel,
+            std::vector<PowerReader*> dram_power_readers,
+            std::string name
+        );
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~GatherBenchmark() {}
+
+        /**
+         * @brief Reports benchmark configuration details to the console.
+         */
+        virtual void reportBenchmarkInfo() const;
+
+        /**
+         * @brief Reports results to the console.
+         */
+        virtual void reportResults() const;
+
+        /**
+         * @brief Gets the instruction flavor.
+         * @returns The gather kernel.
+         */
+        gather_kernel_t getGatherKernel() const { return gather_kernel_; }
+
+        /**
+         * @brief Gets the mean aggregate element rate over all iterations.
+         * @returns Millions of 64-bit elements gathered or scattered per second, or -1 if the benchmark has not run.
+         */
+        double getMeanElementRate() const;
+
+        /**
+         * @brief Gets a short name for a gather kernel.
+         * @param gather_kernel The instruction flavor.
+         * @returns The name.
+         */
+        static std::string gatherKernelName(gather_kernel_t gather_kernel);
+
+        /**
+         * @brief Gets the number of 64-bit elements one instruction of a gather kernel accesses.
+         * @param gather_kernel The instruction flavor.
+         * @returns The number of lanes.
+         */
+        static uint32_t gatherKernelLanes(gather_kernel_t gather_kernel);
+
+    protected:
+        virtual bool runCore();
+
+    private:
+        gather_kernel_t gather_kernel_; /**< The instruction flavor. */
+        std::vector<double> element_rate_on_iter_; /**< Aggregate millions of elements per second for each iteration. */
+    };
+};
+
+#endif
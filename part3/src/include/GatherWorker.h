@@ -0,0 +1,86 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the GatherWorker class.
+ */
+
+#ifndef GATHER_WORKER_H
+#define GATHER_WORKER_H
+
+//Headers
+#include <MemoryWorker.h>
+#include <benchmark_kernels.h>
+#include <common.h>
+
+namespace xmem {
+    /**
+     * @brief Multithreading-friendly class to gather from or scatter to a table of 64-bit elements using precomputed, independent random indices.
+     *
+     * The index array is built by the worker thread after it is pinned, so it lands on the worker's local NUMA node. One pass visits every index once. One untimed pass warms up the table first, so tables that fit in a cache are measured out of that cache.
+     */
+    class GatherWorker : public MemoryWorker {
+        public:
+
+            /**
+             * @brief Constructor.
+             * @param mem_array Pointer to the table.
+             * @param len Length of the table in bytes. Only whole 64-bit elements are used, and at most GATHER_BENCHMARK_MAX_ELEMENTS of them.
+             * @param kernel_fptr The gather or scatter kernel.
+             * @param cpu_affinity Logical CPU identifier to lock this worker's thread to.
+             */
+            GatherWorker(
+                void* mem_array,
+                size_t len,
+                GatherFunction kernel_fptr,
+                int32_t cpu_affinity
+            );
+
+            /**
+             * @brief Destructor.
+             */
+            virtual ~GatherWorker();
+
+            /**
+             * @brief Thread-safe worker method.
+             */
+            virtual void run();
+
+            /**
+             * @brief Gets the number of table elements accessed per pass.
+             * @returns The number of elements.
+             */
+            size_t getElementsPerPass();
+
+        private:
+            // ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
+            GatherFunction kernel_fptr_; /**< The gather or scatter kernel. */
+            size_t elements_per_pass_; /**< Number of table elements accessed per pass. */
+    };
+};
+
+#endif
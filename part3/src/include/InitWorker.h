@@ -0,0 +1,85 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the InitWorker class.
+ */
+
+#ifndef INIT_WORKER_H
+#define INIT_WORKER_H
+
+//Headers
+#include <MemoryWorker.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <vector>
+
+namespace xmem {
+    /**
+     * @brief Multithreading-friendly class to initialize a worker thread's memory before benchmarking.
+     *
+     * The worker writes its whole region from the logical CPU that will later run the benchmark kernel on it, so pages are faulted in in parallel and by the thread that uses them, as first-touch allocation would place them.
+     */
+    class InitWorker : public MemoryWorker {
+        public:
+
+            /**
+             * @brief Constructor.
+             * @param mem_array Start of the region to initialize.
+             * @param len Length of the region in bytes.
+             * @param cpu_affinity Logical CPU identifier to lock this worker's thread to. If negative, the thread is not locked.
+             */
+            InitWorker(
+                void* mem_array,
+                size_t len,
+                int32_t cpu_affinity
+            );
+
+            /**
+             * @brief Destructor.
+             */
+            virtual ~InitWorker();
+
+            /**
+             * @brief Thread-safe worker method.
+             */
+            virtual void run();
+
+            /**
+             * @brief Initializes a set of regions in parallel, one thread per region, and waits for all of them.
+             * @param regions Start of each region.
+             * @param lens Length of each region in bytes.
+             * @param cpu_ids Logical CPU to initialize each region on. Negative entries leave the thread unlocked.
+             * @returns True if every region was initialized on its logical CPU.
+             */
+            static bool initializeRegions(const std::vector<void*>& regions, const std::vector<size_t>& lens, const std::vector<int32_t>& cpu_ids);
+    };
+};
+
+#endif
@@ -49,7 +49,8 @@ namespace xmem {
     public:
 
         /**
-         * @brief Constructor. Parameters are passed directly to the Benchmark constructor. See Benchmark class documentation for parameter semantics.
+         * @brief Constructor. Parameters other than load_rate are passed directly to the Benchmark constructor. See Benchmark class documentation for parameter semantics.
+         * @param load_rate Bandwidth in MB/s that each load thread should impose using open-loop rate limiting. If 0, load threads run as fast as possible.
          */
         LatencyBenchmark(
             void* mem_array,
@@ -63,6 +64,7 @@ namespace xmem {
             chunk_size_t chunk_size,
             int32_t stride_size,
             uint8_t mlp,
+            double load_rate,
             std::vector<PowerReader*> dram_power_readers,
             std::string name
         );
@@ -85,6 +87,30 @@ namespace xmem {
          */
         double getMeanLoadMetric() const;
 
+        /**
+         * @brief Gets the aggregate load throughput in MB/sec that the load threads were asked to impose.
+         * @returns The requested throughput in MB/sec, or 0 if the load threads are not rate-limited.
+         */
+        double getTargetLoadMetric() const;
+
+        /**
+         * @brief Gets the bandwidth in MB/sec that each load thread was asked to impose.
+         * @returns The requested per-thread throughput in MB/sec, or 0 if the load threads are not rate-limited.
+         */
+        double getLoadRatePerThread() const { return load_rate_per_thread_; }
+
+        /**
+         * @brief Gets the energy used per access of the latency measurement thread, i.e., the mean power over the measurement times the mean latency. With load threads, this includes the energy of their traffic over the same time.
+         * @returns The energy in nJ/access for a given power reader, or 0 if it does not exist.
+         */
+        virtual double getEnergyEfficiency(uint32_t socket_id) const;
+
+        /**
+         * @brief Gets the units of getEnergyEfficiency().
+         * @returns "nJ/access".
+         */
+        virtual std::string getEnergyEfficiencyUnits() const;
+
         /**
          * @brief Reports benchmark configuration details to the console.
          */
@@ -100,6 +126,7 @@ namespace xmem {
 
         std::vector<double> load_metric_on_iter_; /**< Load metrics for each iteration of the benchmark. This is in MB/s. */
         double mean_load_metric_; /**< The average load throughput in MB/sec that was imposed on the latency measurement. */
+        double load_rate_per_thread_; /**< Bandwidth in MB/sec that each load thread should impose. If 0, load threads are not rate-limited. */
     };
 };
 
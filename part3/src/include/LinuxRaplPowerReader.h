@@ -0,0 +1,105 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the LinuxRaplPowerReader class.
+ */
+
+#ifndef LINUX_RAPL_POWER_READER_H
+#define LINUX_RAPL_POWER_READER_H
+
+#ifdef __gnu_linux__
+
+//Headers
+#include <common.h>
+#include <PowerReader.h>
+#include <Runnable.h>
+
+//Libraries
+#include <cstdint>
+#include <vector>
+#include <string>
+
+namespace xmem {
+    /**
+     * @brief A class for measuring socket-level power from the energy counters of a RAPL domain, read through the Linux powercap sysfs interface.
+     * Power samples are derived from the energy consumed between consecutive reads, so they are mean power over each sampling period rather than instantaneous readings.
+     */
+    class LinuxRaplPowerReader : public PowerReader {
+    public:
+        /**
+         * @brief Constructor. Checks that the energy counter of the zone can be read, which usually requires root.
+         * @param zone_path The powercap zone directory of the RAPL domain, e.g., /sys/class/powercap/intel-rapl:0:1.
+         * @param sampling_period The time between power samples in milliseconds.
+         * @param name The human-friendly name of this object.
+         * @param cpu_affinity The CPU affinity for this object's run() method for any thread that calls it. If negative, no affinity preference.
+         */
+        LinuxRaplPowerReader(std::string zone_path, uint32_t sampling_period, std::string name, int32_t cpu_affinity);
+
+        /**
+         * @brief Destructor.
+         */
+        ~LinuxRaplPowerReader();
+
+        /**
+         * @brief Starts measuring power at the rate implied by the sampling_period passed in the constructor. Terminates when stop() is called.
+         */
+        virtual void run();
+
+        /**
+         * @brief Indicates if the energy counter of the zone could be read when this object was constructed.
+         * @returns True if power can be measured.
+         */
+        bool isValid();
+
+        /**
+         * @brief Finds the powercap zone of a RAPL domain of one physical package.
+         * Package zones are named package-<id> and sit directly under the root as intel-rapl:<n>. Their DRAM, core and uncore subzones sit under them as intel-rapl:<n>:<m>.
+         * @param sysfs_root The powercap sysfs directory, normally /sys/class/powercap. Another directory with the same layout may be used for testing.
+         * @param package The physical package ID.
+         * @param domain The domain name: "package" for the whole package, or the name of a subzone such as "dram".
+         * @returns The zone directory, or an empty string if the domain does not exist.
+         */
+        static std::string findZone(std::string sysfs_root, uint32_t package, std::string domain);
+
+    private:
+        /**
+         * @brief Reads the energy counter of the zone.
+         * @param energy_uj Set to the counter value in microjoules on success.
+         * @returns True on success.
+         */
+        bool readEnergy(uint64_t& energy_uj) const;
+
+        std::string zone_path_; /**< The powercap zone directory. */
+        uint64_t max_energy_range_uj_; /**< Value at which the energy counter wraps around to zero, in microjoules. 0 if unknown. */
+        bool valid_; /**< True if the energy counter could be read. */
+    };
+};
+
+#endif
+
+#endif
@@ -50,6 +50,7 @@ namespace xmem {
              * @param kernel_fptr Pointer to the sequential core benchmark kernel to use.
              * @param kernel_dummy_fptr Pointer to the sequential dummy version of the core benchmark kernel to use.
              * @param cpu_affinity Logical CPU identifier to lock this worker's thread to.
+             * @param target_rate Bandwidth in MB/s that this worker should impose. If 0, the worker runs as fast as possible.
              */
             LoadWorker(
                 void* mem_array,
@@ -57,7 +58,8 @@ namespace xmem {
                 uint8_t mlp,
                 SequentialFunction kernel_fptr,
                 SequentialFunction kernel_dummy_fptr,
-                int32_t cpu_affinity
+                int32_t cpu_affinity,
+                double target_rate
             );
 
             /**
@@ -67,6 +69,7 @@ namespace xmem {
              * @param kernel_fptr Pointer to the random core benchmark kernel to use.
              * @param kernel_dummy_fptr Pointer to the random dummy version of the core benchmark kernel to use.
              * @param cpu_affinity Logical CPU identifier to lock this worker's thread to.
+             * @param target_rate Bandwidth in MB/s that this worker should impose. If 0, the worker runs as fast as possible.
              */
             LoadWorker(
                 void* mem_array,
@@ -74,7 +77,8 @@ namespace xmem {
                 uint8_t mlp,
                 RandomFunction kernel_fptr,
                 RandomFunction kernel_dummy_fptr,
-                int32_t cpu_affinity
+                int32_t cpu_affinity,
+                double target_rate
             );
 
             /**
@@ -87,14 +91,20 @@ namespace xmem {
              */
             virtual void run();
 
+            /**
+             * @brief Gets the bandwidth this worker was asked to impose.
+             * @returns The target rate in MB/s, or 0 if the worker is not rate-limited.
+             */
+            double getTargetRate();
+
         private:
             // ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
-            uint8_t mlp_; //TODOJ: ?
             bool use_sequential_kernel_fptr_; /**< If true, use the SequentialFunction, otherwise use the RandomFunction. */
             SequentialFunction kernel_fptr_seq_; /**< Points to the memory test core routine to use of the "sequential" type. */
             SequentialFunction kernel_dummy_fptr_seq_; /**< Points to a dummy version of the memory test core routine to use of the "sequential" type. */
             RandomFunction kernel_fptr_ran_; /**< Points to the memory test core routine to use of the "random" type. */
             RandomFunction kernel_dummy_fptr_ran_; /**< Points to a dummy version of the memory test core routine to use of the "random" type. */
+            double target_rate_; /**< Bandwidth in MB/s to impose using a token bucket. If 0, no rate limiting is done. */
     };
 };
 
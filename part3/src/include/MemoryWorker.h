@@ -113,6 +113,12 @@ namespace xmem {
              */
             bool hadWarning();
 
+            /**
+             * @brief Gets the hardware performance counters collected over this worker's timed passes.
+             * @returns The counts. All counters are invalid if collection was not enabled or not possible.
+             */
+            perf_counts_t getPerfCounts();
+
         protected:
             // ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
             void* mem_array_; /**< The memory region for this worker. */
@@ -126,6 +132,7 @@ namespace xmem {
             tick_t adjusted_ticks_; /**< Elapsed ticks minus dummy elapsed ticks. */
             bool warning_; /**< If true, results may be suspect. */
             bool completed_; /**< If true, worker completed. */
+            perf_counts_t perf_counts_; /**< Hardware performance counters over the timed passes. */
     };
 };
 
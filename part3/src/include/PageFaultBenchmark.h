@@ -0,0 +1,157 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the PageFaultBenchmark class.
+ */
+
+#ifndef PAGE_FAULT_BENCHMARK_H
+#define PAGE_FAULT_BENCHMARK_H
+
+//Headers
+#include <Benchmark.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+
+    /**
+     * @brief A type of benchmark that measures the cost of first touch on freshly mapped memory, which dominates the cold start of many services. Every iteration maps a new region, faults it in, and unmaps it again, so nothing is primed.
+     *
+     * The per-iteration metric is the aggregate first-touch throughput in MB/s over the whole region. The number of page faults taken is read from the process resource usage, so the fault rate reflects the page size the kernel actually used.
+     */
+    class PageFaultBenchmark : public Benchmark {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param len Length of the region to map and fault in every iteration, in bytes. Must be a multiple of the backing page size.
+         * @param iterations Number of iterations of the complete benchmark. Used to gather more statistics.
+         * @param num_worker_threads Number of threads that fault in the region in parallel, each taking an equal share. Must be 1 with FAULT_POPULATE, as the kernel populates the region on the mapping thread.
+         * @param mem_node The memory NUMA node that faulted-in pages should land on.
+         * @param cpu_node The CPU NUMA node of the worker threads.
+         * @param backing Kind of pages to back the region with.
+         * @param use_memfd If true, map a memfd with MAP_SHARED instead of private anonymous memory.
+         * @param fault_mode How the region is faulted in.
+         * @param large_page_size Size of transparent or explicit huge pages in bytes.
+         * @param dram_power_readers A group of PowerReader objects for measuring DRAM power.
+         * @param name The name of the benchmark to use when reporting to console.
+         */
+        PageFaultBenchmark(
+            size_t len,
+            uint32_t iterations,
+            uint32_t num_worker_threads,
+            uint32_t mem_node,
+            uint32_t cpu_node,
+            page_backing_t backing,
+            bool use_memfd,
+            fault_mode_t fault_mode,
+            size_t large_page_size,
+            std::vector<PowerReader*> dram_power_readers,
+            std::string name
+        );
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~PageFaultBenchmark() {}
+
+        /**
+         * @brief Reports benchmark configuration details to the console.
+         */
+        virtual void reportBenchmarkInfo() const;
+
+        /**
+         * @brief Reports results to the console.
+         */
+        virtual void reportResults() const;
+
+        /**
+         * @brief Gets the kind of pages backing the region.
+         * @returns The page backing.
+         */
+        page_backing_t getPageBacking() const { return backing_; }
+
+        /**
+         * @brief Indicates whether the region is a memfd mapping.
+         * @returns True for a memfd, false for private anonymous memory.
+         */
+        bool usesMemfd() const { return use_memfd_; }
+
+        /**
+         * @brief Gets how the region is faulted in.
+         * @returns The fault mode.
+         */
+        fault_mode_t getFaultMode() const { return fault_mode_; }
+
+        /**
+         * @brief Gets the mean page fault rate over all iterations.
+         * @returns Page faults per second, or -1 if the benchmark has not run.
+         */
+        double getMeanFaultRate() const;
+
+        /**
+         * @brief Gets the mean number of page faults taken per iteration.
+         * @returns The number of page faults, or -1 if the benchmark has not run.
+         */
+        double getMeanFaults() const;
+
+        /**
+         * @brief Gets a short description of a page fault benchmark setting, e.g. "thp anon cow".
+         * @param backing Kind of pages.
+         * @param use_memfd True for a memfd mapping.
+         * @param fault_mode How the memory is faulted in.
+         * @returns The description.
+         */
+        static std::string settingName(page_backing_t backing, bool use_memfd, fault_mode_t fault_mode);
+
+    protected:
+        virtual bool runCore();
+
+    private:
+        /**
+         * @brief Runs one page fault worker per thread over equal shares of a region and waits for them.
+         * @param region Start of the region.
+         * @param iterwarning Set to true if any worker had a warning.
+         * @returns The longest time any worker took, in ticks.
+         */
+        tick_t touchRegion(void* region, bool& iterwarning);
+
+        page_backing_t backing_; /**< Kind of pages backing the region. */
+        bool use_memfd_; /**< If true, the region is a memfd mapping. */
+        fault_mode_t fault_mode_; /**< How the region is faulted in. */
+        size_t large_page_size_; /**< Size of transparent or explicit huge pages in bytes. */
+        std::vector<double> fault_rate_on_iter_; /**< Page faults per second for each iteration. */
+        std::vector<double> faults_on_iter_; /**< Page faults taken in each iteration. */
+    };
+};
+
+#endif
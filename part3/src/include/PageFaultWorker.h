@@ -0,0 +1,133 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the PageFaultWorker class.
+ */
+
+#ifndef PAGE_FAULT_WORKER_H
+#define PAGE_FAULT_WORKER_H
+
+//Headers
+#include <MemoryWorker.h>
+#include <common.h>
+
+namespace xmem {
+    /**
+     * @brief Multithreading-friendly class to fault in freshly mapped memory and time it.
+     *
+     * A worker either writes once to every page of a region that was mapped without populating it, or maps and populates a new region itself. Either way, the memory policy of the worker's thread is bound to the memory node under test, so the pages it faults in land there.
+     */
+    class PageFaultWorker : public MemoryWorker {
+        public:
+
+            /**
+             * @brief Constructor for a worker that faults in an existing mapping by writing to it.
+             * @param mem_array Start of this worker's part of the mapping. Must be aligned to the backing page size.
+             * @param len Length of this worker's part of the mapping in bytes.
+             * @param mem_node Memory NUMA node that faulted-in pages should land on.
+             * @param cpu_affinity Logical CPU identifier to lock this worker's thread to.
+             */
+            PageFaultWorker(
+                void* mem_array,
+                size_t len,
+                uint32_t mem_node,
+                int32_t cpu_affinity
+            );
+
+            /**
+             * @brief Constructor for a worker that maps and populates a new region in one go.
+             * @param backing Kind of pages to back the region with.
+             * @param use_memfd If true, map a memfd instead of anonymous memory.
+             * @param len Length of the region to map in bytes. Must be a multiple of the backing page size.
+             * @param large_page_size Size of transparent or explicit huge pages in bytes.
+             * @param mem_node Memory NUMA node that faulted-in pages should land on.
+             * @param cpu_affinity Logical CPU identifier to lock this worker's thread to.
+             */
+            PageFaultWorker(
+                page_backing_t backing,
+                bool use_memfd,
+                size_t len,
+                size_t large_page_size,
+                uint32_t mem_node,
+                int32_t cpu_affinity
+            );
+
+            /**
+             * @brief Destructor. This does not unmap anything.
+             */
+            virtual ~PageFaultWorker();
+
+            /**
+             * @brief Thread-safe worker method.
+             */
+            virtual void run();
+
+            /**
+             * @brief Gets the region mapped by a populating worker.
+             * @returns Start of the region, or nullptr if the worker has not run or mapping failed.
+             */
+            void* getRegion();
+
+            /**
+             * @brief Gets the memfd backing the region mapped by a populating worker.
+             * @returns The file descriptor, or -1 if the region is anonymous memory.
+             */
+            int getFd();
+
+            /**
+             * @brief Maps a new region of memory.
+             * @param backing Kind of pages to back the region with. Transparent huge page regions are aligned to the huge page size.
+             * @param use_memfd If true, map a memfd with MAP_SHARED. Otherwise, map private anonymous memory.
+             * @param len Length of the region in bytes. Must be a multiple of the backing page size.
+             * @param large_page_size Size of transparent or explicit huge pages in bytes.
+             * @param populate If true, fault the whole region in before returning.
+             * @param fd Set to the memfd, or -1 for anonymous memory.
+             * @returns Start of the region, or nullptr on failure.
+             */
+            static void* mapRegion(page_backing_t backing, bool use_memfd, size_t len, size_t large_page_size, bool populate, int& fd);
+
+            /**
+             * @brief Unmaps a region created by mapRegion() and closes its memfd, if any.
+             * @param region Start of the region.
+             * @param len Length of the region in bytes.
+             * @param fd The memfd, or -1 for anonymous memory.
+             */
+            static void unmapRegion(void* region, size_t len, int fd);
+
+        private:
+            // ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
+            bool populate_; /**< If true, this worker maps and populates a new region. Otherwise, it writes to an existing one. */
+            page_backing_t backing_; /**< Kind of pages to back a new region with. */
+            bool use_memfd_; /**< If true, a new region is a memfd mapping. */
+            size_t large_page_size_; /**< Size of transparent or explicit huge pages in bytes. */
+            uint32_t mem_node_; /**< Memory NUMA node that faulted-in pages should land on. */
+            int fd_; /**< The memfd backing a new region, or -1. */
+    };
+};
+
+#endif
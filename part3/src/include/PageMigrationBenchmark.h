@@ -0,0 +1,173 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the PageMigrationBenchmark class.
+ */
+
+#ifndef PAGE_MIGRATION_BENCHMARK_H
+#define PAGE_MIGRATION_BENCHMARK_H
+
+//Headers
+#include <Benchmark.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+
+    /**
+     * @brief A type of benchmark that measures how fast the kernel migrates pages between NUMA nodes with move_pages(), as automatic NUMA balancing and memory tiering daemons do, and what access latency a concurrent reader of the migrating memory sees meanwhile.
+     *
+     * Every iteration maps a new region and faults it in on the source node. A latency thread first chases pointers through the start of the region while nothing moves, for a baseline. Then it runs again while the region is migrated to the destination node and back over and over for the same duration. Only migrations towards the destination node are timed, so the per-iteration metric is the source-to-destination migration throughput in MB/s.
+     */
+    class PageMigrationBenchmark : public Benchmark {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param len Length of the region to migrate in bytes. Must be a multiple of the backing page size.
+         * @param probe_len Length of the part at the start of the region that the latency thread chases pointers through, in bytes.
+         * @param iterations Number of iterations of the complete benchmark. Used to gather more statistics.
+         * @param src_node The memory NUMA node that pages are faulted in on and migrated away from.
+         * @param dst_node The memory NUMA node that pages are migrated to.
+         * @param cpu_node The CPU NUMA node of the latency thread and the migrating thread.
+         * @param backing Kind of pages to back the region with.
+         * @param large_page_size Size of explicit huge pages in bytes. Transparent huge pages are always of the PMD size in g_thp_page_size.
+         * @param dram_power_readers A group of PowerReader objects for measuring DRAM power.
+         * @param name The name of the benchmark to use when reporting to console.
+         */
+        PageMigrationBenchmark(
+            size_t len,
+            size_t probe_len,
+            uint32_t iterations,
+            uint32_t src_node,
+            uint32_t dst_node,
+            uint32_t cpu_node,
+            page_backing_t backing,
+            size_t large_page_size,
+            std::vector<PowerReader*> dram_power_readers,
+            std::string name
+        );
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~PageMigrationBenchmark() {}
+
+        /**
+         * @brief Reports benchmark configuration details to the console.
+         */
+        virtual void reportBenchmarkInfo() const;
+
+        /**
+         * @brief Reports results to the console.
+         */
+        virtual void reportResults() const;
+
+        /**
+         * @brief Gets the memory NUMA node that pages are migrated to. The source node is the memory node of the benchmark.
+         * @returns The destination NUMA node.
+         */
+        uint32_t getDstNode() const { return dst_node_; }
+
+        /**
+         * @brief Gets the kind of pages backing the region.
+         * @returns The page backing.
+         */
+        page_backing_t getPageBacking() const { return backing_; }
+
+        /**
+         * @brief Gets the mean migration rate over all iterations.
+         * @returns Pages of the backing page size per second, or -1 if the benchmark has not run.
+         */
+        double getMeanPageRate() const;
+
+        /**
+         * @brief Gets the mean latency seen by the latency thread while the region was migrating.
+         * @returns The latency in ns/access, or -1 if the benchmark has not run.
+         */
+        double getMeanMigrationLatency() const;
+
+        /**
+         * @brief Gets the mean latency seen by the latency thread while nothing was migrating.
+         * @returns The latency in ns/access, or -1 if the benchmark has not run.
+         */
+        double getMeanBaselineLatency() const;
+
+        /**
+         * @brief Gets a short name for a kind of page, such as "thp".
+         * @param backing Kind of pages.
+         * @returns The name.
+         */
+        static std::string backingName(page_backing_t backing);
+
+    protected:
+        virtual bool runCore();
+        virtual std::vector<int32_t> workerCpus() const;
+
+    private:
+        /**
+         * @brief Moves every page of a region to a NUMA node with a single move_pages() call.
+         * @param pages Start address of every page of the region.
+         * @param node The NUMA node to move the pages to.
+         * @param failed Set to the number of pages that could not be moved.
+         * @returns The time the call took, in ticks.
+         */
+        tick_t movePages(std::vector<void*>& pages, uint32_t node, size_t& failed);
+
+        /**
+         * @brief Runs a latency thread on the start of a region for the fixed benchmark duration, optionally while the region is migrated back and forth on the calling thread.
+         * @param region Start of the region. Its first probe_len_ bytes must hold a random pointer permutation.
+         * @param pages Start address of every page of the region, if migrating. Empty to only measure latency.
+         * @param migrated_bytes Set to the number of bytes migrated from the source node to the destination node.
+         * @param migration_ticks Set to the time those migrations took, in ticks.
+         * @param iterwarning Set to true if a worker had a warning or some pages could not be moved.
+         * @returns The latency in ns/access, or 0 if it could not be measured.
+         */
+        double probeLatency(void* region, std::vector<void*>& pages, size_t& migrated_bytes, tick_t& migration_ticks, bool& iterwarning);
+
+        /**
+         * @brief Gets the size of the pages backing the region.
+         * @returns The page size in bytes.
+         */
+        size_t pageSize() const;
+
+        size_t probe_len_; /**< Length of the part at the start of the region that the latency thread chases pointers through. */
+        uint32_t dst_node_; /**< The memory NUMA node that pages are migrated to. */
+        page_backing_t backing_; /**< Kind of pages backing the region. */
+        size_t large_page_size_; /**< Size of explicit huge pages in bytes. */
+        std::vector<double> page_rate_on_iter_; /**< Pages migrated per second for each iteration. */
+        std::vector<double> migration_latency_on_iter_; /**< Latency during migration for each iteration. */
+        std::vector<double> baseline_latency_on_iter_; /**< Latency without migration for each iteration. */
+    };
+};
+
+#endif
@@ -0,0 +1,112 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the PerfCounters class.
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+//Headers
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+    /**
+     * @brief Hardware performance counters for the calling thread, read through perf_event_open() on GNU/Linux.
+     * The counters are split into two groups that each fit on the PMU, so that the events within a group are always counted over the same time.
+     * When the groups do not fit together, the kernel multiplexes them, and the counts are scaled up for the time each group was not running.
+     * Counters that cannot be opened, for example because of perf_event_paranoid, a missing PMU in a virtual machine, or an event this CPU does not have, are left out and reported as invalid.
+     * An object must be used only by the thread that opened it.
+     */
+    class PerfCounters {
+    public:
+        /**
+         * @brief Constructor. Does not open any counters.
+         */
+        PerfCounters();
+
+        /**
+         * @brief Destructor. Closes any open counters.
+         */
+        ~PerfCounters();
+
+        /**
+         * @brief Opens the counters for the calling thread, disabled. Only user-mode events are counted.
+         * @returns True if at least one counter could be opened. Always false on platforms other than GNU/Linux.
+         */
+        bool open();
+
+        /**
+         * @brief Resets and enables all open counters.
+         */
+        void start();
+
+        /**
+         * @brief Disables all open counters.
+         */
+        void stop();
+
+        /**
+         * @brief Reads the counters.
+         * @returns The counts since the last start(), scaled for multiplexing. Counters that are not open or never ran are invalid.
+         */
+        perf_counts_t read() const;
+
+        /**
+         * @brief Indicates if a counter could be opened.
+         * @param counter The counter.
+         * @returns True if it is open.
+         */
+        bool isOpen(perf_counter_t counter) const;
+
+        /**
+         * @brief Gets a counts object with every counter invalid.
+         * @returns The empty counts.
+         */
+        static perf_counts_t emptyCounts();
+
+        /**
+         * @brief Gets the name of a counter for reporting.
+         * @param counter The counter.
+         * @returns The name.
+         */
+        static std::string counterName(perf_counter_t counter);
+
+    private:
+        std::vector<int32_t> group_leaders_; /**< File descriptor of the leader of each counter group, or -1 if no counter of the group could be opened. */
+        std::vector<std::vector<perf_counter_t> > group_members_; /**< Counters of each group that could be opened, in the order the kernel reports them. */
+        std::vector<int32_t> fds_; /**< File descriptors of all open counters. */
+    };
+};
+
+#endif
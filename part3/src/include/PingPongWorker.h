@@ -0,0 +1,79 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the PingPongWorker class.
+ */
+
+#ifndef PING_PONG_WORKER_H
+#define PING_PONG_WORKER_H
+
+//Headers
+#include <MemoryWorker.h>
+#include <common.h>
+
+namespace xmem {
+    /**
+     * @brief Multithreading-friendly class to bounce a single cache line back and forth with a partner worker on another logical CPU.
+     *
+     * Two workers share one 64-bit flag. The initiator writes an odd value and waits for the responder to answer with the next even value. Each round trip therefore moves the cache line from one core to the other and back. Only the initiator times its round trips.
+     */
+    class PingPongWorker : public MemoryWorker {
+        public:
+
+            /**
+             * @brief Constructor.
+             * @param mem_array Pointer to the shared flag. The caller must zero it before starting either worker of a pair.
+             * @param initiator If true, this worker starts and times the round trips. Otherwise it only answers them.
+             * @param round_trips Number of timed round trips.
+             * @param cpu_affinity Logical CPU identifier to lock this worker's thread to.
+             */
+            PingPongWorker(
+                void* mem_array,
+                bool initiator,
+                uint32_t round_trips,
+                int32_t cpu_affinity
+            );
+
+            /**
+             * @brief Destructor.
+             */
+            virtual ~PingPongWorker();
+
+            /**
+             * @brief Thread-safe worker method.
+             */
+            virtual void run();
+
+        private:
+            // ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
+            bool initiator_; /**< If true, this worker starts and times round trips. */
+            uint32_t round_trips_; /**< Number of timed round trips. */
+    };
+};
+
+#endif
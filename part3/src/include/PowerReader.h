@@ -60,7 +60,7 @@ namespace xmem {
         /**
          * @brief Destructor.
          */
-        ~PowerReader();
+        virtual ~PowerReader();
 
         /**
          * @brief Starts measuring power at the rate implied by the sampling_period passed in the constructor.
@@ -111,6 +111,25 @@ namespace xmem {
          */
         double getPeakPower();
 
+        /**
+         * @brief Gets the energy used over the whole measurement, from when run() started to when it noticed the stop signal. Unlike the power trace, this includes the partial sampling period at the end.
+         * @returns The energy in joules. If no data was collected, returns 0.
+         */
+        double getEnergy();
+
+        /**
+         * @brief Gets the length of the measurement that getEnergy() covers.
+         * @returns The measured time in seconds. If no data was collected, returns 0.
+         */
+        double getMeasuredTime();
+
+        /**
+         * @brief Sets the logical CPU for the next thread that calls run(). It should be set before that thread is started.
+         * @param cpu_affinity The logical CPU. If negative, any CPU is OK (no affinity).
+         * @returns True on success.
+         */
+        bool setCpuAffinity(int32_t cpu_affinity);
+
         /**
          * @brief Gets the last sample.
          * @returns The last power sample measured.
@@ -142,6 +161,15 @@ namespace xmem {
         std::string name();
 
     protected:
+        /**
+         * @brief Adds energy to the measurement total in a thread-safe manner.
+         * @param energy Energy in power units times seconds.
+         * @param elapsed_s The time over which the energy was used in seconds.
+         * @returns True on success.
+         */
+        bool addEnergy(double energy, double elapsed_s);
+
+
         /////
         //ONLY ACCESS THESE WHILE HOLDING THIS OBJECT'S LOCK FOR THREAD SAFETY
         bool stop_signal_; /**< When true, the run() function should finish after the current sample iteration it is working on. */
@@ -152,6 +180,8 @@ namespace xmem {
         double mean_power_; /**< The mean power. */
         double peak_power_; /**< The peak power observed. */
         size_t num_samples_; /**< The number of samples collected. */
+        double energy_; /**< Energy used over the measurement in power units times seconds. */
+        double measured_time_; /**< Time covered by energy_ in seconds. */
         uint32_t sampling_period_; /**< Power sampling period in milliseconds. */
         //
         /////
@@ -71,6 +71,18 @@ namespace xmem {
          */
         virtual ~ThroughputBenchmark() {}
 
+        /**
+         * @brief Gets the energy used per GB moved, i.e., the mean power over the measurement divided by the mean throughput.
+         * @returns The energy in J/GB for a given power reader, or 0 if it does not exist.
+         */
+        virtual double getEnergyEfficiency(uint32_t socket_id) const;
+
+        /**
+         * @brief Gets the units of getEnergyEfficiency().
+         * @returns "J/GB".
+         */
+        virtual std::string getEnergyEfficiencyUnits() const;
+
     protected:
         virtual bool runCore();
     };
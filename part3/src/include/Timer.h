@@ -37,6 +37,7 @@
 
 //Libraries
 #include <cstdint>
+#include <vector>
 
 namespace xmem {
     /**
@@ -47,7 +48,8 @@ namespace xmem {
     class Timer {
     public:
         /**
-         * @brief Constructor. This may take a noticeable amount of time.
+         * @brief Constructor. Characterizes the timer backend selected by g_timer_backend. The OS timers need no calibration. The hardware timers are calibrated against the OS clock in a few short samples, which takes some tens of milliseconds.
+         * The cost of every available backend and the core clock frequency are measured as well.
          */
         Timer();
 
@@ -63,9 +65,72 @@ namespace xmem {
          */
         float getNsPerTick();
 
+        /**
+         * @brief Gets the resolution of this timer.
+         * @returns The smallest step the timer can advance by, in nanoseconds.
+         */
+        float getResolutionNs();
+
+        /**
+         * @brief Gets the overhead of timing a section of code with this timer.
+         * @returns The shortest time measured between back-to-back start_timer() and stop_timer() calls, in nanoseconds.
+         */
+        float getOverheadNs();
+
+        /**
+         * @brief Indicates if the time stamp counter ticks at a constant rate regardless of CPU power states. Only queried when using the hardware timer on x86.
+         * @returns True if CPUID reports an invariant TSC.
+         */
+        bool hasInvariantTsc();
+
+        /**
+         * @brief Gets the measured core clock frequency, which converts nanoseconds to core cycles.
+         * @returns The frequency in GHz, or 0 if it could not be measured on this platform.
+         */
+        float getCoreGhz();
+
+        /**
+         * @brief Gets the cost of timing with each timer backend.
+         * @returns The mean cost of a start_timer() and stop_timer() pair in nanoseconds, indexed by timer_backend_t. Backends that are not available have a cost of 0.
+         */
+        std::vector<float> getBackendOverheadNs();
+
     protected:
         tick_t ticks_per_ms_; /**< Ticks per ms for this timer. */
         float ns_per_tick_; /**< Nanoseconds per tick for this timer. */
+        float resolution_ns_; /**< Resolution of this timer in nanoseconds. */
+        float overhead_ns_; /**< Overhead of a back-to-back start and stop of this timer in nanoseconds. */
+        bool invariant_tsc_; /**< True if the time stamp counter is invariant. */
+        float core_ghz_; /**< Measured core clock frequency in GHz. */
+        std::vector<float> backend_overhead_ns_; /**< Mean cost of a start_timer() and stop_timer() pair in nanoseconds for each timer backend. */
+
+    private:
+        /**
+         * @brief Reads the OS reference clock that the hardware timers are calibrated against.
+         * @returns The reference time in nanoseconds.
+         */
+        double referenceNs() const;
+
+        /**
+         * @brief Measures the mean cost of back-to-back start_timer() and stop_timer() calls with the timer backend currently in g_timer_backend.
+         * @returns The cost of one pair in nanoseconds.
+         */
+        double measurePairNs() const;
+
+        /**
+         * @brief Times a chain of dependent single-cycle integer adds against the OS reference clock.
+         * @param ghz Set to the core clock frequency in GHz on success, or to 0 otherwise.
+         * @returns True on success. False if the chain is unavailable for this compiler and architecture, which needs GCC-style inline assembly on x86 or 64-bit ARM.
+         */
+        bool measureCoreGhz(double& ghz) const;
+
+#ifdef USE_TSC_TIMER
+        /**
+         * @brief Asks CPUID whether the time stamp counter is invariant.
+         * @returns True if it is.
+         */
+        bool queryInvariantTsc() const;
+#endif
     };
 };
 
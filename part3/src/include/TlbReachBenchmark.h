@@ -0,0 +1,123 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the TlbReachBenchmark class.
+ */
+
+#ifndef TLB_REACH_BENCHMARK_H
+#define TLB_REACH_BENCHMARK_H
+
+//Headers
+#include <Benchmark.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+
+    /**
+     * @brief A type of benchmark that measures unloaded latency while touching exactly one cache line in each of a number of pages, so that the translation-lookaside buffers rather than the caches run out of reach as the number of pages grows.
+     *
+     * The chain is built over pages that are already mapped and faulted in. The line touched in each page is staggered, so the same number of pages touches the same number of lines in the same cache sets for every page size. With a page size of one cache line, the chain packs its lines densely instead, which gives the latency of the same number of lines with hardly any TLB misses.
+     */
+    class TlbReachBenchmark : public Benchmark {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param mem_array A pointer to a contiguous chunk of memory that has been mapped and faulted in. Must be page aligned.
+         * @param num_pages Number of pages to touch one cache line in.
+         * @param page_size Size of the pages backing mem_array in bytes, or the cache line size for a dense chain.
+         * @param backing Kind of pages backing mem_array.
+         * @param random If true, pages are visited in random order. Otherwise, they are visited with a stride of one page.
+         * @param iterations Number of iterations of the complete benchmark. Used to gather more statistics.
+         * @param mem_node The memory NUMA node of mem_array.
+         * @param cpu_node The CPU NUMA node of the latency thread.
+         * @param dram_power_readers A group of PowerReader objects for measuring DRAM power.
+         * @param name The name of the benchmark to use when reporting to console.
+         */
+        TlbReachBenchmark(
+            void* mem_array,
+            size_t num_pages,
+            size_t page_size,
+            page_backing_t backing,
+            bool random,
+            uint32_t iterations,
+            uint32_t mem_node,
+            uint32_t cpu_node,
+            std::vector<PowerReader*> dram_power_readers,
+            std::string name
+        );
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~TlbReachBenchmark() {}
+
+        /**
+         * @brief Reports benchmark configuration details to the console.
+         */
+        virtual void reportBenchmarkInfo() const;
+
+        /**
+         * @brief Reports results to the console.
+         */
+        virtual void reportResults() const;
+
+        /**
+         * @brief Gets the number of pages that one cache line is touched in.
+         * @returns The number of pages.
+         */
+        size_t getNumPages() const { return num_pages_; }
+
+        /**
+         * @brief Gets the size of the pages that one cache line is touched in.
+         * @returns The page size in bytes, or the cache line size for a dense chain.
+         */
+        size_t getPageSize() const { return page_size_; }
+
+        /**
+         * @brief Gets the kind of pages backing the memory.
+         * @returns The page backing.
+         */
+        page_backing_t getPageBacking() const { return backing_; }
+
+    protected:
+        virtual bool runCore();
+
+    private:
+        size_t num_pages_; /**< Number of pages that one cache line is touched in. */
+        size_t page_size_; /**< Distance between touched pages in bytes. */
+        page_backing_t backing_; /**< Kind of pages backing the memory. */
+    };
+};
+
+#endif
@@ -0,0 +1,141 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the WorkloadMixBenchmark class.
+ */
+
+#ifndef WORKLOAD_MIX_BENCHMARK_H
+#define WORKLOAD_MIX_BENCHMARK_H
+
+//Headers
+#include <Benchmark.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+
+    /**
+     * @brief A type of benchmark that runs a heterogeneous mix of worker threads at the same time. Each thread has its own access pattern, read/write mode, chunk size, stride, working set and NUMA nodes, or is a latency probe.
+     *
+     * The per-iteration metric is the aggregate throughput of all load threads in MB/s, taken as the sum of their individual throughputs since heterogeneous threads do not run for exactly the same time. Per-thread results and the mean probe latency are kept separately.
+     */
+    class WorkloadMixBenchmark : public Benchmark {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param thread_mem_arrays The private memory region of each worker thread. Each must be at least as long as the working set of its thread and lie on the thread's memory NUMA node.
+         * @param workload What each worker thread does. Must have the same number of entries as thread_mem_arrays.
+         * @param iterations Number of iterations of the complete benchmark. Used to gather more statistics.
+         * @param mlp The MLP value passed to every worker.
+         * @param dram_power_readers A group of PowerReader objects for measuring DRAM power.
+         * @param name The name of the benchmark to use when reporting to console.
+         */
+        WorkloadMixBenchmark(
+            std::vector<void*> thread_mem_arrays,
+            std::vector<workload_thread_t> workload,
+            uint32_t iterations,
+            uint8_t mlp,
+            std::vector<PowerReader*> dram_power_readers,
+            std::string name
+        );
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~WorkloadMixBenchmark() {}
+
+        /**
+         * @brief Reports benchmark configuration details to the console.
+         */
+        virtual void reportBenchmarkInfo() const;
+
+        /**
+         * @brief Reports results to the console.
+         */
+        virtual void reportResults() const;
+
+        /**
+         * @brief Gets what a worker thread does.
+         * @param thread The worker thread index.
+         * @returns The thread's specification.
+         */
+        workload_thread_t getThreadSpec(uint32_t thread) const { return workload_[thread]; }
+
+        /**
+         * @brief Gets the mean result of one worker thread over all iterations.
+         * @param thread The worker thread index.
+         * @returns MB/s for a load thread or ns/access for a latency probe, or -1 if the benchmark has not run.
+         */
+        double getThreadMeanMetric(uint32_t thread) const;
+
+        /**
+         * @brief Gets the number of load threads in the mix.
+         * @returns The number of threads that are not latency probes.
+         */
+        uint32_t getNumLoadThreads() const;
+
+        /**
+         * @brief Gets the mean latency of all probe threads over all iterations.
+         * @returns The latency in ns/access, or -1 if the benchmark has not run or has no probes.
+         */
+        double getMeanProbeLatency() const;
+
+        /**
+         * @brief Gets a short description of what a worker thread does, such as "seq-write 64b stride 1".
+         * @param spec The thread's specification.
+         * @returns The description.
+         */
+        static std::string workloadThreadName(const workload_thread_t& spec);
+
+        /**
+         * @brief Gets the width of a chunk size.
+         * @param chunk_size The chunk size.
+         * @returns The width in bits, or 0 if unknown.
+         */
+        static uint32_t chunkSizeBits(chunk_size_t chunk_size);
+
+    protected:
+        virtual bool runCore();
+        virtual bool setupCore();
+        virtual std::vector<int32_t> workerCpus() const;
+
+    private:
+        std::vector<void*> thread_mem_arrays_; /**< The private memory region of each worker thread. */
+        std::vector<workload_thread_t> workload_; /**< What each worker thread does. */
+        std::vector<std::vector<double> > thread_metric_on_iter_; /**< Result of each worker thread for each iteration, indexed by thread then iteration. */
+        std::vector<double> probe_latency_on_iter_; /**< Mean latency of the probe threads for each iteration. */
+        std::vector<int32_t> cpu_ids_; /**< The logical CPU of each worker thread. */
+    };
+};
+
+#endif
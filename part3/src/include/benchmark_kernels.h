@@ -45,6 +45,7 @@ namespace xmem {
     typedef int32_t(*SequentialFunction)(void*, void*);
     typedef int32_t(*RandomFunction)(uintptr_t*, uintptr_t**, size_t, uint8_t);
         //RandomFunction returns type int32_t; aliases ptr to fxn w/ args. uintptr_t*, uintptr_t**, size_t, uint8_
+    typedef int32_t(*GatherFunction)(uint64_t*, uint32_t*, size_t);
 
     /**
      * @brief Determines which sequential memory access kernel to use based on the read/write mode, chunk size, and stride size.
@@ -67,6 +68,15 @@ namespace xmem {
      */
     bool determine_random_kernel(rw_mode_t rw_mode, chunk_size_t chunk_size, RandomFunction* kernel_function, RandomFunction* dummy_kernel_function);
 
+    /**
+     * @brief Determines which gather (READ) or scatter (WRITE) kernel to use.
+     * @param rw_mode Read/write mode. READ gathers and WRITE scatters.
+     * @param gather_kernel The instruction flavor.
+     * @param kernel_function Function pointer that will be set to the matching kernel function.
+     * @returns True on success, false if the combination is not available in this build.
+     */
+    bool determine_gather_kernel(rw_mode_t rw_mode, gather_kernel_t gather_kernel, GatherFunction* kernel_function);
+
     /**
      * @brief Builds a random chain of pointers within the specified memory region.
      * @param start_address Beginning address of the memory region.
@@ -76,6 +86,42 @@ namespace xmem {
      */
     bool build_random_pointer_permutation(void* start_address, void* end_address, chunk_size_t chunk_size);
 
+    /**
+     * @brief Places the heads of several independent pointer chains in a memory region prepared by build_random_pointer_permutation(), for use with the random throughput kernels.
+     * @param start_address Beginning address of the memory region. The first chain starts here.
+     * @param len Length of the memory region in bytes. Must be at least num_chains cache lines.
+     * @param chains Output array of num_chains chain cursors.
+     * @param num_chains Number of chains. Must be at least 1 and at most MAX_RANDOM_CHAINS.
+     */
+    void place_random_chains(void* start_address, size_t len, uintptr_t** chains, uint8_t num_chains);
+
+    /**
+     * @brief Builds a random pointer chain over whole cache lines that forms a single cycle, so chasing it visits every line exactly once per lap. The pointer to the next line is kept in the first word of each line.
+     * @param start_address Beginning address of the memory region. Must be cache line aligned.
+     * @param num_lines Number of cache lines in the chain.
+     * @returns True on success.
+     */
+    bool build_random_cache_line_cycle(void* start_address, size_t num_lines);
+
+    /**
+     * @brief Builds a pointer chain that touches exactly one cache line in each of several pages and forms a single cycle. The line used within each page is staggered from page to page, so that the lines spread over the cache sets in the same way whatever the page size. The pointer to the next line is kept in the first word of each line.
+     * @param start_address Beginning address of the memory region. Must be page aligned.
+     * @param num_pages Number of pages in the chain.
+     * @param page_size Distance between the pages in bytes. Must be a power of two of at least one cache line.
+     * @param random If true, pages are visited in random order. Otherwise, they are visited in address order, one page stride at a time.
+     * @returns True on success.
+     */
+    bool build_page_line_cycle(void* start_address, size_t num_pages, size_t page_size, bool random);
+
+#ifdef HAS_CACHE_LINE_FLUSH
+    /**
+     * @brief Writes back and invalidates every cache line in a memory region from all caches in the coherence domain, then waits for the flushes to complete.
+     * @param start_address Beginning address of the memory region.
+     * @param len Length of the memory region in bytes.
+     */
+    void flush_cache_lines(void* start_address, size_t len);
+#endif
+
     /***********************************************************************
      ***********************************************************************
      ********************** LATENCY-RELATED BENCHMARK KERNELS **************
@@ -619,7 +665,7 @@ namespace xmem {
      * @param len The number of pointers to deference in a chain-like fashion.
      * @returns Undefined.
      */
-    int32_t dummy_randomLoop_Word32(uintptr_t*, uintptr_t**, size_t len);
+    int32_t dummy_randomLoop_Word32(uintptr_t*, uintptr_t**, size_t len, uint8_t mlp);
 #endif
 
 #ifdef HAS_WORD_64
@@ -637,7 +683,7 @@ namespace xmem {
      * @param len The number of pointers to deference in a chain-like fashion.
      * @returns Undefined.
      */
-    int32_t dummy_randomLoop_Word128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+    int32_t dummy_randomLoop_Word128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
 #endif
 
 #ifdef HAS_WORD_256
@@ -646,7 +692,7 @@ namespace xmem {
      * @param len The number of pointers to deference in a chain-like fashion.
      * @returns Undefined.
      */
-    int32_t dummy_randomLoop_Word256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+    int32_t dummy_randomLoop_Word256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
 #endif
 
 #ifdef HAS_WORD_512
@@ -655,7 +701,7 @@ namespace xmem {
      * @param len The number of pointers to deference in a chain-like fashion.
      * @returns Undefined.
      */
-    int32_t dummy_randomLoop_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+    int32_t dummy_randomLoop_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
 #endif
 
     /* ------------------------------------------------------------------------- */
@@ -1645,57 +1691,62 @@ namespace xmem {
 #ifndef HAS_WORD_64
     /**
      * @brief Walks over the allocated memory in random order by chasing 64-bit pointers.
-     * @param first_address Starting address to deference.
-     * @param last_touched_address The last visited address.
-     * @param len The number of pointers to deference in a chain-like fashion.
+     * @param first_address Starting address to deference when there is a single chain. Must equal chains[0].
+     * @param chains In/out array of mlp chain cursors, as set up by place_random_chains(). Each is left at the last visited address of its chain.
+     * @param len Number of bytes to access in this call, shared evenly by the chains. Must be a multiple of mlp words.
+     * @param mlp Number of independent chains to interleave, at most MAX_RANDOM_CHAINS. Each round issues one access per chain, so up to mlp misses can be outstanding.
      * @returns Undefined.
      */
-    int32_t randomRead_Word32(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
+    int32_t randomRead_Word32(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp);
 #endif
 
     //32-bit systems only.
 #ifdef HAS_WORD_64
     /**
      * @brief Walks over the allocated memory in random order by chasing 32-bit pointers.
-     * @param first_address Starting address to deference.
-     * @param last_touched_address The last visited address.
-     * @param len The number of pointers to deference in a chain-like fashion.
+     * @param first_address Starting address to deference when there is a single chain. Must equal chains[0].
+     * @param chains In/out array of mlp chain cursors, as set up by place_random_chains(). Each is left at the last visited address of its chain.
+     * @param len Number of bytes to access in this call, shared evenly by the chains. Must be a multiple of mlp words.
+     * @param mlp Number of independent chains to interleave, at most MAX_RANDOM_CHAINS. Each round issues one access per chain, so up to mlp misses can be outstanding.
      * @returns Undefined.
      */
-    int32_t randomRead_Word64(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
+    int32_t randomRead_Word64(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp);
 #endif
 
 #ifdef HAS_WORD_128
     /**
      * @brief Walks over the allocated memory in random order by chasing 64-bit pointers embedded in 128-bit memory words.
-     * @param first_address Starting address to deference.
-     * @param last_touched_address The last visited address.
-     * @param len The number of pointers to deference in a chain-like fashion.
+     * @param first_address Starting address to deference when there is a single chain. Must equal chains[0].
+     * @param chains In/out array of mlp chain cursors, as set up by place_random_chains(). Each is left at the last visited address of its chain.
+     * @param len Number of bytes to access in this call, shared evenly by the chains. Must be a multiple of mlp words.
+     * @param mlp Number of independent chains to interleave, at most MAX_RANDOM_CHAINS. Each round issues one access per chain, so up to mlp misses can be outstanding.
      * @returns Undefined.
      */
-    int32_t randomRead_Word128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
+    int32_t randomRead_Word128(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp);
 #endif
 
 #ifdef HAS_WORD_256
     /**
      * @brief Walks over the allocated memory in random order by chasing 64-bit pointers embedded in 256-bit memory words.
-     * @param first_address Starting address to deference.
-     * @param last_touched_address The last visited address.
-     * @param len The number of pointers to deference in a chain-like fashion.
+     * @param first_address Starting address to deference when there is a single chain. Must equal chains[0].
+     * @param chains In/out array of mlp chain cursors, as set up by place_random_chains(). Each is left at the last visited address of its chain.
+     * @param len Number of bytes to access in this call, shared evenly by the chains. Must be a multiple of mlp words.
+     * @param mlp Number of independent chains to interleave, at most MAX_RANDOM_CHAINS. Each round issues one access per chain, so up to mlp misses can be outstanding.
      * @returns Undefined.
      */
-    int32_t randomRead_Word256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
+    int32_t randomRead_Word256(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp);
 #endif
 
 #ifdef HAS_WORD_512
     /**
      * @brief Walks over the allocated memory in random order by chasing 64-bit pointers embedded in 512-bit memory words.
-     * @param first_address Starting address to deference.
-     * @param last_touched_address The last visited address.
-     * @param len The number of pointers to deference in a chain-like fashion.
+     * @param first_address Starting address to deference when there is a single chain. Must equal chains[0].
+     * @param chains In/out array of mlp chain cursors, as set up by place_random_chains(). Each is left at the last visited address of its chain.
+     * @param len Number of bytes to access in this call, shared evenly by the chains. Must be a multiple of mlp words.
+     * @param mlp Number of independent chains to interleave, at most MAX_RANDOM_CHAINS. Each round issues one access per chain, so up to mlp misses can be outstanding.
      * @returns Undefined.
      */
-    int32_t randomRead_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
+    int32_t randomRead_Word512(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp);
 #endif
 
     /* ------------ RANDOM WRITE --------------*/
@@ -1704,56 +1755,116 @@ namespace xmem {
 #ifndef HAS_WORD_64
     /**
      * @brief Walks over the allocated memory in random order by chasing 32-bit pointers. A pointer is read and written back with the same value before chasing to the next pointer. Thus, each memory address is a read followed by immediate write operation.
-     * @param first_address Starting address to deference.
-     * @param last_touched_address The last visited address.
-     * @param len The number of pointers to deference in a chain-like fashion.
+     * @param first_address Starting address to deference when there is a single chain. Must equal chains[0].
+     * @param chains In/out array of mlp chain cursors, as set up by place_random_chains(). Each is left at the last visited address of its chain.
+     * @param len Number of bytes to access in this call, shared evenly by the chains. Must be a multiple of mlp words.
+     * @param mlp Number of independent chains to interleave, at most MAX_RANDOM_CHAINS. Each round issues one access per chain, so up to mlp misses can be outstanding.
      * @returns Undefined.
      */
-    int32_t randomWrite_Word32(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
+    int32_t randomWrite_Word32(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp);
 #endif
 
 #ifdef HAS_WORD_64
     /**
      * @brief Walks over the allocated memory in random order by chasing 64-bit pointers. A pointer is read and written back with the same value before chasing to the next pointer. Thus, each memory address is a read followed by immediate write operation.
-     * @param first_address Starting address to deference.
-     * @param last_touched_address The last visited address.
-     * @param len The number of pointers to deference in a chain-like fashion.
+     * @param first_address Starting address to deference when there is a single chain. Must equal chains[0].
+     * @param chains In/out array of mlp chain cursors, as set up by place_random_chains(). Each is left at the last visited address of its chain.
+     * @param len Number of bytes to access in this call, shared evenly by the chains. Must be a multiple of mlp words.
+     * @param mlp Number of independent chains to interleave, at most MAX_RANDOM_CHAINS. Each round issues one access per chain, so up to mlp misses can be outstanding.
      * @returns Undefined.
      */
-    int32_t randomWrite_Word64(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
+    int32_t randomWrite_Word64(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp);
 #endif
 
 #ifdef HAS_WORD_128
     /**
      * @brief Walks over the allocated memory in random order by chasing 64-bit pointers embedded within 128-bit words. A 128-bit word is read and written back with the same value before chasing to the next location extracted as a 64-bit address in the 128-bit word. Thus, each memory address is a read followed by immediate write operation as well as a vector word extraction.
-     * @param first_address Starting address to deference.
-     * @param last_touched_address The last visited address.
-     * @param len The number of pointers to deference in a chain-like fashion.
+     * @param first_address Starting address to deference when there is a single chain. Must equal chains[0].
+     * @param chains In/out array of mlp chain cursors, as set up by place_random_chains(). Each is left at the last visited address of its chain.
+     * @param len Number of bytes to access in this call, shared evenly by the chains. Must be a multiple of mlp words.
+     * @param mlp Number of independent chains to interleave, at most MAX_RANDOM_CHAINS. Each round issues one access per chain, so up to mlp misses can be outstanding.
      * @returns Undefined.
      */
-    int32_t randomWrite_Word128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
+    int32_t randomWrite_Word128(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp);
 #endif
 
 #ifdef HAS_WORD_256
     /**
      * @brief Walks over the allocated memory in random order by chasing 64-bit pointers embedded within 256-bit words. A 256-bit word is read and written back with the same value before chasing to the next location extracted as a 64-bit address in the 256-bit word. Thus, each memory address is a read followed by immediate write operation as well as a vector word extraction.
-     * @param first_address Starting address to deference.
-     * @param last_touched_address The last visited address.
-     * @param len The number of pointers to deference in a chain-like fashion.
+     * @param first_address Starting address to deference when there is a single chain. Must equal chains[0].
+     * @param chains In/out array of mlp chain cursors, as set up by place_random_chains(). Each is left at the last visited address of its chain.
+     * @param len Number of bytes to access in this call, shared evenly by the chains. Must be a multiple of mlp words.
+     * @param mlp Number of independent chains to interleave, at most MAX_RANDOM_CHAINS. Each round issues one access per chain, so up to mlp misses can be outstanding.
      * @returns Undefined.
      */
-    int32_t randomWrite_Word256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
+    int32_t randomWrite_Word256(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp);
 #endif
 
 #ifdef HAS_WORD_512
     /**
      * @brief Walks over the allocated memory in random order by chasing 64-bit pointers embedded within 512-bit words. A 512-bit word is read and written back with the same value before chasing to the next location extracted as a 64-bit address in the 512-bit word. Thus, each memory address is a read followed by immediate write operation as well as a vector word extraction.
-     * @param first_address Starting address to deference.
-     * @param last_touched_address The last visited address.
-     * @param len The number of pointers to deference in a chain-like fashion.
+     * @param first_address Starting address to deference when there is a single chain. Must equal chains[0].
+     * @param chains In/out array of mlp chain cursors, as set up by place_random_chains(). Each is left at the last visited address of its chain.
+     * @param len Number of bytes to access in this call, shared evenly by the chains. Must be a multiple of mlp words.
+     * @param mlp Number of independent chains to interleave, at most MAX_RANDOM_CHAINS. Each round issues one access per chain, so up to mlp misses can be outstanding.
      * @returns Undefined.
      */
-    int32_t randomWrite_Word512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len, uint8_t mlp);
+    int32_t randomWrite_Word512(uintptr_t* first_address, uintptr_t** chains, size_t len, uint8_t mlp);
+#endif
+
+    /***********************************************************************
+     ***********************************************************************
+     ******************* GATHER/SCATTER BENCHMARK KERNELS ******************
+     ***********************************************************************
+     ***********************************************************************/
+
+    /**
+     * @brief Reads one 64-bit table element per index with scalar loads. The indices are independent, so the loads can all be in flight at once.
+     * @param table The table.
+     * @param indices Element indices into the table.
+     * @param num_indices Number of indices. Must be a multiple of 8.
+     * @returns 0
+     */
+    int32_t gatherRead_Word64(uint64_t* table, uint32_t* indices, size_t num_indices);
+
+    /**
+     * @brief Writes one 64-bit table element per index with scalar stores.
+     * @param table The table.
+     * @param indices Element indices into the table.
+     * @param num_indices Number of indices. Must be a multiple of 8.
+     * @returns 0
+     */
+    int32_t scatterWrite_Word64(uint64_t* table, uint32_t* indices, size_t num_indices);
+
+#ifdef HAS_GATHER_256
+    /**
+     * @brief Reads 64-bit table elements four at a time with AVX2 vpgatherdq.
+     * @param table The table.
+     * @param indices Element indices into the table. Must be below 2^31 as they are sign-extended.
+     * @param num_indices Number of indices. Must be a multiple of 8.
+     * @returns 0
+     */
+    int32_t gatherRead_Word64x4(uint64_t* table, uint32_t* indices, size_t num_indices);
+#endif
+
+#ifdef HAS_GATHER_SCATTER_512
+    /**
+     * @brief Reads 64-bit table elements eight at a time with AVX-512 vpgatherdq.
+     * @param table The table.
+     * @param indices Element indices into the table. Must be below 2^31 as they are sign-extended.
+     * @param num_indices Number of indices. Must be a multiple of 8.
+     * @returns 0
+     */
+    int32_t gatherRead_Word64x8(uint64_t* table, uint32_t* indices, size_t num_indices);
+
+    /**
+     * @brief Writes 64-bit table elements eight at a time with AVX-512 vpscatterdq.
+     * @param table The table.
+     * @param indices Element indices into the table. Must be below 2^31 as they are sign-extended.
+     * @param num_indices Number of indices. Must be a multiple of 8.
+     * @returns 0
+     */
+    int32_t scatterWrite_Word64x8(uint64_t* table, uint32_t* indices, size_t num_indices);
 #endif
 };
 
@@ -35,6 +35,8 @@
 //Libraries
 #include <cstdint>
 #include <cstddef>
+#include <vector>
+#include <string>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -257,6 +259,7 @@ namespace xmem {
 #define DEFAULT_NUM_L3_CACHES 0 /**< Default number of L3 caches. */
 #define DEFAULT_NUM_L4_CACHES 0 /**< Default number of L4 caches. */
 #define MIN_ELAPSED_TICKS 10000 /**< If any routine measured fewer than this number of ticks its results should be viewed with suspicion. This is because the latency of the timer itself will matter. */
+#define CACHE_LINE_SIZE 64 /**< Cache line size in bytes assumed by benchmarks that work on individual cache lines. */
 
 
 //Loop unrolling tricks. There are a bunch so that we can use the length needed for each situation. Unrolling too much hurts code size and instruction reuse. Yes, an unroll of 65536 is probably unnecessary. :)
@@ -292,18 +295,33 @@ namespace xmem {
 *   In some cases, such as chunk size, stride size, etc. for throughput benchmarks, all combinations of the options will be used! This might dramatically increase runtime.
 */
 
-//Which timer to use in the benchmarks. Only one may be selected!
-#define USE_OS_TIMER /**< RECOMMENDED ENABLED. If enabled, uses the QPC timer on Windows and the POSIX clock_gettime() on GNU/Linux for all timing purposes. */
-//#define USE_HW_TIMER /**< RECOMMENDED DISABLED. If enabled, uses the platform-specific hardware timer (e.g., TSC on Intel x86-64). This may be less portable or have other implementation-specific quirks but for most purposes should work fine. */
+//Which timer to use by default in the benchmarks. Only one may be selected! The timer can also be picked at runtime with the --timer option.
+#define USE_OS_TIMER /**< RECOMMENDED ENABLED. If enabled, uses the QPC timer on Windows and the POSIX clock_gettime() on GNU/Linux for all timing purposes by default. */
+//#define USE_HW_TIMER /**< RECOMMENDED DISABLED. If enabled, uses the platform-specific hardware timer (e.g., rdtscp followed by lfence on Intel x86-64) by default. This may be less portable or have other implementation-specific quirks but for most purposes should work fine. */
 
 #define BENCHMARK_DURATION_MS 5000 /**< RECOMMENDED VALUE: At least 250. Number of milliseconds to run in each benchmark. */
+#define TIMER_CALIBRATION_SAMPLES 5 /**< RECOMMENDED VALUE: 5. Number of samples taken against the OS clock to calibrate the hardware timer. The median sample is used. */
+#define TIMER_CALIBRATION_SAMPLE_MS 10 /**< RECOMMENDED VALUE: 10. Length in milliseconds of each hardware timer calibration sample. */
+#define TIMER_OVERHEAD_SAMPLES 1000 /**< RECOMMENDED VALUE: 1000. Number of back-to-back timer starts and stops whose minimum is reported as the timer overhead. */
 #define THROUGHPUT_BENCHMARK_BYTES_PER_PASS 4096 /**< RECOMMENDED VALUE: 4096. Number of bytes read or written per pass of any ThroughputBenchmark. This must be less than or equal to the minimum working set size, which is currently 4 KB. */
-
-#define POWER_SAMPLING_PERIOD_MS 1000 /**< RECOMMENDED VALUE: 1000. Sampling period in milliseconds for all power measurement mechanisms. */
+#define MAX_RANDOM_CHAINS 32 /**< Largest number of independent pointer chains one random-access load thread can interleave. This bounds the MLP option for random throughput kernels. */
+#define LOAD_RATE_BURST_PASSES 16 /**< RECOMMENDED VALUE: 16. Number of back-to-back kernel passes a rate-limited load worker issues each time its token bucket allows it. The token bucket holds two bursts, so this bounds how bursty the imposed load can be. */
+#define CORE_TO_CORE_BENCHMARK_ROUND_TRIPS 10000 /**< RECOMMENDED VALUE: 10000. Number of timed cache line round trips between each pair of logical CPUs in the core-to-core transfer latency benchmark. */
+#define CORE_TO_CORE_BENCHMARK_WARMUP_ROUND_TRIPS 1000 /**< RECOMMENDED VALUE: 1000. Number of untimed cache line round trips done before timing starts for each pair of logical CPUs. */
+#define ATOMIC_BENCHMARK_BATCH_OPS 16 /**< RECOMMENDED VALUE: 16. Number of atomic operations timed together as one latency sample in the atomic operation benchmark. Smaller values resolve the latency distribution better but make timer overhead more significant. */
+#define ATOMIC_BENCHMARK_HISTOGRAM_BINS 4096 /**< Number of 1 ns wide bins in the per-operation latency histogram of the atomic operation benchmark. The last bin also collects all slower samples. */
+#define GATHER_BENCHMARK_MAX_ELEMENTS 536870904 /**< Largest number of 64-bit table elements per thread in the gather/scatter benchmark, just under 4 GB. This keeps indices below 2^31, since vector gathers sign-extend them, and keeps the bytes per pass within 32 bits. Must be a multiple of 8. */
+#define TLB_REACH_BENCHMARK_MAX_PAGES 16384 /**< RECOMMENDED VALUE: 16384. Largest number of pages touched in the TLB reach benchmark. One cache line is touched per page, so this keeps the lines within 1 MB of cache while reaching 64 MB with 4 KB pages, well beyond any second-level TLB. */
+#define TLB_REACH_BENCHMARK_KNEE_NS 1.0 /**< RECOMMENDED VALUE: 1.0. Rise in ns of the extra latency over the dense chain that the TLB reach benchmark takes as a TLB level running out of reach. */
+
+#define POWER_SAMPLING_PERIOD_MS 1000 /**< RECOMMENDED VALUE: 1000. Default sampling period in milliseconds for all power measurement mechanisms. The --power_period option overrides it. */
+#define POWER_SAMPLING_PERIOD_MIN_MS 10 /**< RECOMMENDED VALUE: 10. Shortest power sampling period in milliseconds. RAPL energy counters update about once per millisecond, so shorter periods would mostly measure counter update jitter. Power readers also check for a stop at least this often, so a measurement ends at most this long after the benchmark does. */
+#define DEFAULT_RAPL_SYSFS_ROOT "/sys/class/powercap" /**< Powercap sysfs directory that RAPL energy counters are read from on GNU/Linux. The --rapl_root option overrides it. */
 
 //++++++++++++++++++ User-implemented extensions configuration here +++++++++++++++++++++
 //Only one extension may be enabled at a time.
 #define EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK /**< RECOMMENDED ENABLED. This allows for a custom extension to X-Mem that performs latency benchmarking with forward sequential 64-bit and 256-bit read-based load threads with variable delays injected in between memory accesses. */
+#define EXT_MEMCPY_BENCHMARK /**< RECOMMENDED ENABLED. This allows for a custom extension to X-Mem that compares bulk copy (memcpy) and bulk fill (memset) strategies across sizes and source alignments, and reports the size at which each strategy wins. */
 //#define EXT_STREAM_BENCHMARK /**< RECOMMENDED DISABLED. This allows for a custom extension to X-Mem that performs stream copy, add, and triad kernels similar to those of the well-known STREAM throughput benchmark. */
 
 /***********************************************************************************************************/
@@ -312,29 +330,30 @@ namespace xmem {
 /***********************************************************************************************************/
 
 
-//Compile-time options checks: timers
-#ifdef USE_OS_TIMER
+//Compile-time options checks: timers. The OS timer is always built in, and so are the TSC timers on x86. USE_OS_TIMER and USE_HW_TIMER only pick the default.
 #ifdef _WIN32
 #define USE_QPC_TIMER
 #endif
 #ifdef __gnu_linux__
 #define USE_POSIX_TIMER
 #endif
-#endif
 
-#ifdef USE_HW_TIMER
 #ifdef ARCH_INTEL
 #define USE_TSC_TIMER
 #endif
-#ifdef ARCH_ARM
+
+#if defined(USE_HW_TIMER) && defined(ARCH_ARM)
 #error TODO: Implement ARM hardware timer.
 #endif
-#endif
 
 #if defined(USE_OS_TIMER) && defined(USE_HW_TIMER)
 #error Only one type of timer may be defined!
 #endif
 
+#if !defined(USE_OS_TIMER) && !defined(USE_HW_TIMER)
+#error One type of timer must be defined!
+#endif
+
 #if BENCHMARK_DURATION_MS <= 0
 #error BENCHMARK_DURATION_MS must be positive!
 #endif
@@ -343,11 +362,45 @@ namespace xmem {
 #error THROUGHPUT_BENCHMARK_BYTES_PER_PASS must be less than or equal to the minimum possible working set size. It also must be a positive integer.
 #endif
 
-//Compile-time options checks: power sampling frequency. TODO: this should probably be a runtime option
-#if !defined(POWER_SAMPLING_PERIOD_MS) || POWER_SAMPLING_PERIOD_MS <= 0
-#error POWER_SAMPLING_PERIOD_MS must be defined and greater than 0!
+#if MAX_RANDOM_CHAINS < 1 || MAX_RANDOM_CHAINS * CACHE_LINE_SIZE > THROUGHPUT_BENCHMARK_BYTES_PER_PASS
+#error MAX_RANDOM_CHAINS must be positive, and one 512-bit access per chain must fit in THROUGHPUT_BENCHMARK_BYTES_PER_PASS.
+#endif
+
+#if LOAD_RATE_BURST_PASSES <= 0
+#error LOAD_RATE_BURST_PASSES must be a positive integer.
+#endif
+
+#if CORE_TO_CORE_BENCHMARK_ROUND_TRIPS <= 0
+#error CORE_TO_CORE_BENCHMARK_ROUND_TRIPS must be a positive integer.
 #endif
 
+#if ATOMIC_BENCHMARK_BATCH_OPS <= 0
+#error ATOMIC_BENCHMARK_BATCH_OPS must be a positive integer.
+#endif
+
+#if ATOMIC_BENCHMARK_HISTOGRAM_BINS < 2
+#error ATOMIC_BENCHMARK_HISTOGRAM_BINS must be at least 2.
+#endif
+
+//Compile-time options checks: power sampling frequency
+#if !defined(POWER_SAMPLING_PERIOD_MIN_MS) || POWER_SAMPLING_PERIOD_MIN_MS <= 0
+#error POWER_SAMPLING_PERIOD_MIN_MS must be defined and greater than 0!
+#endif
+#if !defined(POWER_SAMPLING_PERIOD_MS) || POWER_SAMPLING_PERIOD_MS < POWER_SAMPLING_PERIOD_MIN_MS
+#error POWER_SAMPLING_PERIOD_MS must be defined and at least POWER_SAMPLING_PERIOD_MIN_MS!
+#endif
+
+    /**
+     * @brief Timers that start_timer() and stop_timer() can read. The TSC timers are only available on x86.
+     */
+    typedef enum {
+        TIMER_OS, /**< QPC on Windows, or clock_gettime(CLOCK_MONOTONIC) on GNU/Linux, which the vDSO serves without a system call. */
+        TIMER_RDTSC, /**< rdtsc fenced by lfence on both sides, so that it neither reads the counter before earlier instructions finish nor lets later ones start early. */
+        TIMER_RDTSCP, /**< rdtscp, which waits for earlier instructions to finish, followed by lfence. */
+        TIMER_CPUID, /**< rdtsc and rdtscp fully serialized by cpuid. cpuid costs hundreds of cycles and traps to the hypervisor in a virtual machine. */
+        NUM_TIMER_BACKENDS
+    } timer_backend_t;
+
 //#ifdef ARCH_64BIT
     typedef uint64_t tick_t;
 //#else
@@ -361,13 +414,22 @@ namespace xmem {
     extern bool g_verbose;
     extern size_t g_page_size;
     extern size_t g_large_page_size;
+    extern size_t g_thp_page_size;
     extern uint32_t g_num_numa_nodes;
+    extern uint32_t g_num_cpu_numa_nodes;
     extern uint32_t g_num_logical_cpus;
     extern uint32_t g_num_physical_packages;
     extern uint32_t g_starting_test_index;
     extern uint32_t g_test_index;
+    extern timer_backend_t g_timer_backend;
     extern tick_t g_ticks_per_ms;
     extern float g_ns_per_tick;
+    extern float g_timer_resolution_ns;
+    extern float g_timer_overhead_ns;
+    extern bool g_invariant_tsc;
+    extern float g_core_ghz;
+    extern bool g_perf_counters;
+    extern std::vector<float> g_timer_backend_overhead_ns;
 
     //Typedef the platform specific stuff to word sizes to match 4 different chunk options
 #if defined(ARCH_64BIT) || defined(ARCH_ARM_NEON)
@@ -379,8 +441,17 @@ namespace xmem {
 #ifdef ARCH_INTEL_AVX
 #define HAS_WORD_256
 #endif
+#if defined(ARCH_INTEL_X86_64) || defined(ARCH_AMD64) || defined(__aarch64__)
+#define HAS_CACHE_LINE_FLUSH
+#endif
 #if defined(ARCH_INTEL_MIC) || defined(ARCH_INTEL_AVX512)
 #define HAS_WORD_512
+#endif
+#ifdef ARCH_INTEL_AVX2
+#define HAS_GATHER_256
+#endif
+#if defined(ARCH_INTEL_AVX512) || defined(__AVX512F__)
+#define HAS_GATHER_SCATTER_512
 #endif
 
     typedef uint32_t Word32_t;
@@ -430,6 +501,120 @@ namespace xmem {
         NUM_RW_MODES
     } rw_mode_t;
 
+    /**
+     * @brief Load intensity knobs that can be stepped to trace out a loaded latency curve.
+     */
+    typedef enum {
+        CURVE_KNOB_RATE,
+        CURVE_KNOB_THREADS,
+        CURVE_KNOB_DELAY,
+        NUM_CURVE_KNOBS
+    } curve_knob_t;
+
+    /**
+     * @brief Policies for placing the memory under test across NUMA nodes.
+     */
+    typedef enum {
+        PLACEMENT_NODE, /**< Each memory node gets its own region bound to it, and every CPU node is paired with every memory node. */
+        PLACEMENT_INTERLEAVE, /**< One region is interleaved across all selected memory nodes at a configurable granularity. */
+        PLACEMENT_LOCAL, /**< Each worker thread's memory is on the node of its own CPU. */
+        NUM_PLACEMENT_POLICIES
+    } placement_policy_t;
+
+    /**
+     * @brief Kinds of memory that back the working sets under test.
+     */
+    typedef enum {
+        BACKING_ANONYMOUS, /**< Anonymous memory, as from malloc(). */
+        BACKING_MEMFD, /**< An in-memory file from memfd_create(), i.e., shared memory. */
+        BACKING_FILE, /**< A temporary file in a user-given directory, e.g., on tmpfs, on a disk file system through the page cache, or on a DAX file system. */
+        NUM_WORKING_SET_BACKINGS
+    } working_set_backing_t;
+
+    /**
+     * @brief Coherence states that the lines under test can be put into before a coherence-state-aware latency measurement.
+     */
+    typedef enum {
+        COHERENCE_MODIFIED, /**< Dirty in the private cache of one preparer core. */
+        COHERENCE_EXCLUSIVE, /**< Clean in the private cache of one preparer core only. */
+        COHERENCE_SHARED, /**< Clean and read by two preparer cores. */
+        COHERENCE_INVALID, /**< Not cached anywhere, so the access goes to memory. */
+        NUM_COHERENCE_STATES
+    } coherence_state_t;
+
+    /**
+     * @brief Atomic read-modify-write operations that can be benchmarked.
+     */
+    typedef enum {
+        ATOMIC_FETCH_ADD, /**< Atomic fetch-and-add (lock xadd on x86). */
+        ATOMIC_COMPARE_EXCHANGE, /**< Compare-and-swap increment loop (lock cmpxchg on x86). One operation is one successful increment. */
+        ATOMIC_EXCHANGE, /**< Atomic swap (xchg on x86). */
+        NUM_ATOMIC_OPS
+    } atomic_op_t;
+
+    /**
+     * @brief Kernels for gathering from or scattering to a table of 64-bit elements with independent random indices.
+     */
+    typedef enum {
+        GATHER_KERNEL_SCALAR, /**< One element per load or store instruction. Available everywhere. */
+        GATHER_KERNEL_256, /**< Four elements per AVX2 vpgatherdq. Gather only. */
+        GATHER_KERNEL_512, /**< Eight elements per AVX-512 vpgatherdq or vpscatterdq. */
+        NUM_GATHER_KERNELS
+    } gather_kernel_t;
+
+    /**
+     * @brief Kinds of pages that can back freshly mapped memory in the page fault benchmark.
+     */
+    typedef enum {
+        PAGE_BACKING_BASE, /**< Regular pages of the system page size. */
+        PAGE_BACKING_THP, /**< Transparent huge pages, requested with MADV_HUGEPAGE. */
+        PAGE_BACKING_HUGETLB, /**< Explicit huge pages of the large page size, taken from the reserved pool. */
+        NUM_PAGE_BACKINGS
+    } page_backing_t;
+
+    /**
+     * @brief Ways of faulting in freshly mapped memory in the page fault benchmark.
+     */
+    typedef enum {
+        FAULT_LAZY, /**< Map without populating, then fault every page in by writing to it. */
+        FAULT_POPULATE, /**< Let the kernel fault everything in when the memory is mapped, with MAP_POPULATE. */
+        FAULT_COW, /**< Write to every page of a private mapping that is shared with a forked child, so that every write takes a copy-on-write fault. */
+        NUM_FAULT_MODES
+    } fault_mode_t;
+
+    /**
+     * @brief Transparent huge page policies that can be applied to a working set in THP comparison mode.
+     */
+    typedef enum {
+        THP_SYSTEM_DEFAULT, /**< No madvise() call, so the system-wide THP setting applies as-is. */
+        THP_MADV_HUGEPAGE, /**< madvise(MADV_HUGEPAGE) before the region is faulted in. */
+        THP_MADV_NOHUGEPAGE, /**< madvise(MADV_NOHUGEPAGE) before the region is faulted in. */
+        THP_COLLAPSE, /**< Faulted in with regular pages, then madvise(MADV_HUGEPAGE) so that khugepaged collapses the region in the background. */
+        NUM_THP_POLICIES
+    } thp_policy_t;
+
+    /**
+     * @brief Hardware performance counters that worker threads can collect.
+     */
+    typedef enum {
+        PERF_CYCLES, /**< Core cycles. */
+        PERF_INSTRUCTIONS, /**< Instructions retired. */
+        PERF_LLC_LOADS, /**< Last-level cache read accesses. */
+        PERF_LLC_MISSES, /**< Last-level cache read misses. */
+        PERF_DTLB_MISSES, /**< Data TLB load misses. */
+        PERF_L1D_REPLACEMENTS, /**< L1 data cache read misses, which perf maps to L1D.REPLACEMENT on Intel. */
+        PERF_OFFCORE_REQUESTS, /**< Intel only. Data read requests sent to the uncore (OFFCORE_REQUESTS.ALL_DATA_RD). */
+        NUM_PERF_COUNTERS
+    } perf_counter_t;
+
+    /**
+     * @brief Hardware performance counter values, scaled up for the time each counter was multiplexed out.
+     */
+    typedef struct {
+        double counts[NUM_PERF_COUNTERS]; /**< Scaled count of each event. */
+        bool valid[NUM_PERF_COUNTERS]; /**< True for each counter that could be opened and was scheduled on the PMU at least some of the time. */
+    } perf_counts_t;
+
     /**
      * @brief Legal memory read/write chunk sizes in bits.
      */
@@ -450,10 +635,36 @@ namespace xmem {
         NUM_CHUNK_SIZES
     } chunk_size_t;
 
+    /**
+     * @brief What one worker thread does in a heterogeneous workload mix.
+     */
+    typedef struct {
+        bool latency_probe; /**< If true, the thread measures latency by chasing 64-bit random pointers, and the load fields below are ignored. */
+        pattern_mode_t pattern_mode; /**< Access pattern of a load thread. */
+        rw_mode_t rw_mode; /**< Read/write mode of a load thread. */
+        chunk_size_t chunk_size; /**< Chunk size of a load thread. */
+        int32_t stride_size; /**< Stride of a sequential load thread in chunks. */
+        size_t working_set_size; /**< Private working set of the thread in bytes. */
+        uint32_t mem_node; /**< Memory NUMA node holding the working set. */
+        uint32_t cpu_node; /**< CPU NUMA node the thread runs on. */
+    } workload_thread_t;
+
+    /**
+     * @brief What is known about the contents of a memory region under test, so that consecutive benchmarks on it can skip redundant setup.
+     */
+    typedef struct {
+        size_t resident_len; /**< Length in bytes from the start of the region that has been written since it was allocated, and is thus physically resident. */
+        size_t slice_len; /**< Length in bytes of the per-thread slices that the permutations below were built over. */
+        std::vector<chunk_size_t> slice_permutations; /**< For each slice, the chunk size of the random pointer permutation it holds, or NUM_CHUNK_SIZES if it holds none. */
+    } region_layout_t;
+
     typedef enum {
 #ifdef EXT_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK
         EXT_NUM_DELAY_INJECTED_LOADED_LATENCY_BENCHMARK,
 #endif
+#ifdef EXT_MEMCPY_BENCHMARK
+        EXT_NUM_MEMCPY_BENCHMARK,
+#endif
 #ifdef EXT_STREAM_BENCHMARK
         EXT_NUM_STREAM_BENCHMARK,
 #endif
@@ -525,6 +736,21 @@ namespace xmem {
      */
     int32_t cpu_id_in_numa_node(uint32_t numa_node, uint32_t cpu_in_node);
 
+    /**
+     * @brief Checks whether a NUMA node has any logical CPUs. Memory-only nodes, such as CXL memory expanders or high-bandwidth memory tiers, do not.
+     * @param numa_node The NUMA node of interest.
+     * @returns True if at least one logical CPU belongs to the node.
+     */
+    bool numa_node_has_cpus(uint32_t numa_node);
+
+    /**
+     * @brief Gets the relative distance between two NUMA nodes as reported by the firmware (the ACPI SLIT on most systems). Local access is normally 10.
+     * @param from_node The NUMA node issuing the accesses.
+     * @param to_node The NUMA node holding the memory.
+     * @returns The distance, or 0 if it is not known.
+     */
+    uint32_t numa_node_distance(uint32_t from_node, uint32_t to_node);
+
     /**
      * @brief Computes the number of passes to use for a given working set size in KB, when size-based benchmarking mode is enabled at compile-time.
      * You may want to change this implementation to suit your needs. See the compile-time options in common.h.
@@ -567,6 +793,20 @@ namespace xmem {
      */
     tick_t stop_timer();
 
+    /**
+     * @brief Gets the name of a timer backend, as accepted by the --timer option.
+     * @param backend The timer backend.
+     * @returns The name.
+     */
+    std::string timer_backend_name(timer_backend_t backend);
+
+    /**
+     * @brief Indicates if a timer backend is built into this binary.
+     * @param backend The timer backend.
+     * @returns True if start_timer() and stop_timer() can use it.
+     */
+    bool timer_backend_available(timer_backend_t backend);
+
 #ifdef _WIN32
     /**
      * @brief Increases the scheduling priority of the calling thread.
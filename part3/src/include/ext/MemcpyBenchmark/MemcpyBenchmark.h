@@ -0,0 +1,143 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the MemcpyBenchmark class.
+ */
+
+#ifdef EXT_MEMCPY_BENCHMARK
+
+#ifndef MEMCPY_BENCHMARK_H
+#define MEMCPY_BENCHMARK_H
+
+//Headers
+#include <Benchmark.h>
+#include <memcpy_benchmark_kernels.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+
+namespace xmem {
+
+    /**
+     * @brief A type of benchmark that measures single-threaded bulk copy (memcpy-like) or bulk fill (memset-like) throughput for one strategy, size, and source alignment.
+     *
+     * The destination starts at the beginning of the memory region and is page aligned. The source follows it on the next cache line boundary, plus MEMCPY_BENCHMARK_MISALIGNMENT bytes if misaligned.
+     */
+    class MemcpyBenchmark : public Benchmark {
+    public:
+
+        /**
+         * @brief Constructor.
+         * @param mem_array A pointer to a contiguous chunk of memory holding both buffers.
+         * @param len Length of the memory region in bytes. Must be at least getRequiredLen(size).
+         * @param iterations Number of iterations of the complete benchmark. Used to gather more statistics.
+         * @param mem_node The memory NUMA node that mem_array belongs to.
+         * @param cpu_node The CPU NUMA node of the worker thread.
+         * @param fill If true, benchmark bulk fill. Otherwise benchmark bulk copy.
+         * @param strategy The bulk copy/fill strategy.
+         * @param misaligned If true, offset the source by MEMCPY_BENCHMARK_MISALIGNMENT bytes. Only meaningful for copies.
+         * @param size Number of bytes copied or filled per call.
+         * @param dram_power_readers A group of PowerReader objects for measuring DRAM power.
+         * @param name The name of the benchmark to use when reporting to console.
+         */
+        MemcpyBenchmark(
+            void* mem_array,
+            size_t len,
+            uint32_t iterations,
+            uint32_t mem_node,
+            uint32_t cpu_node,
+            bool fill,
+            bulk_strategy_t strategy,
+            bool misaligned,
+            size_t size,
+            std::vector<PowerReader*> dram_power_readers,
+            std::string name
+        );
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~MemcpyBenchmark() {}
+
+        /**
+         * @brief Reports benchmark configuration details to the console.
+         */
+        virtual void reportBenchmarkInfo() const;
+
+        /**
+         * @brief Reports results to the console.
+         */
+        virtual void reportResults() const;
+
+        /**
+         * @brief Gets whether this benchmark fills rather than copies.
+         * @returns True for bulk fill, false for bulk copy.
+         */
+        bool isFill() const { return fill_; }
+
+        /**
+         * @brief Gets the bulk copy/fill strategy.
+         * @returns The strategy.
+         */
+        bulk_strategy_t getStrategy() const { return strategy_; }
+
+        /**
+         * @brief Gets whether the source buffer is misaligned.
+         * @returns True if the source is offset from a cache line boundary.
+         */
+        bool isMisaligned() const { return misaligned_; }
+
+        /**
+         * @brief Gets the number of bytes copied or filled per call.
+         * @returns The size in bytes.
+         */
+        size_t getSize() const { return size_; }
+
+        /**
+         * @brief Gets the memory region length needed to benchmark a given size.
+         * @param size Number of bytes copied or filled per call.
+         * @returns The length in bytes.
+         */
+        static size_t getRequiredLen(size_t size);
+
+    protected:
+        virtual bool runCore();
+
+    private:
+        bool fill_; /**< If true, benchmark bulk fill. Otherwise benchmark bulk copy. */
+        bulk_strategy_t strategy_; /**< The bulk copy/fill strategy. */
+        bool misaligned_; /**< If true, the source is offset from a cache line boundary. */
+        size_t size_; /**< Number of bytes copied or filled per call. */
+    };
+};
+
+#endif
+
+#endif
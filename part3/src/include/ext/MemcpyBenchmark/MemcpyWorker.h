@@ -0,0 +1,86 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for the MemcpyWorker class.
+ */
+
+#ifdef EXT_MEMCPY_BENCHMARK
+
+#ifndef MEMCPY_WORKER_H
+#define MEMCPY_WORKER_H
+
+//Headers
+#include <MemoryWorker.h>
+#include <memcpy_benchmark_kernels.h>
+#include <common.h>
+
+namespace xmem {
+    /**
+     * @brief Multithreading-friendly class to time repeated bulk copies or fills of one size.
+     *
+     * Each pass calls the kernel enough times to move at least MEMCPY_BENCHMARK_BATCH_BYTES, so that small sizes are not dominated by timer overhead.
+     */
+    class MemcpyWorker : public MemoryWorker {
+        public:
+
+            /**
+             * @brief Constructor.
+             * @param dst Destination buffer.
+             * @param src Source buffer. Ignored by fill kernels.
+             * @param len Number of bytes to copy or fill per kernel call.
+             * @param kernel_fptr The bulk copy or fill kernel.
+             * @param cpu_affinity Logical CPU identifier to lock this worker's thread to.
+             */
+            MemcpyWorker(
+                void* dst,
+                const void* src,
+                size_t len,
+                BulkFunction kernel_fptr,
+                int32_t cpu_affinity
+            );
+
+            /**
+             * @brief Destructor.
+             */
+            virtual ~MemcpyWorker();
+
+            /**
+             * @brief Thread-safe worker method.
+             */
+            virtual void run();
+
+        private:
+            // ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
+            const void* src_; /**< Source buffer. */
+            BulkFunction kernel_fptr_; /**< The bulk copy or fill kernel. */
+    };
+};
+
+#endif
+
+#endif
@@ -0,0 +1,106 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Author: Mark Gottscho <mgottscho@ucla.edu>
+ */
+
+/**
+ * @file
+ *
+ * @brief Header file for bulk copy and bulk fill kernels used by the memcpy/memset throughput extension.
+ */
+
+#ifndef __MEMCPY_BENCHMARK_KERNELS_H
+#define __MEMCPY_BENCHMARK_KERNELS_H
+
+//Headers
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#if defined(ARCH_INTEL_AVX512) || defined(__AVX512F__)
+#define MEMCPY_BENCHMARK_HAS_AVX512
+#endif
+
+#define MEMCPY_BENCHMARK_DURATION_MS 100 /**< RECOMMENDED VALUE: At least 50. Number of milliseconds to run each copy/fill size and strategy. Kept shorter than BENCHMARK_DURATION_MS because the extension sweeps many points. */
+#define MEMCPY_BENCHMARK_BATCH_BYTES 64*KB /**< RECOMMENDED VALUE: 64*KB. Minimum number of bytes copied or filled between two timer reads, so that timer overhead does not swamp small sizes. */
+#define MEMCPY_BENCHMARK_MIN_SIZE 64 /**< Smallest copy/fill size in bytes. Sizes double from here up to what fits in the working set. */
+#define MEMCPY_BENCHMARK_MISALIGNMENT 1 /**< Byte offset of the source buffer from a cache line boundary for the misaligned copy runs. */
+
+#if MEMCPY_BENCHMARK_DURATION_MS <= 0
+#error MEMCPY_BENCHMARK_DURATION_MS must be positive!
+#endif
+
+#if MEMCPY_BENCHMARK_MISALIGNMENT <= 0 || MEMCPY_BENCHMARK_MISALIGNMENT >= CACHE_LINE_SIZE
+#error MEMCPY_BENCHMARK_MISALIGNMENT must be positive and smaller than CACHE_LINE_SIZE!
+#endif
+
+namespace xmem {
+
+    /**
+     * @brief Bulk copy/fill strategies that can be compared. Not all strategies exist on all platforms; see determine_bulk_kernel().
+     */
+    typedef enum {
+        BULK_LIBC, /**< The C library memcpy() or memset(). */
+        BULK_REP, /**< A single rep movsb or rep stosb instruction (fast with ERMSB/FSRM). x86-64 only. */
+        BULK_SSE2_NT, /**< 128-bit loop with non-temporal stores. x86-64 only. */
+        BULK_AVX, /**< 256-bit loop with regular stores. Needs an AVX build. */
+        BULK_AVX_NT, /**< 256-bit loop with non-temporal stores. Needs an AVX build. */
+        BULK_AVX512, /**< 512-bit loop with regular stores. Needs an AVX-512 build. */
+        BULK_AVX512_NT, /**< 512-bit loop with non-temporal stores. Needs an AVX-512 build. */
+        NUM_BULK_STRATEGIES
+    } bulk_strategy_t;
+
+    /**
+     * @brief A bulk copy or fill kernel. Fill kernels ignore src.
+     * @param dst Destination address. Must be aligned to the kernel's vector width for the non-temporal kernels.
+     * @param src Source address. May be misaligned.
+     * @param len Number of bytes to copy or fill.
+     */
+    typedef void(*BulkFunction)(void* dst, const void* src, size_t len);
+
+    /**
+     * @brief Determines which bulk kernel to use for a strategy.
+     * @param fill If true, pick the fill (memset-like) kernel. Otherwise pick the copy (memcpy-like) kernel.
+     * @param strategy The strategy.
+     * @param kernel_function Function pointer that will be set to the matching kernel function.
+     * @returns True on success, false if the strategy is not available in this build.
+     */
+    bool determine_bulk_kernel(bool fill, bulk_strategy_t strategy, BulkFunction* kernel_function);
+
+    /**
+     * @brief Gets a short name for a bulk strategy.
+     * @param strategy The strategy.
+     * @returns The name.
+     */
+    std::string bulk_strategy_name(bulk_strategy_t strategy);
+
+    /**
+     * @brief Reports CPU features that matter for choosing a bulk copy strategy (ERMSB, FSRM, AVX2, AVX-512) to the console, where the platform allows querying them.
+     */
+    void report_bulk_cpu_features();
+};
+
+#endif
@@ -141,6 +141,54 @@ int main(int argc, char* argv[]) {
                 benchmgr.runLatencyBenchmarks();
             }
 
+            if (config.latencyCurveSelected()) {
+                benchmgr.runLatencyCurve();
+            }
+
+            if (config.coreToCoreSelected()) {
+                benchmgr.runCoreToCoreLatencyBenchmark();
+            }
+
+            if (config.coherenceLatencySelected()) {
+                benchmgr.runCoherenceLatencyBenchmarks();
+            }
+
+            if (config.atomicsSelected()) {
+                benchmgr.runAtomicBenchmarks();
+            }
+
+            if (config.gatherSelected()) {
+                benchmgr.runGatherBenchmarks();
+            }
+
+            if (config.workloadSelected()) {
+                benchmgr.runWorkloadMixBenchmark();
+            }
+
+            if (config.pageFaultsSelected()) {
+                benchmgr.runPageFaultBenchmarks();
+            }
+
+            if (config.numaMatrixSelected()) {
+                benchmgr.runNumaMatrixBenchmarks();
+            }
+
+            if (config.allToAllSelected()) {
+                benchmgr.runAllToAllBenchmark();
+            }
+
+            if (config.thpCompareSelected()) {
+                benchmgr.runThpBenchmarks();
+            }
+
+            if (config.migrationSelected()) {
+                benchmgr.runPageMigrationBenchmarks();
+            }
+
+            if (config.tlbReachSelected()) {
+                benchmgr.runTlbReachBenchmarks();
+            }
+
             if (config.extensionsEnabled()) {
                 std::cout << std::endl;
                 std::cout << "++++++++++++++++++++++++++++++++++++++++++++++++++++++++++" << std::endl;
@@ -156,6 +204,13 @@ int main(int argc, char* argv[]) {
                 }
 #endif
 
+#ifdef EXT_MEMCPY_BENCHMARK
+                if (config.runExtMemcpyBenchmark()) {
+                    std::cout << "EXTENSION " << EXT_NUM_MEMCPY_BENCHMARK << ": memcpy/memset throughput across copy strategies, sizes, and source alignments." << std::endl;
+                    benchmgr.runExtMemcpyBenchmark();
+                }
+#endif
+
 #ifdef EXT_STREAM_BENCHMARK
                 if (config.runExtStreamBenchmark()) {
                     std::cout << "EXTENSION " << EXT_NUM_STREAM_BENCHMARK << ": STREAM-like throughput benchmark using stream copy, add, and triad kernels." << std::endl;
@@ -40,6 +40,7 @@
 //Libraries
 #include <cstdint>
 #include <vector>
+#include <iostream>
 
 using namespace xmem;
 
@@ -67,6 +68,17 @@ WindowsDRAMPowerReader::~WindowsDRAMPowerReader() {
 
 void WindowsDRAMPowerReader::run() {
     bool done = false;
+    int32_t cpu_affinity = -1;
+    if (acquireLock(-1)) { //Wait indefinitely for the lock
+        cpu_affinity = cpu_affinity_;
+        releaseLock();
+    }
+    if (cpu_affinity >= 0 && !lock_thread_to_cpu(cpu_affinity))
+        std::cerr << "WARNING: Failed to lock " << name() << " power measurement to logical CPU " << cpu_affinity << ", so it may perturb the benchmark." << std::endl;
+
+    double last_result = 0;
+    bool have_last = false;
+    tick_t last_tick = start_timer();
 
     while (!done) {
         tick_t start_tick = start_timer();
@@ -76,6 +88,11 @@ void WindowsDRAMPowerReader::run() {
             releaseLock();
         }
 
+        //Samples are instantaneous power, so each one is held until the next to integrate energy. After a stop, this closes the measurement window.
+        if (have_last)
+            addEnergy(last_result * (start_tick - last_tick) * g_ns_per_tick * 1e-9, (start_tick - last_tick) * g_ns_per_tick * 1e-9);
+        last_tick = start_tick;
+
         if (!done) {
             //Read power from performance counter
             double result = 0;
@@ -101,9 +118,21 @@ void WindowsDRAMPowerReader::run() {
             }
 
             calculateMetrics();
-            tick_t stop_tick = stop_timer();
-            tick_t elapsed_ticks = stop_tick - start_tick;
-            Sleep(static_cast<DWORD>(sampling_period_ - elapsed_ticks*g_ns_per_tick*1e-9*1000)); //Account for any loop overhead
+            last_result = result;
+            have_last = true;
+
+            //Sleep for the rest of the sampling period in short slices, accounting for any loop overhead, so that a stop ends the measurement window promptly
+            bool stopping = false;
+            while (!stopping) {
+                double remaining_ms = sampling_period_ - (stop_timer() - start_tick) * g_ns_per_tick * 1e-6;
+                if (remaining_ms <= 0)
+                    break;
+                Sleep(static_cast<DWORD>(remaining_ms < POWER_SAMPLING_PERIOD_MIN_MS ? remaining_ms : POWER_SAMPLING_PERIOD_MIN_MS));
+                if (acquireLock(-1)) { //Wait indefinitely for the lock
+                    stopping = stop_signal_;
+                    releaseLock();
+                }
+            }
         }
     }
 }